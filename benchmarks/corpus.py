@@ -0,0 +1,82 @@
+"""
+Bytecode corpus for the native justjit_bench benchmark.
+
+Each entry is one function at a graded size, recorded with the same packing
+justjit._extract_bytecode uses (4 native int32 fields per instruction), so the
+benchmark can drive JITCore directly without importing the justjit extension.
+Only the standard library is used here.
+"""
+
+import array
+import dis
+
+SIZES = (1, 8, 64, 256)
+
+# Same set as justjit._extract_bytecode: opcodes whose argval is a jump target
+JUMP_OPCODES = {
+    "POP_JUMP_IF_FALSE",
+    "POP_JUMP_IF_TRUE",
+    "JUMP_FORWARD",
+    "JUMP_BACKWARD",
+    "POP_JUMP_IF_NONE",
+    "POP_JUMP_IF_NOT_NONE",
+    "FOR_ITER",
+    "JUMP_BACKWARD_NO_INTERRUPT",
+    "SEND",
+}
+
+# Loop body per kind, repeated ``size`` times; every kind takes (a, b)
+BODIES = {
+    "object": "    x = (x * 3 + b) % 1000003\n",
+    "int": "    x = (x * 3 + b) % 1000003\n",
+    "generator": "    x = (x * 3 + b) % 1000003\n    yield x\n",
+}
+
+
+def pack(func):
+    packed = array.array("i")
+    for instr in dis.get_instructions(func):
+        if instr.opname == "CACHE":
+            continue
+        argval = instr.argval if instr.opname in JUMP_OPCODES and isinstance(instr.argval, int) else 0
+        packed.extend((instr.opcode, instr.arg if instr.arg is not None else 0, argval, instr.offset))
+    return packed.tobytes()
+
+
+def generate(kind, size):
+    name = f"{kind}_{size}"
+    source = f"def {name}(a, b):\n    x = a\n" + BODIES[kind] * size
+    if kind != "generator":
+        source += "    return x\n"
+    namespace = {}
+    exec(compile(source, f"<corpus {name}>", "exec"), namespace)
+    return namespace[name]
+
+
+def entries():
+    """One dict per (kind, size) with everything the JITCore compile_* calls take."""
+    result = []
+    for kind in BODIES:
+        for size in SIZES:
+            func = generate(kind, size)
+            code = func.__code__
+            total_locals = code.co_nlocals + len(code.co_cellvars) + len(code.co_freevars)
+            if kind == "generator":
+                # Generators keep the value stack in extra local slots across yields
+                total_locals += code.co_stacksize
+            result.append(
+                {
+                    "name": func.__name__,
+                    "kind": kind,
+                    "size": size,
+                    "instructions": pack(func),
+                    "instruction_count": sum(1 for instr in dis.get_instructions(func) if instr.opname != "CACHE"),
+                    "constants": list(code.co_consts),
+                    "names": list(code.co_names),
+                    "exception_table": code.co_exceptiontable,
+                    "param_count": code.co_argcount,
+                    "nlocals": code.co_nlocals,
+                    "total_locals": total_locals,
+                }
+            )
+    return result
@@ -0,0 +1,240 @@
+// =============================================================================
+// justjit_bench - native compiler-latency benchmarks
+// =============================================================================
+// Drives JITCore directly from C++ (Google Benchmark) so compile costs are
+// measured without nanobind argument conversion or interpreter dispatch in
+// the timed region. Python is embedded only to record the bytecode corpus
+// (benchmarks/corpus.py) and to own the objects compiled code works on.
+//
+//   BM_Compile/<kind>_<size>/<opt_level>  compile_function, compile_int_function
+//                                         or compile_generator plus the first
+//                                         lookup, which materializes native code
+//   BM_InlineC/<opt_level>                InlineCCompiler::compile_and_execute
+//   BM_Call/<python|object|int>           one vectorcall through a JITFunction
+//                                         (the plain Python function for scale)
+// =============================================================================
+
+#include "jit_core.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace nb = nanobind;
+
+#ifndef JUSTJIT_BENCH_CORPUS_DIR
+#define JUSTJIT_BENCH_CORPUS_DIR "."
+#endif
+
+namespace
+{
+    struct CorpusEntry
+    {
+        std::string name;
+        std::string kind; // "object", "int" or "generator"
+        int size;
+        nb::object instructions;
+        nb::list constants;
+        nb::list names;
+        nb::object exception_table;
+        int param_count;
+        int nlocals;
+        int total_locals;
+        size_t instruction_count;
+    };
+
+    std::vector<CorpusEntry> corpus;
+    nb::dict corpus_globals;
+    nb::dict corpus_builtins;
+
+    void load_corpus()
+    {
+        nb::module_ sys = nb::module_::import_("sys");
+        nb::borrow<nb::list>(sys.attr("path")).insert(0, nb::str(JUSTJIT_BENCH_CORPUS_DIR));
+        corpus_builtins = nb::borrow<nb::dict>(nb::module_::import_("builtins").attr("__dict__"));
+        for (nb::handle item : nb::module_::import_("corpus").attr("entries")())
+        {
+            nb::dict entry = nb::borrow<nb::dict>(item);
+            corpus.push_back({nb::cast<std::string>(entry["name"]), nb::cast<std::string>(entry["kind"]),
+                              nb::cast<int>(entry["size"]), entry["instructions"],
+                              nb::borrow<nb::list>(entry["constants"]), nb::borrow<nb::list>(entry["names"]),
+                              entry["exception_table"], nb::cast<int>(entry["param_count"]),
+                              nb::cast<int>(entry["nlocals"]), nb::cast<int>(entry["total_locals"]),
+                              nb::cast<size_t>(entry["instruction_count"])});
+        }
+    }
+
+    // Compiles entry under name; returns the symbol whose lookup materializes it
+    std::string compile_entry(justjit::JITCore &core, const CorpusEntry &entry, const std::string &name)
+    {
+        bool ok;
+        if (entry.kind == "int")
+        {
+            ok = core.compile_int_function(entry.instructions, entry.constants, name, entry.param_count,
+                                           entry.total_locals);
+        }
+        else if (entry.kind == "generator")
+        {
+            ok = core.compile_generator(entry.instructions, entry.constants, entry.names, corpus_globals,
+                                        corpus_builtins, nb::list(), entry.exception_table, name,
+                                        entry.param_count, entry.total_locals, entry.nlocals);
+        }
+        else
+        {
+            ok = core.compile_function(entry.instructions, entry.constants, entry.names, corpus_globals,
+                                       corpus_builtins, nb::list(), entry.exception_table, name,
+                                       entry.param_count, entry.total_locals, entry.nlocals);
+        }
+        if (!ok)
+        {
+            return "";
+        }
+        return entry.kind == "generator" ? name + "_step" : name;
+    }
+
+    void BM_Compile(benchmark::State &state, const CorpusEntry *entry)
+    {
+        justjit::JITCore core;
+        core.set_opt_level(static_cast<int>(state.range(0)));
+        // Every iteration compiles a new symbol; compiled names are never reused
+        size_t serial = 0;
+        for (auto _ : state)
+        {
+            std::string name = entry->name + "_" + std::to_string(serial++);
+            std::string symbol = compile_entry(core, *entry, name);
+            if (symbol.empty() || core.lookup_symbol(symbol) == 0)
+            {
+                PyErr_Clear();
+                state.SkipWithError("compile failed");
+                break;
+            }
+            state.PauseTiming();
+            core.unload(name);
+            state.ResumeTiming();
+        }
+        state.counters["instructions"] = static_cast<double>(entry->instruction_count);
+    }
+
+#ifdef JUSTJIT_HAS_CLANG
+    void BM_InlineC(benchmark::State &state)
+    {
+        justjit::JITCore core;
+        justjit::InlineCCompiler compiler(&core);
+        int opt_level = static_cast<int>(state.range(0));
+        size_t serial = 0;
+        for (auto _ : state)
+        {
+            // A fresh function name per iteration: snippets share the core's dylib
+            std::string code = "double bench_dot_" + std::to_string(serial++) +
+                               "(double *a, double *b, int n) {\n"
+                               "    double total = 0.0;\n"
+                               "    for (int i = 0; i < n; i++) total += a[i] * b[i];\n"
+                               "    return total;\n"
+                               "}\n";
+            benchmark::DoNotOptimize(compiler.compile_and_execute(code, "c", nb::dict(), opt_level));
+        }
+    }
+#endif
+
+    // Vectorcall through callable with (3, 4): boxing, binding and the trampoline
+    void BM_Call(benchmark::State &state, const char *kind)
+    {
+        justjit::JITCore core;
+        std::string mode = kind;
+        nb::dict scope;
+        PyObject *defined = PyRun_String("def add(a, b):\n    return a + b\n", Py_file_input, scope.ptr(), scope.ptr());
+        Py_XDECREF(defined);
+        nb::object callable = scope["add"];
+        if (mode != "python")
+        {
+            nb::object code = callable.attr("__code__");
+            nb::object instructions = nb::module_::import_("corpus").attr("pack")(callable);
+            nb::list constants = nb::steal<nb::list>(PySequence_List(code.attr("co_consts").ptr()));
+            bool ok = mode == "int"
+                          ? core.compile_int_function(instructions, constants, "add", 2, 2)
+                          : core.compile_function(instructions, constants,
+                                                  nb::steal<nb::list>(PySequence_List(code.attr("co_names").ptr())),
+                                                  corpus_globals, corpus_builtins, nb::list(),
+                                                  code.attr("co_exceptiontable"), "add", 2, 2, 2);
+            if (!ok)
+            {
+                PyErr_Clear();
+                state.SkipWithError("compile failed");
+                return;
+            }
+            callable = mode == "int" ? core.get_int_callable("add", 2) : core.get_callable("add", 2);
+        }
+        if (!callable.is_valid() || callable.is_none())
+        {
+            PyErr_Clear();
+            state.SkipWithError("compile failed");
+            return;
+        }
+
+        PyObject *args[] = {PyLong_FromLong(3), PyLong_FromLong(4)};
+        for (auto _ : state)
+        {
+            PyObject *result = PyObject_Vectorcall(callable.ptr(), args, 2, nullptr);
+            benchmark::DoNotOptimize(result);
+            Py_XDECREF(result);
+        }
+        Py_DECREF(args[0]);
+        Py_DECREF(args[1]);
+    }
+
+    void register_benchmarks()
+    {
+        for (const CorpusEntry &entry : corpus)
+        {
+            benchmark::RegisterBenchmark(("BM_Compile/" + entry.name).c_str(), BM_Compile, &entry)
+                ->ArgName("opt")
+                ->DenseRange(0, 3)
+                ->Unit(benchmark::kMillisecond);
+        }
+#ifdef JUSTJIT_HAS_CLANG
+        benchmark::RegisterBenchmark("BM_InlineC", BM_InlineC)
+            ->ArgName("opt")
+            ->DenseRange(0, 3)
+            ->Unit(benchmark::kMillisecond);
+#endif
+        for (const char *kind : {"python", "object", "int"})
+        {
+            benchmark::RegisterBenchmark((std::string("BM_Call/") + kind).c_str(), BM_Call, kind);
+        }
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Py_Initialize();
+    {
+        nb::gil_scoped_acquire gil;
+        if (!justjit::ready_runtime_types()) // Importing _core would do this
+        {
+            PyErr_Print();
+            return 1;
+        }
+        try
+        {
+            load_corpus();
+        }
+        catch (const std::exception &e)
+        {
+            std::fprintf(stderr, "justjit_bench: cannot load the corpus: %s\n", e.what());
+            return 1;
+        }
+        register_benchmarks();
+        benchmark::Initialize(&argc, argv);
+        if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        {
+            return 1;
+        }
+        benchmark::RunSpecifiedBenchmarks();
+        benchmark::Shutdown();
+        corpus.clear();
+    }
+    // Compiled code holds references the interpreter cannot safely drop at exit
+    return 0;
+}
@@ -1,5 +1,6 @@
 #include <nanobind/nanobind.h>
 #include <nanobind/stl/string.h>
+#include <nanobind/stl/vector.h>
 #include "jit_core.h"
 
 namespace nb = nanobind;
@@ -13,54 +14,129 @@ NB_MODULE(_core, m)
      nb::set_leak_warnings(false);
 
      m.doc() = "Fast Python JIT compiler using LLVM ORC";
+     justjit::install_fork_handlers();
+     if (!justjit::ready_runtime_types())
+     {
+          throw nb::python_error();
+     }
 
      nb::class_<justjit::JITCore>(m, "JIT")
          .def(nb::init<>())
          .def("set_opt_level", &justjit::JITCore::set_opt_level, "level"_a)
          .def("get_opt_level", &justjit::JITCore::get_opt_level)
+         .def("set_hot_code", &justjit::JITCore::set_hot_code, "hot"_a, "Link this core's code into the hot code slabs, next to other hot code")
          .def("set_dump_ir", &justjit::JITCore::set_dump_ir, "dump"_a, "Enable/disable IR capture for debugging")
          .def("get_dump_ir", &justjit::JITCore::get_dump_ir, "Check if IR dump is enabled")
+         .def("set_explain_codegen", &justjit::JITCore::set_explain_codegen, "enable"_a, "Record per-offset lowering, vectorizer remarks and assembly of the next compiles")
+         .def("set_target", &justjit::JITCore::set_target, "cpu"_a = "", "features"_a = "", "Set the target CPU and feature string (empty = detected host)")
+         .def("get_target_cpu", &justjit::JITCore::get_target_cpu, "Get the CPU name compiled code targets")
+         .def("target_signature", &justjit::JITCore::target_signature, "Triple, CPU and features compiled code is tied to; objects load only where it matches")
+         .def("set_multiversion", &justjit::JITCore::set_multiversion, "enable"_a, "Emit per-ISA clones of each function with runtime CPU dispatch")
+         .def("set_lazy_materialize", &justjit::JITCore::set_lazy_materialize, "enable"_a, "Optimize and generate code of later compiles on their first call")
+         .def("set_closure_argument", &justjit::JITCore::set_closure_argument, "enable"_a, "Compile object-mode functions to take their __closure__ as a hidden last argument, so one body serves every closure")
+         .def("set_profile_instrumentation", &justjit::JITCore::set_profile_instrumentation, "enable"_a, "Count the taken/not-taken edges of every conditional branch in functions compiled from now on")
+         .def("get_branch_profile", &justjit::JITCore::get_branch_profile, "name"_a, "Get the branch counts of an instrumented function (taken, not taken per branch)")
+         .def("set_branch_profile", &justjit::JITCore::set_branch_profile, "name"_a, "counts"_a, "Use branch counts from get_branch_profile as branch weights when name is next compiled")
+         .def("set_aot_capture", &justjit::JITCore::set_aot_capture, "enable"_a, "Collect compiled typed-mode functions for ahead-of-time export")
+         .def("set_ufunc_loops", &justjit::JITCore::set_ufunc_loops, "enable"_a, "Also emit a NumPy-style <name>__ufunc loop for each int/float/int32/float32 function")
+         .def("set_reduce_loops", &justjit::JITCore::set_reduce_loops, "enable"_a, "Also emit <name>__reduce and <name>__scan loops for each two-argument int/float/int32/float32 function")
+         .def("set_cuda_target", &justjit::JITCore::set_cuda_target, "arch"_a, "Also emit a <name>__cuda PTX kernel for each int/float/int32/float32 function (e.g. 'sm_52'; '' disables)")
+         .def("get_cuda_ptx", &justjit::JITCore::get_cuda_ptx, "name"_a, "Get the PTX emitted for a function ('' if none)")
+         .def("set_parallel_loops", &justjit::JITCore::set_parallel_loops, "for_iter_offsets"_a, "Run these prange() loops of the next int/float compile in parallel")
+         .def("set_simd_calls", &justjit::JITCore::set_simd_calls, "calls"_a, "Lower these justjit.simd calls ({CALL offset: operation}) in the next vector-mode compile")
+         .def("set_bit_calls", &justjit::JITCore::set_bit_calls, "calls"_a, "Lower these justjit.bits calls and int bit methods ({offset: operation} for each of their instructions) in the next int/int32 compile")
+         .def("set_raise_sites", &justjit::JITCore::set_raise_sites, "sites"_a, "Raise these builtin exceptions natively ({offset: 'Name:message'} for each instruction of a raise) in the next int/float compile")
+         .def("emit_aot_object", &justjit::JITCore::emit_aot_object, "Emit a relocatable object containing every captured function")
+         .def("load_object", &justjit::JITCore::load_object, "object"_a, "names"_a, "Link a previously exported object into this JIT")
+         .def("set_native_callees", &justjit::JITCore::set_native_callees, "globals"_a, "builtins"_a, "callees"_a, "Declare globals the next int/float/native compile may call natively: (name_index, name, wrapper, address, param_count[, signature]) tuples")
+         .def("set_frozen_globals", &justjit::JITCore::set_frozen_globals, "globals"_a, "builtins"_a, "names"_a, "values"_a, "Declare globals the next compile reads as constants; its entry deoptimizes once one is rebound")
+         .def("set_transitive_callees", &justjit::JITCore::set_transitive_callees, "callees"_a, "Declare plain Python functions whose object-mode CALL sites run a compiled JITFunction instead: {function: wrapper}, or None")
+         .def("unload", &justjit::JITCore::unload, "name"_a, "Free a compiled function's native code and the Python references it holds")
+         .def("get_code_size", &justjit::JITCore::get_code_size, "name"_a, "Get the native object size in bytes of a compiled function (0 until materialized)")
+         .def("get_compile_stats", &justjit::JITCore::get_compile_stats, "name"_a, "Get per-phase compile seconds, IR instruction counts and code bytes of a compiled function")
+         .def("get_memory_usage", &justjit::JITCore::get_memory_usage, "Get linked code/data bytes, pending IR and Python references held by this core, per function")
+         .def("take_rejection", &justjit::JITCore::take_rejection, "Why the last compile gave up: (mode, reason, opcode, offset), or None; clears it")
+         .def("set_pipeline_options", &justjit::JITCore::set_pipeline_options, "vectorize"_a = true, "inline"_a = true, "unroll"_a = true, "fastmath"_a = false, "Tune the optimization pipeline (vectorization, inlining, unrolling, fast-math)")
+         .def("set_fastmath_flags", &justjit::JITCore::set_fastmath_flags, "flags"_a, "Set individual fast-math flags: reassoc, nnan, ninf, nsz, arcp, contract, afn (or fast for all)")
          .def("get_last_ir", &justjit::JITCore::get_last_ir, "Get the LLVM IR from the last compiled function")
-         .def("compile", [](justjit::JITCore &self, nb::list instructions, nb::list constants, nb::list names, nb::object globals_dict, nb::object builtins_dict, nb::list closure_cells, nb::list exception_table, const std::string &name, int param_count, int total_locals, int nlocals)
-              { return self.compile_function(instructions, constants, names, globals_dict, builtins_dict, closure_cells, exception_table, name, param_count, total_locals, nlocals); }, "instructions"_a, "constants"_a, "names"_a, "globals_dict"_a, "builtins_dict"_a, "closure_cells"_a, "exception_table"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "nlocals"_a = 3, "Compile a Python function to native code")
-         .def("compile_int", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
-              { return self.compile_int_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile an integer-only function to native code (no Python object overhead)")
-         .def("compile_float", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("get_last_explain", &justjit::JITCore::get_last_explain, "Get what set_explain_codegen recorded of the last compile")
+         .def("compile", [](justjit::JITCore &self, nb::object instructions, nb::list constants, nb::list names, nb::object globals_dict, nb::object builtins_dict, nb::list closure_cells, nb::object exception_table, const std::string &name, int param_count, int total_locals, int nlocals, int osr_offset)
+              { return self.compile_function(instructions, constants, names, globals_dict, builtins_dict, closure_cells, exception_table, name, param_count, total_locals, nlocals, osr_offset); }, "instructions"_a, "constants"_a, "names"_a, "globals_dict"_a, "builtins_dict"_a, "closure_cells"_a, "exception_table"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "nlocals"_a = 3, "osr_offset"_a = -1, "Compile a Python function to native code (osr_offset: enter at that loop header, with every local as a parameter)")
+         .def("compile_int", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals, const std::string &overflow)
+              { return self.compile_int_function(instructions, constants, name, param_count, total_locals, overflow); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "overflow"_a = "deopt", "Compile an integer-only function to native code (no Python object overhead; overflow: 'deopt' reruns the call in the interpreter, 'raise' raises OverflowError, 'wrap' wraps)")
+         .def("compile_float", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_float_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a float-only function to native code (no Python object overhead)")
-         .def("compile_generator", [](justjit::JITCore &self, nb::list instructions, nb::list constants, nb::list names, nb::object globals_dict, nb::object builtins_dict, nb::list closure_cells, nb::list exception_table, const std::string &name, int param_count, int total_locals, int nlocals)
-              { return self.compile_generator(instructions, constants, names, globals_dict, builtins_dict, closure_cells, exception_table, name, param_count, total_locals, nlocals); }, "instructions"_a, "constants"_a, "names"_a, "globals_dict"_a, "builtins_dict"_a, "closure_cells"_a, "exception_table"_a, "name"_a, "param_count"_a = 0, "total_locals"_a = 1, "nlocals"_a = 1, "Compile a generator function to a state machine step function")
-         .def("lookup", &justjit::JITCore::lookup_symbol, "name"_a)
+         .def("compile_generator", [](justjit::JITCore &self, nb::object instructions, nb::list constants, nb::list names, nb::object globals_dict, nb::object builtins_dict, nb::list closure_cells, nb::object exception_table, const std::string &name, int param_count, int total_locals, int nlocals, const std::string &yield_kind)
+              { return self.compile_generator(instructions, constants, names, globals_dict, builtins_dict, closure_cells, exception_table, name, param_count, total_locals, nlocals, yield_kind); }, "instructions"_a, "constants"_a, "names"_a, "globals_dict"_a, "builtins_dict"_a, "closure_cells"_a, "exception_table"_a, "name"_a, "param_count"_a = 0, "total_locals"_a = 1, "nlocals"_a = 1, "yield_kind"_a = "", "Compile a generator function to a state machine step function")
+         .def("lookup", &justjit::JITCore::lookup_callee, "name"_a)
          .def("get_callable", &justjit::JITCore::get_callable, "name"_a, "param_count"_a)
+         .def("compile_baseline", &justjit::JITCore::compile_baseline, "instructions"_a, "constants"_a, "names"_a, "varnames"_a,
+              "globals_dict"_a, "builtins_dict"_a, "name"_a, "nlocals"_a, "stack_size"_a,
+              "Copy-and-patch an object-mode function from precompiled stencils, without LLVM (False if an opcode has no stencil)")
+         .def("get_baseline_callable", &justjit::JITCore::get_baseline_callable, "name"_a, "param_count"_a,
+              "Get a callable for a compile_baseline function (None if there is none)")
          .def("get_int_callable", &justjit::JITCore::get_int_callable, "name"_a, "param_count"_a, "Get a callable for an integer-mode function")
          .def("get_float_callable", &justjit::JITCore::get_float_callable, "name"_a, "param_count"_a, "Get a callable for a float-mode function")
-         .def("compile_bool", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("compile_bool", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_bool_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a bool-only function to native code (no Python object overhead)")
          .def("get_bool_callable", &justjit::JITCore::get_bool_callable, "name"_a, "param_count"_a, "Get a callable for a bool-mode function")
-         .def("compile_int32", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("compile_int32", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_int32_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a 32-bit integer function (C interop)")
          .def("get_int32_callable", &justjit::JITCore::get_int32_callable, "name"_a, "param_count"_a, "Get a callable for an int32-mode function")
-         .def("compile_float32", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("compile_float32", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_float32_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a 32-bit float function (SIMD/ML)")
          .def("get_float32_callable", &justjit::JITCore::get_float32_callable, "name"_a, "param_count"_a, "Get a callable for a float32-mode function")
-         .def("compile_complex128", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("compile_complex128", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_complex128_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a complex128 function (scientific computing)")
          .def("get_complex128_callable", &justjit::JITCore::get_complex128_callable, "name"_a, "param_count"_a, "Get a callable for a complex128-mode function")
-         .def("compile_ptr", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("compile_ptr", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_ptr_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a ptr function (array access)")
          .def("get_ptr_callable", &justjit::JITCore::get_ptr_callable, "name"_a, "param_count"_a, "Get a callable for a ptr-mode function")
-         .def("compile_vec4f", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("compile_vec4f", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_vec4f_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a vec4f function (SSE SIMD)")
          .def("get_vec4f_callable", &justjit::JITCore::get_vec4f_callable, "name"_a, "param_count"_a, "Get a callable for a vec4f-mode function")
-         .def("compile_vec8i", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("compile_vec8i", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_vec8i_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a vec8i function (AVX SIMD)")
          .def("get_vec8i_callable", &justjit::JITCore::get_vec8i_callable, "name"_a, "param_count"_a, "Get a callable for a vec8i-mode function")
-         .def("compile_complex64", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("compile_vec8d", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+              { return self.compile_vec8d_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a vec8d function (<8 x f64> SIMD)")
+         .def("get_vec8d_callable", &justjit::JITCore::get_vec8d_callable, "name"_a, "param_count"_a, "Get a callable for a vec8d-mode function")
+         .def("compile_vec16f", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+              { return self.compile_vec16f_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a vec16f function (<16 x f32> SIMD)")
+         .def("get_vec16f_callable", &justjit::JITCore::get_vec16f_callable, "name"_a, "param_count"_a, "Get a callable for a vec16f-mode function")
+         .def("compile_vec16i", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+              { return self.compile_vec16i_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a vec16i function (<16 x i32> SIMD)")
+         .def("get_vec16i_callable", &justjit::JITCore::get_vec16i_callable, "name"_a, "param_count"_a, "Get a callable for a vec16i-mode function")
+         .def("compile_vec16u8", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+              { return self.compile_vec16u8_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a vec16u8 function (<16 x u8> SIMD, saturating idioms)")
+         .def("get_vec16u8_callable", &justjit::JITCore::get_vec16u8_callable, "name"_a, "param_count"_a, "Get a callable for a vec16u8-mode function")
+         .def("compile_vec32u8", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+              { return self.compile_vec32u8_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a vec32u8 function (<32 x u8> SIMD, saturating idioms)")
+         .def("get_vec32u8_callable", &justjit::JITCore::get_vec32u8_callable, "name"_a, "param_count"_a, "Get a callable for a vec32u8-mode function")
+         .def("compile_vec16i16", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+              { return self.compile_vec16i16_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a vec16i16 function (<16 x i16> SIMD, saturating idioms)")
+         .def("get_vec16i16_callable", &justjit::JITCore::get_vec16i16_callable, "name"_a, "param_count"_a, "Get a callable for a vec16i16-mode function")
+         .def("compile_complex64", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_complex64_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile a complex64 function")
          .def("get_complex64_callable", &justjit::JITCore::get_complex64_callable, "name"_a, "param_count"_a, "Get a callable for a complex64-mode function")
-         .def("compile_optional_f64", [](justjit::JITCore &self, nb::list instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
+         .def("get_complex_sum_callable", &justjit::JITCore::get_complex_sum_callable, "name"_a, "param_count"_a, "single"_a, "Get a callable summing a complex-mode function over complex buffers")
+         .def("compile_optional_f64", [](justjit::JITCore &self, nb::object instructions, nb::list constants, const std::string &name, int param_count, int total_locals)
               { return self.compile_optional_f64_function(instructions, constants, name, param_count, total_locals); }, "instructions"_a, "constants"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "Compile an optional_f64 function")
          .def("get_optional_f64_callable", &justjit::JITCore::get_optional_f64_callable, "name"_a, "param_count"_a, "Get a callable for an optional_f64-mode function")
-         .def("get_generator_callable", &justjit::JITCore::get_generator_callable, "name"_a, "param_count"_a, "total_locals"_a, "func_name"_a, "func_qualname"_a, "Get generator metadata for creating generator objects");
+         .def("compile_native", [](justjit::JITCore &self, nb::object instructions, nb::list constants, nb::list names, const std::string &name, int param_count, int total_locals, const std::vector<std::string> &param_types, const std::string &return_type, bool explain)
+              { return self.compile_native_function(instructions, constants, names, name, param_count, total_locals, param_types, return_type, explain); }, "instructions"_a, "constants"_a, "names"_a, "name"_a, "param_count"_a = 2, "total_locals"_a = 3, "param_types"_a = std::vector<std::string>(), "return_type"_a = "", "explain"_a = true, "Compile a numeric function with per-variable native types (param_types: 'int', 'float' or 'bool' per parameter, '' for int; return_type: '' to infer; explain: report rejections on stderr)")
+         .def("set_native_records", &justjit::JITCore::set_native_records, "records"_a, "Declare the record types the next native compile may use: (global name, class, field names, kinds) tuples; parameters name them as 'record:<index>'")
+         .def("set_native_shapes", &justjit::JITCore::set_native_shapes, "shapes"_a, "Fix the extents of C-contiguous array parameters in the next native compile: {parameter index: shape}; other shapes deoptimize")
+         .def("set_native_disjoint", &justjit::JITCore::set_native_disjoint, "pairs"_a, "Pairs of array parameters the next native compile assumes don't share memory; calls where they do deoptimize")
+         .def("get_native_callable", &justjit::JITCore::get_native_callable, "name"_a, "param_count"_a, "Get a callable for a native-mode function")
+         .def("native_signature", &justjit::JITCore::native_signature, "name"_a, "Kinds ('q', 'd' or '?' per parameter, then the result) of a native-mode function other native code can call directly; '' if it can't")
+         .def("get_ufunc_callable", &justjit::JITCore::get_ufunc_callable, "name"_a, "nin"_a, "kind"_a, "parallel"_a = false, "Get f(*inputs, out) running a function's ufunc loop over 1-D buffers (kind: 'd', 'f', 'q' or 'i'), split into blocks across the thread pool when parallel")
+         .def("get_reduce_callable", &justjit::JITCore::get_reduce_callable, "name"_a, "kind"_a, "Get f(array, init) folding a contiguous 1-D buffer through a function's reduce loop on the thread pool")
+         .def("get_scan_callable", &justjit::JITCore::get_scan_callable, "name"_a, "kind"_a, "Get f(array, out) writing the inclusive prefix scan of a contiguous 1-D buffer through a function's scan loop")
+         .def("get_stream_callable", &justjit::JITCore::get_stream_callable, "name"_a, "kind"_a, "Get f(path, init, chunk, offset) folding a memory-mapped file of elements through a function's reduce loop, chunk by chunk")
+         .def("get_cuda_callable", &justjit::JITCore::get_cuda_callable, "name"_a, "nin"_a, "kind"_a, "Get f(*inputs, out) launching a function's CUDA kernel over 1-D buffers or CUDA arrays")
+         .def("get_numpy_ufunc", &justjit::JITCore::get_numpy_ufunc, "name"_a, "nin"_a, "kind"_a, "doc"_a = "", "Register a function's ufunc loop as a NumPy ufunc (None if NumPy is not installed)")
+         .def("get_generator_callable", &justjit::JITCore::get_generator_callable, "name"_a, "param_count"_a, "total_locals"_a, "func_name"_a, "func_qualname"_a, "param_names"_a = nb::none(), "defaults"_a = nb::none(), "coroutine"_a = false, "yield_kind"_a = "", "async_generator"_a = false, "Get a native factory that binds arguments and creates a generator (or coroutine, or async generator) per call; yield_kind 'q'/'d' makes typed generators");
 
 #ifdef JUSTJIT_HAS_CLANG
      // InlineCCompiler - Compile C/C++ code at runtime using embedded Clang
@@ -70,20 +146,128 @@ NB_MODULE(_core, m)
          .def("add_include_path", &justjit::InlineCCompiler::add_include_path, "path"_a,
               "Add an include path for #include directives")
          .def("compile", &justjit::InlineCCompiler::compile_and_execute,
-              "code"_a, "lang"_a, "captured_vars"_a,
+              "code"_a, "lang"_a, "captured_vars"_a, "opt_level"_a = 2, "march"_a = "native",
+              "fast_math"_a = false, "extra_args"_a = std::vector<std::string>(), "nogil"_a = "off",
               "Compile C/C++ code and return dict of callable functions")
+         .def("compile_sources", &justjit::InlineCCompiler::compile_sources,
+              "codes"_a, "lang"_a, "captured_vars"_a, "opt_level"_a = 2, "march"_a = "native",
+              "fast_math"_a = false, "extra_args"_a = std::vector<std::string>(), "nogil"_a = "off",
+              "Compile several C/C++ translation units concurrently, link them and return dict of callable functions")
          .def("get_callable", &justjit::InlineCCompiler::get_c_callable,
-              "name"_a, "signature"_a,
+              "name"_a, "signature"_a, "nogil"_a = false,
               "Get a callable for a previously compiled C function")
          .def("get_last_ir", &justjit::InlineCCompiler::get_last_ir,
-              "Get the LLVM IR from the last compilation");
+              "Get the LLVM IR from the last compilation")
+         .def("get_memory_usage", &justjit::InlineCCompiler::get_memory_usage,
+              "Get the cached sources, bitcode and prelude PCH bytes this compiler holds");
 #endif // JUSTJIT_HAS_CLANG
 
+     // Persistent on-disk object cache for typed-mode functions
+     m.def("set_cache_dir", &justjit::set_object_cache_dir, "path"_a,
+        "Set the directory used to cache compiled native objects across processes (empty string disables)");
+     m.def("get_cache_dir", &justjit::get_object_cache_dir,
+        "Get the object cache directory (empty string if caching is disabled)");
+     m.def("set_cache_remote", &justjit::set_object_cache_remote, "fetch"_a.none(),
+        "Ask fetch(key) -> bytes or None for entries missing on disk, and queue new entries for upload (None disconnects)");
+     m.def("take_cache_uploads", &justjit::take_object_cache_uploads,
+        "Take the (key, bytes) entries stored since the last call, for the remote backend");
+
+     // Shared libraries JIT and inline C code may call into
+     m.def("load_library", &justjit::load_library, "path"_a,
+        "Make a shared library's exported symbols callable from JIT and inline C code");
+     m.def("loaded_libraries", &justjit::loaded_libraries,
+        "Paths passed to load_library(), in load order");
+
+     // Symbolize JIT frames in perf, gdb and VTune
+     m.def("enable_profiling", &justjit::enable_profiling,
+        "Register functions compiled from now on with perf's map file, GDB's JIT interface and VTune");
+
+     // Memory held by the JIT runtime
+     m.def("runtime_memory_usage", &justjit::runtime_memory_usage,
+        "Code and data bytes linked by the shared JIT, and live/pooled JIT generator and coroutine objects");
+
+     // Per-thread JIT event rings (justjit.trace)
+     m.def("trace_start", &justjit::trace_start, "capacity"_a,
+        "Record JIT events into per-thread rings of capacity events (0 stops); earlier events are dropped");
+     m.def("trace_stop", &justjit::trace_stop, "Stop recording JIT events; recorded ones stay readable");
+     m.def("tracing", &justjit::tracing, "Whether JIT events are being recorded");
+     m.def("trace_instant", &justjit::trace_instant, "name"_a, "category"_a, "detail"_a = "",
+        "Record an instant event (while tracing)");
+     m.def("trace_events", &justjit::trace_events, "clear"_a = true,
+        "Recorded events as (name, category, phase, ts_ns, dur_ns, value, tid, detail) tuples");
+
+     // Swiss-table hash aggregation behind justjit.groupby
+     m.def("group_aggregate", &justjit::group_aggregate, "keys"_a, "values"_a.none(), "op"_a,
+        "Per-key aggregate of values over int keys (see justjit.groupby); returns (keys, results, type code)");
+
+     // Per-thread xoshiro256++ streams shared with int/float-mode code
+     m.def("random", &justjit::random_f64, "Return the next random float in [0, 1)");
+     m.def("randint", [](int64_t a, int64_t b) {
+         if (b < a)
+         {
+             throw nb::value_error("empty range in randint(a, b)");
+         }
+         return justjit::random_int(a, b);
+     }, "a"_a, "b"_a, "Return a random integer N such that a <= N <= b");
+     m.def("seed", [](int64_t n) { justjit::seed_random(static_cast<uint64_t>(n)); }, "n"_a,
+        "Seed the generator; the calling thread restarts at stream 0 and other threads on their next draw");
+
+     // Thread pool of prange() loops, parallel reductions and OpenMP regions
+     m.def("set_num_threads", &justjit::set_num_threads, "count"_a,
+        "Run parallel regions on count threads, the caller included; waits for a running region");
+     m.def("get_num_threads", &justjit::get_num_threads, "Threads a parallel region uses, the caller included");
+     m.def("set_thread_affinity", &justjit::set_thread_affinity, "cpus"_a, "nodes"_a,
+        "Pin pool thread k to cpus[k % len(cpus)], or split the threads into equal groups bound to the given NUMA nodes");
+     m.def("numa_nodes", &justjit::numa_nodes, "CPUs of each NUMA node (empty if the system reports none)");
+     m.def("parallel_stats", &justjit::parallel_stats, "reset"_a = false,
+        "Per-slot regions, chunks, stolen chunks, busy_ns and idle_ns of the thread pool");
+
+     m.def("cuda_available", &justjit::cuda_available,
+        "Whether vectorize(target='cuda') can run: built with NVPTX and a CUDA device is present");
+     m.def("baseline_available", &justjit::baseline_available,
+        "Whether tiered='baseline' can copy-and-patch: this build has the stencils (x86-64 ELF, built with clang)");
+
+     // Vectorcall wrapper that @jit functions are published as
+     m.attr("JITFunction") = nb::borrow(reinterpret_cast<PyObject *>(&justjit::JITFunction_Type));
+     m.def("create_jit_function", [](nb::str name, nb::object slow_path, nb::object fallback, nb::tuple param_names,
+                                     nb::object defaults, nb::object kwdefaults, Py_ssize_t positional_count,
+                                     bool star_args, bool star_kwargs) {
+         PyObject* function = justjit::JITFunction_New(name.ptr(), slow_path.ptr(), fallback.ptr(),
+                                                       param_names.ptr(), defaults.ptr(), kwdefaults.ptr(),
+                                                       positional_count, star_args, star_kwargs);
+         if (function == nullptr) {
+             throw nb::python_error();
+         }
+         return nb::steal(function);
+     }, "name"_a, "slow_path"_a, "fallback"_a, "param_names"_a, "defaults"_a, "kwdefaults"_a = nb::none(),
+        "positional_count"_a = -1, "star_args"_a = false, "star_kwargs"_a = false,
+        "Create the callable a @jit function is published as (install native code with _set_native); "
+        "names past positional_count are keyword-only, then the *args and **kwargs slots");
+     m.def("set_stats_enabled", &justjit::set_stats_enabled, "enabled"_a,
+        "Turn per-function call, native time and deopt counters on or off");
+     m.def("stats_enabled", &justjit::stats_enabled,
+        "Whether per-function runtime counters are on");
+     m.def("_fail_deferred_compiles", &justjit::set_fail_deferred_compiles, "enable"_a,
+        "Testing: make lazily materialized compiles fail on their first call");
+
+     // Generators and coroutines share their step function and names through a
+     // factory; a one-off object gets a parameterless factory of its own
+     auto step_factory = [](uint64_t step_func_addr, int64_t num_locals, nb::object name, nb::object qualname, bool coroutine) {
+         nb::object no_names = nb::steal(PyTuple_New(0));
+         PyObject* factory = justjit::JITGeneratorFactory_New(reinterpret_cast<justjit::GeneratorStepFunc>(step_func_addr),
+                                                              static_cast<Py_ssize_t>(num_locals), 0, name.ptr(),
+                                                              qualname.is_none() ? nullptr : qualname.ptr(),
+                                                              no_names.ptr(), Py_None, coroutine);
+         if (factory == nullptr) {
+             throw nb::python_error();
+         }
+         return nb::steal(factory);
+     };
+
      // Expose the JITGenerator type and creation function
-     m.def("create_jit_generator", [](uint64_t step_func_addr, int64_t num_locals, nb::object name, nb::object qualname) {
-         auto step_func = reinterpret_cast<justjit::GeneratorStepFunc>(step_func_addr);
-         PyObject* gen = justjit::JITGenerator_New(step_func, static_cast<Py_ssize_t>(num_locals),
-                                                    name.ptr(), qualname.ptr());
+     m.def("create_jit_generator", [step_factory](uint64_t step_func_addr, int64_t num_locals, nb::object name, nb::object qualname) {
+         nb::object factory = step_factory(step_func_addr, num_locals, name, qualname, false);
+         PyObject* gen = justjit::JITGenerator_New(reinterpret_cast<justjit::JITGeneratorFactoryObject*>(factory.ptr()));
          if (gen == nullptr) {
              throw nb::python_error();
          }
@@ -92,14 +276,23 @@ NB_MODULE(_core, m)
         "Create a new JIT generator object from a compiled step function");
      
      // Expose the JITCoroutine type and creation function
-     m.def("create_jit_coroutine", [](uint64_t step_func_addr, int64_t num_locals, nb::object name, nb::object qualname) {
-         auto step_func = reinterpret_cast<justjit::GeneratorStepFunc>(step_func_addr);
-         PyObject* coro = justjit::JITCoroutine_New(step_func, static_cast<Py_ssize_t>(num_locals),
-                                                     name.ptr(), qualname.ptr());
+     m.def("create_jit_coroutine", [step_factory](uint64_t step_func_addr, int64_t num_locals, nb::object name, nb::object qualname) {
+         nb::object factory = step_factory(step_func_addr, num_locals, name, qualname, true);
+         PyObject* coro = justjit::JITCoroutine_New(reinterpret_cast<justjit::JITGeneratorFactoryObject*>(factory.ptr()));
          if (coro == nullptr) {
              throw nb::python_error();
          }
          return nb::steal(coro);
      }, "step_func_addr"_a, "num_locals"_a, "name"_a, "qualname"_a,
         "Create a new JIT coroutine object from a compiled step function");
+
+     // Native run queue behind justjit.run_all()
+     m.def("run_coroutines", [](nb::object awaitables) {
+         PyObject* outcome = justjit::JITCoroutine_RunReady(awaitables.ptr());
+         if (outcome == nullptr) {
+             throw nb::python_error();
+         }
+         return nb::steal(outcome);
+     }, "awaitables"_a,
+        "Run JIT coroutines natively; returns (results, blocked) with (index, awaitable, pending) for the event loop");
 }
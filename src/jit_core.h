@@ -6,12 +6,21 @@
 #include <nanobind/stl/function.h>
 #include <nanobind/stl/vector.h>
 #include <nanobind/stl/unordered_map.h>
+#include <nanobind/stl/pair.h>
+#include "tier0.h"
+#include <llvm/ExecutionEngine/Orc/IndirectionUtils.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/DebugInfoMetadata.h>
+#include <llvm/Target/TargetMachine.h>
+#include <cstring>
+#include <map>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <unordered_set>
@@ -39,29 +48,38 @@ namespace justjit
 
     // Forward declaration of the JIT generator object
     struct JITGeneratorObject;
+    struct JITGeneratorFactoryObject;
 
     // Type definition for generator step function
     // Signature: PyObject* step_func(int32_t* state, PyObject** locals, PyObject* sent_value)
     typedef PyObject* (*GeneratorStepFunc)(int32_t* state, PyObject** locals, PyObject* sent_value);
 
+    // Typed generators: resume until `capacity` values are unboxed into `out` or the generator
+    // finishes; returns the count, or -1 with an exception set
+    typedef int64_t (*GeneratorFillFunc)(int32_t* state, PyObject** locals, void* out, int64_t capacity);
+
     // JIT Generator object - a Python object that wraps a compiled generator
+    // Variable-size: ob_size is the capacity of `locals`, which live inline.
+    // What every object of one function shares (step and fill functions,
+    // names, slot count) stays in `code`, the factory that created it.
     struct JITGeneratorObject {
-        PyObject_HEAD
+        PyObject_VAR_HEAD
         int32_t state;              // Current state (0=initial, >0=suspended at yield N, -1=done)
-        PyObject** locals;          // Array of local variables (preserved across yields)
-        Py_ssize_t num_locals;      // Number of local variable slots
-        GeneratorStepFunc step_func; // Pointer to the compiled step function
-        PyObject* name;             // Generator name (for repr)
-        PyObject* qualname;         // Qualified name
+        JITGeneratorFactoryObject* code; // Per-code descriptor (strong reference)
+        void* batch;                // Typed generators: values unboxed ahead of iteration
+        Py_ssize_t batch_pos;       // Next value of `batch` to return
+        Py_ssize_t batch_len;       // Values in `batch`
+        PyObject* locals[1];        // Local variables (preserved across yields), ob_size slots
     };
 
     // Python type object for JIT generators (defined in jit_core.cpp)
     extern PyTypeObject JITGenerator_Type;
 
     // Helper functions for JIT generator
-    PyObject* JITGenerator_New(GeneratorStepFunc step_func, Py_ssize_t num_locals,
-                               PyObject* name, PyObject* qualname);
+    PyObject* JITGenerator_New(JITGeneratorFactoryObject* code);
     PyObject* JITGenerator_Send(JITGeneratorObject* gen, PyObject* value);
+    // Next value for FOR_ITER; NULL without an exception once exhausted
+    PyObject* JITGenerator_Next(JITGeneratorObject* gen);
 
     // =========================================================================
     // JIT Coroutine Object
@@ -76,25 +94,309 @@ namespace justjit
     struct JITCoroutineObject;
 
     // JIT Coroutine object - wraps a compiled async function
+    // Variable-size like JITGeneratorObject, and as small: a server holding
+    // many suspended coroutines pays 48 bytes plus the slots for each
     struct JITCoroutineObject {
-        PyObject_HEAD
+        PyObject_VAR_HEAD
         int32_t state;              // Current state (0=initial, >0=suspended at await, -1=done)
-        PyObject** locals;          // Array of local variables (preserved across awaits)
-        Py_ssize_t num_locals;      // Number of local variable slots
-        GeneratorStepFunc step_func; // Pointer to the compiled step function (same signature)
-        PyObject* name;             // Coroutine name (for repr)
-        PyObject* qualname;         // Qualified name
+        JITGeneratorFactoryObject* code; // Per-code descriptor (strong reference)
         PyObject* awaiting;         // Currently awaited object (for SEND delegation)
+        PyObject* locals[1];        // Local variables (preserved across awaits), ob_size slots
     };
 
     // Python type object for JIT coroutines (defined in jit_core.cpp)
     extern PyTypeObject JITCoroutine_Type;
 
     // Helper functions for JIT coroutine
-    PyObject* JITCoroutine_New(GeneratorStepFunc step_func, Py_ssize_t num_locals,
-                               PyObject* name, PyObject* qualname);
+    PyObject* JITCoroutine_New(JITGeneratorFactoryObject* code);
     PyObject* JITCoroutine_Send(JITCoroutineObject* coro, PyObject* value);
 
+    // Run the JIT coroutines of a sequence of awaitables natively. Returns
+    // (results, blocked): results in order (None where not finished) and
+    // (index, awaitable, pending future or None) for those needing an event loop.
+    PyObject* JITCoroutine_RunReady(PyObject* awaitables);
+
+    // =========================================================================
+    // JIT Async Generator Object
+    // =========================================================================
+    // An async generator is a JITGenerator whose step function wraps yielded
+    // values with JITAsyncGenWrap (ASYNC_GEN_WRAP) and passes awaited objects'
+    // yields through unwrapped. __anext__()/asend()/athrow()/aclose() return a
+    // JITAsyncGenAwaitable that resumes the step function: a wrapped value
+    // completes the awaitable, anything else is yielded to the event loop.
+    // =========================================================================
+
+    struct JITAsyncGeneratorObject {
+        PyObject_HEAD
+        JITGeneratorObject* gen;    // Underlying generator (step function and locals)
+        bool finished;              // Returned, raised or closed
+    };
+
+    // Awaitable returned by __anext__, asend, athrow and aclose
+    struct JITAsyncGenAwaitableObject {
+        PyObject_HEAD
+        JITAsyncGeneratorObject* agen;
+        PyObject* value;            // asend: first value sent; athrow: throw() arguments
+        int kind;                   // 0 = asend, 1 = athrow, 2 = aclose
+        int state;                  // 0 = not started, 1 = running, 2 = done
+    };
+
+    // Python type objects (defined in jit_core.cpp)
+    extern PyTypeObject JITAsyncGenerator_Type;
+    extern PyTypeObject JITAsyncGenAwaitable_Type;
+
+    // Wrap a new JITGenerator (steals the reference)
+    PyObject* JITAsyncGenerator_New(PyObject* gen);
+
+    // =========================================================================
+    // JIT Function Object
+    // =========================================================================
+    // The callable a @jit function is published as. Its vectorcall slot binds
+    // positional/keyword arguments and defaults onto the compiled parameters
+    // and calls the function's `<name>__entry` trampoline, which unboxes them.
+    // With no entry installed (not compiled yet, or per-call bookkeeping such
+    // as tiering still pending) calls go to `slow_path`. Only a deoptimization
+    // (a binding error, or the trampoline rejecting an argument before any
+    // code runs) reruns the call on `fallback`; exceptions raised by the
+    // compiled code propagate.
+    //
+    // While runtime statistics are on (set_stats_enabled() or JUSTJIT_STATS=1)
+    // every entry call adds to relaxed atomic counters: calls, nanoseconds
+    // spent in the entry and deoptimizations, the latter also counted per
+    // exception type. A JITFunction returned by a core can count into the
+    // published wrapper instead (`stats_owner`), so tiered and specialized
+    // code report under one function.
+    //
+    // Calls running an entry are always counted (`active_calls`, on the
+    // stats owner too), so unloading can wait until no call runs the code.
+    // An entry cleared with _set_native(None) on a JITFunction without a
+    // slow path sends later calls to `fallback`.
+    //
+    // Object-mode code compiled with set_closure_argument() serves every
+    // closure of one code object; each JITFunction then carries its own
+    // `closure` tuple and passes it to the entry as one extra argument.
+    // =========================================================================
+
+    // Entry trampoline: boxed arguments in, new reference (or NULL with an exception) out
+    typedef PyObject* (*JITEntryFunc)(PyObject* const* args, Py_ssize_t nargs);
+
+    struct JITFunctionObject {
+        PyObject_HEAD
+        vectorcallfunc vectorcall;  // Must be set for tp_vectorcall_offset
+        std::atomic<JITEntryFunc> entry; // Entry trampoline (NULL = call slow_path); read once per call
+        Py_ssize_t param_count;     // Arguments of `entry`: positional, keyword-only, *args, **kwargs
+        Py_ssize_t positional_count; // Leading parameters that accept positional arguments
+        bool star_args;             // Extra positional arguments are packed into a tuple slot
+        bool star_kwargs;           // Unmatched keyword arguments are packed into a dict slot (the last)
+        PyObject* name;             // Function name (for repr and errors)
+        PyObject* param_names;      // Tuple of parameter names (keyword binding)
+        PyObject* defaults;         // Tuple of trailing defaults, or NULL
+        PyObject* kwdefaults;       // Keyword-only name -> default (a private copy), or NULL
+        PyObject* slow_path;        // Called while no entry is installed, or NULL
+        PyObject* fallback;         // Called when the entry deoptimizes, or NULL
+        PyObject* resume;           // resume(frame_state, *args, **kwargs) for a deopt at a recorded guard, or NULL
+        PyObject* dict;             // Instance __dict__
+        PyObject* weakreflist;
+        PyObject* stats_owner;      // JITFunction counting this one's calls, or NULL for itself
+        PyObject* deopt_types;      // Exception type name -> deopts (dict), or NULL before the first
+        PyObject* closure;          // Passed to `entry` after the parameters (shared closure code), or NULL
+        PyObject* value_slots;      // Argument slots whose values pick a clone (tuple of indices), or NULL
+        PyObject* value_clones;     // Value (a tuple for several slots) -> (clone or None, argument types...), or NULL
+        bool value_learning;        // A value not in value_clones goes to slow_path, which may add a clone
+        bool value_shapes;          // Keys are the shapes of C-contiguous buffers in value_slots, not their values
+        std::atomic<uint64_t> calls;     // Entry calls while statistics were on
+        std::atomic<uint64_t> native_ns; // Nanoseconds spent in those calls
+        std::atomic<uint64_t> deopts;    // Calls rerun on `fallback`
+        std::atomic<Py_ssize_t> active_calls; // Calls running an entry that counts here (always counted)
+    };
+
+    // Runtime statistics switch for every JITFunction (default: $JUSTJIT_STATS)
+    void set_stats_enabled(bool enabled);
+    bool stats_enabled();
+
+    // Testing: make deferred compiles (set_lazy_materialize) fail at materialization
+    void set_fail_deferred_compiles(bool enable);
+
+    // Python type object for JIT functions (defined in jit_core.cpp)
+    extern PyTypeObject JITFunction_Type;
+
+    // A JITFunction calling `entry` directly (no slow path or fallback)
+    PyObject* JITFunction_FromEntry(JITEntryFunc entry, Py_ssize_t param_count, const std::string& name);
+    // The published wrapper of a @jit function; install code with _set_native().
+    // `param_names` names every argument slot; the ones past `positional_count`
+    // are keyword-only, then the *args and **kwargs slots when requested.
+    PyObject* JITFunction_New(PyObject* name, PyObject* slow_path, PyObject* fallback,
+                              PyObject* param_names, PyObject* defaults, PyObject* kwdefaults,
+                              Py_ssize_t positional_count, bool star_args, bool star_kwargs);
+
+    // =========================================================================
+    // JIT Generator Factory Object
+    // =========================================================================
+    // What a generator or async function compiles to. Each call binds its
+    // arguments like a Python function (keywords, defaults), allocates a
+    // JITGenerator or JITCoroutine over `step_func` and moves the arguments
+    // into the first locals, all without running Python code. The objects
+    // keep a reference to it in place of their own copies of its fields.
+    // =========================================================================
+
+    struct JITGeneratorFactoryObject {
+        PyObject_HEAD
+        vectorcallfunc vectorcall;  // Must be set for tp_vectorcall_offset
+        GeneratorStepFunc step_func; // Step function of every object created
+        GeneratorFillFunc fill_func; // Typed generators: batch fill function, else NULL
+        char yield_kind;            // 'q' or 'd' with fill_func
+        Py_ssize_t num_locals;      // Locals per object (arguments first)
+        Py_ssize_t param_count;     // Positional parameters
+        bool coroutine;             // Create JITCoroutines instead of JITGenerators
+        bool async_generator;       // Wrap each JITGenerator in a JITAsyncGenerator
+        PyObject* name;             // Name (repr, errors and the created objects)
+        PyObject* qualname;         // Qualified name of the created objects
+        PyObject* param_names;      // Tuple of parameter names (keyword binding)
+        PyObject* defaults;         // Tuple of trailing defaults, or NULL
+        PyObject* dict;             // Instance __dict__
+        PyObject* weakreflist;
+    };
+
+    // Python type object for generator factories (defined in jit_core.cpp)
+    extern PyTypeObject JITGeneratorFactory_Type;
+
+    // PyType_Ready every runtime type above (and JITCallable) at module init,
+    // before any thread can create one; false with a Python error set
+    bool ready_runtime_types();
+
+    // `param_names` may be empty (positional-only binding); `defaults` is a tuple or None.
+    // A non-NULL `fill_func` makes the created generators typed ('q' or 'd' `yield_kind`).
+    PyObject* JITGeneratorFactory_New(GeneratorStepFunc step_func, Py_ssize_t num_locals, Py_ssize_t param_count,
+                                      PyObject* name, PyObject* qualname, PyObject* param_names, PyObject* defaults,
+                                      bool coroutine, GeneratorFillFunc fill_func = NULL, char yield_kind = 0,
+                                      bool async_generator = false);
+
+    // Per-site LOAD_GLOBAL cache. JIT code reads `value` directly, so it must
+    // stay the first member; nullptr means "refill on next execution".
+    struct GlobalCacheEntry
+    {
+        PyObject *value = nullptr; // Borrowed: invalidated by the dict watcher before the binding changes
+        PyObject *name = nullptr;
+        PyObject *globals = nullptr;
+        PyObject *builtins = nullptr;
+    };
+
+    // Per-site LOAD_ATTR / STORE_ATTR cache: up to ATTR_CACHE_WAYS receiver
+    // types, each guarded on the type's tp_version_tag. JIT code checks
+    // entries[0] inline for slot reads, so keep `entries` the first member.
+    enum AttrCacheKind : int32_t
+    {
+        ATTR_CACHE_EMPTY = 0,
+        ATTR_CACHE_SLOT = 1,     // __slots__ member at a fixed offset
+        ATTR_CACHE_INSTANCE = 2, // Instance __dict__, then the class attribute
+        ATTR_CACHE_CLASS = 3     // Class attribute only (no instance dict)
+    };
+
+    struct AttrCacheEntry
+    {
+        PyTypeObject *type = nullptr;
+        uint32_t version = 0;
+        int32_t kind = ATTR_CACHE_EMPTY;
+        Py_ssize_t offset = 0;     // ATTR_CACHE_SLOT
+        PyObject *descr = nullptr; // Borrowed class attribute, kept alive by the versioned type
+    };
+
+    constexpr int ATTR_CACHE_WAYS = 4;
+
+    // What a site does, and how settled it is. JIT code calls the site through
+    // `stub`, which the runtime swaps as receivers show up: monomorphic (way 0
+    // only), polymorphic (all ways), then megamorphic (no cache, the generic
+    // C-API call) once ATTR_SITE_MEGAMORPHIC_MISSES lookups found no way to use.
+    enum AttrSiteOp : int32_t
+    {
+        ATTR_SITE_LOAD = 0,
+        ATTR_SITE_LOAD_METHOD = 1,
+        ATTR_SITE_STORE = 2
+    };
+
+    enum AttrSiteState : int32_t
+    {
+        ATTR_SITE_MONOMORPHIC = 0,
+        ATTR_SITE_POLYMORPHIC = 1,
+        ATTR_SITE_MEGAMORPHIC = 2
+    };
+
+    constexpr uint32_t ATTR_SITE_MEGAMORPHIC_MISSES = 64;
+
+    struct AttrCache
+    {
+        AttrCacheEntry entries[ATTR_CACHE_WAYS];
+        PyObject *name = nullptr;
+        bool store = false;
+        int next_way = 0; // Round-robin replacement once all ways are used
+        void *stub = nullptr; // Current handler of the site (see AttrSiteState)
+        int32_t op = ATTR_SITE_LOAD;
+        int32_t state = ATTR_SITE_MONOMORPHIC;
+        uint32_t misses = 0; // Evictions and uncacheable lookups
+    };
+
+    // Per-site CALL feedback for builtin C functions. A site that sees a
+    // PyCFunction or method_descriptor whose convention is METH_O,
+    // METH_NOARGS or METH_FASTCALL(|METH_KEYWORDS) remembers it and later
+    // calls `def->ml_meth` directly while the callable is the same object
+    // (and still wraps `def`); anything else takes PyObject_Vectorcall.
+    // Under transitive=True, a plain Python function with a compiled
+    // JITFunction in `redirects` is called through that instead. A class
+    // with the default __new__ and a Python __init__ is constructed inline:
+    // tp_alloc, then __init__ called directly, guarded on tp_version_tag.
+    enum CallSiteKind : int32_t
+    {
+        CALL_SITE_EMPTY = 0,
+        CALL_SITE_CFUNCTION = 1,         // builtin_function_or_method: self is m_self
+        CALL_SITE_METHOD_DESCRIPTOR = 2, // method_descriptor: self is the first argument
+        CALL_SITE_GENERIC = 3,           // Given up on: too many different callables
+        CALL_SITE_REDIRECT = 4,          // Plain function: calls `target`
+        CALL_SITE_CONSTRUCT = 5          // Class: tp_alloc, then `target` (its __init__)
+    };
+
+    constexpr uint32_t CALL_SITE_GENERIC_MISSES = 64;
+
+    struct CallSiteCache
+    {
+        PyObject *callable = nullptr; // Borrowed, compared by identity together with `def`
+        PyMethodDef *def = nullptr;
+        PyObject *redirects = nullptr; // function -> JITFunction (see JITCore::set_transitive_callees), or NULL
+        PyObject *target = nullptr;    // CALL_SITE_REDIRECT: borrowed from `redirects`; CONSTRUCT: kept by the versioned type
+        uint32_t version = 0;          // CALL_SITE_CONSTRUCT: the class's tp_version_tag
+        int32_t kind = CALL_SITE_EMPTY;
+        uint32_t misses = 0; // Times the site was reseeded with another callable
+    };
+
+    // A global name that resolves to another @jit function with the same
+    // typed signature (see JITCore::set_native_callees). `address` is the
+    // callee's native entry point, or 0 for a call to the function itself.
+    // Math callees (`math.sqrt` or `from math import sqrt`) instead carry the
+    // math function they lower to; `attr` is set for the `math.<name>` form.
+    // Native-mode callees carry their kernel's `signature`: one 'q' / 'd' / '?'
+    // kind per parameter, then the result's.
+    struct NativeCallee
+    {
+        PyObject *name = nullptr;
+        PyObject *expected = nullptr; // Wrapper (or math module / function) the global must still be bound to
+        uint64_t address = 0;
+        int param_count = 0;
+        std::string math_function;
+        PyObject *attr = nullptr;
+        std::string signature;
+        int result_count = 1; // Fields of the struct an int/float callee returns for `return a, b`
+    };
+
+    // A @justjit.record class native mode may take as a parameter or build
+    // (see JITCore::set_native_records). `kinds` holds one character per
+    // field: 'q' int64, 'd' float64 or '?' bool.
+    struct NativeRecordType
+    {
+        PyObject *global_name = nullptr; // Global the function calls to build one, or nullptr
+        PyObject *type = nullptr;
+        PyObject *fields = nullptr; // Tuple of field names (owned by the class's __justjit_record__)
+        std::string kinds;
+    };
+
     struct Instruction
     {
         uint16_t opcode;
@@ -113,6 +415,11 @@ namespace justjit
         bool lasti;     // Whether to push last instruction offset
     };
 
+    // Decoded bytecode lives in the per-compile arena (jit_core.cpp), freed
+    // in one go when the compile ends
+    using InstructionList = std::pmr::vector<Instruction>;
+    using ExceptionTable = std::pmr::vector<ExceptionTableEntry>;
+
     // =========================================================================
     // Control Flow Graph (CFG) Data Structures for PHI Node Support
     // =========================================================================
@@ -120,19 +427,52 @@ namespace justjit
     // patterns like pattern matching (match/case), loops, and exception handling.
     // =========================================================================
 
-    // Represents a basic block in the CFG
+    // Represents a basic block in the CFG (edges live in ControlFlowGraph)
     struct BasicBlockInfo
     {
         int start_offset;                      // Bytecode offset where block starts
         int end_offset;                        // Bytecode offset where block ends (exclusive)
-        std::vector<int> predecessors;         // Offsets of predecessor blocks
-        std::vector<int> successors;           // Offsets of successor blocks
+        int first_instruction;                 // Index of the block's first instruction
+        int end_instruction;                   // One past the index of its last instruction
         int stack_depth_at_entry;              // Expected stack depth when entering this block
         bool is_exception_handler;             // True if this is an exception handler block
         bool needs_phi_nodes;                  // True if multiple predecessors with different stacks
         llvm::BasicBlock* llvm_block;          // The LLVM BasicBlock for this CFG block
     };
 
+    // Blocks in offset order, addressed by index, with edges in CSR
+    // (compressed sparse row) form: block b's successors are
+    // successors[successor_begin[b] .. successor_begin[b + 1]), and likewise
+    // for predecessors. A few flat vectors instead of a node per block and
+    // two vectors per edge list keep large functions cheap to analyze.
+    struct ControlFlowGraph
+    {
+        std::pmr::vector<BasicBlockInfo> blocks;
+        std::pmr::vector<int> block_at_offset; // Bytecode offset -> block index, -1 if no block starts there
+        std::pmr::vector<int> successor_begin; // blocks.size() + 1 entries
+        std::pmr::vector<int> successors;      // Block indices
+        std::pmr::vector<int> predecessor_begin;
+        std::pmr::vector<int> predecessors;
+
+        explicit ControlFlowGraph(std::pmr::memory_resource *arena)
+            : blocks(arena), block_at_offset(arena), successor_begin(arena), successors(arena),
+              predecessor_begin(arena), predecessors(arena) {}
+
+        int index_of(int offset) const
+        {
+            return offset >= 0 && static_cast<size_t>(offset) < block_at_offset.size() ? block_at_offset[offset] : -1;
+        }
+        BasicBlockInfo* find(int offset)
+        {
+            int index = index_of(offset);
+            return index < 0 ? nullptr : &blocks[index];
+        }
+        int predecessor_count(int block) const
+        {
+            return predecessor_begin[block + 1] - predecessor_begin[block];
+        }
+    };
+
     // Stack state at a specific point in control flow
     struct CFGStackState
     {
@@ -141,6 +481,112 @@ namespace justjit
         int from_offset;                       // Bytecode offset this state is from
     };
 
+    // =========================================================================
+    // Persistent Object Cache
+    // =========================================================================
+    // Directory where native objects for typed-mode functions are cached across
+    // processes. Empty disables the cache. Defaults to $JUSTJIT_CACHE_DIR.
+    // =========================================================================
+    void register_global_cache(GlobalCacheEntry *entry);   // Start watching the entry's dicts
+    void unregister_global_cache(GlobalCacheEntry *entry); // Stop invalidating a freed entry
+    void set_object_cache_dir(const std::string& dir);
+    std::string get_object_cache_dir();
+    // Remote backend behind the directory: fetch(key) -> bytes or None is asked
+    // on a miss, and entries stored since the last call are taken for upload
+    void set_object_cache_remote(nb::object fetch);
+    std::vector<std::pair<std::string, nb::bytes>> take_object_cache_uploads();
+
+    // =========================================================================
+    // Random Numbers
+    // =========================================================================
+    // justjit.random() / randint() / seed(). Int/float-mode code draws from
+    // the same per-thread xoshiro256++ streams (see jit_random_f64).
+    // =========================================================================
+    double random_f64();                           // Uniform in [0, 1)
+    int64_t random_int(int64_t low, int64_t high); // Uniform in [low, high]; requires low <= high
+    void seed_random(uint64_t seed);               // Restart every thread's stream from `seed`
+
+    // =========================================================================
+    // Parallel Thread Pool
+    // =========================================================================
+    // The pool that prange() loops, parallel reductions and OpenMP regions run
+    // on (see jit_parallel_for). Its size counts the calling thread; pinning
+    // takes effect on Linux only.
+    // =========================================================================
+    void set_num_threads(int count); // 1 to 64 threads
+    int get_num_threads();
+    void set_thread_affinity(const std::vector<int> &cpus, const std::vector<int> &nodes); // Both empty: unpinned
+    std::vector<std::vector<int>> numa_nodes(); // CPUs of each NUMA node
+    nb::list parallel_stats(bool reset);        // Work counters of each slot
+
+    // True when this build has the NVPTX target and libcuda found a device (see emit_cuda_kernel)
+    bool cuda_available();
+
+    // True when this build has the baseline tier's stencils (see JITCore::compile_baseline)
+    bool baseline_available();
+
+    // =========================================================================
+    // External Libraries
+    // =========================================================================
+    // Shared libraries whose exported symbols JIT and inline C code may call
+    // (BLAS, LAPACK, SLEEF, ...): each gets a DynamicLibrarySearchGenerator on
+    // the shared main JITDylib, which every JITCore links against. Loading
+    // the same path again does nothing.
+    // =========================================================================
+    void load_library(const std::string& path);
+    std::vector<std::string> loaded_libraries();
+
+    // =========================================================================
+    // Profiling
+    // =========================================================================
+    // Report every function the shared JIT links from now on to perf
+    // (/tmp/perf-<pid>.map), GDB's JIT interface and, when LLVM has them,
+    // perf jitdump and Intel VTune. JUSTJIT_PROFILE=1 turns it on at startup.
+    // =========================================================================
+    void enable_profiling();
+
+    // =========================================================================
+    // Memory Accounting
+    // =========================================================================
+    // Process-wide totals: code and data bytes the shared JIT's object linker
+    // currently holds (every core, helpers and inline C included), and live
+    // and pooled JIT generator / coroutine objects. JITCore::get_memory_usage
+    // breaks a single core down per function.
+    // =========================================================================
+    nb::dict runtime_memory_usage();
+
+    // =========================================================================
+    // Event Tracing
+    // =========================================================================
+    // Per-thread rings of timestamped JIT events (see jit_core.cpp); capacity
+    // is events kept per thread, 0 turns tracing off.
+    // =========================================================================
+    void trace_start(size_t capacity);
+    void trace_stop();
+    bool tracing();
+    void trace_instant(const std::string &name, const std::string &category, const std::string &detail);
+    // (name, category, phase, ts_ns, dur_ns, value, tid, detail) per event; clear: don't return them again
+    nb::list trace_events(bool clear);
+
+    // =========================================================================
+    // Hash Aggregation
+    // =========================================================================
+    // justjit.groupby(): `op` ('sum', 'count', 'min', 'max' or 'mean') of
+    // `values` (None for 'count') per distinct key of the int buffer `keys`,
+    // in a Swiss-table style map, split across the prange() pool for large
+    // inputs. Returns (sorted int64 keys, results) as raw bytes and the
+    // results' type code: 'q' for counts and int values, 'd' otherwise.
+    // =========================================================================
+    nb::tuple group_aggregate(nb::handle keys, nb::handle values, const std::string &op);
+
+    // =========================================================================
+    // Fork Safety
+    // =========================================================================
+    // pthread_atfork handlers keeping the runtime's locks, thread pool and
+    // trace rings consistent in forked children (no-op on Windows).
+    // =========================================================================
+    void install_fork_handlers();
+
 #ifdef JUSTJIT_HAS_CLANG
     // =========================================================================
     // Inline C Compiler - Compiles C/C++ code to LLVM IR at runtime
@@ -167,33 +613,164 @@ namespace justjit
         // Compile C/C++ code string to LLVM Module
         // lang: "c" or "c++"
         // captured_vars: Python dict of variables to inject into C code
+        // opt_level: 0-3, run through the same pipeline as Python-JIT code
+        // march: "native" (host CPU and features), a CPU name, or "" for clang's default
+        // fast_math: -ffast-math; extra_args: appended clang -cc1 arguments
+        // nogil: "off", "on" (callables release the GIL around the C call) or
+        //        "auto" (only functions that never touch Python or jit_* helpers)
         // Returns: dict of new/modified variables to export back to Python
         nb::dict compile_and_execute(
             const std::string& code,
             const std::string& lang,
-            nb::dict captured_vars
+            nb::dict captured_vars,
+            int opt_level = 2,
+            const std::string& march = "native",
+            bool fast_math = false,
+            const std::vector<std::string>& extra_args = {},
+            const std::string& nogil = "off"
+        );
+
+        // Compile several translation units (e.g. a library plus its kernels) as
+        // one snippet: the units run through clang concurrently on the parallel
+        // pool with the GIL released, then are linked into a single module.
+        // captured_vars are defined in the first unit and extern in the others;
+        // the other parameters are as for compile_and_execute.
+        nb::dict compile_sources(
+            const std::vector<std::string>& codes,
+            const std::string& lang,
+            nb::dict captured_vars,
+            int opt_level = 2,
+            const std::string& march = "native",
+            bool fast_math = false,
+            const std::vector<std::string>& extra_args = {},
+            const std::string& nogil = "off"
         );
 
         // Get a Python callable wrapper for a C function
         // signature: "int(int,int)" or "double(double)" etc.
-        nb::object get_c_callable(const std::string& name, const std::string& signature);
+        // nogil: release the GIL around the call (functions from compile_and_execute only)
+        nb::object get_c_callable(const std::string& name, const std::string& signature, bool nogil = false);
         
-        // Get the LLVM IR from the last compilation
-        std::string get_last_ir() const { return last_ir_; }
+        // Get the LLVM IR from the last compilation (printed from a bitcode snapshot)
+        std::string get_last_ir() const;
+
+        // Cached compile results (bitcode snapshots, captured array copies),
+        // trampolines and prelude PCH files this compiler holds
+        nb::dict get_memory_usage();
 
     private:
+        // Captured Python values: C declarations keyed by name and type only,
+        // plus the values written into those globals once the module is linked
+        struct CapturedVariables
+        {
+            struct Value
+            {
+                std::string name;  // C global ("n", "xs_len", ...)
+                char bytes[8];
+                size_t size;
+            };
+            std::string declarations;
+            std::vector<Value> values;
+            std::vector<nb::object> references;     // Objects whose address or UTF-8 data is bound
+            std::vector<std::vector<char>> arrays;  // Element copies of captured lists and tuples
+
+            template <typename T>
+            void bind(const std::string& name, T value)
+            {
+                static_assert(sizeof(T) <= 8, "captured values are scalars or pointers");
+                Value bound{name, {}, sizeof(T)};
+                std::memcpy(bound.bytes, &value, sizeof(T));
+                values.push_back(bound);
+            }
+        };
+
+        // Result of an earlier compile, keyed by source_cache_key()
+        struct CompiledSource
+        {
+            nb::dict result;
+            std::string ir;  // Bitcode snapshot (see get_last_ir)
+            std::unordered_map<std::string, uint64_t> captured_globals;  // C name -> address
+            CapturedVariables captured;  // Values currently bound (keeps their objects alive)
+        };
+
         JITCore* jit_core_;
         std::vector<std::string> include_paths_;
-        std::string last_ir_;  // Store last compiled IR
+        std::string last_ir_;  // Bitcode of the last compiled module
+        std::unordered_map<std::string, CompiledSource> compiled_sources_;
+        // namedtuple types the __jit_result_type_<name> globals point at
+        std::vector<nb::object> result_types_;
+        std::unordered_map<std::string, std::string> prelude_pchs_;  // clang arguments + headers -> PCH path
+        std::mutex pch_mutex_;  // prelude_pch() also runs on compile_sources workers
+        // __jit_vcall_<name> trampoline of a compiled C function
+        struct Trampoline
+        {
+            uint64_t address;
+            int param_count;
+            bool pure;  // Never touches Python or jit_* helpers (nogil="auto" releases the GIL)
+        };
+        std::unordered_map<std::string, Trampoline> trampolines_;  // C function name -> trampoline
+        std::vector<std::string> temp_files_;  // Removed in the destructor
+
+        // Declare captured Python variables as zero-initialized C globals and
+        // collect the values to bind into them (see bind_captured_variables)
+        CapturedVariables generate_variable_declarations(nb::dict captured_vars);
+
+        // Write this call's captured values into an earlier compile's globals
+        void bind_captured_variables(CompiledSource& compiled, CapturedVariables captured);
+
+        // Clang command line (language, optimization, target, include paths, system headers)
+        // minus the source file
+        std::vector<std::string> clang_args(const std::string& lang, int opt_level, const std::string& march,
+                                            bool fast_math, const std::vector<std::string>& extra_args);
+
+        // Content key over the prelude, source, clang arguments, LLVM/clang version and host CPU
+        std::string source_cache_key(const std::string& source, const std::vector<std::string>& args);
+
+        // Run the clang front end on the prelude + source and return the module it emits into context
+        std::unique_ptr<llvm::Module> emit_module(const std::string& source, const std::string& lang,
+                                                  std::vector<std::string> args_storage, llvm::LLVMContext& context);
 
-        // Generate C code that declares captured Python variables
-        std::string generate_variable_declarations(nb::dict captured_vars);
+        // Module for one or more units (source + its source_cache_key), from cached
+        // bitcode when persist is set or from clang, linked into one module
+        std::unique_ptr<llvm::Module> emit_units(const std::vector<std::string>& sources,
+                                                 const std::vector<std::string>& keys, const std::string& lang,
+                                                 const std::vector<std::string>& args_storage,
+                                                 llvm::LLVMContext& context, bool persist);
+
+        // Interop prelude, followed by `headers` (see pch_headers), precompiled once
+        // for these clang arguments; "" if the build failed
+        const std::string& prelude_pch(const std::vector<std::string>& args, const std::string& headers = "");
+
+        // "#include <...>" lines a C++ source starts with, for prelude_pch, so
+        // <vector>, <algorithm> and the like are parsed once per process
+        static std::string pch_headers(const std::string& source, const std::string& lang);
 
         // Extract new variables from compiled module
         nb::dict extract_exported_variables(llvm::Module* module);
     };
 #endif // JUSTJIT_HAS_CLANG
 
+    // Where one function's compile went (see JITCore::get_compile_stats).
+    // Phases are in seconds; codegen is whatever the compile spent outside
+    // the other phases, i.e. building the IR.
+    struct CompilePhases
+    {
+        double decode = 0.0;       // Instruction records -> Instruction
+        double cfg = 0.0;          // build_cfg (object mode)
+        double stack_depths = 0.0; // compute_stack_depths (object mode)
+        double codegen = 0.0;
+        double verify = 0.0;       // verifyFunction
+        double optimize = 0.0;     // optimize_module
+        double add_module = 0.0;   // addIRModule
+        double materialize = 0.0;  // First lookup: instruction selection and linking
+        size_t ir_instructions_before = 0; // Module instructions entering optimize_module
+        size_t ir_instructions_after = 0;
+        size_t shared_slow_paths = 0; // Error checks that reuse an existing unwind or return block
+        size_t cold_instructions = 0; // IR instructions hot/cold splitting moved into .cold functions
+        bool materialized = false;
+        bool recorded = false; // False for code loaded from the object cache
+    };
+
     class JITCore
     {
     public:
@@ -202,45 +779,114 @@ namespace justjit
 
         void set_opt_level(int level);
         int get_opt_level() const;
+        void set_hot_code(bool hot); // Link this core's code into the hot code slabs from now on
         void set_dump_ir(bool dump);
         bool get_dump_ir() const;
+        void set_explain_codegen(bool enable); // Record lowering, vectorizer remarks and assembly of the next compiles (see get_last_explain)
+        void set_pipeline_options(bool vectorize, bool inline_calls, bool unroll, bool fastmath);
+        void set_fastmath_flags(const std::vector<std::string> &flags); // Individual fast-math flags ("nnan", "contract", ...)
+        void set_target(const std::string &cpu, const std::string &features); // Empty = detected host
+        std::string get_target_cpu() const;
+        std::string target_signature() const; // Triple, CPU and features this core's code is tied to
+        void set_multiversion(bool enable); // Clone entry functions per x86-64 level with runtime dispatch
+        void set_lazy_materialize(bool enable); // Optimize and generate code of later compiles on their first call
+        void set_closure_argument(bool enable); // Object-mode code takes its closure tuple as a hidden last argument
+        void set_profile_instrumentation(bool enable); // Count the edges of every conditional branch compiled from now on
+        std::vector<uint64_t> get_branch_profile(const std::string &name) const; // (taken, not taken) per branch, in IR order
+        void set_branch_profile(const std::string &name, const std::vector<uint64_t> &counts); // Branch weights for name's next compile
+        void set_aot_capture(bool enable);  // Collect compiled modules for emit_aot_object()
+        void set_ufunc_loops(bool enable);  // Also emit NumPy inner loops for int/float/int32/float32 kernels
+        void set_reduce_loops(bool enable); // Also emit __reduce/__scan loops for two-argument int/float/int32/float32 kernels
+        void set_cuda_target(const std::string &arch); // Also emit PTX for int/float/int32/float32 kernels ("" = off)
+        std::string get_cuda_ptx(const std::string &name) const; // A function's PTX, or ""
+        void set_parallel_loops(const std::vector<int> &for_iter_offsets); // prange() loops of the next int/float compile
+        void set_simd_calls(const std::unordered_map<int, std::string> &calls); // justjit.simd calls of the next vector-mode compile
+        void set_bit_calls(const std::unordered_map<int, std::string> &calls);  // justjit.bits calls of the next int/int32 compile
+        void set_raise_sites(const std::unordered_map<int, std::string> &sites);  // raise statements of the next int/float compile
+        nb::bytes emit_aot_object();        // Relocatable (PIC) object of every captured function
+        bool load_object(nb::bytes object, const std::vector<std::string> &names); // Link an AOT object into this core
+        void set_native_callees(nb::dict globals, nb::dict builtins, nb::list callees); // Globals typed code may call directly
+        void set_frozen_globals(nb::dict globals, nb::dict builtins, nb::list names, nb::list values); // Globals the next compile folded in as constants
+        void set_transitive_callees(nb::object callees); // Object-mode CALL redirects: {function: JITFunction}, or None
+        bool unload(const std::string &name);             // Free a function's code and Python references
+        size_t get_code_size(const std::string &name) const; // Native object bytes of a compiled function
+        nb::dict get_compile_stats(const std::string &name) const; // Phase times, IR sizes and code bytes of a compile
+        nb::dict get_memory_usage() const; // Linked code/data bytes, pending IR and Python references, per function
+        nb::object take_rejection(); // (mode, reason, opcode, offset) of the last compile_* that gave up, or None; clears it
         std::string get_last_ir() const;
+        nb::dict get_last_explain() const; // {"sites", "remarks", "assembly", "cpu"} of the last compile with explain_codegen on
         nb::object get_callable(const std::string &name, int param_count);
         nb::object get_int_callable(const std::string &name, int param_count); // For integer-mode functions
-        bool compile_function(nb::list py_instructions, nb::list py_constants, nb::list py_names, nb::object py_globals_dict, nb::object py_builtins_dict, nb::list py_closure_cells, nb::list py_exception_table, const std::string &name, int param_count = 2, int total_locals = 3, int nlocals = 3);
-        bool compile_int_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Integer-only mode
-        bool compile_float_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Float-only mode
+        bool compile_function(nb::object py_instructions, nb::list py_constants, nb::list py_names, nb::object py_globals_dict, nb::object py_builtins_dict, nb::list py_closure_cells, nb::object py_exception_table, const std::string &name, int param_count = 2, int total_locals = 3, int nlocals = 3, int osr_offset = -1);
+        // Baseline tier: object-mode code copied from precompiled stencils, no LLVM; false if an opcode has no stencil
+        bool compile_baseline(nb::object py_instructions, nb::list py_constants, nb::list py_names, nb::list py_varnames,
+                              nb::object py_globals_dict, nb::object py_builtins_dict, const std::string &name, int nlocals,
+                              int stack_size);
+        nb::object get_baseline_callable(const std::string &name, int param_count); // For compile_baseline functions
+        bool compile_int_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3,
+                                  const std::string &overflow = "deopt"); // Integer-only mode (overflow: "deopt", "raise" or "wrap")
+        bool compile_float_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Float-only mode
         nb::object get_float_callable(const std::string &name, int param_count); // For float-mode functions
-        bool compile_bool_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Bool-only mode
+        bool compile_bool_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Bool-only mode
         nb::object get_bool_callable(const std::string &name, int param_count); // For bool-mode functions
-        bool compile_int32_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Int32 mode (C interop)
+        bool compile_int32_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Int32 mode (C interop)
         nb::object get_int32_callable(const std::string &name, int param_count); // For int32-mode functions
-        bool compile_float32_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Float32 mode (SIMD/ML)
+        bool compile_float32_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Float32 mode (SIMD/ML)
         nb::object get_float32_callable(const std::string &name, int param_count); // For float32-mode functions
-        bool compile_complex128_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Complex128 mode (scientific)
+        bool compile_complex128_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Complex128 mode (scientific)
         nb::object get_complex128_callable(const std::string &name, int param_count); // For complex128-mode functions
-        bool compile_ptr_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Ptr mode (array access)
+        bool compile_ptr_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Ptr mode (array access)
         nb::object get_ptr_callable(const std::string &name, int param_count); // For ptr-mode functions
-        bool compile_vec4f_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Vec4f mode (SSE SIMD)
+        bool compile_vec4f_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Vec4f mode (SSE SIMD)
         nb::object get_vec4f_callable(const std::string &name, int param_count); // For vec4f-mode functions
-        bool compile_vec8i_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Vec8i mode (AVX SIMD)
+        bool compile_vec8i_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Vec8i mode (AVX SIMD)
         nb::object get_vec8i_callable(const std::string &name, int param_count); // For vec8i-mode functions
-        bool compile_complex64_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Complex64 mode (single-precision)
+        bool compile_vec8d_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Vec8d mode (<8 x f64>, AVX-512)
+        nb::object get_vec8d_callable(const std::string &name, int param_count); // For vec8d-mode functions
+        bool compile_vec16f_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Vec16f mode (<16 x f32>, AVX-512)
+        nb::object get_vec16f_callable(const std::string &name, int param_count); // For vec16f-mode functions
+        bool compile_vec16i_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Vec16i mode (<16 x i32>, AVX-512)
+        nb::object get_vec16i_callable(const std::string &name, int param_count); // For vec16i-mode functions
+        bool compile_vec16u8_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Vec16u8 mode (<16 x u8>, SSE)
+        nb::object get_vec16u8_callable(const std::string &name, int param_count); // For vec16u8-mode functions
+        bool compile_vec32u8_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Vec32u8 mode (<32 x u8>, AVX2)
+        nb::object get_vec32u8_callable(const std::string &name, int param_count); // For vec32u8-mode functions
+        bool compile_vec16i16_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Vec16i16 mode (<16 x i16>, AVX2)
+        nb::object get_vec16i16_callable(const std::string &name, int param_count); // For vec16i16-mode functions
+        bool compile_complex64_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Complex64 mode (single-precision)
         nb::object get_complex64_callable(const std::string &name, int param_count); // For complex64-mode functions
-        bool compile_optional_f64_function(nb::list py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Optional<f64> mode (nullable)
+        nb::object get_complex_sum_callable(const std::string &name, int param_count, bool single); // Sum of a complex-mode function over buffers
+        bool compile_optional_f64_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count = 2, int total_locals = 3); // Optional<f64> mode (nullable)
         nb::object get_optional_f64_callable(const std::string &name, int param_count); // For optional_f64-mode functions
+        bool compile_native_function(nb::object py_instructions, nb::list py_constants, nb::list py_names, const std::string &name, int param_count, int total_locals, const std::vector<std::string> &param_types, const std::string &return_type_name = "", bool explain = true); // Native mode (per-variable types)
+        void set_native_records(nb::list records); // Record types the next native compile may use
+        void set_native_shapes(const std::unordered_map<int, std::vector<int64_t>> &shapes); // Fixed extents of array parameters in the next native compile
+        void set_native_disjoint(const std::vector<std::pair<int, int>> &pairs); // Array parameters the next native compile assumes don't overlap
+        nb::object get_native_callable(const std::string &name, int param_count); // For native-mode functions
+        std::string native_signature(const std::string &name); // Kernel kinds a native-mode caller may call directly, or ""
+        nb::object get_ufunc_callable(const std::string &name, int nin, char kind, bool parallel = false); // f(*inputs, out) over 1-D buffers
+        nb::object get_reduce_callable(const std::string &name, char kind); // f(array, init) folding a 1-D buffer in parallel
+        nb::object get_scan_callable(const std::string &name, char kind);   // f(array, out) prefix scan of a 1-D buffer
+        nb::object get_stream_callable(const std::string &name, char kind); // f(path, init, chunk, offset) folding a memory-mapped file
+        nb::object get_numpy_ufunc(const std::string &name, int nin, char kind, const std::string &doc); // None without NumPy
+        nb::object get_cuda_callable(const std::string &name, int nin, char kind); // f(*inputs, out) launched on the GPU
         
         // Generator compilation - transforms generator function to state machine step function
-        bool compile_generator(nb::list py_instructions, nb::list py_constants, nb::list py_names, 
+        bool compile_generator(nb::object py_instructions, nb::list py_constants, nb::list py_names, 
                               nb::object py_globals_dict, nb::object py_builtins_dict, 
-                              nb::list py_closure_cells, nb::list py_exception_table,
-                              const std::string &name, int param_count, int total_locals, int nlocals);
+                              nb::list py_closure_cells, nb::object py_exception_table,
+                              const std::string &name, int param_count, int total_locals, int nlocals,
+                              const std::string &yield_kind = "");
         
-        // Get a generator factory callable (returns a new generator on each call)
+        // Get a generator factory callable (returns a new generator, or coroutine, on each call)
         nb::object get_generator_callable(const std::string &name, int param_count, int total_locals,
-                                          nb::object func_name, nb::object func_qualname);
+                                          nb::object func_name, nb::object func_qualname,
+                                          nb::object param_names = nb::none(), nb::object defaults = nb::none(),
+                                          bool coroutine = false, const std::string &yield_kind = "",
+                                          bool async_generator = false);
         
         uint64_t lookup_symbol(const std::string &name);
+        uint64_t lookup_callee(const std::string &name); // Address for direct callers: a stub while `name` is unmaterialized
 
         // Helper to declare Python C API functions in LLVM module
         void declare_python_api_functions(llvm::Module *module, llvm::IRBuilder<> *builder);
@@ -255,6 +901,7 @@ namespace justjit
         llvm::Function *py_xincref_func = nullptr; // NULL-safe Py_XINCREF
         llvm::Function *py_decref_func = nullptr;
         llvm::Function *py_xdecref_func = nullptr; // NULL-safe Py_XDECREF
+        llvm::Function *py_xdecref_cold_func = nullptr; // Out-of-line Py_XDECREF for unwind paths
         llvm::Function *py_long_fromlong_func = nullptr;
         llvm::Function *py_long_fromlonglong_func = nullptr; // For 64-bit int conversion (Windows fix)
         llvm::Function *py_tuple_new_func = nullptr;
@@ -348,9 +995,13 @@ namespace justjit
         llvm::Function *py_float_asdouble_func = nullptr;    // double PyFloat_AsDouble(PyObject*)
         llvm::Function *py_float_fromdouble_func = nullptr;  // PyObject* PyFloat_FromDouble(double)
         llvm::Function *py_bool_fromlong_func = nullptr;     // PyObject* PyBool_FromLong(long)
+        // Speculative BINARY_OP results that reuse an operand only the stack (or the target local) holds;
+        // defined by the inline runtime, nullptr without it
+        llvm::Function *jit_float_result_func = nullptr;     // PyObject* (lhs, rhs, PyObject** local, double)
+        llvm::Function *jit_long_result_func = nullptr;      // PyObject* (lhs, rhs, int64_t)
 
         // JIT helper functions
-        llvm::Function *jit_call_with_kwargs_func = nullptr; // PyObject* jit_call_with_kwargs(...) for CALL_KW
+        llvm::Function *py_object_vectorcall_func = nullptr; // PyObject_Vectorcall for CALL / CALL_KW
         llvm::Function *jit_debug_trace_func = nullptr;      // void jit_debug_trace(...) for debugging
         llvm::Function *jit_debug_stack_func = nullptr;      // void jit_debug_stack(...) for debugging
 
@@ -363,11 +1014,254 @@ namespace justjit
 
     private:
         friend class InlineCCompiler;  // Allow access to jit for object loading
-        std::unique_ptr<llvm::orc::LLJIT> jit;
+        llvm::orc::LLJIT *jit = nullptr;          // Process-wide shared LLJIT (not owned)
+        llvm::orc::JITDylib *dylib = nullptr;     // This core's JITDylib inside the shared LLJIT
         std::unique_ptr<llvm::LLVMContext> context;
         int opt_level = 3;
         bool dump_ir = false;
-        std::string last_ir;
+
+        // Serializes compiles, lookups, unloads and next-compile settings of
+        // this core across threads. Recursive: compiles look symbols up.
+        mutable std::recursive_mutex core_mutex;
+        // Lock core_mutex, waiting with the thread state detached: the holder
+        // may need the GIL (or a stop-the-world pause) to finish
+        std::unique_lock<std::recursive_mutex> lock_core() const;
+
+        // Pass pipeline tuning (mapped onto llvm::PipelineTuningOptions)
+        bool vectorize = true;    // Loop + SLP vectorization and loop interleaving
+        bool inline_calls = true; // Inliner at the default threshold for opt_level
+        bool unroll = true;       // Loop unrolling
+        unsigned fastmath = 0;    // llvm::FastMathFlags bits set on every FP operation
+
+        // Code generation target (empty = detected host CPU and features)
+        std::string target_cpu;
+        std::string target_features;
+        bool multiversion = false;
+        void apply_target(llvm::Module &module);
+
+        // Lazy materialization (see set_lazy_materialize): optimize_module
+        // leaves the pass pipeline to the first materialization, and entry
+        // points are handed out as call-through stubs until then
+        bool lazy_materialize = false;
+        bool pending_lazy = false; // optimize_module deferred the next add_ir_module's pipeline
+        std::unique_ptr<llvm::orc::IndirectStubsManager> lazy_stubs;
+        uint64_t lazy_stub(const std::string &name, const std::string &symbol); // Stub forwarding to `name`'s `symbol`
+
+        // Object-mode kernels read free variables from a trailing closure-tuple
+        // parameter instead of embedding the cells (see set_closure_argument)
+        bool closure_argument = false;
+        void multiversion_function(llvm::Module &module, llvm::Function *func);
+
+        // Profile-guided optimization (see set_profile_instrumentation), keyed by module name
+        bool profile_instrument = false;
+        std::unordered_map<std::string, std::vector<uint64_t>> branch_counters; // Incremented by instrumented code
+        std::unordered_map<std::string, std::vector<uint64_t>> branch_profiles; // Turned into !prof branch weights
+        void instrument_branches(llvm::Module &module);
+        void apply_branch_profile(llvm::Module &module, const std::vector<uint64_t> &counts);
+
+        // Ahead-of-time export (see set_aot_capture)
+        bool aot_capture = false;
+        std::unique_ptr<llvm::LLVMContext> aot_context;
+        std::unique_ptr<llvm::Module> aot_module;
+        llvm::Error capture_aot_module(llvm::Module &module);
+
+        // NumPy-style `<kernel>__ufunc` loops (see set_ufunc_loops)
+        bool ufunc_loops = false;
+        void emit_ufunc_loop(llvm::Module &module, llvm::Function *kernel);
+
+        // `<kernel>__reduce` / `<kernel>__scan` loops (see set_reduce_loops)
+        bool reduce_loops = false;
+        void emit_reduce_loops(llvm::Module &module, llvm::Function *kernel);
+
+        // `<kernel>__cuda` PTX kernels, by function name (see set_cuda_target)
+        std::string cuda_arch;
+        std::unordered_map<std::string, std::string> cuda_ptx;
+        void emit_cuda_kernel(llvm::Module &module, llvm::Function *kernel);
+
+        // Vector modes: one lowering for every element type and width, plus `<kernel>__batch` whole-array loops
+        bool compile_vector_function(nb::object py_instructions, nb::list py_constants, const std::string &name, int param_count,
+                                     int total_locals, const char *mode, bool float_elements, unsigned element_bits, unsigned lanes,
+                                     bool unsigned_elements = false);
+        nb::object get_vector_callable(const std::string &name, int param_count, int lanes, char kind);
+        void emit_vector_batch(llvm::Module &module, llvm::Function *kernel, llvm::FixedVectorType *vec_type);
+        // justjit.simd calls of the next vector-mode compile: CALL offset -> operation (see set_simd_calls)
+        std::unordered_map<int, std::string> simd_calls;
+        // justjit.bits calls of the next int/int32 compile: offset of each of their instructions -> operation (see set_bit_calls)
+        std::unordered_map<int, std::string> bit_calls;
+        // raise statements of the next int/float compile: offset of each of their instructions -> "Name:message" (see set_raise_sites)
+        std::unordered_map<int, std::string> raise_sites;
+        // Complex modes: `<kernel>__batch` and `<kernel>__sum` loops over interleaved buffers
+        void emit_complex_loops(llvm::Module &module, llvm::Function *kernel);
+        // optional_f64: `<kernel>__batch` loop over values + validity bitmap columns
+        void emit_optional_batch(llvm::Module &module, llvm::Function *kernel);
+        // Bool mode: `loop_name` mask loop running a predicate kernel over int64/float64 columns
+        void emit_bool_mask_loop(llvm::Module &module, llvm::Function *kernel, const std::string &loop_name);
+        // Typed generators: `<step>__fill` running the step and unboxing yields into an int64/float64 buffer
+        void emit_generator_fill(llvm::Module &module, llvm::Function *step, bool floating);
+        struct UfuncStorage // Arrays a NumPy ufunc keeps pointers into
+        {
+            void (*functions[1])(char **args, const Py_ssize_t *dimensions, const Py_ssize_t *steps, void *data);
+            void *data[1];
+            std::vector<char> types;
+            std::string name;
+            std::string doc;
+        };
+        std::vector<std::unique_ptr<UfuncStorage>> ufunc_storage;
+
+        // prange() loops, by FOR_ITER offset (see set_parallel_loops)
+        std::unordered_set<int> parallel_loops;
+        void parallelize_loops(llvm::Module &module, llvm::Function *func);
+
+        void define_inline_runtime(llvm::Module *module); // Inline refcount / C-API fast paths
+        std::string last_ir;  // Bitcode of the last module compiled with dump_ir on
+
+        // explain(f): bytecode offsets travel through codegen and the optimizer
+        // as debug line numbers (offset + 1), so each IR instruction and each
+        // vectorizer remark can be traced back to the instruction it came from
+        bool explain_codegen = false;
+        struct ExplainSite
+        {
+            int64_t instructions = 0; // IR instructions before optimization
+            int64_t capi_calls = 0;   // Py*/_Py* calls, not counting refcounts and PyErr_*
+            int64_t refcount_ops = 0; // Py_INCREF/Py_DECREF and their X variants
+            int64_t cache_calls = 0;  // Inline-cache sites and inline fast paths (jit_rt_*)
+            int64_t helper_calls = 0; // Other JustJIT runtime helpers
+        };
+        struct ExplainRemark
+        {
+            int offset; // -1 when the remark has no location
+            std::string pass;
+            std::string kind; // "passed", "missed" or "analysis"
+            std::string message;
+        };
+        struct ExplainCapture
+        {
+            std::map<int, ExplainSite> sites; // By bytecode offset
+            std::vector<ExplainRemark> remarks;
+            std::string assembly; // Optimized module as target assembly, with .loc lines
+        };
+        ExplainCapture last_explain;
+        llvm::DISubprogram *explain_scope(llvm::Module &module, llvm::Function *func); // nullptr unless explain_codegen
+        void count_explain_sites(llvm::Function *func);
+        void complete_debug_locations(llvm::Module &module);
+        void capture_explain_assembly(llvm::Module &module);
+
+        // Why the most recent compile_* call gave up (see take_rejection())
+        struct CompileRejection
+        {
+            std::string mode;
+            std::string reason;
+            int opcode = -1; // -1 when the reason is not tied to one instruction
+            int offset = -1;
+            bool recorded = false;
+        };
+        CompileRejection last_rejection;
+        void note_rejection(const char *mode, const std::string &reason, const Instruction *instr = nullptr);
+
+        // Per-function code ownership, keyed by symbol name (see unload())
+        struct FunctionResources
+        {
+            llvm::orc::ResourceTrackerSP tracker;
+            std::string object_id;           // Module identifier the compile layer reported the object under
+            size_t object_bytes = 0;         // Known size for objects loaded directly (cache / AOT)
+            std::vector<PyObject *> py_refs; // References only this function's code uses
+            std::vector<std::unique_ptr<GlobalCacheEntry>> global_caches;
+            std::vector<std::unique_ptr<AttrCache>> attr_caches;
+            std::vector<std::unique_ptr<CallSiteCache>> call_sites;
+            std::vector<const void *> constant_table; // Backs the <name>__consts symbol its code loads from
+            std::string callee_body;          // Inlinable bitcode, registered under its address by the first lookup
+            uint64_t callee_body_address = 0; // Where callee_body was registered
+            bool lazy = false;                                // Optimized and generated on first materialization
+            std::unordered_map<std::string, uint64_t> stubs; // Symbol -> its call-through stub, while lazy
+            CompilePhases phases;
+            void *baseline_code = nullptr; // compile_baseline's mapping (no tracker), and its length
+            size_t baseline_mapped = 0;
+            Tier0Code baseline_info{};     // The entry stencil's operand
+        };
+        std::vector<const void *> pending_constant_table; // Slots for the next add_ir_module's table
+        std::string pending_callee_body;                  // Inlinable bitcode of the next add_ir_module's function
+        std::unordered_map<std::string, FunctionResources> function_resources;
+
+        struct StoredRefsMark
+        {
+            size_t constants;
+            size_t names;
+            size_t closure_cells;
+            size_t global_caches;
+            size_t attr_caches;
+            size_t call_sites;
+        };
+        std::vector<std::unique_ptr<GlobalCacheEntry>> global_caches; // Not yet claimed by a function
+        std::vector<std::unique_ptr<AttrCache>> attr_caches;          // Not yet claimed by a function
+        std::vector<std::unique_ptr<CallSiteCache>> call_sites;       // Not yet claimed by a function
+        GlobalCacheEntry *new_global_cache(PyObject *name);
+        GlobalCacheEntry *new_module_attr_cache(PyObject *module, PyObject *name); // Watches the module's __dict__
+        GlobalCacheEntry *new_import_cache(PyObject *name);                        // Watches sys.modules
+        AttrCache *new_attr_cache(PyObject *name, AttrSiteOp op);
+        CallSiteCache *new_call_site();
+
+        // Record types of native-mode parameters and constructor calls ('record:<index>')
+        std::vector<NativeRecordType> native_records;
+        // Parameter -> extents of a C-contiguous array, compiled in as constants (see set_native_shapes)
+        std::unordered_map<int, std::vector<int64_t>> native_shapes;
+        // Pairs of array parameters whose buffers must not overlap (see set_native_disjoint)
+        std::vector<std::pair<int, int>> native_disjoint;
+
+        // Direct calls between typed-mode functions (int / float)
+        // co_names index -> callee; `math.<name>` entries use index | ((attr index + 1) << 16)
+        std::unordered_map<int, NativeCallee> native_callees;
+        // Globals compiled in as constants: (name, value), borrowed; entry trampolines guard them
+        std::vector<std::pair<PyObject *, PyObject *>> frozen_globals;
+        std::unordered_map<int, const NativeCallee *> find_native_call_sites(
+            const InstructionList &instructions, const std::unordered_set<int> &range_loop_offsets) const;
+        // `kinds` (native mode) gives each argument's and the result's kind; empty when all are `value_type`
+        llvm::Value *emit_native_call(llvm::IRBuilder<> &builder, llvm::Module *module, const NativeCallee &callee,
+                                      const std::vector<llvm::Value *> &args, llvm::Type *value_type,
+                                      const std::string &kinds = "");
+        llvm::Value *emit_math_call(llvm::IRBuilder<> &builder, llvm::Module *module, const std::string &name,
+                                    const std::vector<llvm::Value *> &args);
+
+        // Add `<kernel>__entry`: PyObject *(PyObject *const *args, Py_ssize_t nargs) that unboxes,
+        // calls the kernel and boxes the result (`bool_values`: i64 params/result are Python bools;
+        // `kernel_bails`: the kernel may call jit_native_bailout(), checked after the call;
+        // a void kernel returns None)
+        void emit_entry_trampoline(llvm::Module &module, llvm::Function *kernel, bool bool_values = false, bool kernel_bails = false);
+        // JITFunction calling `name`'s entry trampoline (throws if it was not emitted)
+        nb::object entry_callable(const std::string &name, int param_count);
+
+        // Object-mode BINARY_OP with native int/float fast paths; `generic` is the PyNumber_* fallback.
+        // `target_local` is the address of the local the result is stored straight back to, when
+        // `first` was loaded from it (`acc = acc + x`), so a float result can overwrite the old value
+        llvm::Value *emit_speculative_binary_op(llvm::IRBuilder<> &builder, int nb_op, llvm::Function *generic,
+                                                llvm::Value *first, llvm::Value *second,
+                                                llvm::Value *target_local = nullptr);
+
+        // Object-mode COMPARE_OP as PyObject_RichCompareBool (i32: 1/0, -1 on error) with native int/float fast paths
+        llvm::Value *emit_speculative_compare(llvm::IRBuilder<> &builder, int op_code, llvm::Value *lhs, llvm::Value *rhs);
+        // match/case literal dispatch: i64 index of the first of `values` equal to exact-int `subject`
+        // (values.size() if none; -1 if `subject` is not an exact compact int); borrows `subject`
+        llvm::Value *emit_literal_switch(llvm::IRBuilder<> &builder, llvm::Value *subject, const std::vector<int64_t> &values);
+
+        // FOR_ITER next item (new reference, or NULL when exhausted) with native iterator fast paths
+        llvm::Value *emit_iter_next(llvm::IRBuilder<> &builder, llvm::Value *iterator);
+
+        // BINARY_SUBSCR with native list/tuple/dict fast paths (new reference, or NULL); borrows both operands
+        llvm::Value *emit_subscr(llvm::IRBuilder<> &builder, llvm::Value *container, llvm::Value *key);
+        // STORE_SUBSCR with native list/dict fast paths (i32: 0, or -1 on error); borrows all operands
+        llvm::Value *emit_store_subscr(llvm::IRBuilder<> &builder, llvm::Value *container, llvm::Value *key, llvm::Value *value);
+
+        // CALL / CALL_KW lowering through PyObject_Vectorcall, or through jit_call_site
+        // when `site` is given (builtin C functions called directly); consumes `args`
+        llvm::Value *emit_vectorcall(llvm::IRBuilder<> &builder, llvm::Value *callable, llvm::Value *self_or_null,
+                                     const std::vector<llvm::Value *> &args, llvm::Value *kwnames,
+                                     CallSiteCache *site = nullptr);
+        // Whether emit_builtin_call inlines builtin `name` called with `num_args` positional arguments
+        static bool lowers_builtin(const std::string &name, int num_args);
+        // Inline len / isinstance / abs / min / max on owned pointer `args` (consumed); new reference or NULL
+        llvm::Value *emit_builtin_call(llvm::IRBuilder<> &builder, const std::string &name,
+                                       const std::vector<llvm::Value *> &args);
+        StoredRefsMark mark_stored_refs() const;
+        void claim_stored_refs(const std::string &name, const StoredRefsMark &mark);
 
         // Store references to Python objects we've incref'd (for cleanup)
         std::vector<PyObject *> stored_constants;
@@ -376,6 +1270,7 @@ namespace justjit
         // Runtime globals/builtins dicts for LOAD_GLOBAL (Bug #4 fix)
         PyObject *globals_dict_ptr = nullptr;
         PyObject *builtins_dict_ptr = nullptr;
+        nb::object transitive_callees; // set_transitive_callees; each call site of a compile keeps its own reference
 
         // Cache of already-compiled function names to prevent duplicate symbol errors
         std::unordered_set<std::string> compiled_functions;
@@ -386,47 +1281,6 @@ namespace justjit
         // Closure cells storage (for COPY_FREE_VARS / LOAD_DEREF)
         std::vector<PyObject *> stored_closure_cells;
 
-        nb::object create_callable_0(uint64_t func_ptr);
-        nb::object create_callable_1(uint64_t func_ptr);
-        nb::object create_callable_2(uint64_t func_ptr);
-        nb::object create_callable_3(uint64_t func_ptr);
-        nb::object create_callable_4(uint64_t func_ptr);
-
-        // Integer-mode callable generators (native i64 -> i64 functions)
-        nb::object create_int_callable_0(uint64_t func_ptr);
-        nb::object create_int_callable_1(uint64_t func_ptr);
-        nb::object create_int_callable_2(uint64_t func_ptr);
-        nb::object create_int_callable_3(uint64_t func_ptr);
-        nb::object create_int_callable_4(uint64_t func_ptr);
-
-        // Float-mode callable generators (native f64 -> f64 functions)
-        nb::object create_float_callable_0(uint64_t func_ptr);
-        nb::object create_float_callable_1(uint64_t func_ptr);
-        nb::object create_float_callable_2(uint64_t func_ptr);
-        nb::object create_float_callable_3(uint64_t func_ptr);
-        nb::object create_float_callable_4(uint64_t func_ptr);
-
-        // Bool-mode callable generators (native i64 -> bool functions)
-        nb::object create_bool_callable_0(uint64_t func_ptr);
-        nb::object create_bool_callable_1(uint64_t func_ptr);
-        nb::object create_bool_callable_2(uint64_t func_ptr);
-        nb::object create_bool_callable_3(uint64_t func_ptr);
-        nb::object create_bool_callable_4(uint64_t func_ptr);
-
-        // Int32-mode callable generators (native i32 functions)
-        nb::object create_int32_callable_0(uint64_t func_ptr);
-        nb::object create_int32_callable_1(uint64_t func_ptr);
-        nb::object create_int32_callable_2(uint64_t func_ptr);
-        nb::object create_int32_callable_3(uint64_t func_ptr);
-        nb::object create_int32_callable_4(uint64_t func_ptr);
-
-        // Float32-mode callable generators (native f32 functions)
-        nb::object create_float32_callable_0(uint64_t func_ptr);
-        nb::object create_float32_callable_1(uint64_t func_ptr);
-        nb::object create_float32_callable_2(uint64_t func_ptr);
-        nb::object create_float32_callable_3(uint64_t func_ptr);
-        nb::object create_float32_callable_4(uint64_t func_ptr);
-
         // Complex128-mode callable generators (native {double,double} functions)
         nb::object create_complex128_callable_0(uint64_t func_ptr);
         nb::object create_complex128_callable_1(uint64_t func_ptr);
@@ -436,12 +1290,6 @@ namespace justjit
         nb::object create_ptr_callable_2(uint64_t func_ptr);
         nb::object create_ptr_callable_3(uint64_t func_ptr);
 
-        // Vec4f-mode callable generators (<4 x float> SIMD)
-        nb::object create_vec4f_callable_2(uint64_t func_ptr);
-
-        // Vec8i-mode callable generators (<8 x i32> SIMD)
-        nb::object create_vec8i_callable_2(uint64_t func_ptr);
-
         // Complex64-mode callable generators ({float, float})
         nb::object create_complex64_callable_0(uint64_t func_ptr);
         nb::object create_complex64_callable_1(uint64_t func_ptr);
@@ -452,7 +1300,18 @@ namespace justjit
         nb::object create_optional_f64_callable_1(uint64_t func_ptr);
         nb::object create_optional_f64_callable_2(uint64_t func_ptr);
 
-        void optimize_module(llvm::Module &module, llvm::Function *func);
+        // Add a finished module to this core's JITDylib.
+        // A non-empty cache_key makes the persistent object cache store the result.
+        llvm::Error add_ir_module(llvm::orc::ThreadSafeModule tsm, const std::string &name = "", const std::string &cache_key = "");
+
+        // Persistent object cache (typed modes only; see set_object_cache_dir)
+        std::string object_cache_key(const char *mode, nb::object py_instructions, nb::list py_constants,
+                                     const std::string &name, int param_count, int total_locals);
+        bool load_cached_object(const std::string &cache_key, const std::string &name);
+
+        // At `level` in place of opt_level (inline C passes its own per call)
+        void optimize_module(llvm::Module &module, llvm::Function *func, int level);
+        void optimize_module(llvm::Module &module, llvm::Function *func) { optimize_module(module, func, opt_level); }
     };
 
 }
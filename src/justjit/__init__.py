@@ -1,7 +1,16 @@
 import os
 import sys
+import array
+import atexit
+import collections
+import copyreg
 import dis
+import hashlib
+import math
+import threading
+import time
 import types
+import weakref
 
 # Add DLL directories on Windows before importing the extension
 if sys.platform == "win32":
@@ -36,8 +45,37 @@ if sys.platform == "win32":
             except OSError:
                 pass
 
+
+def _in_main_interpreter():
+    try:
+        import _interpreters  # 3.13+
+    except ImportError:
+        try:
+            import _xxsubinterpreters as _interpreters  # 3.12
+        except ImportError:
+            return True
+    return _interpreters.get_current() == _interpreters.get_main()
+
+
+# The extension's types, compiled code and the Python objects that code holds
+# are process-wide and belong to the main interpreter. A legacy subinterpreter
+# would be handed a copy of the main interpreter's module instead of its own.
+if not _in_main_interpreter():
+    raise ImportError(
+        "justjit can only be imported in the main interpreter; for parallel "
+        "workers use threads on free-threaded Python or forked processes "
+        "(see justjit.precompile_all)"
+    )
+
 # Now import the C++ extension module
-from ._core import JIT, create_jit_generator, create_jit_coroutine
+from ._core import JIT, JITFunction, create_jit_function, create_jit_generator, create_jit_coroutine, set_cache_dir, get_cache_dir
+from ._core import set_cache_remote as _set_cache_remote, take_cache_uploads as _take_cache_uploads
+from ._core import random, randint, seed, cuda_available, baseline_available, run_coroutines as _run_coroutines
+from ._core import load_library as _load_library, loaded_libraries, enable_profiling, runtime_memory_usage
+from ._core import set_stats_enabled as _set_stats_enabled, stats_enabled as _stats_enabled
+from ._core import group_aggregate as _group_aggregate
+from ._core import set_num_threads, get_num_threads, numa_nodes, parallel_stats
+from ._core import set_thread_affinity as _set_thread_affinity
 
 # InlineCCompiler is only available if Clang support was compiled in
 try:
@@ -47,8 +85,25 @@ except ImportError:
     _HAS_CLANG = False
     InlineCCompiler = None
 
+from . import aot
+from . import hotness
+from .hotness import start as start_sampling, stop as stop_sampling, hot_functions
+from .hotness import save as save_profile, load as load_profile
+from . import trace
+from .lazy import lazy, expr
+from .stencil import stencil
+from . import simd
+from . import bits
+from .trace import start as start_tracing, stop as stop_tracing, dump as dump_trace
+from ._core import tracing as _tracing, trace_instant as _trace_instant
+
 __version__ = "0.1.7"
-__all__ = ["JIT", "jit", "dump_ir", "create_jit_generator", "create_jit_coroutine", "InlineCCompiler", "inline_c", "dump_c_ir"]
+__all__ = ["JIT", "jit", "dump_ir", "explain", "create_jit_generator", "create_jit_coroutine", "InlineCCompiler", "inline_c", "dump_c_ir", "set_cache_dir", "get_cache_dir", "set_cache_backend", "aot", "set_code_limit", "get_code_usage", "memory_usage", "vectorize", "reduce", "scan", "stream", "groupby", "lazy", "expr", "stencil", "simd", "bits", "prange", "set_num_threads", "get_num_threads", "set_thread_affinity", "numa_nodes", "parallel_stats", "record", "fixed", "random", "randint", "seed", "cuda_available", "baseline_available", "run_all", "load_library", "loaded_libraries", "enable_profiling", "enable_stats", "stats", "reset_stats", "compile_report", "report", "hotness", "start_sampling", "stop_sampling", "hot_functions", "save_profile", "load_profile", "precompile_all", "compile_many", "warmup", "jit_module", "trace", "start_tracing", "stop_tracing", "dump_trace"]
+
+# 512-bit vector modes; LLVM splits them into AVX2/SSE/NEON operations on narrower targets
+_WIDE_VECTOR_MODES = ("vec8d", "vec16f", "vec16i")
+# u8 / i16 vector modes with saturating clamps, for image and audio buffers
+_NARROW_VECTOR_MODES = ("vec16u8", "vec32u8", "vec16i16")
 
 # Python code flags
 _CO_GENERATOR = 0x20
@@ -79,10 +134,6 @@ _GENERATOR_OPCODES = {
 # These remaining opcodes are for more complex constructs.
 _EXCEPTION_OPCODES = {"SETUP_FINALLY", "POP_BLOCK"}
 
-# Pattern matching opcodes - now supported with proper CFG analysis and PHI nodes
-# These opcodes work correctly with the implemented stack state tracking.
-_PATTERN_MATCHING_OPCODES = set()  # All pattern matching opcodes are now supported
-
 
 def _is_generator_or_coroutine(func):
     """Check if function is a generator, coroutine, or async generator."""
@@ -92,13 +143,17 @@ def _is_generator_or_coroutine(func):
 
 def _has_unsupported_opcodes(func):
     """Check if function contains opcodes we cannot JIT compile."""
+    instr = _first_unsupported_instruction(func)
+    if instr is None:
+        return None
+    return "generator" if instr.opname in _GENERATOR_OPCODES else "exception"
+
+
+def _first_unsupported_instruction(func):
+    """The first generator or legacy exception opcode in ``func``, or None."""
     for instr in dis.get_instructions(func):
-        if instr.opname in _GENERATOR_OPCODES:
-            return "generator"
-        if instr.opname in _EXCEPTION_OPCODES:
-            return "exception"
-        if instr.opname in _PATTERN_MATCHING_OPCODES:
-            return "pattern_matching"
+        if instr.opname in _GENERATOR_OPCODES or instr.opname in _EXCEPTION_OPCODES:
+            return instr
         # All CALL_INTRINSIC_1 args are now supported (1-11)
     return None
 
@@ -110,21 +165,116 @@ def jit(
     vectorize=True,
     inline=True,
     parallel=False,
-    lazy=False,
+    lazy=True,
     mode="auto",
+    async_compile=False,
+    tiered=False,
+    tier_threshold=1000,
+    unroll=True,
+    fastmath=False,
+    target_cpu=None,
+    target_features=None,
+    multiversion=False,
+    specialize=False,
+    profile_calls=100,
+    osr=False,
+    osr_threshold=1000,
+    signature=None,
+    int_overflow="deopt",
+    pgo=False,
+    freeze_globals=None,
+    transitive=False,
+    regions=False,
+    trace_loops=False,
+    trace_threshold=1000,
 ):
     """
     JIT compile a Python function for aggressive performance optimization.
 
     Args:
-        func: The function to compile (when used without parentheses)
+        func: The function to compile (when used without parentheses), or a
+              signature string such as 'f64(f64, i64)' (same as signature=).
+              On a class, every method, static method and class method is
+              compiled with these options
         opt_level: LLVM optimization level (0-3, default 3 for maximum performance)
-        vectorize: Enable loop vectorization (default True)
+        vectorize: Enable loop/SLP vectorization and loop interleaving (default True)
         inline: Enable function inlining (default True)
-        parallel: Enable parallelization (default False)
-        lazy: Delay compilation until first call (default False)
+        parallel: Run the prange() loops of mode='int' and mode='float' functions
+              on a thread pool with the GIL released (default False); see prange()
+        lazy: Compile on the first call (default True). False compiles at
+              decoration time, at the top tier, so the first call runs native
+              code; see also warmup()
         mode: Compilation mode - 'auto', 'object', or 'int' (default 'auto')
-              'int' mode generates native integer code with no Python object overhead
+              'int' mode generates native integer code with no Python object overhead.
+              On a generator, 'int' or 'float' makes it typed: yields are unboxed
+              in batches and g.take(n) returns them as a memoryview
+        async_compile: Compile on a background thread (default False). Calls made
+              before native code is ready run the original Python function.
+        tiered: Compile at O1 first and recompile at opt_level in the background
+              once the function has been called tier_threshold times (default False).
+              'baseline' starts object-mode functions in code copied from precompiled
+              stencils without running LLVM at all (see baseline_available()); functions
+              the stencils cannot express start at opt_level
+        tier_threshold: Calls before a tiered function is recompiled (default 1000)
+        unroll: Enable loop unrolling (default True)
+        fastmath: Allow fast-math FP transforms (default False). True sets every LLVM
+              fast-math flag; a set such as {'contract', 'reassoc'} (or 'contract,reassoc')
+              sets only those: reassoc, nnan, ninf, nsz, arcp, contract, afn
+        target_cpu: CPU to generate code for, e.g. 'x86-64-v3' (default: detected host)
+        target_features: LLVM feature string, e.g. '+avx2,+fma' (default: host features)
+        multiversion: Emit x86-64 v2/v3/v4 clones with runtime CPU dispatch (default False)
+        specialize: For mode='auto', profile argument and return types for the first
+              profile_calls calls and, if they were all int or all float, add an int/float
+              mode version used whenever the arguments match (default False).
+              A parameter name or tuple of names, e.g. specialize=('window',), instead
+              compiles a clone per distinct value of those parameters (up to 8), with
+              the value compiled in as a constant; the entry picks the clone natively
+              In native mode, True clones per small, stable shape of the array
+              arguments (C-contiguous, at most 64 elements), with constant extents
+        profile_calls: Calls observed before specializing (default 100)
+        osr: On-stack replacement for object mode (default False). A call running in
+              the interpreter (e.g. while async_compile is still compiling) continues
+              in native code once one of its while loops has jumped back
+              osr_threshold times. Functions with try/with blocks or closures, and
+              for loops, are not entered mid-call.
+        osr_threshold: Backward jumps to a loop header before it gets an entry (default 1000)
+        signature: Parameter and return types for mode='native', e.g. 'f64(f64, i64)'
+              (i64/int, f64/float, b1/bool; '(f64, i64)' infers the return type).
+              Array parameters are 'f64[:]', 'f32[:]', 'i64[:]', 'i32[:]', 'u8[:]' or N-D
+              'f64[:, :]', 'f64[:, :, :]', ..., and 'void(...)' declares a
+              function returning None. 'bytes' and 'str' parameters are 'u8[:]'
+              views of a bytes, bytearray or ASCII str argument.
+              With mode='auto', functions whose parameters are all annotated
+              int/float/bool compile in native mode with those types.
+        int_overflow: What mode='int' does when a result overflows int64 (default 'deopt'):
+              'deopt' continues that call in the interpreter from the overflowing
+              operation, which returns the exact Python int; 'raise' raises
+              OverflowError; 'wrap' wraps silently
+        pgo: With tiered=True, tier 1 counts how often each branch goes each way
+              and tier 2 is optimized with those counts as branch weights (default False)
+        freeze_globals: Compile globals bound to int, float, complex, bool, str, bytes,
+              None or tuples of those in as constants, so loops fold them (default None:
+              only in mode='int', 'float' and 'native', which cannot read globals
+              otherwise). Rebinding one makes calls run interpreted until the next
+              call recompiles with the new value. True freezes in object mode too;
+              False never freezes
+        transitive: Also compile the plain Python functions this one calls through
+              globals, with the same options, and theirs in turn (default False).
+              Each helper compiles on its first call; int/float/native mode call
+              it natively, object mode through its JITFunction. Calls are guarded
+              on the global still naming that function
+        regions: For mode='auto' and 'object', move each loop of plain int/float/array
+              arithmetic into a region function compiled in native mode for the
+              types of the locals it uses, and call that from the rest of the
+              function (default False). Loops whose locals native mode cannot
+              type run their region interpreted
+        trace_loops: For mode='auto' and 'object', run the function interpreted until a
+              loop takes trace_threshold backward jumps, record the calls that loop
+              makes (receiver types included, three levels deep), and compile the
+              function with those calls inlined behind guards; a failed guard makes
+              the original call (default False). See justjit.trace_loops
+        trace_threshold: Backward jumps to a loop header before its calls are recorded
+              (default 1000)
 
     Example:
         @jit
@@ -135,19 +285,1426 @@ def jit(
         def mul(a, b):
             return a * b
     """
+    if isinstance(func, str):
+        signature, func = func, None
     if func is None:
 
         def decorator(f):
+            if isinstance(f, type):
+                return _jit_class(f, decorator)
             return _create_jit_wrapper(
-                f, opt_level, vectorize, inline, parallel, lazy, mode
+                f,
+                opt_level,
+                vectorize,
+                inline,
+                parallel,
+                lazy,
+                mode,
+                async_compile,
+                tiered,
+                tier_threshold,
+                unroll,
+                fastmath,
+                target_cpu,
+                target_features,
+                multiversion,
+                specialize,
+                profile_calls,
+                osr,
+                osr_threshold,
+                signature,
+                int_overflow,
+                pgo,
+                freeze_globals,
+                transitive,
+                regions,
+                trace_loops,
+                trace_threshold,
             )
 
         return decorator
-    return _create_jit_wrapper(func, opt_level, vectorize, inline, parallel, lazy, mode)
+    if isinstance(func, type):
+        return _jit_class(func, jit)
+    return _create_jit_wrapper(
+        func,
+        opt_level,
+        vectorize,
+        inline,
+        parallel,
+        lazy,
+        mode,
+        async_compile,
+        tiered,
+        tier_threshold,
+        unroll,
+        fastmath,
+        target_cpu,
+        target_features,
+        multiversion,
+        specialize,
+        profile_calls,
+        osr,
+        osr_threshold,
+        signature,
+        int_overflow,
+        pgo,
+        freeze_globals,
+        transitive,
+        regions,
+        trace_loops,
+        trace_threshold,
+    )
+
+
+# vectorize() modes -> element format of every operand (struct / array module codes)
+# LLVM fast-math flags accepted by fastmath=; fastmath=True sets all of them
+_FASTMATH_FLAGS = ("reassoc", "nnan", "ninf", "nsz", "arcp", "contract", "afn")
+
+
+def _fastmath_flags(fastmath):
+    """Flag names for a ``fastmath=`` value: a bool, a comma-separated string or an iterable of names."""
+    if fastmath is True:
+        return list(_FASTMATH_FLAGS)
+    if not fastmath:
+        return []
+    names = fastmath.split(",") if isinstance(fastmath, str) else list(fastmath)
+    flags = []
+    for name in names:
+        name = name.strip()
+        if name == "fast":
+            flags.extend(_FASTMATH_FLAGS)
+        elif name in _FASTMATH_FLAGS:
+            flags.append(name)
+        else:
+            raise ValueError(
+                f"unknown fast-math flag {name!r}; expected one of {', '.join(_FASTMATH_FLAGS)} or 'fast'"
+            )
+    return flags
+
+
+def prange(*args):
+    """
+    range() for loops that @jit(parallel=True) may split across threads.
+
+    In mode='int' and mode='float' functions compiled with parallel=True, a
+    ``for i in prange(...)`` loop whose iterations only share sum, product,
+    min or max reductions runs on a thread pool with the GIL released.
+    Everywhere else (including the interpreter) it is exactly range().
+    """
+    return range(*args)
+
+
+def set_thread_affinity(cpus=None, nodes=None):
+    """
+    Pin the threads of the prange() pool (Linux; ignored elsewhere).
+
+    With ``cpus``, pool thread k runs on ``cpus[k % len(cpus)]``; the calling
+    thread, slot 0, is never moved. With ``nodes`` (see numa_nodes()), the
+    slots are split into equal contiguous groups, one per node in order, and
+    each thread may run on any CPU of its node. Work is then stolen only
+    between slots of one node. With neither, the threads are unpinned.
+    """
+    _set_thread_affinity(list(cpus or ()), list(nodes or ()))
+
+
+# Record field annotations and the unpack/box kind codes native mode uses for them
+_RECORD_KINDS = {int: "q", float: "d", bool: "?", "int": "q", "float": "d", "bool": "?"}
+
+
+def record(cls):
+    """
+    Declare a dataclass or NamedTuple as a native-mode record type.
+
+    Every field must be annotated ``int``, ``float`` or ``bool``. A
+    mode='native' function whose parameter is annotated with (or whose
+    signature names) the class unpacks the fields once at entry, so
+    ``p.x`` is a native value. ``return Point(x, y)`` boxes one new
+    instance. Arguments of another type deoptimize to the interpreter.
+
+    Example:
+        @justjit.record
+        class Point(typing.NamedTuple):
+            x: float
+            y: float
+
+        @justjit.jit
+        def norm2(p: Point) -> float:
+            return p.x * p.x + p.y * p.y
+    """
+    import dataclasses
+
+    if dataclasses.is_dataclass(cls):
+        fields = dataclasses.fields(cls)
+        if any(not f.init or getattr(f, "kw_only", False) for f in fields):
+            raise TypeError(f"record {cls.__name__!r}: every field must be a positional __init__ argument")
+        names, types_ = [f.name for f in fields], [f.type for f in fields]
+    elif isinstance(cls, type) and issubclass(cls, tuple) and hasattr(cls, "_fields"):
+        annotations = getattr(cls, "__annotations__", {})
+        names, types_ = list(cls._fields), [annotations.get(name) for name in cls._fields]
+    else:
+        raise TypeError(f"record() expects a dataclass or NamedTuple class, not {cls!r}")
+    kinds = []
+    for name, hint in zip(names, types_):
+        kind = _RECORD_KINDS.get(hint) if isinstance(hint, (type, str)) else None
+        if kind is None:
+            raise TypeError(f"record {cls.__name__!r}: field {name!r} must be annotated int, float or bool")
+        kinds.append(kind)
+    cls.__justjit_record__ = (tuple(names), "".join(kinds))
+    return cls
+
+
+def _is_record(obj):
+    return isinstance(obj, type) and "__justjit_record__" in obj.__dict__
+
+
+# Decimal places a native-mode fixed-point type may have (an int64 holds 18 digits)
+_FIXED_MAX_SCALE = 18
+
+
+def fixed(scale):
+    """
+    Name the native-mode fixed-point type with ``scale`` decimal places.
+
+    A ``fixed(k)`` value is an int64 count of 10**-k units: it arrives as
+    an ``int`` or a ``decimal.Decimal`` with at most k places and is
+    returned as a ``Decimal``. + and - are exact; * and / round half-even
+    to k places. Every fixed type in one function shares its k. Use it as
+    an annotation, or write ``fixed<k>`` in a signature string
+    (``'fixed2(fixed2, i64)'``).
+
+    Example:
+        @justjit.jit
+        def total(price: justjit.fixed(2), qty: int, rate: justjit.fixed(2)) -> justjit.fixed(2):
+            gross = price * qty
+            return gross + gross * rate
+    """
+    if not isinstance(scale, int) or not 0 <= scale <= _FIXED_MAX_SCALE:
+        raise ValueError(f"fixed() takes 0 to {_FIXED_MAX_SCALE} decimal places, not {scale!r}")
+    return f"fixed{scale}"
+
+
+def _fixed_type(name):
+    """'fixed<k>' for a fixed-point type name ('fixed2', or 'fixed(2)' from a string annotation), else None."""
+    name = name.strip().rpartition(".")[2].replace("(", "").replace(")", "").replace(" ", "")
+    digits = name[5:] if name.startswith("fixed") else ""
+    return name if digits.isdigit() and int(digits) <= _FIXED_MAX_SCALE and str(int(digits)) == digits else None
+
+
+def _native_records(func, param_types, return_type):
+    """Number the record types a native-mode function uses.
+
+    Record classes in ``param_types`` / ``return_type`` become
+    ``'record:<k>'``, and arrays of them (``(cls,)``) ``'record:<k>[:]'``. Returns ``(param_types, return_type, records)``, where
+    records holds ``(global name or '', class, field names, kinds)`` tuples
+    for JIT.set_native_records(); record globals the function calls are
+    listed too, so ``Point(x, y)`` can box natively.
+    """
+    records, numbers = [], {}
+
+    def number(cls, global_name=""):
+        if id(cls) not in numbers:
+            numbers[id(cls)] = len(records)
+            records.append((global_name, cls) + cls.__justjit_record__)
+        return f"record:{numbers[id(cls)]}"
+
+    for name in func.__code__.co_names:
+        target = func.__globals__.get(name)
+        if _is_record(target):
+            number(target, name)
+    params = [
+        number(t) if _is_record(t) else number(t[0]) + "[:]" if isinstance(t, tuple) else t
+        for t in param_types
+    ]
+    result = number(return_type) if _is_record(return_type) else return_type
+    return params, result, records
+
+
+_UFUNC_KINDS = {"float": "d", "float32": "f", "int": "q", "int32": "i"}
+
+
+def vectorize(
+    func=None,
+    *,
+    mode="float",
+    ufunc=True,
+    opt_level=3,
+    fastmath=False,
+    target_cpu=None,
+    target_features=None,
+    target="cpu",
+):
+    """
+    Compile a scalar function into an element-wise loop over arrays.
+
+    The body is compiled in ``mode`` ('float', 'float32', 'int' or 'int32') and
+    called from a native loop over the input and output buffers, so LLVM can
+    inline and vectorize it instead of crossing from Python once per element.
+    Scalar arguments are broadcast against the arrays.
+
+    Args:
+        func: The scalar function (when used without parentheses); an @jit
+              function is recompiled from its original source
+        mode: Scalar mode of the body (default 'float'). Int results wrap
+              on overflow, as NumPy integer arithmetic does.
+        ufunc: Register the loop as a real NumPy ufunc when NumPy is installed
+               (default True), which adds N-D broadcasting, ``out=``, and the
+               ufunc methods through ``wrapper.ufunc``
+        opt_level: LLVM optimization level (0-3, default 3)
+        fastmath: Fast-math flags, as for jit() (default False)
+        target_cpu: CPU to generate code for (default: detected host)
+        target_features: LLVM feature string (default: host features)
+        target: 'cpu' (default) or 'cuda', which compiles the body to a PTX
+                kernel with one GPU thread per element (see cuda_available())
+
+    Without NumPy (or with ``ufunc=False``), arguments are 1-D buffers such as
+    ``array.array`` of the mode's element type or scalars, and the result is a
+    new ``array.array`` unless ``out=`` names a writable buffer. With
+    ``target='cuda'``, arguments may also be 1-D ``__cuda_array_interface__``
+    arrays (CuPy, Numba, PyTorch), which stay on the device; host buffers are
+    copied over for each call.
+
+    Example:
+        @justjit.vectorize
+        def distance(x, y):
+            return (x * x + y * y) ** 0.5
+
+        distance(xs, ys)  # one native loop over both arrays
+    """
+    if mode not in _UFUNC_KINDS:
+        raise ValueError(f"vectorize mode must be one of {', '.join(_UFUNC_KINDS)}, not {mode!r}")
+    if target not in ("cpu", "cuda"):
+        raise ValueError(f"vectorize target must be 'cpu' or 'cuda', not {target!r}")
+
+    def decorator(f):
+        return _create_vectorized(f, mode, ufunc, opt_level, fastmath, target_cpu, target_features, target)
+
+    if func is None:
+        return decorator
+    return decorator(func)
+
+
+def _buffer_length(obj):
+    """Length of a 1-D buffer or CUDA array, or None for scalars and 0-D buffers."""
+    interface = getattr(obj, "__cuda_array_interface__", None)
+    if interface is not None:
+        shape = interface["shape"]
+        return shape[0] if shape else None
+    try:
+        view = memoryview(obj)
+    except TypeError:
+        return None
+    return len(view) if view.ndim else None
+
+
+# PTX target of vectorize(target='cuda'); the driver compiles it for newer GPUs when the kernel loads
+_CUDA_ARCH = "sm_52"
+
+
+def _create_vectorized(func, mode, ufunc, opt_level, fastmath, target_cpu, target_features, target, parallel=False):
+    func = getattr(func, "_original_func", func)  # @jit functions are vectorized from their source
+    kind = _UFUNC_KINDS[mode]
+    code = func.__code__
+    nin = code.co_argcount
+    total_locals = code.co_nlocals + len(code.co_cellvars) + len(code.co_freevars)
+
+    core = JIT()
+    core.set_opt_level(opt_level)
+    core.set_pipeline_options(True, True, True)
+    core.set_fastmath_flags(_fastmath_flags(fastmath))
+    core.set_target(target_cpu or "", target_features or "")
+    if target == "cuda":
+        core.set_cuda_target(_CUDA_ARCH)
+        ufunc = False  # NumPy ufunc loops run on the host
+    else:
+        core.set_ufunc_loops(True)
+    # Per-element deoptimization can't rerun half a loop, so int results wrap
+    extra = ("wrap",) if mode == "int" else ()
+    if not getattr(core, "compile_" + mode)(
+        _extract_bytecode(func), _extract_constants(func), func.__name__, nin, total_locals, *extra
+    ):
+        raise RuntimeError(f"Failed to compile '{func.__name__}' in {mode} mode for vectorize")
+
+    if target == "cuda":
+        loop = core.get_cuda_callable(func.__name__, nin, kind)
+    else:
+        loop = core.get_ufunc_callable(func.__name__, nin, kind, parallel)
+    numpy_ufunc = core.get_numpy_ufunc(func.__name__, nin, kind, func.__doc__ or "") if ufunc else None
+
+    def vectorized(*args, out=None):
+        if len(args) != nin:
+            raise TypeError(f"{func.__name__}() takes {nin} arguments ({len(args)} given)")
+        if numpy_ufunc is not None:
+            return numpy_ufunc(*args) if out is None else numpy_ufunc(*args, out=out)
+        if out is None:
+            lengths = [n for n in map(_buffer_length, args) if n is not None]
+            out = array.array(kind, bytes(max(lengths, default=1) * array.array(kind).itemsize))
+            if not lengths:
+                return loop(*args, out)[0]  # All scalars: a scalar result
+        return loop(*args, out)
+
+    vectorized.__name__ = func.__name__
+    vectorized.__qualname__ = func.__qualname__
+    vectorized.__doc__ = func.__doc__
+    vectorized.__wrapped__ = func
+    vectorized.ufunc = numpy_ufunc
+    vectorized._original_func = func
+    vectorized._mode = mode
+    vectorized._jit_instance = core  # Owns the loop code (and the ufunc's tables)
+    return vectorized
+
+
+# Mode of reduce()/scan() for each (buffer format, itemsize) they accept
+_BUFFER_MODES = {
+    ("d", 8): "float", ("f", 4): "float32",
+    ("q", 8): "int", ("l", 8): "int", ("i", 4): "int32", ("l", 4): "int32",
+}
+
+# Kernel -> {mode: (core, reduce, scan, stream callables)} compiled by reduce()/scan()/stream()
+_reduction_loops = weakref.WeakKeyDictionary()
+
+
+def _reduction_mode(data, mode):
+    if mode is not None:
+        if mode not in _UFUNC_KINDS:
+            raise ValueError(f"mode must be one of {', '.join(_UFUNC_KINDS)}, not {mode!r}")
+        return mode
+    view = memoryview(data)
+    key = (view.format.lstrip("@=<"), view.itemsize)
+    if key not in _BUFFER_MODES:
+        raise TypeError(f"reduce() and scan() take float64, float32, int64 or int32 buffers, not format {view.format!r}")
+    return _BUFFER_MODES[key]
+
+
+def _reduction_loops_for(kernel, mode):
+    kernel = getattr(kernel, "_original_func", kernel)
+    loops = _reduction_loops.setdefault(kernel, {})
+    if mode not in loops:
+        code = kernel.__code__
+        if code.co_argcount != 2:
+            raise TypeError(f"{kernel.__name__}() must take exactly 2 arguments to be used as a reduction kernel")
+        core = JIT()
+        core.set_opt_level(3)
+        core.set_pipeline_options(True, True, True)
+        core.set_reduce_loops(True)
+        name = kernel.__name__ if kernel.__name__.isidentifier() else "kernel"  # <lambda>
+        total_locals = code.co_nlocals + len(code.co_cellvars) + len(code.co_freevars)
+        # A chunk can't be rerun after a deoptimization, so int kernels wrap
+        extra = ("wrap",) if mode == "int" else ()
+        if not getattr(core, "compile_" + mode)(
+            _extract_bytecode(kernel), _extract_constants(kernel), name, 2, total_locals, *extra
+        ):
+            raise RuntimeError(f"Failed to compile '{kernel.__name__}' in {mode} mode for reduce/scan")
+        kind = _UFUNC_KINDS[mode]
+        loops[mode] = (core, core.get_reduce_callable(name, kind), core.get_scan_callable(name, kind),
+                       core.get_stream_callable(name, kind))
+    return loops[mode]
+
+
+def reduce(kernel, data, init, *, mode=None):
+    """
+    Fold a 1-D buffer through a two-argument kernel: ``kernel(...kernel(init, data[0])..., data[-1])``.
+
+    The kernel is compiled in ``mode`` ('float', 'float32', 'int' or 'int32';
+    by default the one matching the buffer's element type) and inlined into a
+    native loop that keeps several independent accumulators, so LLVM can
+    combine them as a SIMD tree. Buffers of more than a few tens of thousands
+    of elements are split across the ``prange()`` thread pool with the GIL
+    released. Both reorder the kernel's applications: it must be associative
+    and commutative, like ``a + b``, ``a * b``, ``max(a, b)`` or ``min(a, b)``.
+
+    Args:
+        kernel: A function of two arguments (or an @jit function)
+        data: A contiguous 1-D buffer (NumPy array, ``array.array``, ...)
+        init: Starting value, folded in once
+        mode: Scalar mode of the kernel (default: from the buffer's format)
+
+    Example:
+        def add(a, b):
+            return a + b
+
+        total = justjit.reduce(add, data, 0.0)
+
+    Compiled loops are kept per kernel function and mode, so later calls with
+    the same function only run them (a new lambda each call compiles again).
+    """
+    mode = _reduction_mode(data, mode)
+    return _reduction_loops_for(kernel, mode)[1](data, init)
+
+
+def scan(kernel, data, *, out=None, mode=None):
+    """
+    Inclusive prefix scan: ``out[0] = data[0]``, ``out[i] = kernel(out[i - 1], data[i])``.
+
+    Compiled like reduce(). Large buffers use a two-pass parallel scan over
+    blocks on the ``prange()`` thread pool, with the GIL released; blocks are
+    only combined in order, so the kernel needs to be associative but not
+    commutative. Returns ``out``, a new ``array.array`` of the buffer's element
+    type unless a writable buffer of the same length is given.
+
+    Example:
+        running = justjit.scan(add, data)
+    """
+    mode = _reduction_mode(data, mode)
+    if out is None:
+        kind = _UFUNC_KINDS[mode]
+        out = array.array(kind, bytes(len(memoryview(data)) * array.array(kind).itemsize))
+    return _reduction_loops_for(kernel, mode)[2](data, out)
+
+
+def stream(kernel, path, init, *, dtype="d", chunk=1 << 22, offset=0, mode=None):
+    """
+    Fold a binary file of fixed-size elements through a reduction kernel without loading it.
+
+    Like ``reduce(kernel, numpy.memmap(path, dtype, offset=offset), init)``,
+    but the loop over the file runs in native code: the file is memory-mapped
+    and folded ``chunk`` elements at a time with the GIL released, the
+    accumulator carried from chunk to chunk, each large chunk split across the
+    ``prange()`` pool. The mapping is advised sequential, the next chunk is
+    read ahead while the current one is folded, and finished chunks are
+    dropped from the mapping, so files larger than memory stream through.
+
+    Args:
+        kernel: A function of two arguments (or an @jit function), as for reduce()
+        path: File to read
+        init: Starting value, folded in once
+        dtype: Element type code ('d', 'f', 'q' or 'i', or a NumPy dtype), native byte order
+        chunk: Elements per chunk
+        offset: Header bytes to skip, a multiple of the element size
+        mode: Scalar mode of the kernel (default: from ``dtype``)
+
+    Example:
+        total = justjit.stream(add, "telemetry.bin", 0.0, dtype="d")
+    """
+    if mode is None:
+        code = getattr(dtype, "char", dtype)  # NumPy dtypes carry their type code
+        try:
+            key = (code, array.array(code).itemsize)
+        except (TypeError, ValueError):
+            key = None
+        if key not in _BUFFER_MODES:
+            raise TypeError(f"stream() reads float64, float32, int64 or int32 elements, not dtype {dtype!r}")
+        mode = _BUFFER_MODES[key]
+    else:
+        mode = _reduction_mode(None, mode)
+    return _reduction_loops_for(kernel, mode)[3](os.fspath(path), init, chunk, offset)
+
+
+def groupby(keys, values=None, op="sum", *, output="dict"):
+    """
+    Aggregate ``values`` per distinct key, in native code, without Python dicts.
+
+    ``keys`` is a 1-D buffer of int64 or int32 keys and ``values`` one of the
+    same length (float64, float32, int64 or int32), or None for ``op='count'``.
+    The rows go through an open-addressing hash table probed 16 buckets per
+    SIMD compare, with the GIL released; large inputs are split across the
+    ``prange()`` pool, one table per thread, merged at the end. Groups come
+    out in key order. The number of distinct keys is
+    ``len(groupby(keys, op="count"))``.
+
+    Args:
+        keys: Group keys
+        values: Values to aggregate
+        op: 'sum', 'count', 'min', 'max' or 'mean'
+        output: 'dict' for {key: result}, or 'arrays' for (keys, results),
+                NumPy arrays when an input is one, otherwise array.array
+
+    Example:
+        totals = justjit.groupby(customer_ids, amounts, "sum")
+    """
+    if output not in ("dict", "arrays"):
+        raise ValueError(f"output must be 'dict' or 'arrays', not {output!r}")
+    key_bytes, result_bytes, kind = _group_aggregate(keys, values, op)
+    group_keys = array.array("q", key_bytes)
+    results = array.array(kind, result_bytes)
+    if output == "dict":
+        return dict(zip(group_keys, results))
+    if any(type(operand).__module__ == "numpy" for operand in (keys, values)):
+        numpy = sys.modules["numpy"]
+        return numpy.frombuffer(key_bytes, dtype="q").copy(), numpy.frombuffer(result_bytes, dtype=kind).copy()
+    return group_keys, results
+
+
+# LRU of wrappers holding native code: id(wrapper) -> [weakref(wrapper), code bytes, cores, name]
+_code_lru = collections.OrderedDict()
+_code_limit = 0
+
+
+def set_code_limit(nbytes):
+    """
+    Cap the native code kept alive by @jit functions.
+
+    When the total exceeds ``nbytes``, the least recently called functions are
+    unloaded (they recompile on their next call). 0 disables the cap.
+    """
+    global _code_limit
+    _code_limit = max(0, int(nbytes or 0))
+    if _code_limit:
+        # Calls must go through the Python dispatch again to keep the LRU order
+        for ref, *_rest in list(_code_lru.values()):
+            victim = ref()
+            if victim is not None:
+                victim._set_native(None)
+    _enforce_code_limit()
+
+
+def get_code_usage():
+    """Return the native code bytes currently held by @jit functions."""
+    return sum(entry[1] for entry in _code_lru.values())
+
+
+def memory_usage():
+    """
+    Memory held by the JIT runtime, for budgeting workers.
+
+    Returns the process-wide code and data bytes the object linker holds
+    (every core, helpers and inline C included), live and pooled JIT
+    generator and coroutine objects, ``"functions"``: per compiled @jit
+    function (by qualified name, summed over its tiers and specializations)
+    its linked bytes, IR still waiting to be compiled and Python references
+    held, and ``"inline_c"`` for the inline C compiler's caches. Unloading
+    the largest functions (``f.unload()``) brings the totals back down.
+    """
+    usage = runtime_memory_usage()
+    functions = {}
+    for ref, _size, cores, name in list(_code_lru.values()):
+        wrapper = ref()
+        if wrapper is None:
+            continue
+        entry = functions.setdefault(getattr(wrapper, "__qualname__", name), collections.Counter())
+        for core in cores:
+            entry.update(core.get_memory_usage()["functions"].get(name, {}))
+    usage["functions"] = {name: dict(entry) for name, entry in functions.items()}
+    usage["inline_c"] = _global_c_compiler.get_memory_usage() if _global_c_compiler is not None else {}
+    return usage
+
+
+_cache_backend = None
+
+
+def set_cache_backend(backend):
+    """
+    Share compiled objects through a remote store (Redis, S3, ...).
+
+    ``backend`` has ``get(key)``, returning the stored bytes or None, and
+    ``put(key, data)``. Objects missing from the cache directory are asked of
+    the backend before compiling, and new ones are put there after each
+    compile. Keys include the JustJIT version on top of the LLVM version and
+    target the local cache keys already carry, and every value starts with a
+    SHA-256 of its object: an entry that fails the check, or a backend that
+    raises, only costs a compile. None disconnects the backend.
+    """
+    global _cache_backend
+    _flush_cache_uploads()
+    _cache_backend = backend
+    _set_cache_remote(None if backend is None else _fetch_cached_object)
+
+
+def _cache_backend_key(key):
+    return f"justjit-{__version__}/{key}"
+
+
+def _fetch_cached_object(key):
+    backend = _cache_backend
+    if backend is None:
+        return None
+    try:
+        data = backend.get(_cache_backend_key(key))
+    except Exception:
+        return None
+    if not data or len(data) < 32:
+        return None
+    data = bytes(data)
+    digest, payload = data[:32], data[32:]
+    return payload if hashlib.sha256(payload).digest() == digest else None
+
+
+def _flush_cache_uploads():
+    """Put the objects compiled since the last flush into the remote backend."""
+    backend = _cache_backend
+    if backend is None:
+        return
+    for key, payload in _take_cache_uploads():
+        try:
+            backend.put(_cache_backend_key(key), hashlib.sha256(payload).digest() + payload)
+        except Exception:
+            pass  # Another process, or the next run, uploads it
+
+
+atexit.register(_flush_cache_uploads)
+
+
+# Wrappers unloaded while a call still ran their code, which stays mapped until it returns
+_unloads_pending = weakref.WeakSet()
+
+
+def _register_code(wrapper, cores, name):
+    """Record a wrapper's native code size and evict others if over the cap."""
+    for pending in list(_unloads_pending):
+        if pending is not wrapper:
+            pending._jit_free_retired()
+    key = id(wrapper)
+    size = sum(core.get_code_size(name) for core in cores)
+    ref = weakref.ref(wrapper, lambda _ref, key=key: _code_lru.pop(key, None))
+    _code_lru[key] = [ref, size, cores, name]
+    _code_lru.move_to_end(key, last=True)
+    _enforce_code_limit(keep=key)
+
+
+def _enforce_code_limit(keep=None):
+    if not _code_limit:
+        return
+    total = get_code_usage()
+    for key in list(_code_lru):
+        if total <= _code_limit:
+            break
+        if key == keep:
+            continue
+        ref, size = _code_lru[key][:2]
+        victim = ref()
+        if victim is not None and victim.unload(wait=False) is False:
+            continue  # Being compiled by another thread; evict it later
+        _code_lru.pop(key, None)
+        total -= size
+
+
+# Runtime statistics: @jit wrappers that count calls, and compile time per mode
+_stats_functions = weakref.WeakSet()
+_compile_times = collections.defaultdict(lambda: [0, 0.0])  # mode -> [compiles, seconds]
+
+
+def _record_compile(mode, seconds):
+    entry = _compile_times[mode]
+    entry[0] += 1
+    entry[1] += seconds
+
+
+def enable_stats(enabled=True):
+    """
+    Turn per-function runtime counters on or off (default: $JUSTJIT_STATS).
+
+    While on, every native call of a @jit function counts its call, the time
+    spent in native code and any deoptimization, and every call the wrapper
+    runs in the interpreter instead counts a fallback with its reason. The
+    counters are relaxed atomics; read them with stats().
+    """
+    _set_stats_enabled(bool(enabled))
+
+
+def reset_stats():
+    """Zero every function's counters and the compile times."""
+    for wrapper in list(_stats_functions):
+        wrapper._reset_stats()
+        wrapper._jit_fallbacks.clear()
+    _compile_times.clear()
+
+
+def stats(prometheus=False):
+    """
+    Runtime counters of every @jit function, and compile time by mode.
+
+    Returns a dict ``{"functions": {name: {...}}, "compile": {mode: {...}}}``.
+    Each function entry has ``mode``, ``calls``, ``native_seconds``,
+    ``deopts``, ``deopt_types`` (exception type name -> count) and
+    ``fallbacks`` (reason -> calls run in the interpreter). Functions are
+    named ``module.qualname``; redefinitions add up. Calls are only counted
+    while enable_stats() is on, compile times always.
+
+    With ``prometheus=True`` the same numbers are returned as Prometheus text
+    exposition format instead.
+    """
+    functions = {}
+    for wrapper in list(_stats_functions):
+        func = wrapper._original_func
+        name = f"{func.__module__}.{func.__qualname__}"
+        calls, native_seconds, deopts, deopt_types = wrapper._stats()
+        entry = functions.setdefault(
+            name,
+            {"mode": wrapper._mode, "calls": 0, "native_seconds": 0.0, "deopts": 0, "deopt_types": {}, "fallbacks": {}},
+        )
+        entry["calls"] += calls
+        entry["native_seconds"] += native_seconds
+        entry["deopts"] += deopts
+        for counts, more in ((entry["deopt_types"], deopt_types), (entry["fallbacks"], wrapper._jit_fallbacks)):
+            for key, count in more.items():
+                counts[key] = counts.get(key, 0) + count
+    compile_times = {mode: {"count": count, "seconds": seconds} for mode, (count, seconds) in _compile_times.items()}
+    if not prometheus:
+        return {"functions": functions, "compile": compile_times}
+
+    def labels(**values):
+        # Label values escape backslash, double quote and newline
+        escaped = (
+            key + '="' + str(value).replace("\\", "\\\\").replace('"', '\\"').replace("\n", "\\n") + '"'
+            for key, value in values.items()
+        )
+        return "{" + ",".join(escaped) + "}"
+
+    lines = []
+
+    def metric(name, kind, help_text, samples):
+        lines.append(f"# HELP {name} {help_text}")
+        lines.append(f"# TYPE {name} {kind}")
+        lines.extend(f"{name}{labels(**sample_labels)} {value}" for sample_labels, value in samples)
+
+    rows = sorted(functions.items())
+    metric("justjit_calls_total", "counter", "Native calls of a @jit function.",
+           [({"function": name, "mode": f["mode"]}, f["calls"]) for name, f in rows])
+    metric("justjit_native_seconds_total", "counter", "Seconds spent in a @jit function's native code.",
+           [({"function": name, "mode": f["mode"]}, repr(f["native_seconds"])) for name, f in rows])
+    metric("justjit_deopts_total", "counter", "Native calls rerun in the interpreter, by exception type.",
+           [({"function": name, "mode": f["mode"], "exception": exc}, count)
+            for name, f in rows for exc, count in sorted(f["deopt_types"].items())])
+    metric("justjit_fallbacks_total", "counter", "Calls the wrapper ran in the interpreter, by reason.",
+           [({"function": name, "mode": f["mode"], "reason": reason}, count)
+            for name, f in rows for reason, count in sorted(f["fallbacks"].items())])
+    metric("justjit_compiles_total", "counter", "Compilations by mode.",
+           [({"mode": mode}, c["count"]) for mode, c in sorted(compile_times.items())])
+    metric("justjit_compile_seconds_total", "counter", "Seconds spent compiling, by mode.",
+           [({"mode": mode}, repr(c["seconds"])) for mode, c in sorted(compile_times.items())])
+    return "\n".join(lines) + "\n"
+
+
+_COMPILE_PHASES = ("decode", "build_cfg", "stack_depths", "codegen", "verify", "optimize", "add_module", "materialize")
+
+
+def compile_report(file=None):
+    """
+    Where compile time went, per @jit function, slowest first.
+
+    Each function's ``_jit_compile_stats`` holds the seconds spent in every
+    phase of its last compile (decode, build_cfg, stack_depths, codegen,
+    verify, optimize, add_module, materialize), their ``total``, the
+    ``wall`` time the wrapper saw, the module's IR instruction count before
+    and after optimization and the machine-code bytes. This prints one row
+    per compiled function (to ``file``, default stdout) and returns the rows
+    as ``(name, stats)`` pairs.
+    """
+    rows = []
+    for wrapper in list(_stats_functions):
+        compile_stats = getattr(wrapper, "_jit_compile_stats", None)
+        if compile_stats:
+            func = wrapper._original_func
+            rows.append((f"{func.__module__}.{func.__qualname__}", compile_stats))
+    rows.sort(key=lambda row: row[1]["total"], reverse=True)
+    header = ["function", "total_ms"] + [phase + "_ms" for phase in _COMPILE_PHASES] + ["ir_before", "ir_after", "shared_slow", "cold_ir", "code_bytes"]
+    print("\t".join(header), file=file)
+    for name, compile_stats in rows:
+        cells = [name] + [f"{compile_stats[key] * 1000:.3f}" for key in ("total",) + _COMPILE_PHASES]
+        cells += [str(compile_stats[key]) for key in ("ir_instructions_before", "ir_instructions_after",
+                                                        "shared_slow_paths", "cold_instructions", "code_bytes")]
+        print("\t".join(cells), file=file)
+    return rows
+
+
+# Why functions did not get native code: one record per rejection, oldest first
+_rejections = []
+
+
+def _record_rejection(func, mode, reason, opcode=None, offset=None):
+    """Note that ``func`` was not compiled in ``mode``; ``opcode`` is a name or number."""
+    if isinstance(opcode, int):
+        opcode = dis.opname[opcode] if 0 <= opcode < len(dis.opname) else None
+    _rejections.append(
+        {
+            "function": f"{func.__module__}.{func.__qualname__}",
+            "mode": mode,
+            "reason": reason,
+            "opcode": opcode,
+            "offset": offset if offset is not None and offset >= 0 else None,
+        }
+    )
+
+
+def _take_rejection(core, func, mode, failed):
+    """Record why ``core``'s last compile gave up, or a generic reason if it failed without one."""
+    rejection = core.take_rejection()
+    if rejection is not None:
+        _record_rejection(func, *rejection)
+    elif failed:
+        _record_rejection(func, mode, "compile failed")
+
+
+def _record_compile_error(func, mode, error):
+    """Record a compile that raised before its caller falls back (worker thread, tier-up, OSR, specialization)."""
+    _record_rejection(func, mode, f"compile raised {type(error).__name__}: {error}")
+
+
+def report(file=None, clear=False):
+    """
+    Which functions and opcodes kept code out of native modes, process-wide.
+
+    Every rejection is recorded: opcodes the decorator or the generator
+    compiler refuses, typed compilers (int, float, bool, native) giving up on
+    an instruction, compiles that failed without a reason, and compiles that
+    raised (including background, tier-up, OSR and specialized ones). Returns
+    ``{"opcodes": {opname: {"count", "modes", "functions"}}, "reasons":
+    {reason: count}, "rejections": [...]}`` with opcodes ordered by how many
+    rejections they caused, so the first entries are the opcodes whose
+    support would unlock the most native code. Each rejection has
+    ``function``, ``mode``, ``reason``, ``opcode`` and ``offset`` (None when
+    not tied to one instruction). Also prints the opcode table (to ``file``,
+    default stdout); ``clear=True`` forgets the records afterwards.
+    """
+    opcodes = {}
+    reasons = {}
+    for rejection in _rejections:
+        reasons[rejection["reason"]] = reasons.get(rejection["reason"], 0) + 1
+        if rejection["opcode"] is None:
+            continue
+        entry = opcodes.setdefault(rejection["opcode"], {"count": 0, "modes": {}, "functions": []})
+        entry["count"] += 1
+        entry["modes"][rejection["mode"]] = entry["modes"].get(rejection["mode"], 0) + 1
+        if rejection["function"] not in entry["functions"]:
+            entry["functions"].append(rejection["function"])
+    opcodes = dict(sorted(opcodes.items(), key=lambda item: (-item[1]["count"], item[0])))
+    print("opcode\tcount\tmodes\tfunctions", file=file)
+    for opname, entry in opcodes.items():
+        modes = ",".join(f"{mode}:{count}" for mode, count in sorted(entry["modes"].items()))
+        print(f"{opname}\t{entry['count']}\t{modes}\t{','.join(entry['functions'])}", file=file)
+    result = {"opcodes": opcodes, "reasons": reasons, "rejections": list(_rejections)}
+    if clear:
+        _rejections.clear()
+    return result
+
+
+# Background compilation worker (lazy initialized, shared by async_compile and tiered wrappers)
+_compile_executor = None
+
+
+def _get_compile_executor():
+    """Return the single background thread used for async_compile."""
+    global _compile_executor
+    if _compile_executor is None:
+        import concurrent.futures
+
+        _compile_executor = concurrent.futures.ThreadPoolExecutor(
+            max_workers=1, thread_name_prefix="justjit-compile"
+        )
+    return _compile_executor
+
+
+def precompile_all():
+    """
+    Compile every @jit function now, at its top tier, including cold and
+    lazy ones, and wait for background compiles. Returns how many have
+    native code. Call it in a pre-fork server's parent: forked workers then
+    share the compiled code pages copy-on-write instead of each compiling
+    (and storing) its own copy.
+    """
+    return sum(1 for wrapper in _callees_first(list(_stats_functions)) if wrapper._jit_precompile())
+
+
+def _callees_first(wrappers):
+    """``wrappers`` reordered so each comes after the ones it calls through a global."""
+    by_id = {id(wrapper): wrapper for wrapper in wrappers}
+    ordered = []
+    seen = set()
+
+    def visit(wrapper):
+        if id(wrapper) in seen:
+            return
+        seen.add(id(wrapper))
+        func = wrapper._original_func
+        for name in func.__code__.co_names:
+            callee = by_id.get(id(func.__globals__.get(name)))
+            if callee is not None:
+                visit(callee)
+        ordered.append(wrapper)
+
+    for wrapper in wrappers:
+        visit(wrapper)
+    return ordered
+
+
+def compile_many(funcs, lazy=False):
+    """
+    Compile the @jit functions ``funcs`` now, each after the ones it calls.
+    Typed callers (int, float, native mode) then call typed callees directly,
+    and small callees are inlined into their callers. Returns how many have
+    native code; other objects in ``funcs`` are skipped.
+
+    ``lazy=True`` only lowers each function to IR now: it is optimized and
+    compiled to machine code on its first call, through a stub, so functions
+    a process never calls cost no more than their lowering.
+    """
+    wrappers = [func for func in funcs if hasattr(func, "_jit_precompile")]
+    return sum(1 for wrapper in _callees_first(wrappers) if wrapper._jit_precompile(lazy))
+
+
+def warmup(funcs=None, parallel=True):
+    """
+    Compile the @jit functions ``funcs`` (default: every one created so far)
+    that have no native code yet, and wait for them, so no later call pays
+    for compiling. Each compiles after the ones it calls, as in
+    compile_many(); with ``parallel``, functions that do not call each other
+    compile on a thread pool at once (LLVM runs without the GIL). Natively
+    typed code is also written to the cache directory (see set_cache_dir()),
+    so later processes load it instead. Returns how many have native code.
+    """
+    wrappers = list(_stats_functions) if funcs is None else [func for func in funcs if hasattr(func, "_jit_precompile")]
+    ordered = _callees_first(wrappers)
+    if not parallel or len(ordered) < 2:
+        return sum(1 for wrapper in ordered if wrapper._jit_precompile())
+    import concurrent.futures
+
+    # Level n only calls functions of lower levels, which have native addresses by then
+    by_id = {id(wrapper): wrapper for wrapper in ordered}
+    levels, groups = {}, []
+    for wrapper in ordered:
+        func = wrapper._original_func
+        callees = (by_id.get(id(func.__globals__.get(name))) for name in func.__code__.co_names)
+        level = 1 + max((levels[id(callee)] for callee in callees if callee is not None and id(callee) in levels), default=-1)
+        levels[id(wrapper)] = level
+        if level == len(groups):
+            groups.append([])
+        groups[level].append(wrapper)
+    compiled = 0
+    with concurrent.futures.ThreadPoolExecutor(
+        max_workers=min(len(ordered), os.cpu_count() or 1), thread_name_prefix="justjit-warmup"
+    ) as pool:
+        for group in groups:
+            compiled += sum(pool.map(lambda wrapper: bool(wrapper._jit_precompile()), group))
+    return compiled
+
+
+def _reduce_jit_function(wrapper):
+    """
+    Pickle a @jit function like a plain one: by module and qualified name when
+    that finds it, else by value with its jit() options. Typed native code
+    travels along as a relocatable object (see aot.export_function), which the
+    receiving process links instead of compiling when its CPU matches.
+    """
+    func = getattr(wrapper, "_jit_source", None)
+    if func is None:
+        raise TypeError(f"cannot pickle {wrapper!r}: not a @jit function")
+    export = wrapper._jit_export()
+    target = sys.modules.get(func.__module__)
+    for part in func.__qualname__.split("."):
+        target = getattr(target, part, None)
+    if target is wrapper:
+        return _restore_jit_function, (func.__module__, func.__qualname__, export)
+    return _rebuild_jit_function, (func, wrapper._jit_options, export)
+
+
+def _restore_jit_function(module, qualname, export):
+    import importlib
+
+    wrapper = importlib.import_module(module)
+    for part in qualname.split("."):
+        wrapper = getattr(wrapper, part)
+    if export is not None and hasattr(wrapper, "_jit_install"):
+        wrapper._jit_install(*export)
+    return wrapper
+
+
+def _rebuild_jit_function(func, options, export):
+    wrapper = jit(func, **options)
+    if export is not None and hasattr(wrapper, "_jit_install"):
+        wrapper._jit_install(*export)
+    return wrapper
+
+
+copyreg.pickle(JITFunction, _reduce_jit_function)
+
+
+def jit_module(module, **options):
+    """
+    Apply @jit (with ``options``) to every function defined in ``module`` (a
+    module or its name), rebind the module's globals to the wrappers, and
+    compile them together with compile_many(lazy=True): each is lowered now
+    and optimized on its first call. Returns the wrappers by name.
+    """
+    if isinstance(module, str):
+        module = sys.modules[module]
+    wrappers = {}
+    for name, value in list(vars(module).items()):
+        if isinstance(value, types.FunctionType) and value.__module__ == module.__name__:
+            wrapper = jit(value, **options)
+            if wrapper is not value:
+                setattr(module, name, wrapper)
+                wrappers[name] = wrapper
+    compile_many(wrappers.values(), lazy=True)
+    return wrappers
+
+
+def _jit_class(cls, decorate):
+    """@jit on a class: ``decorate`` its methods, static methods and class methods."""
+    for name, member in list(vars(cls).items()):
+        if isinstance(member, (staticmethod, classmethod)) and isinstance(member.__func__, types.FunctionType):
+            setattr(cls, name, type(member)(decorate(member.__func__)))
+        elif isinstance(member, types.FunctionType):
+            setattr(cls, name, decorate(member))
+    return cls
+
+
+def _before_fork():
+    # Queued compiles finish in the parent: the child has no compile thread to run them
+    executor = _compile_executor
+    if executor is not None and not threading.current_thread().name.startswith("justjit-compile"):
+        executor.submit(int).result()
+
+
+def _after_fork_in_child():
+    global _compile_executor
+    _compile_executor = None  # Its worker thread stayed in the parent
+
+
+if hasattr(os, "register_at_fork"):
+    os.register_at_fork(before=_before_fork, after_in_child=_after_fork_in_child)
+
+
+# On-stack replacement: interpreted calls of osr=True functions report jumps
+# through sys.monitoring (code object -> the wrapper's handler)
+_osr_handlers = {}
+_osr_tool = None
+
+
+class _OSRTransfer(BaseException):
+    """Raised out of a frame at a hot loop header; carries its native entry and locals."""
+
+    def __init__(self, entry, values):
+        super().__init__()
+        self.entry = entry
+        self.values = values
+
+
+def _osr_run(func, args, kwargs):
+    """Run ``func`` in the interpreter; a hot loop may finish the call natively."""
+    try:
+        return func(*args, **kwargs)
+    except _OSRTransfer as transfer:
+        return transfer.entry(*transfer.values)
+
+
+def _osr_jump(code, instruction_offset, destination_offset):
+    handler = _osr_handlers.get(code)
+    if handler is None or destination_offset > instruction_offset:
+        return sys.monitoring.DISABLE  # Forward jumps never reach a loop header
+    frame = sys._getframe(1)
+    # Only frames started by _osr_run have someone to catch the transfer
+    if frame.f_code is not code or frame.f_back is None or frame.f_back.f_code is not _osr_run.__code__:
+        return None
+    return handler(frame, destination_offset)
+
+
+def _osr_headers(func):
+    """Loop headers an interpreted call of ``func`` can leave at (empty set if none)."""
+    code = func.__code__
+    if not hasattr(sys, "monitoring") or code.co_exceptiontable or code.co_cellvars or code.co_freevars:
+        # The transfer unwinds the frame, which must not run handlers; cells have no native slots
+        return set()
+    instructions = list(dis.get_instructions(func))
+    for_iter = {instr.offset for instr in instructions if instr.opname == "FOR_ITER"}
+    # A for loop keeps its iterator on the value stack, which frames do not expose
+    return {
+        instr.argval
+        for instr in instructions
+        if instr.opname == "JUMP_BACKWARD" and instr.argval not in for_iter
+    }
+
+
+# Deoptimization with frame reconstruction: an int-mode guard that fails
+# records the interpreter state at its instruction (locals, and the value
+# stack with for-loop iterators rebuilt), and the call continues in a copy of
+# the function's code that takes those as arguments, pushes the stack values
+# and jumps to the instruction. States the copy can't express rerun the call.
+_NO_FALLTHROUGH = {
+    "RETURN_VALUE", "RETURN_CONST", "RAISE_VARARGS", "RERAISE",
+    "JUMP_FORWARD", "JUMP_BACKWARD", "JUMP_BACKWARD_NO_INTERRUPT",
+}
+_NO_LOCATION = 0x80 | (15 << 3)  # Location table entry with no position; low bits are length - 1
+
+
+def _stack_depths(code):
+    """Value stack depth before each reachable instruction of ``code``, by offset."""
+    instructions = list(dis.get_instructions(code))
+    index = {instr.offset: k for k, instr in enumerate(instructions)}
+    depths = {}
+    pending = [(0, 0)]
+    while pending:
+        k, depth = pending.pop()
+        while k < len(instructions) and instructions[k].offset not in depths:
+            instr = instructions[k]
+            depths[instr.offset] = depth
+            arg = instr.arg if instr.opcode >= dis.HAVE_ARGUMENT else None
+            if instr.jump_target is not None:
+                pending.append((index[instr.jump_target], depth + dis.stack_effect(instr.opcode, arg, jump=True)))
+            if instr.opname in _NO_FALLTHROUGH:
+                break
+            depth += dis.stack_effect(instr.opcode, arg, jump=False)
+            k += 1
+    return depths
+
+
+def _resume_code(code, offset, stack_size):
+    """
+    Copy of ``code`` taking its locals and then ``stack_size`` stack values
+    as positional arguments and continuing at ``offset``, or None when the
+    interpreter's stack there doesn't have ``stack_size`` values.
+
+    A prologue (RESUME, a LOAD_FAST per stack value, JUMP_FORWARD) goes in
+    front of the unchanged bytecode: jumps are relative, so only the location
+    table needs entries for it.
+    """
+    if (
+        code.co_cellvars
+        or code.co_freevars
+        or code.co_exceptiontable
+        or code.co_flags & (_CO_GENERATOR | _CO_COROUTINE | _CO_ASYNC_GENERATOR)
+        or _stack_depths(code).get(offset) != stack_size
+    ):
+        return None
+    nlocals = len(code.co_varnames)
+    prologue = bytearray()
+
+    def emit(opname, arg=0):
+        for shift in (24, 16, 8):
+            if arg >> shift:
+                prologue.extend((dis.opmap["EXTENDED_ARG"], (arg >> shift) & 0xFF))
+        prologue.extend((dis.opmap[opname], arg & 0xFF))
+
+    emit("RESUME")
+    for slot in range(stack_size):
+        emit("LOAD_FAST", nlocals + slot)
+    emit("JUMP_FORWARD", offset // 2)  # The original code starts right after the jump
+    locations = bytearray()
+    units = len(prologue) // 2
+    while units:
+        length = min(units, 8)
+        locations.append(_NO_LOCATION | (length - 1))
+        units -= length
+    names = code.co_varnames + tuple(f".stack{slot}" for slot in range(stack_size))
+    return code.replace(
+        co_code=bytes(prologue) + code.co_code,
+        co_linetable=bytes(locations) + code.co_linetable,
+        co_varnames=names,
+        co_nlocals=len(names),
+        co_argcount=len(names),
+        co_posonlyargcount=0,
+        co_kwonlyargcount=0,
+        co_flags=code.co_flags & ~(_CO_VARARGS | _CO_VARKEYWORDS),
+    )
+
+
+def _deopt_resumer(func, fallback):
+    """
+    ``resume(frame_state, *args, **kwargs)`` for JITFunction._set_resume:
+    continues a deoptimized call of ``func`` from the ``(offset, locals,
+    stack)`` its kernel recorded, or calls ``fallback`` with the arguments.
+    """
+    code = func.__code__
+    nlocals = len(code.co_varnames)
+    resumed = {}  # (offset, stack size) -> function, or None if not resumable
+
+    def resume(frame_state, *args, **kwargs):
+        offset, values, stack = frame_state
+        key = (offset, len(stack))
+        if key not in resumed:
+            resume_code = _resume_code(code, offset, len(stack)) if len(values) >= nlocals else None
+            resumed[key] = resume_code and types.FunctionType(resume_code, func.__globals__, func.__name__)
+        target = resumed[key]
+        if target is None:
+            return fallback(*args, **kwargs)
+        return target(*values[:nlocals], *stack)
+
+    return resume
+
+
+def _prange_loops(func):
+    """FOR_ITER offsets of the ``for ... in prange(...)`` loops of ``func``."""
+    instructions = [instr for instr in dis.get_instructions(func) if instr.opname != "CACHE"]
+    builtins_dict = _extract_builtins(func)
+
+    def resolve(instr):
+        if instr.opname != "LOAD_GLOBAL":
+            return None
+        return func.__globals__.get(instr.argval, builtins_dict.get(instr.argval))
+
+    offsets = []
+    for idx, instr in enumerate(instructions):
+        if (
+            instr.opname != "FOR_ITER"
+            or idx < 3
+            or instructions[idx - 1].opname != "GET_ITER"
+            or instructions[idx - 2].opname != "CALL"
+        ):
+            continue
+        # Walk back over the call's arguments to the instruction that pushed the callable
+        argc = instructions[idx - 2].arg
+        depth = 0
+        k = idx - 3
+        while k >= 0:
+            load = instructions[k]
+            depth += dis.stack_effect(load.opcode, load.arg if load.opcode >= dis.HAVE_ARGUMENT else None)
+            if depth > argc:
+                break
+            k -= 1
+        if k < 0:
+            continue
+        load = instructions[k]
+        if load.opname == "LOAD_ATTR" and k > 0:
+            # justjit.prange(...)
+            target = getattr(resolve(instructions[k - 1]), load.argval, None)
+        else:
+            target = resolve(load)
+        if target is prange:
+            offsets.append(instr.offset)
+    return offsets
+
+
+def _module_calls(func, module, aliases=()):
+    """{CALL offset: (function name, offsets of the callable's loads)} for ``func``'s calls into ``module``.
+
+    ``aliases`` pairs other callables with the name their calls map to.
+    """
+    instructions = [instr for instr in dis.get_instructions(func) if instr.opname != "CACHE"]
+    builtins_dict = _extract_builtins(func)
+
+    calls = {}
+    for idx, instr in enumerate(instructions):
+        if instr.opname != "CALL":
+            continue
+        # Walk back over the arguments to the instruction that pushed the callable
+        depth = 0
+        k = idx - 1
+        while k >= 0:
+            load = instructions[k]
+            depth += dis.stack_effect(load.opcode, load.arg if load.opcode >= dis.HAVE_ARGUMENT else None)
+            if depth > instr.arg:
+                break
+            k -= 1
+        loads = []
+        if k > 0 and instructions[k].opname == "PUSH_NULL":
+            loads.append(instructions[k].offset)
+            k -= 1  # A module attribute is loaded, then the NULL pushed
+        # simd.hsum(...), justjit.simd.hsum(...) or an imported hsum(...)
+        attrs = []
+        while k > 0 and instructions[k].opname == "LOAD_ATTR":
+            attrs.append(instructions[k].argval)
+            loads.append(instructions[k].offset)
+            k -= 1
+        if k < 0 or instructions[k].opname != "LOAD_GLOBAL":
+            continue
+        loads.append(instructions[k].offset)
+        name = instructions[k].argval
+        target = func.__globals__.get(name, builtins_dict.get(name))
+        for attr in reversed(attrs):
+            target = getattr(target, attr, None)
+        if getattr(target, "__module__", None) == module.__name__ and target.__name__ in module.__all__:
+            calls[instr.offset] = (target.__name__, loads)
+        for alias_target, alias in aliases:
+            if target is alias_target:
+                calls[instr.offset] = (alias, loads)
+    return calls
+
+
+def _simd_calls(func):
+    """{CALL offset: operation} for the ``justjit.simd`` calls of ``func``; builtin min/max of two are minimum/maximum."""
+    aliases = ((min, "minimum"), (max, "maximum"))
+    return {offset: operation for offset, (operation, _loads) in _module_calls(func, simd, aliases).items()}
+
+
+# int methods int and int32 mode lower like justjit.bits operations
+_BIT_METHODS = ("bit_count", "bit_length")
+
+
+def _bits_calls(func, offsets=None):
+    """{offset: operation} for the ``justjit.bits`` calls and ``x.bit_count()`` / ``x.bit_length()`` of ``func``.
+
+    Every instruction of a call maps to its operation: the callable's loads,
+    which push nothing in int mode, and the CALL. ``offsets`` is the offset
+    map of ``_inline_reductions``, if it rewrote the bytecode.
+    """
+    calls = {}
+    for offset, (operation, loads) in _module_calls(func, bits).items():
+        for load in loads:
+            calls[load] = operation
+        calls[offset] = operation
+    instructions = [instr for instr in dis.get_instructions(func) if instr.opname != "CACHE"]
+    for method, instr in zip(instructions, instructions[1:]):
+        if (instr.opname == "CALL" and instr.arg == 0 and method.opname == "LOAD_ATTR" and method.arg & 1
+                and method.argval in _BIT_METHODS):
+            calls[method.offset] = calls[instr.offset] = method.argval
+    if offsets is not None:
+        calls = {offsets[offset]: operation for offset, operation in calls.items() if offset in offsets}
+    return calls
+
+
+# Builtin exceptions int and float mode raise without leaving native code
+_NATIVE_EXCEPTIONS = (
+    "ArithmeticError", "AssertionError", "IndexError", "KeyError", "LookupError", "NotImplementedError",
+    "OverflowError", "RuntimeError", "TypeError", "ValueError", "ZeroDivisionError",
+)
+
+
+def _raise_sites(func, offsets=None):
+    """{offset: "Name:message"} for the ``raise Name``, ``raise Name("message")`` and ``assert`` statements of ``func``.
+
+    Name is one of ``_NATIVE_EXCEPTIONS``, not shadowed by a global, and the
+    message a constant string (empty without one). Every instruction from the
+    exception's load to the RAISE_VARARGS maps to the statement's entry.
+    ``offsets`` is the offset map of ``_inline_reductions``, if it rewrote the
+    bytecode.
+    """
+    instructions = [instr for instr in dis.get_instructions(func) if instr.opname != "CACHE"]
+    builtins_dict = _extract_builtins(func)
+
+    sites = {}
+    for idx, instr in enumerate(instructions):
+        if instr.opname != "RAISE_VARARGS" or instr.arg != 1:
+            continue
+        k = idx - 1
+        call = instructions[k] if instructions[k].opname == "CALL" else None
+        message = None
+        if call is not None:
+            k -= 1
+            if instructions[k].opname == "LOAD_CONST" and isinstance(instructions[k].argval, str):
+                message = instructions[k].argval
+                k -= 1
+        load = instructions[k]
+        if load.opname == "LOAD_ASSERTION_ERROR":
+            # assert cond, "message" calls AssertionError with no arguments after loading the message
+            name = "AssertionError"
+            if call is not None and (message is None or call.arg != 0):
+                continue
+        elif load.opname == "LOAD_GLOBAL":
+            name = load.argval
+            if name not in _NATIVE_EXCEPTIONS or func.__globals__.get(name, builtins_dict.get(name)) is not builtins_dict[name]:
+                continue
+            # raise Name, or raise Name() / Name("message") with the NULL under the callable
+            if (call is None) == bool(load.arg & 1) or (call is not None and call.arg != (message is not None)):
+                continue
+        else:
+            continue
+        site = name + ":" + (message or "")
+        for covered in instructions[k:idx + 1]:
+            sites[covered.offset] = site
+    if offsets is not None:
+        sites = {offsets[offset]: site for offset, site in sites.items() if offset in offsets}
+    return sites
+
+
+def _osr_watch(code, handler):
+    """Report the backward jumps of ``code`` to ``handler``; False if the monitoring tool is taken."""
+    global _osr_tool
+    monitoring = sys.monitoring
+    if _osr_tool is None:
+        if monitoring.get_tool(monitoring.OPTIMIZER_ID) is not None:
+            return False
+        monitoring.use_tool_id(monitoring.OPTIMIZER_ID, "justjit")
+        monitoring.register_callback(monitoring.OPTIMIZER_ID, monitoring.events.JUMP, _osr_jump)
+        _osr_tool = monitoring.OPTIMIZER_ID
+    _osr_handlers[code] = handler
+    monitoring.set_local_events(_osr_tool, code, monitoring.events.JUMP)
+    return True
 
 
 def _extract_bytecode(func):
-    """Extract bytecode instructions from a Python function."""
+    """Extract bytecode instructions from a Python function.
+
+    Returns a packed bytes object with 4 native int32 fields per instruction
+    (opcode, arg, argval, offset), decoded by JITCore without per-field casts.
+    """
     # Opcodes that use argval as a jump target (offset)
     JUMP_OPCODES = {
         "POP_JUMP_IF_FALSE",
@@ -161,7 +1718,7 @@ def _extract_bytecode(func):
         "SEND",  # SEND jumps to target when sub-iterator returns
     }
 
-    instructions = []
+    packed = array.array("i")
     for instr in dis.get_instructions(func):
         # Skip CACHE instructions - they're just placeholders for the adaptive interpreter
         if instr.opname == "CACHE":
@@ -177,15 +1734,15 @@ def _extract_bytecode(func):
         # For all other opcodes (LOAD_CONST, RETURN_CONST, etc), argval stays 0
         # We use instr.arg as the index into constants/names/locals
 
-        instructions.append(
-            {
-                "opcode": instr.opcode,
-                "arg": instr.arg if instr.arg is not None else 0,
-                "argval": argval,
-                "offset": instr.offset,
-            }
+        packed.extend(
+            (
+                instr.opcode,
+                instr.arg if instr.arg is not None else 0,
+                argval,
+                instr.offset,
+            )
         )
-    return instructions
+    return packed.tobytes()
 
 
 def _extract_constants(func):
@@ -227,149 +1784,1169 @@ def _extract_closure(func):
     return []
 
 
-def _parse_exception_table(func):
-    """Parse Python 3.11+ exception table from code object.
+# Object-mode code of closures, compiled once per code object: (code object,
+# globals id, compile options) -> core compiled with set_closure_argument. Each
+# closure's JITFunction passes its own __closure__ to the shared entry.
+_shared_closure_cores = {}
+_shared_closure_lock = threading.Lock()
+
+
+# Wrappers currently resolving their direct callees (breaks mutual recursion)
+_native_resolving = set()
+
+# math functions float mode calls natively, with their argument counts
+# (kept in sync with JITCore::emit_math_call; fma is new in Python 3.13)
+_MATH_NATIVE = {
+    name: argc
+    for name, argc in {
+        "sqrt": 1, "exp": 1, "exp2": 1, "expm1": 1, "log": 1, "log2": 1, "log10": 1,
+        "log1p": 1, "sin": 1, "cos": 1, "tan": 1, "asin": 1, "acos": 1, "atan": 1,
+        "sinh": 1, "cosh": 1, "tanh": 1, "asinh": 1, "acosh": 1, "atanh": 1,
+        "cbrt": 1, "erf": 1, "erfc": 1, "fabs": 1, "floor": 1, "ceil": 1, "trunc": 1,
+        "pow": 2, "atan2": 2, "hypot": 2, "copysign": 2, "fmod": 2, "fma": 3,
+    }.items()
+    if hasattr(math, name)
+}
+
+
+def _math_callees(func):
+    """Find ``math.<name>`` and ``from math import <name>`` calls float mode lowers natively.
+
+    Returns the extra ``_native_callees`` tuples: the module or function is
+    the guard's expected binding, followed by the math function name and the
+    co_names index of the attribute (-1 for an imported function).
+    """
+    code = func.__code__
+    callees = []
+    for idx, name in enumerate(code.co_names):
+        target = func.__globals__.get(name)
+        if target is math:
+            for attr_idx, attr in enumerate(code.co_names):
+                if attr in _MATH_NATIVE:
+                    callees.append((idx, name, math, 0, _MATH_NATIVE[attr], attr, attr_idx))
+        else:
+            for math_name, argc in _MATH_NATIVE.items():
+                if target is getattr(math, math_name):
+                    callees.append((idx, name, target, 0, argc, math_name, -1))
+                    break
+    return callees
+
+
+# Generator each typed mode draws from natively: (function, argument count, runtime helper)
+_RANDOM_NATIVE = {"float": (random, 0, "jit_random_f64"), "int": (randint, 2, "jit_random_int")}
+
 
-    Returns a list of dicts with keys:
-    - start: start offset of protected range
-    - end: end offset of protected range
-    - target: handler offset (PUSH_EXC_INFO location)
-    - depth: stack depth to unwind to
-    - lasti: whether to push last instruction offset
+def _random_callees(func, mode):
+    """Find ``justjit.random()`` (float mode) and ``justjit.randint(a, b)`` (int mode) calls.
+
+    Like prange(), the binding is resolved here, when the function compiles;
+    the entries have the ``_math_callees`` layout with the helper as the
+    math function.
     """
-    table = func.__code__.co_exceptiontable
-    if not table:
+    if mode not in _RANDOM_NATIVE:
         return []
+    target_func, argc, helper = _RANDOM_NATIVE[mode]
+    module = sys.modules[__name__]
+    code = func.__code__
+    callees = []
+    for idx, name in enumerate(code.co_names):
+        target = func.__globals__.get(name)
+        if target is module:
+            for attr_idx, attr in enumerate(code.co_names):
+                if attr == target_func.__name__:
+                    callees.append((idx, name, module, 0, argc, helper, attr_idx))
+        elif target is target_func:
+            callees.append((idx, name, target, 0, argc, helper, -1))
+    return callees
 
-    def read_varint(data, pos):
-        """Read a variable-length integer from exception table.
-        
-        Python 3.11+ uses a big-endian varint format:
-        - Bit 6 (0x40) is the continuation flag
-        - Bits 0-5 (0x3F) are the value bits
-        - Values are built from high bits to low bits
-        """
-        b = data[pos]
-        pos += 1
-        val = b & 0x3F
-        while b & 0x40:
-            val <<= 6
-            b = data[pos]
-            pos += 1
-            val |= b & 0x3F
-        return val, pos
-
-    entries = []
+
+def _returned_tuple_size(func):
+    """n when every return of ``func`` is an n-tuple (``return a, b`` or ``return 0, 0``), else 1.
+
+    Mirrors returned_tuple_size() in jit_core.cpp: int and float mode
+    kernels of such functions return a struct of n values.
+    """
+    sizes = set()
+    previous = None
+    for instr in dis.get_instructions(func):
+        if instr.opname == "CACHE":
+            continue
+        if instr.opname == "RETURN_VALUE":
+            tuple_built = previous is not None and previous.opname == "BUILD_TUPLE" and previous.arg >= 2
+            sizes.add(previous.arg if tuple_built else 1)
+        elif instr.opname == "RETURN_CONST":
+            constant = instr.argval
+            sizes.add(len(constant) if isinstance(constant, tuple) and len(constant) >= 2 else 1)
+        previous = instr
+    return sizes.pop() if len(sizes) == 1 else 1
+
+
+def _native_callees(func, wrapper, mode, helpers=None):
+    """Find globals of ``func`` that are @jit functions callable natively.
+
+    Only int/float/native mode calls between functions of the same mode are
+    direct; float mode also calls math functions directly (see ``_math_callees``),
+    and both draw random numbers natively (see ``_random_callees``).
+    Returns ``(co_names index, name, wrapper, address, param_count)`` tuples;
+    address 0 means ``func`` calling itself. Native-mode entries add the
+    callee's kernel signature, and callees without one (array, record or
+    None signatures) are left out. Int and float callees that return an
+    n-tuple add n (see ``_returned_tuple_size``). Each callee records ``wrapper`` as a
+    dependent so unloading the callee also unloads the caller.
+
+    ``inline_c`` functions with only numeric parameters and result are
+    callees too, through their typed entry (``__justjit_native__``): from
+    native mode with their signature, from int or float mode when every
+    kind is that mode's.
+
+    ``helpers`` (transitive=True, see ``_transitive_callees``) maps plain
+    functions to their wrappers: such a global is called through its
+    wrapper's native code, guarded on still naming the plain function.
+    """
+    if mode not in ("int", "float", "native"):
+        return []
+    code = func.__code__
+    callees = _math_callees(func) if mode == "float" else []
+    callees += _random_callees(func, mode)
+    _native_resolving.add(id(wrapper))
+    try:
+        for idx, name in enumerate(code.co_names):
+            if name == func.__name__:
+                # Direct calls pass positional arguments only
+                if _parameter_slots(code) == code.co_argcount:
+                    entry = (idx, name, wrapper, 0, code.co_argcount)
+                    results = _returned_tuple_size(func) if mode != "native" else 1
+                    callees.append(entry + ((results,) if results > 1 else ()))
+                continue
+            target = func.__globals__.get(name)
+            expected = target
+            if helpers and type(target) is types.FunctionType and target in helpers:
+                target = helpers[target]
+            native_c = getattr(target, "__justjit_native__", None) if type(target).__name__ == "JITCallable" else None
+            if native_c is not None:
+                address, signature = native_c
+                if mode == "native":
+                    callees.append((idx, name, target, address, len(signature) - 1, signature))
+                elif signature == ("q" if mode == "int" else "d") * len(signature):
+                    callees.append((idx, name, target, address, len(signature) - 1))
+                continue
+            if getattr(target, "_mode", None) != mode or not hasattr(target, "_native_address"):
+                continue
+            address = target._native_address()
+            if not address:
+                continue
+            target_code = target._original_func.__code__
+            if _parameter_slots(target_code) != target_code.co_argcount:
+                continue
+            entry = (idx, name, expected, address, target_code.co_argcount)
+            if mode == "native":
+                signature = target._jit_instance.native_signature(target._original_func.__name__)
+                if not signature:
+                    continue
+                entry += (signature,)
+            elif _returned_tuple_size(target._original_func) > 1:
+                entry += (_returned_tuple_size(target._original_func),)
+            target._jit_dependents.add(wrapper)
+            callees.append(entry)
+    finally:
+        _native_resolving.discard(id(wrapper))
+    return callees
+
+
+# transitive=True: (plain function, compile options) -> its lazily compiling
+# wrapper. Kept for the life of the process, like the callers' code using them.
+_transitive_wrappers = {}
+_transitive_lock = threading.Lock()
+
+
+def _transitive_callees(func, options):
+    """``{function: wrapper}`` for the plain Python functions ``func`` reads as globals.
+
+    Each is wrapped once per set of options with jit(lazy=True,
+    transitive=True, **options), so it compiles on its first call (or when
+    a typed caller asks for its native address) and its own helpers follow.
+    Generators, coroutines, this package's functions, and functions jit()
+    leaves uncompiled are skipped.
+    """
+    import warnings
+
+    package = __name__.partition(".")[0]
+    options_key = repr(sorted(options.items()))
+    callees = {}
+    for name in func.__code__.co_names:
+        target = func.__globals__.get(name)
+        if type(target) is not types.FunctionType or target is func or _is_generator_or_coroutine(target):
+            continue
+        if (target.__module__ or "").partition(".")[0] == package:
+            continue
+        key = (target, options_key)
+        with _transitive_lock:
+            helper = _transitive_wrappers.get(key)
+        if helper is None:
+            with warnings.catch_warnings():
+                # A helper jit() can't compile just stays interpreted
+                warnings.simplefilter("ignore", RuntimeWarning)
+                helper = jit(target, lazy=True, transitive=True, **options)
+            with _transitive_lock:
+                helper = _transitive_wrappers.setdefault(key, helper)
+        if helper is not target:
+            callees[target] = helper
+    return callees
+
+
+# C types of a typed-mode kernel's parameters and result, by kind: (ctypes name, C name)
+_C_TYPES = {
+    "q": ("c_longlong", "long long"),
+    "i": ("c_int", "int"),
+    "d": ("c_double", "double"),
+    "f": ("c_float", "float"),
+    "?": ("c_bool", "_Bool"),
+}
+_MODE_C_KINDS = {"int": "q", "float": "d", "bool": "q", "int32": "i", "float32": "f"}
+
+
+def _add_c_callbacks(wrapper, func, param_count, native_address):
+    """
+    Give a typed-mode wrapper address(), c_signature(), ctypes(), cffi() and
+    low_level_callable(): its kernel as a plain C function pointer for C code
+    that takes callbacks. Each compiles the function if it has not been yet.
+    """
+
+    def kernel():
+        if _returned_tuple_size(func) > 1:
+            raise TypeError(f"{func.__name__}() returns a tuple; it has no plain C signature")
+        address = native_address()
+        if not address:
+            raise RuntimeError(f"{func.__name__}() has no native code to take the address of")
+        if wrapper._mode == "native":
+            kinds = wrapper._jit_instance.native_signature(func.__name__)
+            if not kinds:
+                raise TypeError(f"{func.__name__}() takes or returns arrays; it has no plain C signature")
+        else:
+            kinds = _MODE_C_KINDS[wrapper._mode] * (param_count + 1)
+        return address, kinds
+
+    def declaration(kinds, declarator):
+        params = ", ".join(_C_TYPES[kind][1] for kind in kinds[:-1]) or "void"
+        return f"{_C_TYPES[kinds[-1]][1]}{declarator}({params})"
+
+    def address():
+        """Address of the compiled C function; valid until unload()."""
+        return kernel()[0]
+
+    def c_signature():
+        """C signature of address(), such as ``'double (double, double)'``."""
+        return declaration(kernel()[1], " ")
+
+    def as_ctypes():
+        """A ctypes function pointer to the kernel; it keeps the wrapper alive."""
+        import ctypes
+
+        address, kinds = kernel()
+        # PYFUNCTYPE keeps the GIL, which raise and assert in the kernel need, and re-raises what they set
+        prototype = ctypes.PYFUNCTYPE(*(getattr(ctypes, _C_TYPES[kind][0]) for kind in kinds[-1:] + kinds[:-1]))
+        pointer = prototype(address)
+        pointer._jit_function = wrapper
+        return pointer
+
+    def as_cffi(ffi=None):
+        """A cffi function pointer to the kernel (from a new cffi.FFI() by default)."""
+        if ffi is None:
+            import cffi
+
+            ffi = cffi.FFI()
+        address, kinds = kernel()
+        return ffi.cast(declaration(kinds, "(*)"), address)
+
+    def low_level_callable(user_data=None):
+        """The kernel as a scipy.LowLevelCallable, for quad, solve_ivp and other SciPy solvers."""
+        from scipy import LowLevelCallable
+
+        return LowLevelCallable(as_ctypes(), user_data, c_signature())
+
+    wrapper.address = address
+    wrapper.c_signature = c_signature
+    wrapper.ctypes = as_ctypes
+    wrapper.cffi = as_cffi
+    wrapper.low_level_callable = low_level_callable
+
+
+# Modes whose entry trampoline guards frozen globals (see freeze_globals)
+_FREEZE_MODES = ("auto", "object", "int", "float", "native", "bool", "int32", "float32")
+_FROZEN_TYPES = (int, float, complex, bool, str, bytes, type(None))
+
+
+def _is_frozen_constant(value):
+    """True for values a compile may fold in: immutable scalars and tuples of them."""
+    if type(value) is tuple:
+        return all(_is_frozen_constant(item) for item in value)
+    return type(value) in _FROZEN_TYPES
+
+
+def _frozen_globals(func):
+    """``{name: value}`` of the globals ``func`` reads that can be compiled in as constants.
+
+    Names ``func`` itself assigns or deletes stay runtime lookups, as do
+    builtins and globals holding anything mutable.
+    """
+    instructions = [instr for instr in dis.get_instructions(func) if instr.opname != "CACHE"]
+    written = {instr.argval for instr in instructions if instr.opname in ("STORE_GLOBAL", "DELETE_GLOBAL")}
+    frozen = {}
+    for instr in instructions:
+        # LOAD_GLOBAL pushing a NULL for a call leaves the callable lookup alone
+        if instr.opname != "LOAD_GLOBAL" or instr.arg & 1 or instr.argval in written:
+            continue
+        if instr.argval in func.__globals__ and _is_frozen_constant(func.__globals__[instr.argval]):
+            frozen[instr.argval] = func.__globals__[instr.argval]
+    return frozen
+
+
+def _frozen_changed(func, frozen):
+    """True once a global in ``frozen`` no longer names the value compiled in."""
+    return any(name not in func.__globals__ or func.__globals__[name] is not value for name, value in frozen.items())
+
+
+def _freeze_bytecode(func, instructions, constants, frozen):
+    """``instructions`` / ``constants`` with every LOAD_GLOBAL of a ``frozen`` name turned into LOAD_CONST."""
+    if not frozen:
+        return instructions, constants
+    names = func.__code__.co_names
+    load_global, load_const = dis.opmap["LOAD_GLOBAL"], dis.opmap["LOAD_CONST"]
+    packed = array.array("i")
+    packed.frombytes(instructions)
+    constants = list(constants)
+    indices = {}
+    for i in range(0, len(packed), 4):
+        opcode, arg = packed[i], packed[i + 1]
+        if opcode != load_global or arg & 1 or names[arg >> 1] not in frozen:
+            continue
+        name = names[arg >> 1]
+        if name not in indices:
+            indices[name] = len(constants)
+            constants.append(frozen[name])
+        packed[i], packed[i + 1] = load_const, indices[name]
+    return packed.tobytes(), constants
+
+
+# specialize=(names...): clones per function; later values run the generic code
+_VALUE_CLONE_LIMIT = 8
+
+
+def _value_slots(func, names):
+    """Argument slots of the parameters ``names`` for value specialization.
+
+    Each must be a parameter (not ``*args`` / ``**kwargs``) that the body
+    never assigns, deletes or captures in a closure, so every read of it can
+    become the constant.
+    """
+    code = func.__code__
+    params = code.co_varnames[: code.co_argcount + code.co_kwonlyargcount]
+    written = set(code.co_cellvars)
+    for instr in dis.get_instructions(func):
+        if instr.opname.startswith(("STORE_FAST", "DELETE_FAST")) or instr.opname == "LOAD_FAST_AND_CLEAR":
+            written.update(instr.argval if type(instr.argval) is tuple else (instr.argval,))
+    slots = []
+    for name in names:
+        if name not in params:
+            raise ValueError(f"specialize: {func.__name__}() has no parameter {name!r}")
+        if name in written:
+            raise ValueError(f"specialize: {func.__name__}() assigns or captures parameter {name!r}")
+        slots.append(params.index(name))
+    return tuple(slots)
+
+
+# specialize=True in native mode: a shape is cloned once it has been seen this
+# many times, if the array holds at most _SHAPE_CLONE_ELEMENTS elements
+_SHAPE_CLONE_CALLS = 16
+_SHAPE_CLONE_ELEMENTS = 64
+
+
+def _buffer_shape(value):
+    """Shape of a C-contiguous buffer, the key of its shape clone; TypeError for anything else."""
+    view = memoryview(value)
+    if not view.c_contiguous:
+        raise TypeError("shape clones take C-contiguous buffers")
+    return view.shape
+
+
+def _shape_clonable(shape):
+    """True for shapes small enough that a clone with constant extents pays off."""
+    return 0 < math.prod(shape) <= _SHAPE_CLONE_ELEMENTS
+
+
+def _value_clonable(value):
+    """True for values a clone can compile in: immutable constants, except zeros that hide their sign."""
+    if not _is_frozen_constant(value):
+        return False
+    # -0.0 == 0.0 would pick the other one's clone
+    return not (type(value) in (float, complex) and value == 0)
+
+
+def _specialize_bytecode(instructions, constants, values):
+    """``instructions`` / ``constants`` with every read of the slots in ``values`` ({slot: value}) a LOAD_CONST.
+
+    A superinstruction that reads one of them is split in two, the second
+    half at the odd offset after it, so every original offset (jump
+    targets, exception table, deoptimization resume points) stays put.
+    """
+    load_fast, load_const, store_fast = dis.opmap["LOAD_FAST"], dis.opmap["LOAD_CONST"], dis.opmap["STORE_FAST"]
+    reads = {dis.opmap["LOAD_FAST"], dis.opmap["LOAD_FAST_CHECK"]}
+    pair, store_then_load = dis.opmap["LOAD_FAST_LOAD_FAST"], dis.opmap["STORE_FAST_LOAD_FAST"]
+    packed = array.array("i")
+    packed.frombytes(instructions)
+    constants = list(constants)
+    indices = {}
+
+    def load(slot):
+        if slot not in values:
+            return load_fast, slot
+        if slot not in indices:
+            indices[slot] = len(constants)
+            constants.append(values[slot])
+        return load_const, indices[slot]
+
+    out = array.array("i")
+    for i in range(0, len(packed), 4):
+        opcode, arg, argval, offset = packed[i : i + 4]
+        if opcode in reads and arg in values:
+            out.extend((*load(arg), 0, offset))
+        elif opcode == pair and (arg >> 4 in values or arg & 15 in values):
+            out.extend((*load(arg >> 4), 0, offset))
+            out.extend((*load(arg & 15), 0, offset + 1))
+        elif opcode == store_then_load and arg & 15 in values:
+            out.extend((store_fast, arg >> 4, 0, offset))
+            out.extend((*load(arg & 15), 0, offset + 1))
+        else:
+            out.extend((opcode, arg, argval, offset))
+    return out.tobytes(), constants
+
+
+# Builtins whose generator-expression argument int and float mode inline
+_INLINE_REDUCTIONS = {"sum": sum, "min": min, "max": max, "any": any, "all": all}
+
+# Generator-expression body opcodes _inline_reductions copies into the caller
+_GENEXPR_BODY_OPCODES = frozenset({
+    "NOP", "LOAD_FAST", "LOAD_FAST_LOAD_FAST", "STORE_FAST", "STORE_FAST_LOAD_FAST",
+    "STORE_FAST_STORE_FAST", "LOAD_CONST", "LOAD_DEREF", "BINARY_OP", "UNARY_NEGATIVE",
+    "COMPARE_OP", "TO_BOOL", "POP_JUMP_IF_FALSE", "POP_JUMP_IF_TRUE", "JUMP_FORWARD",
+    "JUMP_BACKWARD", "COPY", "POP_TOP", "YIELD_VALUE", "RESUME",
+})
+
+
+def _genexpr_body(code):
+    """The loop body of a one-``for`` generator expression over its ``.0`` argument, or None.
+
+    Returns ``(for_iter, body, end_for)``: the FOR_ITER, the instructions it
+    runs per item (yielding exactly once) and the END_FOR it exits to.
+    """
+    if code.co_name != "<genexpr>" or not code.co_flags & _CO_GENERATOR or code.co_cellvars:
+        return None
+    instructions = [instr for instr in dis.get_instructions(code) if instr.opname != "CACHE"]
+    k = 0
+    while k < len(instructions) and instructions[k].opname in ("COPY_FREE_VARS", "RETURN_GENERATOR", "POP_TOP", "RESUME"):
+        k += 1
+    if k + 1 >= len(instructions) or instructions[k].opname != "LOAD_FAST" or instructions[k].arg != 0:
+        return None
+    for_iter = instructions[k + 1]
+    end = next((j for j in range(k + 2, len(instructions)) if instructions[j].offset == for_iter.argval), None)
+    if for_iter.opname != "FOR_ITER" or end is None or instructions[end].opname != "END_FOR":
+        return None
+    body = instructions[k + 2 : end]
+    for b, instr in enumerate(body):
+        following = [later.opname for later in body[b + 1 : b + 3]]
+        if (
+            instr.opname not in _GENEXPR_BODY_OPCODES
+            # `.0` is the iterator the caller's loop replaces
+            or ("FAST" in instr.opname and ".0" in (instr.argval if type(instr.argval) is tuple else (instr.argval,)))
+            or (instr.opname == "LOAD_DEREF" and instr.argval not in code.co_freevars)
+            # Typed POP_JUMP_IF_* test against zero themselves
+            or (instr.opname == "TO_BOOL" and following[:1] not in (["POP_JUMP_IF_FALSE"], ["POP_JUMP_IF_TRUE"]))
+            or (instr.opname == "YIELD_VALUE" and following != ["RESUME", "POP_TOP"])
+        ):
+            return None
+    if sum(instr.opname == "YIELD_VALUE" for instr in body) != 1:
+        return None
+    return for_iter, body, instructions[end]
+
+
+def _reduction_site(func, rows, opnames, i, constants):
+    """Match ``reducer(<genexpr> for x in range(...))`` whose LOAD_GLOBAL of the reducer is ``rows[i]``.
+
+    Returns ``(reducer, closure, code, iter_start, get_iter)``: the builtin's
+    name, the caller's local indices of the captured cells, the generator's
+    code object and the indices of the ``range(...)`` LOAD_GLOBAL and its
+    GET_ITER (followed by CALL 0 and CALL 1), or None.
+    """
+    builtins_dict = _extract_builtins(func)
+
+    def resolve(row):
+        name = func.__code__.co_names[row[1] >> 1]
+        return func.__globals__.get(name, builtins_dict.get(name))
+
+    reducer = resolve(rows[i]) if rows[i][1] & 1 else None
+    if reducer is None or _INLINE_REDUCTIONS.get(getattr(reducer, "__name__", None)) is not reducer:
+        return None
+    j = i + 1
+    closure = []
+    while j < len(rows) and opnames[j] in ("LOAD_FAST", "LOAD_CLOSURE"):
+        closure.append(rows[j][1])
+        j += 1
+    if closure:
+        if j >= len(rows) or opnames[j] != "BUILD_TUPLE" or rows[j][1] != len(closure):
+            return None
+        j += 1
+    if j + 1 >= len(rows) or opnames[j] != "LOAD_CONST" or opnames[j + 1] != "MAKE_FUNCTION":
+        return None
+    code = constants[rows[j][1]]
+    if not isinstance(code, types.CodeType) or len(code.co_freevars) != len(closure):
+        return None
+    j += 2
+    if closure:
+        if j >= len(rows) or opnames[j] != "SET_FUNCTION_ATTRIBUTE" or rows[j][1] != 8:
+            return None
+        j += 1
+    iter_start = j
+    if iter_start >= len(rows) or opnames[iter_start] != "LOAD_GLOBAL" or resolve(rows[iter_start]) is not range:
+        return None
+    while j < len(rows) and opnames[j] != "GET_ITER":
+        j += 1
+    if j + 2 >= len(rows) or opnames[j + 1 : j + 3] != ["CALL", "CALL"] or (rows[j + 1][1], rows[j + 2][1]) != (0, 1):
+        return None
+    return reducer.__name__, closure, code, iter_start, j
+
+
+def _inline_reductions(func, instructions, constants, total_locals):
+    """Inline ``sum``/``min``/``max``/``any``/``all`` over generator expressions for int and float mode.
+
+    ``sum(i * k for i in range(n))`` calls a nested generator that neither
+    typed mode can compile. Here each such call becomes the generator's own
+    ``range()`` loop in the caller, folding the yielded values into a new
+    local: ``any``/``all`` leave the loop at the first deciding item, and
+    ``min``/``max`` of an empty range end in a bare ``raise``, which typed
+    modes deoptimize so the interpreter raises the ValueError. The
+    generator's locals become new locals of the caller and the cells it
+    captured become plain locals again. The builtins are resolved now, like
+    prange().
+
+    Returns ``(instructions, constants, total_locals, offsets)``, ``offsets``
+    mapping each old instruction offset to its new one (None when nothing
+    changed). Unless every MAKE_FUNCTION is such a call, the input is
+    returned unchanged.
+    """
+    unchanged = instructions, constants, total_locals, None
+    packed = array.array("i")
+    packed.frombytes(instructions)
+    rows = [tuple(packed[i : i + 4]) for i in range(0, len(packed), 4)]
+    opnames = [dis.opname[row[0]] for row in rows]
+    if "MAKE_FUNCTION" not in opnames:
+        return unchanged
+    constants = list(constants)
+    const_index = {}
+
+    def const(value):
+        key = (type(value), repr(value))  # Keeps 0.0 and -0.0 apart
+        if key not in const_index:
+            const_index[key] = len(constants)
+            constants.append(value)
+        return const_index[key]
+
+    # (opcode, arg, jump target key, keys naming this instruction); a key is
+    # ("o", offset) in the caller, ("g", site, offset) in a generator or a
+    # ("s", site, label) of the reduction code
+    out = []
+    pending = []  # Keys of dropped instructions: they name the next one emitted
+
+    def emit(opname, arg=0, target=None, key=None):
+        out.append((dis.opmap[opname], arg, target, pending + ([key] if key is not None else [])))
+        pending.clear()
+
+    cells = {row[1] for row, opname in zip(rows, opnames) if opname == "MAKE_CELL"}
+    sites = 0
     i = 0
-    while i < len(table):
-        start, i = read_varint(table, i)
-        length, i = read_varint(table, i)
-        target, i = read_varint(table, i)
-        depth_lasti, i = read_varint(table, i)
-        depth = depth_lasti >> 1
-        lasti = bool(depth_lasti & 1)
-
-        entries.append(
-            {
-                "start": start * 2,  # Convert to byte offset
-                "end": (start + length) * 2,
-                "target": target * 2,
-                "depth": depth,
-                "lasti": lasti,
-            }
+    while i < len(rows):
+        opname = opnames[i]
+        match = _reduction_site(func, rows, opnames, i, constants) if opname == "LOAD_GLOBAL" else None
+        parsed = _genexpr_body(match[2]) if match else None
+        if parsed is None:
+            if opname == "MAKE_CELL" and rows[i][1] in cells:
+                pending.append(("o", rows[i][3]))
+            elif opname in ("LOAD_DEREF", "STORE_DEREF") and rows[i][1] in cells:
+                emit(opname.replace("DEREF", "FAST"), rows[i][1], key=("o", rows[i][3]))
+            else:
+                target = ("o", rows[i][2]) if rows[i][0] in dis.hasjump else None
+                emit(opname, rows[i][1], target, key=("o", rows[i][3]))
+            i += 1
+            continue
+
+        reducer, closure, code, iter_start, get_iter = match
+        for_iter, body, end_for = parsed
+        site = sites
+        sites += 1
+        # The generator's locals after `.0` and the reduction's get new slots
+        slots = {name: total_locals + n for n, name in enumerate(code.co_varnames[1:])}
+        slots.update(zip(code.co_freevars, closure))
+        total_locals += len(code.co_varnames) - 1
+        acc, first, item = total_locals, total_locals + 1, total_locals + 2
+        total_locals += 3 if reducer in ("min", "max") else 1
+
+        pending.extend(("o", row[3]) for row in rows[i:iter_start])
+        emit("LOAD_CONST", const(1 if reducer == "all" else 0))
+        emit("STORE_FAST", acc)
+        if reducer in ("min", "max"):
+            emit("LOAD_CONST", const(1))
+            emit("STORE_FAST", first)
+        for k in range(iter_start, get_iter + 1):
+            emit(opnames[k], rows[k][1], key=("o", rows[k][3]))
+        emit("FOR_ITER", 0, ("g", site, for_iter.argval), key=("g", site, for_iter.offset))
+
+        b = 0
+        while b < len(body):
+            instr = body[b]
+            key = ("g", site, instr.offset)
+            if instr.opname in ("LOAD_FAST", "STORE_FAST", "LOAD_DEREF"):
+                emit(instr.opname.replace("DEREF", "FAST"), slots[instr.argval], key=key)
+            elif instr.opname in ("LOAD_FAST_LOAD_FAST", "STORE_FAST_LOAD_FAST", "STORE_FAST_STORE_FAST"):
+                first_op, second_op = instr.opname.split("_FAST_")
+                emit(first_op + "_FAST", slots[instr.argval[0]], key=key)
+                emit(second_op, slots[instr.argval[1]])
+            elif instr.opname == "LOAD_CONST":
+                emit("LOAD_CONST", const(instr.argval), key=key)
+            elif instr.opname == "TO_BOOL":
+                pending.append(key)
+            elif instr.opname == "YIELD_VALUE":
+                # YIELD_VALUE, RESUME, POP_TOP: fold the item into the accumulator
+                pending.append(key)
+                cont = ("s", site, "cont")
+                if reducer == "sum":
+                    emit("LOAD_FAST", acc)
+                    emit("BINARY_OP", 0)
+                    emit("STORE_FAST", acc)
+                elif reducer in ("any", "all"):
+                    emit("POP_JUMP_IF_FALSE" if reducer == "any" else "POP_JUMP_IF_TRUE", 0, cont)
+                    emit("LOAD_CONST", const(1 if reducer == "any" else 0))
+                    emit("STORE_FAST", acc)
+                    emit("JUMP_FORWARD", 0, ("s", site, "after"))
+                else:
+                    # Python keeps the first of equal items: replace only on a strict < / >
+                    emit("STORE_FAST", item)
+                    emit("LOAD_FAST", first)
+                    emit("POP_JUMP_IF_TRUE", 0, ("s", site, "take"))
+                    emit("LOAD_FAST", item)
+                    emit("LOAD_FAST", acc)
+                    emit("COMPARE_OP", (0 if reducer == "min" else 4) << 5 | 16)
+                    emit("POP_JUMP_IF_FALSE", 0, cont)
+                    emit("LOAD_FAST", item, key=("s", site, "take"))
+                    emit("STORE_FAST", acc)
+                    emit("LOAD_CONST", const(0))
+                    emit("STORE_FAST", first)
+                pending.extend((("g", site, body[b + 1].offset), ("g", site, body[b + 2].offset), cont))
+                b += 2
+            else:
+                target = ("g", site, instr.argval) if instr.opcode in dis.hasjump else None
+                emit(instr.opname, instr.arg or 0, target, key=key)
+            b += 1
+        # No POP_TOP after END_FOR: typed modes never push the iterator
+        emit("END_FOR", key=("g", site, end_for.offset))
+        pending.extend((("o", rows[get_iter + 1][3]), ("o", rows[get_iter + 2][3]), ("s", site, "after")))
+        if reducer in ("min", "max"):
+            emit("LOAD_FAST", first)
+            emit("POP_JUMP_IF_FALSE", 0, ("s", site, "done"))
+            emit("RAISE_VARARGS", 0)
+            emit("LOAD_FAST", acc, key=("s", site, "done"))
+        else:
+            emit("LOAD_FAST", acc)
+        i = get_iter + 3
+
+    if not sites or any(dis.opname[opcode] == "MAKE_FUNCTION" for opcode, _, _, _ in out):
+        return unchanged
+    offset_of = {key: 2 * n for n, (_, _, _, keys) in enumerate(out) for key in keys}
+    packed = array.array("i")
+    for n, (opcode, arg, target, _) in enumerate(out):
+        packed.extend((opcode, arg, offset_of[target] if target is not None else 0, 2 * n))
+    offsets = {key[1]: offset for key, offset in offset_of.items() if key[0] == "o"}
+    return packed.tobytes(), constants, total_locals, offsets
+
+
+# Opcodes a range() loop body may contain for the loop to fuse with its neighbour
+_FUSIBLE_OPCODES = frozenset({
+    "NOP", "LOAD_FAST", "LOAD_FAST_CHECK", "LOAD_FAST_LOAD_FAST", "STORE_FAST",
+    "STORE_FAST_LOAD_FAST", "STORE_FAST_STORE_FAST", "LOAD_CONST", "BINARY_OP",
+    "BINARY_SUBSCR", "STORE_SUBSCR", "UNARY_NEGATIVE", "UNARY_NOT", "UNARY_INVERT",
+    "COMPARE_OP", "TO_BOOL", "POP_JUMP_IF_FALSE", "POP_JUMP_IF_TRUE", "JUMP_FORWARD",
+    "JUMP_BACKWARD", "POP_TOP", "COPY", "SWAP", "PUSH_NULL", "BUILD_TUPLE",
+    "LOAD_GLOBAL", "LOAD_ATTR", "CALL",
+})
+
+# Builtins a fused body may call: they neither touch arrays nor keep state
+_FUSIBLE_BUILTINS = ("abs", "min", "max", "float", "int", "bool", "round", "len")
+
+# Opcodes of a range() bound: range(n), range(len(a)), range(1, n - 1), ...
+_RANGE_BOUND_OPCODES = frozenset({
+    "LOAD_FAST", "LOAD_FAST_CHECK", "LOAD_FAST_LOAD_FAST", "LOAD_CONST", "BINARY_OP",
+    "UNARY_NEGATIVE", "LOAD_GLOBAL", "CALL",
+})
+
+
+def _fuse_range_loops(func, instructions, param_types):
+    """Fuse adjacent native-mode ``range()`` loops over the same bounds into one.
+
+    ``for i in range(n): tmp[i] = ...`` followed by ``for i in range(n):
+    out[i] = tmp[i] ...`` runs as a single loop whose body is the first
+    body, then the second, so each element is produced and consumed while
+    it is still in a register. Loops fuse when neither body leaves the loop
+    (no ``break`` or ``return``), calls only math functions and pure
+    builtins, reads a local the other assigns, or touches an array the other
+    writes at an index other than its own counter. The second loop's
+    counter is renamed to the first's when it is not used elsewhere.
+
+    Bodies run interleaved, so arrays written by one loop and accessed by
+    the other must not share memory: returns ``(instructions, pairs)``, the
+    ``pairs`` of array parameters compiled code checks are disjoint before
+    running (see ``JIT.set_native_disjoint``).
+    """
+    packed = array.array("i")
+    packed.frombytes(instructions)
+    rows = [list(packed[i : i + 4]) for i in range(0, len(packed), 4)]
+    opnames = [dis.opname[row[0]] for row in rows]
+    if opnames.count("FOR_ITER") < 2:
+        return instructions, []
+    code = func.__code__
+    arrays = {slot for slot, kind in enumerate(param_types) if isinstance(kind, str) and kind.endswith("]")}
+    if any(param_types[slot].startswith("record:") for slot in arrays):
+        return instructions, []  # a[i].x = v writes through STORE_ATTR, which the bodies don't track
+    builtins_dict = func.__builtins__ if isinstance(func.__builtins__, dict) else vars(func.__builtins__)
+
+    def locals_of(row, opname):
+        """(read, written) locals of an instruction."""
+        if opname in ("LOAD_FAST", "LOAD_FAST_CHECK"):
+            return (row[1],), ()
+        if opname == "LOAD_FAST_LOAD_FAST":
+            return (row[1] >> 4, row[1] & 15), ()
+        if opname in ("STORE_FAST", "DELETE_FAST"):
+            return (), (row[1],)
+        if opname == "STORE_FAST_LOAD_FAST":
+            return (row[1] & 15,), (row[1] >> 4,)
+        if opname == "STORE_FAST_STORE_FAST":
+            return (), (row[1] >> 4, row[1] & 15)
+        return (), ()
+
+    # An array parameter that is ever rebound could name another one
+    if any(arrays.intersection(locals_of(row, opname)[1]) for row, opname in zip(rows, opnames)):
+        return instructions, []
+
+    def global_value(row):
+        name = code.co_names[row[1] >> 1]
+        return func.__globals__.get(name, builtins_dict.get(name))
+
+    def pure_global(k):
+        value = global_value(rows[k])
+        if value is math or getattr(value, "__module__", None) == "math":
+            return True
+        return any(value is builtins_dict.get(name) for name in _FUSIBLE_BUILTINS)
+
+    def find_loops():
+        index_of = {row[3]: k for k, row in enumerate(rows)}
+        loops = []
+        for f, opname in enumerate(opnames):
+            end = index_of.get(rows[f][2]) if opname == "FOR_ITER" else None
+            if (end is None or f < 3 or end + 1 >= len(rows) or opnames[end] != "END_FOR"
+                    or opnames[end + 1] != "POP_TOP" or opnames[end - 1] != "JUMP_BACKWARD"
+                    or rows[end - 1][2] != rows[f][3] or opnames[f + 1] != "STORE_FAST"
+                    or opnames[f - 1] != "GET_ITER" or opnames[f - 2] != "CALL"):
+                continue
+            start = f - 3
+            while start >= 0 and opnames[start] in _RANGE_BOUND_OPCODES:
+                if opnames[start] == "LOAD_GLOBAL" and rows[start][1] & 1 and global_value(rows[start]) is range:
+                    break
+                start -= 1
+            else:
+                continue
+            bound = range(start + 1, f - 1)
+            if any(opnames[k] == "LOAD_GLOBAL" and global_value(rows[k]) is not len for k in bound):
+                continue
+            loops.append((start, f, end, index_of))
+        return loops
+
+    def body_of(f, end, counter):
+        """Locals and arrays the body of the loop at FOR_ITER ``f`` uses, or None if it can't fuse."""
+        reads, writes = set(), set()
+        at_counter, other, written = set(), set(), set()
+        stores, augmented = {}, []
+        index_of = {row[3]: k for k, row in enumerate(rows)}
+        k = f + 2
+        while k < end - 1:
+            row, opname = rows[k], opnames[k]
+            if opname not in _FUSIBLE_OPCODES:
+                return None
+            if row[0] in dis.hasjump:
+                target = index_of.get(row[2])
+                if target is None or not (f + 2 <= target <= end - 1 or (opname == "JUMP_BACKWARD" and target == f)):
+                    return None
+            if opname == "LOAD_GLOBAL" and not pure_global(k):
+                return None
+            if opname == "LOAD_ATTR" and not (opnames[k - 1] == "LOAD_GLOBAL" and global_value(rows[k - 1]) is math):
+                return None
+            if opname == "STORE_SUBSCR" and k not in stores:
+                if not (augmented and opnames[k - 1] == "SWAP" and opnames[k - 2] == "SWAP"):
+                    return None  # A store to something other than an array at the counter
+                written.add(augmented.pop())
+            elif opname == "STORE_SUBSCR":
+                written.add(stores[k])
+            read, wrote = locals_of(row, opname)
+            reads.update(read)
+            writes.update(wrote)
+            # x[counter]: LOAD_FAST_LOAD_FAST (x, counter), or LOAD_FAST x then LOAD_FAST counter
+            pair = None
+            if opname == "LOAD_FAST_LOAD_FAST" and read[0] in arrays and read[1] == counter:
+                pair = (read[0], k + 1)
+            elif opname == "LOAD_FAST" and row[1] in arrays and k + 1 < end and opnames[k + 1] == "LOAD_FAST" and rows[k + 1][1] == counter:
+                pair = (row[1], k + 2)
+            if pair is not None:
+                x, n = pair
+                if opnames[n] == "BINARY_SUBSCR":
+                    at_counter.add(x)
+                elif opnames[n] == "STORE_SUBSCR":
+                    at_counter.add(x)
+                    stores[n] = x
+                elif opnames[n : n + 3] == ["COPY", "COPY", "BINARY_SUBSCR"]:
+                    at_counter.add(x)
+                    augmented.append(x)
+                else:
+                    pair = None
+                if pair is not None:
+                    k = n
+                    reads.add(counter)
+                    continue
+            other.update(arrays.intersection(read))
+            k += 1
+        if counter in writes or augmented:
+            return None
+        return reads, writes, at_counter | other, other, written
+
+    fused, fused_pairs = False, set()
+    changed = True
+    while changed:
+        changed = False
+        loops = find_loops()
+        for (a_start, a_for, a_end, index_of), (b_start, b_for, b_end, _) in zip(loops, loops[1:]):
+            if a_end + 2 != b_start:
+                continue
+            a_bound, b_bound = rows[a_start : a_for - 1], rows[b_start : b_for - 1]
+            if [row[:2] for row in a_bound] != [row[:2] for row in b_bound]:
+                continue
+            i, j = rows[a_for + 1][1], rows[b_for + 1][1]
+            a_body, b_body = body_of(a_for, a_end, i), body_of(b_for, b_end, j)
+            if a_body is None or b_body is None:
+                continue
+            a_reads, a_writes, a_arrays, a_other, a_written = a_body
+            b_reads, b_writes, b_arrays, b_other, b_written = b_body
+            bound_reads = {slot for k in range(a_start, a_for - 1) for slot in locals_of(rows[k], opnames[k])[0]}
+            if (bound_reads & (a_writes | {i}) or a_writes & (b_reads | b_writes) or b_writes & a_reads
+                    or a_written & b_other or b_written & a_other):
+                continue
+            if j != i:
+                # The second counter becomes the first: it must mean nothing outside its loop
+                body = range(b_for + 2, b_end - 1)
+                uses = [k for k in range(len(rows)) if j in sum(locals_of(rows[k], opnames[k]), ())]
+                elsewhere = any(k != b_for + 1 and k not in body for k in uses)
+                packs = any(opnames[k] != "LOAD_FAST" for k in uses if k in body)
+                if i in b_reads or j in a_reads | a_writes or elsewhere or (i > 15 and packs):
+                    continue
+                for k in body:
+                    if opnames[k] in ("LOAD_FAST", "LOAD_FAST_CHECK") and rows[k][1] == j:
+                        rows[k][1] = i
+                    elif opnames[k] in ("LOAD_FAST_LOAD_FAST", "STORE_FAST_LOAD_FAST"):
+                        # Only loads can name j: the body never assigns its counter
+                        high, low = rows[k][1] >> 4, rows[k][1] & 15
+                        rows[k][1] = (i if high == j else high) << 4 | (i if low == j else low)
+            fused_pairs.update((min(x, y), max(x, y)) for x in a_written for y in b_arrays if x != y)
+            fused_pairs.update((min(x, y), max(x, y)) for x in b_written for y in a_arrays if x != y)
+
+            a_latch, b_latch = rows[a_for][3], rows[b_for][3]
+            for k in range(a_for + 2, a_end - 1):
+                if opnames[k] == "JUMP_BACKWARD" and rows[k][2] == a_latch:
+                    # Ending the first body's iteration runs the second body
+                    rows[k][:3] = dis.opmap["JUMP_FORWARD"], 0, rows[a_end - 1][3]
+                    opnames[k] = "JUMP_FORWARD"
+            for k in range(b_for + 2, b_end):
+                if opnames[k] == "JUMP_BACKWARD" and rows[k][2] == b_latch:
+                    rows[k][2] = a_latch
+            rows[a_for][2] = rows[b_end][3]
+            for k in (*range(a_end - 1, a_end + 2), *range(b_start, b_for + 2)):
+                rows[k][:3] = dis.opmap["NOP"], 0, 0
+                opnames[k] = "NOP"
+            fused = changed = True
+            break
+
+    if not fused:
+        return instructions, []
+    packed = array.array("i")
+    for row in rows:
+        packed.extend(row)
+    return packed.tobytes(), sorted(fused_pairs)
+
+
+# Type names accepted in signature strings, mapped to native-mode parameter types
+_SIGNATURE_TYPES = {
+    "i64": "int",
+    "int64": "int",
+    "int": "int",
+    "f64": "float",
+    "float64": "float",
+    "float": "float",
+    "double": "float",
+    "b1": "bool",
+    "bool": "bool",
+}
+
+# Element names accepted in array types such as 'f64[:]' or 'i32[:, :]'
+_ARRAY_ELEMENTS = {
+    "f64": "f64",
+    "float64": "f64",
+    "double": "f64",
+    "f32": "f32",
+    "float32": "f32",
+    "i64": "i64",
+    "int64": "i64",
+    "i32": "i32",
+    "int32": "i32",
+    "u8": "u8",
+    "uint8": "u8",
+}
+
+# Shorthands for 'u8[:]': a bytes, bytearray or ASCII str argument viewed as bytes
+_BYTES_TYPES = ("bytes", "str")
+
+# Highest array rank native mode accepts (kNativeMaxDims in jit_core.cpp)
+_ARRAY_MAX_DIMS = 8
+
+# Return types for functions that only return None
+_NONE_TYPES = ("void", "none", "None")
+
+
+def _parse_signature(func, signature):
+    """Parse a numba-style signature such as ``'f64(f64, i64)'``.
+
+    Returns ``(param_types, return_type)`` in native-mode names ('int',
+    'float', 'bool', 'fixed<k>', or arrays such as 'f64[:]', 'i32[:,:]' and 'u8[:]' for
+    'bytes'/'str'), the
+    class for a @justjit.record global, or a 1-tuple of the class for an
+    array of them ('Trade[:]'); the return type is 'none' for
+    'void', and '' when the string starts with '('.
+    """
+    ret, paren, rest = signature.partition("(")
+    args, close, tail = rest.rpartition(")")
+    if not paren or not close or tail.strip():
+        raise ValueError(f"Invalid signature {signature!r}; expected e.g. 'f64(f64, i64)'")
+
+    def native_type(name, arrays=True):
+        name = name.strip()
+        element, bracket, dims = name.partition("[")
+        if bracket and arrays and element.strip() in _ARRAY_ELEMENTS:
+            dims = dims.replace(" ", "")
+            ndim = dims.count(":")
+            if 1 <= ndim <= _ARRAY_MAX_DIMS and dims == ":," * (ndim - 1) + ":]":
+                return _ARRAY_ELEMENTS[element.strip()] + "[" + dims
+        if arrays and name in _BYTES_TYPES:
+            return "u8[:]"
+        if _is_record(func.__globals__.get(name)):
+            return func.__globals__[name]
+        if arrays and bracket and dims.replace(" ", "") == ":]" and _is_record(func.__globals__.get(element.strip())):
+            return (func.__globals__[element.strip()],)  # An array of records
+        if not bracket and _fixed_type(name):
+            return _fixed_type(name)
+        try:
+            return _SIGNATURE_TYPES[name]
+        except KeyError:
+            raise ValueError(
+                f"Unknown type {name!r} in signature {signature!r}; expected one of "
+                f"{', '.join(_SIGNATURE_TYPES)}, 'fixed<k>', an array such as 'f64[:]' or 'i32[:, :]', "
+                "'bytes', 'str', or a @justjit.record class (or 'Rec[:]', an array of them)"
+            ) from None
+
+    # Split on the commas between parameters, not those inside 'f64[:, :]'
+    params, depth, start = [], 0, 0
+    for pos, char in enumerate(args):
+        depth += (char == "[") - (char == "]")
+        if char == "," and depth == 0:
+            params.append(args[start:pos])
+            start = pos + 1
+    params.append(args[start:])
+    param_types = [native_type(arg) for arg in params] if args.strip() else []
+    code = func.__code__
+    if code.co_flags & (_CO_VARARGS | _CO_VARKEYWORDS):
+        raise TypeError(f"signature= cannot type the *args or **kwargs of '{func.__name__}'")
+    argcount = code.co_argcount + code.co_kwonlyargcount  # Keyword-only parameters come last
+    if len(param_types) != argcount:
+        raise TypeError(
+            f"Signature {signature!r} has {len(param_types)} parameters; "
+            f"'{func.__name__}' takes {argcount}"
         )
+    if ret.strip() in _NONE_TYPES:
+        return param_types, "none"
+    return param_types, native_type(ret, arrays=False) if ret.strip() else ""
 
-    return entries
 
+def _annotated_signature(func):
+    """Native-mode types from ``int``/``float``/``bool``, fixed() or @justjit.record annotations.
 
-def _is_simple_generator(func):
-    """Check if a generator only uses opcodes the JIT generator compiler supports.
-    
-    The generator compiler supports most common opcodes. This function returns
-    False for opcodes that are NOT yet implemented in compile_generator.
+    Returns ``(param_types, return_type, complete)``; unannotated
+    parameters (and an unannotated return) are '', and ``complete`` is True
+    when every parameter and any return annotation name one of the types.
+    Record annotations are returned as the class.
     """
-    # Opcodes supported by the generator compiler
-    # These opcodes are actually implemented in JITCore::compile_generator()
-    supported_opcodes = {
-        # Control flow
-        "RESUME", "RETURN_GENERATOR", "NOP", "CACHE",
-        # Load/store
-        "LOAD_CONST", "LOAD_FAST", "LOAD_FAST_CHECK", "STORE_FAST",
-        "LOAD_FAST_LOAD_FAST", "STORE_FAST_STORE_FAST",  # Python 3.13 combined opcodes
-        "STORE_FAST_LOAD_FAST", "LOAD_FAST_AND_CLEAR",   # Python 3.13 combined opcodes
-        "LOAD_LOCALS",  # Python 3.13 annotation scope
-        "LOAD_FROM_DICT_OR_DEREF", "LOAD_FROM_DICT_OR_GLOBALS",  # Python 3.13 annotation scope
-        # Global/builtin access
-        "LOAD_GLOBAL", "LOAD_ATTR", "PUSH_NULL",
-        "STORE_GLOBAL", "STORE_ATTR",
-        "CALL", "CALL_KW", "CALL_FUNCTION_EX",
-        "CALL_INTRINSIC_2",  # Two-arg intrinsics (type params, etc.)
-        # Generator specific
-        "YIELD_VALUE", "RETURN_VALUE", "RETURN_CONST",
-        # Stack manipulation
-        "POP_TOP", "COPY", "SWAP",
-        # Arithmetic
-        "BINARY_OP",
-        # Comparison and boolean
-        "COMPARE_OP", "CONTAINS_OP", "IS_OP", "TO_BOOL",
-        # Unary operations
-        "UNARY_NEGATIVE", "UNARY_NOT", "UNARY_INVERT",
-        # Looping support
-        "GET_ITER", "FOR_ITER", "END_FOR",
-        "JUMP_BACKWARD", "JUMP_FORWARD", "JUMP_BACKWARD_NO_INTERRUPT",
-        "POP_JUMP_IF_FALSE", "POP_JUMP_IF_TRUE",
-        "POP_JUMP_IF_NONE", "POP_JUMP_IF_NOT_NONE",
-        # Collections
-        "BUILD_LIST", "BUILD_TUPLE", "BUILD_CONST_KEY_MAP",
-        "BUILD_MAP", "BUILD_SET",
-        "LIST_APPEND", "SET_ADD", "MAP_ADD",
-        "LIST_EXTEND", "SET_UPDATE", "DICT_UPDATE", "DICT_MERGE",
-        # Subscript and slicing
-        "BINARY_SUBSCR", "STORE_SUBSCR", "DELETE_SUBSCR",
-        "BUILD_SLICE", "BINARY_SLICE", "STORE_SLICE",
-        # Unpacking
-        "UNPACK_SEQUENCE", "UNPACK_EX",
-        # Exception handling (supported via exception table)
-        "CALL_INTRINSIC_1", "RERAISE", "PUSH_EXC_INFO", "POP_EXCEPT",
-        "CHECK_EXC_MATCH", "CHECK_EG_MATCH",  # except* exception group matching
-        "RAISE_VARARGS",  # raise, raise exc, raise exc from cause
-        # Closures
-        "LOAD_DEREF", "STORE_DEREF", "LOAD_CLOSURE",
-        "COPY_FREE_VARS", "MAKE_CELL",
-        # Import
-        "IMPORT_NAME", "IMPORT_FROM",
-        # Function creation
-        "MAKE_FUNCTION", "SET_FUNCTION_ATTRIBUTE",
-        # Class support
-        "SETUP_ANNOTATIONS", "EXIT_INIT_CHECK",
-        # Async with
-        "BEFORE_ASYNC_WITH",
-    }
-    
-    # Note: All opcodes that appear in actual bytecode are now supported!
-    # - LOAD_METHOD is a pseudo-instruction (emitted as LOAD_ATTR with flag)
-    # - RAISE_VARARGS is implemented (line 6513 in jit_core.cpp)
-    # - LOAD_FAST_AND_CLEAR is implemented (line 1973, 8644 in jit_core.cpp)
-    
-    # Allow all opcodes - we have full coverage
-    return True
+    annotations = getattr(func, "__annotations__", None) or {}
+
+    def native_type(hint):
+        if isinstance(hint, str) and _is_record(func.__globals__.get(hint)):
+            hint = func.__globals__[hint]  # from __future__ import annotations
+        if _is_record(hint):
+            return hint
+        if isinstance(hint, str) and _fixed_type(hint):
+            return _fixed_type(hint)  # justjit.fixed(k), possibly as a string annotation
+        hint = getattr(hint, "__name__", hint)
+        return hint if hint in ("int", "float", "bool") else ""
+
+    code = func.__code__
+    named = code.co_argcount + code.co_kwonlyargcount
+    param_types = [native_type(annotations.get(name)) for name in code.co_varnames[:named]]
+    # *args and **kwargs (annotated by their elements) keep a function out of native mode
+    param_types += [""] * (_parameter_slots(code) - named)
+    return_type = native_type(annotations.get("return"))
+    complete = bool(annotations) and all(param_types) and ("return" not in annotations or bool(return_type))
+    return param_types, return_type, complete
+
+
+def _specialized_mode(func, arg_types, result_types):
+    """Pick a typed mode from profiled types: 'int', 'float', or None.
+
+    Every profiled call must have had only exact ``int`` (or only exact
+    ``float``) arguments and the same result type. Int specialization also
+    requires no true division, whose int-mode lowering differs from Python's.
+    """
+    for mode, typ in (("int", int), ("float", float)):
+        if arg_types == {typ} and result_types == {typ}:
+            if mode == "int" and any(
+                ins.opname == "BINARY_OP" and ins.arg in (11, 24)
+                for ins in dis.get_instructions(func)
+            ):
+                return None
+            return mode
+    return None
+
+
+def _parse_exception_table(func):
+    """Return the Python 3.11+ exception table of a function's code object.
+
+    The raw co_exceptiontable bytes are passed through unchanged; JITCore
+    decodes the varint entries (start, end, target, depth, lasti) natively.
+    """
+    return func.__code__.co_exceptiontable
+
+
+# Opcodes JITCore::compile_generator() lowers. Exception handlers run natively
+# across yields (try/except/finally, with, raise); throw() and close() enter
+# them at the suspended yield.
+_GENERATOR_SUPPORTED_OPCODES = frozenset({
+    # Control flow
+    "RESUME", "RETURN_GENERATOR", "NOP", "CACHE", "EXTENDED_ARG",
+    "YIELD_VALUE", "RETURN_VALUE", "RETURN_CONST",
+    "GET_ITER", "FOR_ITER", "END_FOR",
+    "JUMP_BACKWARD", "JUMP_FORWARD", "JUMP_BACKWARD_NO_INTERRUPT",
+    "POP_JUMP_IF_FALSE", "POP_JUMP_IF_TRUE", "POP_JUMP_IF_NONE", "POP_JUMP_IF_NOT_NONE",
+    # Locals, globals, attributes
+    "LOAD_CONST", "LOAD_FAST", "LOAD_FAST_CHECK", "STORE_FAST", "DELETE_FAST",
+    "LOAD_FAST_LOAD_FAST", "STORE_FAST_STORE_FAST", "STORE_FAST_LOAD_FAST", "LOAD_FAST_AND_CLEAR",
+    "LOAD_GLOBAL", "STORE_GLOBAL", "LOAD_ATTR", "STORE_ATTR", "PUSH_NULL",
+    # Calls, including keyword arguments and *args/**kwargs
+    "CALL", "CALL_KW", "CALL_FUNCTION_EX", "CALL_INTRINSIC_1",
+    # Stack and operators
+    "POP_TOP", "COPY", "SWAP",
+    "BINARY_OP", "COMPARE_OP", "CONTAINS_OP", "IS_OP", "TO_BOOL",
+    "UNARY_NEGATIVE", "UNARY_NOT", "UNARY_INVERT",
+    # Collections, subscripts, unpacking
+    "BUILD_LIST", "BUILD_TUPLE", "BUILD_CONST_KEY_MAP", "BUILD_MAP", "BUILD_SET",
+    "LIST_APPEND", "SET_ADD", "MAP_ADD", "LIST_EXTEND", "SET_UPDATE", "DICT_UPDATE", "DICT_MERGE",
+    "BINARY_SUBSCR", "STORE_SUBSCR", "DELETE_SUBSCR", "BUILD_SLICE", "BINARY_SLICE", "STORE_SLICE",
+    "UNPACK_SEQUENCE", "UNPACK_EX",
+    # f-strings
+    "FORMAT_SIMPLE", "FORMAT_WITH_SPEC", "CONVERT_VALUE", "BUILD_STRING",
+    # Exceptions and with statements
+    "PUSH_EXC_INFO", "POP_EXCEPT", "CHECK_EXC_MATCH", "RERAISE", "RAISE_VARARGS",
+    "LOAD_ASSERTION_ERROR", "BEFORE_WITH", "WITH_EXCEPT_START",
+    # Closures, nested functions, imports
+    "LOAD_DEREF", "STORE_DEREF", "LOAD_CLOSURE", "COPY_FREE_VARS", "MAKE_CELL",
+    "MAKE_FUNCTION", "SET_FUNCTION_ATTRIBUTE", "IMPORT_NAME", "IMPORT_FROM",
+    # yield from / await / async for
+    "SEND", "END_SEND", "CLEANUP_THROW", "GET_AWAITABLE",
+    "GET_AITER", "GET_ANEXT", "END_ASYNC_FOR",
+})
 
+# Signatures the native generator factory cannot bind
+_CO_VARARGS = 0x04
+_CO_VARKEYWORDS = 0x08
 
-def _create_generator_wrapper(func, opt_level):
+
+def _parameter_slots(code):
+    """Entry-point arguments of ``code``: positional and keyword-only parameters, then *args and **kwargs.
+
+    These are its first locals in co_varnames order, which is how every
+    compiled mode reads its parameters.
+    """
+    return (code.co_argcount + code.co_kwonlyargcount
+            + bool(code.co_flags & _CO_VARARGS) + bool(code.co_flags & _CO_VARKEYWORDS))
+
+
+def _unsupported_generator_features(func):
+    """Return what keeps a generator from JIT compilation (empty if nothing).
+
+    Lists the opcodes JITCore::compile_generator() does not lower, and the
+    parameter kinds (*args, **kwargs, keyword-only) its factory cannot bind.
+    """
+    code = func.__code__
+    missing = sorted({instr.opname for instr in dis.get_instructions(func)} - _GENERATOR_SUPPORTED_OPCODES)
+    if code.co_flags & _CO_VARARGS:
+        missing.append("*args")
+    if code.co_flags & _CO_VARKEYWORDS:
+        missing.append("**kwargs")
+    if code.co_kwonlyargcount:
+        missing.append("keyword-only parameters")
+    return missing
+
+
+def _copy_function_metadata(wrapper, func):
+    """Give a native generator factory the introspection attributes of ``func``."""
+    wrapper.__name__ = func.__name__
+    wrapper.__qualname__ = func.__qualname__
+    wrapper.__doc__ = func.__doc__
+    wrapper.__module__ = func.__module__
+    wrapper.__wrapped__ = func
+
+
+def _create_generator_wrapper(func, opt_level, mode="auto"):
     """Create a JIT-compiled wrapper for a generator function.
     
     This compiles the generator into a state machine and returns a factory
-    function that creates JIT generator objects when called.
+    function that creates JIT generator objects when called. With mode='int'
+    or mode='float' the generators are typed: yields are unboxed into int64
+    or float64 batches, served by iteration and by take(n).
     """
-    import functools
     import warnings
     
     # Check if this generator is simple enough for JIT compilation
-    if not _is_simple_generator(func):
-        # Complex generator - fall back to Python for safety
+    unsupported = _unsupported_generator_features(func)
+    if unsupported:
+        offsets = {}
+        for instr in dis.get_instructions(func):
+            offsets.setdefault(instr.opname, instr.offset)
+        for feature in unsupported:
+            if feature in offsets:
+                _record_rejection(func, "generator", "unsupported opcode", feature, offsets[feature])
+            else:
+                _record_rejection(func, "generator", f"unsupported {feature}")
         warnings.warn(
-            f"Generator '{func.__name__}' uses opcodes not yet supported by JIT. "
-            f"Using Python implementation (no performance impact for generators).",
+            f"Generator '{func.__name__}' uses {', '.join(unsupported)}, which the JIT "
+            f"generator compiler does not support; it runs as a regular Python generator.",
             RuntimeWarning,
             stacklevel=4,
         )
@@ -398,6 +2975,8 @@ def _create_generator_wrapper(func, opt_level):
     max_stack_depth = func.__code__.co_stacksize
     total_locals = base_locals + max_stack_depth
     
+    yield_kind = {"int": "q", "float": "d"}.get(mode, "")
+    
     # Compile the generator to a step function
     success = jit_instance.compile_generator(
         instructions,
@@ -411,8 +2990,10 @@ def _create_generator_wrapper(func, opt_level):
         param_count,
         total_locals,
         nlocals,
+        yield_kind,
     )
     
+    _take_rejection(jit_instance, func, "generator", not success)
     if not success:
         warnings.warn(
             f"Failed to JIT compile generator '{func.__name__}'. "
@@ -422,47 +3003,22 @@ def _create_generator_wrapper(func, opt_level):
         )
         return func
     
-    # Get the step function address and metadata
-    gen_info = jit_instance.get_generator_callable(
+    # Native factory: binds arguments and creates a JIT generator per call
+    generator_factory = jit_instance.get_generator_callable(
         func.__name__,
         param_count,
         total_locals,
         func.__name__,
         func.__qualname__,
+        func.__code__.co_varnames[:param_count],
+        func.__defaults__,
+        yield_kind=yield_kind,
     )
     
-    if gen_info is None:
+    if generator_factory is None:
         return func
     
-    step_func_addr = gen_info["step_func_addr"]
-    num_locals = gen_info["num_locals"]
-    gen_name = gen_info["name"]
-    gen_qualname = gen_info["qualname"]
-    
-    @functools.wraps(func)
-    def generator_factory(*args, **kwargs):
-        """Factory function that creates a new JIT generator each time it's called."""
-        if kwargs:
-            # For simplicity, don't support kwargs in generators yet
-            # Fall back to original
-            return func(*args, **kwargs)
-        
-        if len(args) != param_count:
-            raise TypeError(
-                f"{func.__name__}() takes {param_count} positional arguments "
-                f"but {len(args)} were given"
-            )
-        
-        # Create a new JIT generator
-        gen = create_jit_generator(step_func_addr, num_locals, gen_name, gen_qualname)
-        
-        # Store arguments in the generator's locals array
-        # The generator's step function expects args at indices 0..param_count-1
-        for i, arg in enumerate(args):
-            gen._set_local(i, arg)
-        
-        return gen
-    
+    _copy_function_metadata(generator_factory, func)
     generator_factory._jit_instance = jit_instance
     generator_factory._original_func = func
     generator_factory._instructions = instructions
@@ -535,7 +3091,6 @@ def _create_coroutine_wrapper(func, opt_level):
     This compiles the async function into a state machine and returns a factory
     function that creates JIT coroutine objects when called.
     """
-    import functools
     import warnings
     
     # Check if this coroutine is simple enough for JIT compilation
@@ -585,6 +3140,7 @@ def _create_coroutine_wrapper(func, opt_level):
         nlocals,
     )
     
+    _take_rejection(jit_instance, func, "coroutine", not success)
     if not success:
         warnings.warn(
             f"Failed to JIT compile async function '{func.__name__}'. "
@@ -594,45 +3150,22 @@ def _create_coroutine_wrapper(func, opt_level):
         )
         return func
     
-    # Get the step function address and metadata
-    coro_info = jit_instance.get_generator_callable(
+    # Native factory: binds arguments and creates a JIT coroutine per call
+    coroutine_factory = jit_instance.get_generator_callable(
         func.__name__,
         param_count,
         total_locals,
         func.__name__,
         func.__qualname__,
+        func.__code__.co_varnames[:param_count],
+        func.__defaults__,
+        coroutine=True,
     )
     
-    if coro_info is None:
+    if coroutine_factory is None:
         return func
     
-    step_func_addr = coro_info["step_func_addr"]
-    num_locals = coro_info["num_locals"]
-    coro_name = coro_info["name"]
-    coro_qualname = coro_info["qualname"]
-    
-    @functools.wraps(func)
-    def coroutine_factory(*args, **kwargs):
-        """Factory function that creates a new JIT coroutine each time it's called."""
-        if kwargs:
-            # For simplicity, don't support kwargs in coroutines yet
-            return func(*args, **kwargs)
-        
-        if len(args) != param_count:
-            raise TypeError(
-                f"{func.__name__}() takes {param_count} positional arguments "
-                f"but {len(args)} were given"
-            )
-        
-        # Create a new JIT coroutine
-        coro = create_jit_coroutine(step_func_addr, num_locals, coro_name, coro_qualname)
-        
-        # Store arguments in the coroutine's locals array
-        for i, arg in enumerate(args):
-            coro._set_local(i, arg)
-        
-        return coro
-    
+    _copy_function_metadata(coroutine_factory, func)
     coroutine_factory._jit_instance = jit_instance
     coroutine_factory._original_func = func
     coroutine_factory._instructions = instructions
@@ -655,11 +3188,10 @@ def _create_async_generator_wrapper(func, opt_level):
     - athrow(exc) throws an exception into the generator
     - aclose() closes the generator
     
-    For now, we compile async generators using the same mechanism as
-    regular generators, but the caller (async for loop) must handle
-    the async protocol wrapping.
+    The generator is compiled like a regular one, with yielded values
+    wrapped by ASYNC_GEN_WRAP; the native JITAsyncGenerator type implements
+    the protocol on top of its step function.
     """
-    import functools
     import warnings
     
     # Compile using the generator compilation path
@@ -697,6 +3229,7 @@ def _create_async_generator_wrapper(func, opt_level):
         nlocals,
     )
     
+    _take_rejection(jit_instance, func, "async generator", not success)
     if not success:
         warnings.warn(
             f"Failed to JIT compile async generator '{func.__name__}'. "
@@ -706,47 +3239,22 @@ def _create_async_generator_wrapper(func, opt_level):
         )
         return func
     
-    # Get the step function address and metadata
-    gen_info = jit_instance.get_generator_callable(
+    # Native factory: binds arguments and creates a JITAsyncGenerator per call
+    async_generator_factory = jit_instance.get_generator_callable(
         func.__name__,
         param_count,
         total_locals,
         func.__name__,
         func.__qualname__,
+        func.__code__.co_varnames[:param_count],
+        func.__defaults__,
+        async_generator=True,
     )
     
-    if gen_info is None:
+    if async_generator_factory is None:
         return func
     
-    step_func_addr = gen_info["step_func_addr"]
-    num_locals = gen_info["num_locals"]
-    gen_name = gen_info["name"]
-    gen_qualname = gen_info["qualname"]
-    
-    @functools.wraps(func)
-    def async_generator_factory(*args, **kwargs):
-        """Factory function that creates a new async generator each time it's called."""
-        if kwargs:
-            # Fall back for kwargs (complex case)
-            return func(*args, **kwargs)
-        
-        if len(args) != param_count:
-            raise TypeError(
-                f"{func.__name__}() takes {param_count} positional arguments "
-                f"but {len(args)} were given"
-            )
-        
-        # Create a JIT generator as the underlying implementation
-        # The async generator protocol is handled by wrapping this
-        gen = create_jit_generator(step_func_addr, num_locals, gen_name, gen_qualname)
-        
-        # Store arguments in the generator's locals array
-        for i, arg in enumerate(args):
-            gen._set_local(i, arg)
-        
-        # Wrap in an async generator adapter
-        return _AsyncGeneratorAdapter(gen, gen_name, gen_qualname)
-    
+    _copy_function_metadata(async_generator_factory, func)
     async_generator_factory._jit_instance = jit_instance
     async_generator_factory._original_func = func
     async_generator_factory._instructions = instructions
@@ -756,76 +3264,92 @@ def _create_async_generator_wrapper(func, opt_level):
     return async_generator_factory
 
 
-class _AsyncGeneratorAdapter:
-    """Adapter that wraps a JIT generator to implement the async generator protocol.
-    
-    This provides the asynchronous iteration interface (__aiter__, __anext__, etc.)
-    on top of a synchronous JIT-compiled generator.
+def run_all(awaitables):
     """
-    
-    def __init__(self, inner_gen, name, qualname):
-        self._inner = inner_gen
-        self._name = name
-        self._qualname = qualname
-        self._closed = False
-    
-    def __aiter__(self):
-        return self
-    
-    async def __anext__(self):
-        if self._closed:
-            raise StopAsyncIteration
-        
-        try:
-            # Get next value from inner generator
-            value = self._inner.send(None)
-            return value
-        except StopIteration:
-            self._closed = True
-            raise StopAsyncIteration
-    
-    async def asend(self, value):
-        if self._closed:
-            raise StopAsyncIteration
-        
-        try:
-            result = self._inner.send(value)
-            return result
-        except StopIteration:
-            self._closed = True
-            raise StopAsyncIteration
-    
-    async def athrow(self, exc_type, exc_val=None, exc_tb=None):
-        if self._closed:
-            raise StopAsyncIteration
-        
+    Run awaitables to completion and return their results in order.
+
+    JIT coroutines (``@jit async def``) are driven by a native run queue that
+    resumes their step functions directly, including the JIT coroutines they
+    await, with no asyncio Task or Future per step. Only the ones that await
+    something an event loop must complete (an I/O future), and any awaitables
+    that are not JIT coroutines, are finished with ``asyncio.run``, so this
+    cannot be called from a running event loop in that case. The first
+    exception raised propagates.
+    """
+    results, blocked = _run_coroutines(list(awaitables))
+    if blocked:
+        import asyncio
+
+        async def finish():
+            return await asyncio.gather(*(_resume_on_loop(awaitable, pending) for _, awaitable, pending in blocked))
+
+        for (index, _, _), value in zip(blocked, asyncio.run(finish())):
+            results[index] = value
+    return results
+
+
+async def _resume_on_loop(awaitable, pending):
+    """Finish an awaitable the native scheduler handed back, waiting on `pending` first."""
+    import asyncio
+
+    if pending is None:  # Not a JIT coroutine, not started
+        return await awaitable
+    while True:
+        # The coroutine reads the future's result (or exception) itself when resumed
+        if pending is None:
+            await asyncio.sleep(0)
+        else:
+            await asyncio.wait((pending,))
         try:
-            if exc_val is None:
-                exc_val = exc_type()
-            return self._inner.throw(exc_type, exc_val, exc_tb)
-        except StopIteration:
-            self._closed = True
-            raise StopAsyncIteration
-    
-    async def aclose(self):
-        if not self._closed:
-            try:
-                self._inner.close()
-            except Exception:
-                pass
-            self._closed = True
-    
-    def __repr__(self):
-        return f"<async_gen_jit {self._qualname} at {id(self):#x}>"
+            pending = awaitable.send(None)
+        except StopIteration as stop:
+            return stop.value
 
 
 def _create_jit_wrapper(
-    func, opt_level, vectorize, inline, parallel, lazy, mode="auto"
+    func,
+    opt_level,
+    vectorize,
+    inline,
+    parallel,
+    lazy,
+    mode="auto",
+    async_compile=False,
+    tiered=False,
+    tier_threshold=1000,
+    unroll=True,
+    fastmath=False,
+    target_cpu=None,
+    target_features=None,
+    multiversion=False,
+    specialize=False,
+    profile_calls=100,
+    osr=False,
+    osr_threshold=1000,
+    signature=None,
+    int_overflow="deopt",
+    pgo=False,
+    freeze_globals=None,
+    transitive=False,
+    regions=False,
+    trace_loops=False,
+    trace_threshold=1000,
 ):
     """Create a JIT-compiled wrapper for the given function."""
     import warnings
     import functools
 
+    # The jit() call, so a pickled wrapper that is not a module global can be rebuilt
+    jit_options = dict(
+        opt_level=opt_level, vectorize=vectorize, inline=inline, parallel=parallel, lazy=lazy, mode=mode,
+        async_compile=async_compile, tiered=tiered, tier_threshold=tier_threshold, unroll=unroll,
+        fastmath=fastmath, target_cpu=target_cpu, target_features=target_features, multiversion=multiversion,
+        specialize=specialize, profile_calls=profile_calls, osr=osr, osr_threshold=osr_threshold,
+        signature=signature, int_overflow=int_overflow, pgo=pgo, freeze_globals=freeze_globals,
+        transitive=transitive, regions=regions, trace_loops=trace_loops, trace_threshold=trace_threshold,
+    )
+    source_func = func
+
     # Check if this is a generator function
     is_generator = _is_generator_or_coroutine(func)
     
@@ -839,9 +3363,31 @@ def _create_jit_wrapper(
     if flags & _CO_ASYNC_GENERATOR:
         return _create_async_generator_wrapper(func, opt_level)
 
+    # trace_loops=True: interpreted until a loop is hot, then compiled with its calls inlined (see trace_loops.py)
+    if trace_loops and mode in ("auto", "object") and signature is None and not is_generator:
+        from .trace_loops import TracingFunction
+
+        tracer = TracingFunction.create(func, dict(jit_options, trace_loops=False), trace_threshold)
+        if tracer is not None:
+            return tracer
+
+    # regions=True: qualifying loops become native-mode region functions (see regions.py)
+    outlined = False
+    if regions and mode in ("auto", "object") and signature is None and not is_generator:
+        from .regions import outline_regions
+
+        rewritten = outline_regions(func)
+        if rewritten is not None:
+            func, outlined = rewritten, True
+
     # Check bytecode for unsupported opcodes
     unsupported = _has_unsupported_opcodes(func)
     if unsupported == "exception":
+        instr = _first_unsupported_instruction(func)
+        _record_rejection(func, mode, "unsupported exception construct", instr.opname, instr.offset)
+        if outlined:
+            # The rest runs interpreted, calling its compiled regions
+            return func
         # Bug #3 Fix: Detect exception handling and skip JIT compilation
         warnings.warn(
             f"Function '{func.__name__}' uses unsupported exception constructs. "
@@ -859,23 +3405,18 @@ def _create_jit_wrapper(
             stacklevel=3,
         )
         return func
-    if unsupported == "pattern_matching":
-        # Structural pattern matching has complex control flow
-        warnings.warn(
-            f"Function '{func.__name__}' uses structural pattern matching "
-            f"(match/case with class/mapping/sequence patterns). "
-            f"The @jit decorator has no effect. Literal matching works fine.",
-            RuntimeWarning,
-            stacklevel=3,
-        )
-        return func
     
     # For generators, compile using the generator compilation path
     if is_generator:
-        return _create_generator_wrapper(func, opt_level)
+        return _create_generator_wrapper(func, opt_level, mode)
 
+    fastmath_flags = _fastmath_flags(fastmath)
     jit_instance = JIT()
     jit_instance.set_opt_level(opt_level)
+    jit_instance.set_pipeline_options(vectorize, inline, unroll)
+    jit_instance.set_fastmath_flags(fastmath_flags)
+    jit_instance.set_target(target_cpu or "", target_features or "")
+    jit_instance.set_multiversion(multiversion)
 
     instructions = _extract_bytecode(func)
     constants = _extract_constants(func)
@@ -884,7 +3425,9 @@ def _create_jit_wrapper(
     builtins_dict = _extract_builtins(func)  # For fallback lookup
     closure_cells = _extract_closure(func)
     exception_table = _parse_exception_table(func)  # Bug #3 Fix: Exception handling
-    param_count = func.__code__.co_argcount
+    # Keyword-only parameters, *args and **kwargs are entry arguments too; the JITFunction binds them
+    param_count = _parameter_slots(func.__code__)
+    positional_count = func.__code__.co_argcount
 
     # Calculate local slot layout:
     # - nlocals: number of local variables (co_nlocals)
@@ -896,6 +3439,29 @@ def _create_jit_wrapper(
     num_freevars = len(func.__code__.co_freevars)
     total_locals = nlocals + num_cellvars + num_freevars
 
+    if int_overflow not in ("deopt", "raise", "wrap"):
+        raise ValueError(f"int_overflow must be 'deopt', 'raise' or 'wrap', not {int_overflow!r}")
+    if tiered not in (False, True, "baseline"):
+        raise ValueError(f"tiered must be False, True or 'baseline', not {tiered!r}")
+
+    # Native-mode types: an explicit signature, or int/float/bool annotations on every parameter
+    # Report why native mode rejects a function (a region just runs in object mode instead)
+    native_explain = not getattr(func, "_justjit_region", False)
+    if signature is not None:
+        if mode not in ("auto", "native"):
+            raise ValueError(f"signature= requires mode='native', not mode={mode!r}")
+        native_param_types, native_return_type = _parse_signature(func, signature)
+        mode = "native"
+    else:
+        native_param_types, native_return_type, annotated = _annotated_signature(func)
+        if mode == "auto" and annotated:
+            # If native mode cannot type it, fall back to object mode without a warning
+            mode = "native"
+            native_explain = False
+    native_param_types, native_return_type, native_records = _native_records(
+        func, native_param_types, native_return_type
+    )
+
     # Determine compilation mode
     use_int_mode = mode == "int"
     use_float_mode = mode == "float"
@@ -906,114 +3472,428 @@ def _create_jit_wrapper(
     use_ptr_mode = mode == "ptr"
     use_vec4f_mode = mode == "vec4f"
     use_vec8i_mode = mode == "vec8i"
+    use_wide_vector_mode = mode in _WIDE_VECTOR_MODES or mode in _NARROW_VECTOR_MODES
     use_complex64_mode = mode == "complex64"
     use_optional_f64_mode = mode == "optional_f64"
+    use_native_mode = mode == "native"
+
+    # parallel=True: prange() loops of int/float functions run on the thread pool
+    prange_loops = _prange_loops(func) if parallel and mode in ("int", "float") else []
+
+    # transitive=True: the plain functions this one calls compile lazily with these options
+    transitive_options = None
+    if transitive and mode in ("auto", "object", "int", "float", "native"):
+        transitive_options = dict(
+            opt_level=opt_level, vectorize=vectorize, inline=inline, unroll=unroll, fastmath=fastmath,
+            target_cpu=target_cpu, target_features=target_features, multiversion=multiversion,
+            int_overflow=int_overflow, freeze_globals=freeze_globals,
+            # Native mode has no signature for helpers; annotated ones get theirs under 'auto'
+            mode=mode if mode in ("int", "float") else "auto",
+        )
+
+    # freeze_globals: immutable globals compile in as constants, guarded at entry
+    if freeze_globals is None:
+        freeze_globals = mode in ("int", "float", "native")
+    freeze_globals = freeze_globals and mode in _FREEZE_MODES
+    frozen_values = {}  # name -> value the current code was compiled with
+
+    # Object-mode closures share one compile per code object (see _shared_closure_cores)
+    # (DELETE_DEREF still names its cell at compile time)
+    shared_closure = (
+        bool(func.__code__.co_freevars)
+        and not pgo
+        and not any(instr.opname == "DELETE_DEREF" for instr in dis.get_instructions(func))
+    )
 
     compiled_ptr = None
+    compile_future = None
+    compile_failed = False
+    # Held while this function compiles, tiers up, specializes or unloads. Calls
+    # finding it busy run the interpreter instead of waiting (free-threaded
+    # Pythons call from many threads at once); only unload() waits for it.
+    compile_lock = threading.Lock()
+    natives = []  # Every JITFunction over this function's code, cleared by unload()
+    # Code unload() took out of use while a call may still run it: (core, its
+    # name to unload) and the callers whose direct calls may still reach it
+    retired_cores = []
+    retired_callers = []
 
-    def wrapper(*args, **kwargs):
-        nonlocal compiled_ptr
+    # Tiered compilation: start at O1 (or in copied stencils), recompile at opt_level once hot
+    baseline = tiered == "baseline" and mode in ("auto", "object") and baseline_available()
+    tier_up_pending = baseline or (tiered and opt_level > 1)
+    if tier_up_pending and not baseline:
+        jit_instance.set_opt_level(1)
+        # pgo: tier 1 profiles its branches for tier 2
+        jit_instance.set_profile_instrumentation(pgo)
+    call_count = 0
+    tier_up_future = None
+    tier_cores = [jit_instance]  # Keep every tier's code alive
 
-        if compiled_ptr is None:
-            if use_int_mode:
-                # Integer mode - pure native i64 operations
-                success = jit_instance.compile_int(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_int_callable(func.__name__, param_count)
-            elif use_float_mode:
-                # Float mode - pure native f64 operations
-                success = jit_instance.compile_float(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_float_callable(func.__name__, param_count)
-            elif use_bool_mode:
-                # Bool mode - pure native boolean operations
-                success = jit_instance.compile_bool(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_bool_callable(func.__name__, param_count)
-            elif use_int32_mode:
-                # Int32 mode - 32-bit integer for C interop
-                success = jit_instance.compile_int32(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_int32_callable(func.__name__, param_count)
-            elif use_float32_mode:
-                # Float32 mode - 32-bit float for SIMD/ML
-                success = jit_instance.compile_float32(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_float32_callable(func.__name__, param_count)
-            elif use_complex128_mode:
-                # Complex128 mode - native {double,double} struct for complex numbers
-                success = jit_instance.compile_complex128(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_complex128_callable(func.__name__, param_count)
-            elif use_ptr_mode:
-                # Ptr mode - array element access via GEP
-                success = jit_instance.compile_ptr(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_ptr_callable(func.__name__, param_count)
-            elif use_vec4f_mode:
-                # Vec4f mode - SSE SIMD <4 x float>
-                success = jit_instance.compile_vec4f(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_vec4f_callable(func.__name__, param_count)
-            elif use_vec8i_mode:
-                # Vec8i mode - AVX SIMD <8 x i32>
-                success = jit_instance.compile_vec8i(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_vec8i_callable(func.__name__, param_count)
-            elif use_complex64_mode:
-                # Complex64 mode - single-precision complex {float, float}
-                success = jit_instance.compile_complex64(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_complex64_callable(func.__name__, param_count)
-            elif use_optional_f64_mode:
-                # Optional<f64> mode - nullable float64 {i1, f64}
-                success = jit_instance.compile_optional_f64(
-                    instructions, constants, func.__name__, param_count, total_locals
-                )
-                if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_optional_f64_callable(func.__name__, param_count)
+    # Value specialization: specialize=('name', ...) compiles a clone per distinct value
+    value_slots = ()
+    if isinstance(specialize, str):
+        specialize = (specialize,)
+    if isinstance(specialize, (tuple, list)):
+        value_slots, specialize = _value_slots(func, specialize), False
+    # Shape specialization: in native mode, specialize=True clones per small, stable array argument shape
+    value_shapes = False
+    if specialize is True and use_native_mode:
+        value_slots = tuple(
+            slot for slot, kind in enumerate(native_param_types)
+            if isinstance(kind, str) and kind.endswith("]") and not kind.startswith("record:")
+        )
+        value_shapes = bool(value_slots)
+    shape_sightings = collections.Counter()  # Shape key -> calls seen before its clone
+    value_clones = {}  # Value (tuple for several) -> (clone or None, argument types...); the JITFunction reads it
+    value_cores = []  # Keep every clone's code alive
+
+    # Type-feedback specialization (object mode only)
+    use_specialize = specialize and mode in ("auto", "object") and profile_calls > 0
+    profile_remaining = profile_calls
+    profiled_arg_types = set()
+    profiled_result_types = set()
+    specialized = None  # (argument type, native callable) once specialized
+
+    # On-stack replacement (object mode): interpreted calls leave at a hot loop header
+    osr_headers = _osr_headers(func) if osr and mode in ("auto", "object") else set()
+    osr_counts = collections.Counter()  # loop header -> backward jumps seen
+    osr_entries = {}  # loop header -> compile Future, native entry, or None if not enterable
+    osr_cores = []  # Keep every OSR entry's code alive
+
+    # Hotness sampling: while the sampler runs, calls stay interpreted until
+    # it finds the function hot; a loaded profile's hot set compiles up front.
+    # Either way the compile runs on the background worker.
+    hot_key = f"{func.__module__}.{func.__qualname__}"
+    precompile = not async_compile and hotness.is_hot(hot_key)
+    cold = not async_compile and not precompile and hotness.sampling()
+    background_compile = async_compile or precompile or cold
+
+    if osr_headers:
+
+        def interpret(*args, **kwargs):
+            return _osr_run(func, args, kwargs)
+
+    else:
+        interpret = func
+
+    def compile_native(core, values=None, shapes=None):
+        """
+        Compile the function on ``core``; returns the native callable (deoptimizing to ``func``) or None.
+        ``values`` ({argument slot: value}) compiles a value-specialized clone,
+        ``shapes`` ({argument slot: shape}) one with constant array extents.
+        """
+        started = time.perf_counter()
+        native = compile_mode(core, values, shapes)
+        seconds = time.perf_counter() - started
+        _record_compile(wrapper._mode, seconds)
+        # Native mode may give up and still produce object-mode code: keep its reason too
+        _take_rejection(core, func, wrapper._mode, native is None)
+        if native:
+            compile_stats = core.get_compile_stats(func.__name__)
+            if compile_stats:
+                compile_stats["wall"] = seconds
+                wrapper._jit_compile_stats = compile_stats
+        if native is not None and type(native) is type(wrapper):
+            adopt(native)
+        if _cache_backend is not None:
+            _flush_cache_uploads()
+        return native
+
+    def compile_baseline(core):
+        """Copy-and-patch the first version on ``core`` (tiered='baseline'); None if the stencils cannot express it."""
+        code = func.__code__
+        started = time.perf_counter()
+        if not core.compile_baseline(instructions, constants, names, list(code.co_varnames), globals_dict,
+                                     builtins_dict, func.__name__, code.co_nlocals, code.co_stacksize):
+            return None
+        _record_compile("baseline", time.perf_counter() - started)
+        native = core.get_baseline_callable(func.__name__, param_count)
+        adopt(native)
+        return native
+
+    def adopt(native):
+        """Send ``native``'s deoptimizations back to the interpreter and its statistics to the wrapper."""
+        fallback = frozen_fallback if frozen_values else interpret
+        native._set_fallback(fallback)
+        if use_int_mode:
+            native._set_resume(_deopt_resumer(func, fallback))
+        native._count_into(wrapper)
+        natives.append(native)
+
+    def freeze(core):
+        """Bytecode and constants for a compile on ``core``, with the frozen globals' current values."""
+        nonlocal frozen_values
+        frozen_values = _frozen_globals(func) if freeze_globals else {}
+        core.set_frozen_globals(globals_dict, builtins_dict, list(frozen_values), list(frozen_values.values()))
+        return _freeze_bytecode(func, instructions, constants, frozen_values)
+
+    def frozen_fallback(*args, **kwargs):
+        """Deoptimization target of code with frozen globals: recompile once one was rebound."""
+        if _frozen_changed(func, frozen_values):
+            if background_compile:
+                _get_compile_executor().submit(refreeze)
             else:
-                # Object mode - handles Python objects with closure support
-                # Bug #4 Fix: Pass globals_dict and builtins_dict for runtime lookup
-                # Bug #3 Fix: Pass exception_table for try/except handling
-                success = jit_instance.compile(
+                refreeze()
+        return interpret(*args, **kwargs)
+
+    def refreeze():
+        """Compile again, on a new core, with the current values of the frozen globals."""
+        nonlocal compiled_ptr
+        if not compile_lock.acquire(blocking=False):
+            return  # Another thread is compiling; a later call retries
+        try:
+            if not _frozen_changed(func, frozen_values):
+                return  # Already recompiled
+            # The old code stays mapped: calls further up the stack may still run it
+            core = JIT()
+            core.set_hot_code(True)
+            core.set_opt_level(wrapper._jit_instance.get_opt_level())
+            core.set_pipeline_options(vectorize, inline, unroll)
+            core.set_fastmath_flags(fastmath_flags)
+            core.set_target(target_cpu or "", target_features or "")
+            core.set_multiversion(multiversion)
+            native = compile_native(core)
+            if native is None:
+                return
+            tier_cores.append(core)
+            wrapper._jit_instance = core
+            compiled_ptr = native
+            _register_code(wrapper, tier_cores, func.__name__)
+            publish_native()
+            # Clones compiled the old values in too; their code stays mapped like the old tier's
+            value_clones.clear()
+            if value_slots:
+                wrapper._set_value_clones(value_slots, value_clones, True, value_shapes)
+        finally:
+            compile_lock.release()
+
+    def add_value_clone(key, types):
+        """Table entry for a new value ``key``, compiling its clone if it can; None while another thread compiles."""
+        if not compile_lock.acquire(blocking=False):
+            return None
+        try:
+            if key not in value_clones and len(value_clones) < _VALUE_CLONE_LIMIT:
+                values = key if len(value_slots) > 1 else (key,)
+                clonable = all(map(_shape_clonable if value_shapes else _value_clonable, values))
+                if value_shapes and clonable:
+                    shape_sightings[key] += 1
+                    if shape_sightings[key] < _SHAPE_CLONE_CALLS:
+                        return None  # Not stable yet: the generic code runs this call
+                    del shape_sightings[key]
+                clone = None
+                if clonable:
+                    core = JIT()
+                    core.set_hot_code(True)
+                    core.set_opt_level(wrapper._jit_instance.get_opt_level())
+                    core.set_pipeline_options(vectorize, inline, unroll)
+                    core.set_fastmath_flags(fastmath_flags)
+                    core.set_target(target_cpu or "", target_features or "")
+                    core.set_multiversion(multiversion)
+                    if value_shapes:
+                        clone = compile_native(core, shapes=dict(zip(value_slots, values)))
+                    else:
+                        clone = compile_native(core, dict(zip(value_slots, values)))
+                    if clone is not None:
+                        value_cores.append(core)
+                value_clones[key] = (clone, *types)
+                if len(value_clones) >= _VALUE_CLONE_LIMIT:
+                    # Full: later values take the generic code without leaving native dispatch
+                    wrapper._set_value_clones(value_slots, value_clones, False, value_shapes)
+            return value_clones.get(key)
+        finally:
+            compile_lock.release()
+
+    def compile_native_mode(core, instructions, constants, helpers, shapes=None):
+        """Native-mode compile on ``core``; False when native mode cannot type the function."""
+        # Consecutive loops over the same range run as one; object mode keeps the original bytecode
+        instructions, disjoint = _fuse_range_loops(func, instructions, native_param_types)
+        core.set_native_records(native_records)
+        core.set_native_shapes(shapes or {})
+        core.set_native_disjoint(disjoint)
+        core.set_native_callees(globals_dict, builtins_dict, _native_callees(func, wrapper, "native", helpers))
+        return core.compile_native(
+            instructions,
+            constants,
+            names,
+            func.__name__,
+            param_count,
+            total_locals,
+            native_param_types,
+            native_return_type,
+            native_explain,
+        )
+
+    def compile_mode(core, values=None, shapes=None):
+        """Compile the function on ``core`` for the selected mode; returns the native callable or None."""
+        instructions, constants = freeze(core)
+        if values:
+            instructions, constants = _specialize_bytecode(instructions, constants, values)
+        typed_locals, parallel_loops = total_locals, prange_loops
+        helpers = None
+        if transitive_options is not None:
+            helpers = _transitive_callees(func, transitive_options)
+            core.set_transitive_callees(helpers)
+        if use_int_mode or use_float_mode:
+            # sum()/min()/max()/any()/all() over generator expressions become loops of this function
+            instructions, constants, typed_locals, offsets = _inline_reductions(func, instructions, constants, total_locals)
+            if offsets is not None:
+                parallel_loops = [offsets[offset] for offset in prange_loops]
+        if use_int_mode:
+            # Integer mode - pure native i64 operations
+            core.set_native_callees(globals_dict, builtins_dict, _native_callees(func, wrapper, "int", helpers))
+            core.set_bit_calls(_bits_calls(func, offsets))
+            core.set_raise_sites(_raise_sites(func, offsets))
+            core.set_parallel_loops(parallel_loops)
+            success = core.compile_int(
+                instructions, constants, func.__name__, param_count, typed_locals, int_overflow
+            )
+            if not success:
+                return None
+            return core.get_int_callable(func.__name__, param_count)
+        elif use_float_mode:
+            # Float mode - pure native f64 operations
+            core.set_native_callees(globals_dict, builtins_dict, _native_callees(func, wrapper, "float", helpers))
+            core.set_raise_sites(_raise_sites(func, offsets))
+            core.set_parallel_loops(parallel_loops)
+            success = core.compile_float(
+                instructions, constants, func.__name__, param_count, typed_locals
+            )
+            if not success:
+                return None
+            return core.get_float_callable(func.__name__, param_count)
+        elif use_bool_mode:
+            # Bool mode - pure native boolean operations
+            success = core.compile_bool(
+                instructions, constants, func.__name__, param_count, total_locals
+            )
+            if not success:
+                return None
+            return core.get_bool_callable(func.__name__, param_count)
+        elif use_int32_mode:
+            # Int32 mode - 32-bit integer for C interop
+            core.set_bit_calls(_bits_calls(func))
+            success = core.compile_int32(
+                instructions, constants, func.__name__, param_count, total_locals
+            )
+            if not success:
+                return None
+            return core.get_int32_callable(func.__name__, param_count)
+        elif use_float32_mode:
+            # Float32 mode - 32-bit float for SIMD/ML
+            success = core.compile_float32(
+                instructions, constants, func.__name__, param_count, total_locals
+            )
+            if not success:
+                return None
+            return core.get_float32_callable(func.__name__, param_count)
+        elif use_complex128_mode:
+            # Complex128 mode - native {double,double} struct for complex numbers
+            success = core.compile_complex128(
+                instructions, constants, func.__name__, param_count, total_locals
+            )
+            if not success:
+                return None
+            return core.get_complex128_callable(func.__name__, param_count)
+        elif use_ptr_mode:
+            # Ptr mode - array element access via GEP
+            success = core.compile_ptr(
+                instructions, constants, func.__name__, param_count, total_locals
+            )
+            if not success:
+                return None
+            return core.get_ptr_callable(func.__name__, param_count)
+        elif use_vec4f_mode:
+            # Vec4f mode - SSE SIMD <4 x float>
+            core.set_simd_calls(_simd_calls(func))
+            success = core.compile_vec4f(
+                instructions, constants, func.__name__, param_count, total_locals
+            )
+            if not success:
+                return None
+            return core.get_vec4f_callable(func.__name__, param_count)
+        elif use_vec8i_mode:
+            # Vec8i mode - AVX SIMD <8 x i32>
+            core.set_simd_calls(_simd_calls(func))
+            success = core.compile_vec8i(
+                instructions, constants, func.__name__, param_count, total_locals
+            )
+            if not success:
+                return None
+            return core.get_vec8i_callable(func.__name__, param_count)
+        elif use_wide_vector_mode:
+            # vec8d/vec16f/vec16i - 512-bit SIMD, split into narrower vectors without AVX-512;
+            # vec16u8/vec32u8/vec16i16 - saturating u8/i16 lanes
+            core.set_simd_calls(_simd_calls(func))
+            success = getattr(core, "compile_" + mode)(
+                instructions, constants, func.__name__, param_count, total_locals
+            )
+            if not success:
+                return None
+            return getattr(core, "get_" + mode + "_callable")(func.__name__, param_count)
+        elif use_complex64_mode:
+            # Complex64 mode - single-precision complex {float, float}
+            success = core.compile_complex64(
+                instructions, constants, func.__name__, param_count, total_locals
+            )
+            if not success:
+                return None
+            return core.get_complex64_callable(func.__name__, param_count)
+        elif use_optional_f64_mode:
+            # Optional<f64> mode - nullable float64 {i1, f64}
+            success = core.compile_optional_f64(
+                instructions, constants, func.__name__, param_count, total_locals
+            )
+            if not success:
+                return None
+            return core.get_optional_f64_callable(func.__name__, param_count)
+        elif use_native_mode and compile_native_mode(core, instructions, constants, helpers, shapes):
+            # Native mode - per-variable int/float/bool; functions it can't type use object mode below
+            return core.get_native_callable(func.__name__, param_count)
+        elif shared_closure and not frozen_values and not values:
+            return compile_shared_closure(core)
+        else:
+            # Object mode - handles Python objects with closure support
+            # Bug #4 Fix: Pass globals_dict and builtins_dict for runtime lookup
+            # Bug #3 Fix: Pass exception_table for try/except handling
+            success = core.compile(
+                instructions,
+                constants,
+                names,
+                globals_dict,
+                builtins_dict,
+                closure_cells,
+                exception_table,
+                func.__name__,
+                param_count,
+                total_locals,
+                nlocals,
+            )
+            if not success:
+                return None
+            return core.get_callable(func.__name__, param_count)
+
+    def compile_shared_closure(core):
+        """Object-mode code for every closure of ``func.__code__``, compiled by the first; this closure is its last argument."""
+        key = (func.__code__, id(globals_dict), core.get_opt_level(), vectorize, inline, unroll,
+               tuple(fastmath_flags), target_cpu, target_features, multiversion)
+        with _shared_closure_lock:
+            shared = _shared_closure_cores.get(key)
+            if shared is None:
+                # Its own core: unloading one closure must not free code the others run
+                shared = JIT()
+                shared.set_opt_level(core.get_opt_level())
+                shared.set_pipeline_options(vectorize, inline, unroll)
+                shared.set_fastmath_flags(fastmath_flags)
+                shared.set_target(target_cpu or "", target_features or "")
+                shared.set_multiversion(multiversion)
+                shared.set_closure_argument(True)
+                success = shared.compile(
                     instructions,
                     constants,
                     names,
                     globals_dict,
                     builtins_dict,
-                    closure_cells,
+                    [],
                     exception_table,
                     func.__name__,
                     param_count,
@@ -1021,53 +3901,589 @@ def _create_jit_wrapper(
                     nlocals,
                 )
                 if not success:
-                    return func(*args, **kwargs)
-                compiled_ptr = jit_instance.get_callable(func.__name__, param_count)
+                    return None
+                _shared_closure_cores[key] = shared
+        native = shared.get_callable(func.__name__, param_count)
+        if native is not None:
+            native._set_closure(func.__closure__)
+        return native
+
+    def compile_osr(header):
+        """Compile an object-mode entry at loop ``header`` taking every local; returns the callable or None."""
+        osr_name = f"{func.__name__}__osr{header}"
+        try:
+            core = JIT()
+            core.set_opt_level(opt_level)
+            core.set_pipeline_options(vectorize, inline, unroll)
+            core.set_fastmath_flags(fastmath_flags)
+            core.set_target(target_cpu or "", target_features or "")
+            core.set_multiversion(multiversion)
+            if not core.compile(
+                instructions,
+                constants,
+                names,
+                globals_dict,
+                builtins_dict,
+                closure_cells,
+                exception_table,
+                osr_name,
+                nlocals,
+                total_locals,
+                nlocals,
+                header,
+            ):
+                return None
+            native = core.get_callable(osr_name, nlocals)
+        except Exception as error:
+            _record_compile_error(func, "object", error)
+            return None
+        osr_cores.append(core)
+        return native
+
+    def osr_jump(frame, header):
+        """Backward jump of a running interpreted call; raises _OSRTransfer to continue natively."""
+        if header not in osr_headers:
+            return sys.monitoring.DISABLE
+        if header not in osr_entries:
+            osr_counts[header] += 1
+            if osr_counts[header] >= osr_threshold:
+                # The interpreter keeps running the loop while the entry compiles
+                osr_entries[header] = _get_compile_executor().submit(compile_osr, header)
+            return None
+        entry = osr_entries[header]
+        if entry is not None and not callable(entry):  # Still the compile Future
+            if not entry.done():
+                return None
+            entry = osr_entries[header] = entry.result()
+        if entry is None:
+            return sys.monitoring.DISABLE
+        f_locals = frame.f_locals
+        try:
+            values = [f_locals[name] for name in func.__code__.co_varnames]
+        except KeyError:
+            return None  # A local is still unbound at the header; retry on a later iteration
+        raise _OSRTransfer(entry, values)
+
+    def on_hot():
+        """Sampler thread: the function is hot; the next call starts its compile."""
+        nonlocal cold, tier_up_pending
+        if tier_up_pending:
+            # Only hot code is compiled, so it goes straight to the top tier
+            jit_instance.set_opt_level(opt_level)
+            jit_instance.set_profile_instrumentation(False)
+            tier_up_pending = False
+        jit_instance.set_hot_code(True)
+        cold = False
+
+    def on_hot_loop(header):
+        """Sampler thread: a loop of a running interpreted call is hot; enter it natively."""
+        if header in osr_headers and header not in osr_entries:
+            osr_counts[header] = max(osr_counts[header], osr_threshold - 1)
+
+    def compile_native_in_background():
+        # Errors in the worker thread become an interpreted fallback instead
+        # of surfacing from an unrelated later call; report() still lists them.
+        try:
+            return compile_native(jit_instance)
+        except Exception as error:
+            _record_compile_error(func, wrapper._mode, error)
+            return None
+
+    def compile_top_tier():
+        # Tier 2 gets its own core: symbols are unique per JITDylib, and the
+        # tier-1 code must stay mapped while other threads may still run it.
+        try:
+            core = JIT()
+            core.set_hot_code(True)
+            core.set_opt_level(opt_level)
+            core.set_pipeline_options(vectorize, inline, unroll)
+            core.set_fastmath_flags(fastmath_flags)
+            core.set_target(target_cpu or "", target_features or "")
+            core.set_multiversion(multiversion)
+            if pgo and not baseline:
+                core.set_branch_profile(func.__name__, jit_instance.get_branch_profile(func.__name__))
+            native = compile_native(core)
+        except Exception as error:
+            _record_compile_error(func, wrapper._mode, error)
+            return None
+        if native is None:
+            return None
+        return core, native
+
+    def _tier_up_check():
+        """Count a tier-1 call; swap in the O3 code once its compile finishes."""
+        if not compile_lock.acquire(blocking=False):
+            return  # Another thread is checking; this call goes uncounted
+        try:
+            _tier_up_check_locked()
+        finally:
+            compile_lock.release()
+
+    def _tier_up_check_locked():
+        nonlocal compiled_ptr, call_count, tier_up_future, tier_up_pending
+        if tier_up_future is None:
+            call_count += 1
+            if call_count >= tier_threshold:
+                tier_up_future = _get_compile_executor().submit(compile_top_tier)
+        elif tier_up_future.done():
+            tier_up_pending = False
+            result = tier_up_future.result()
+            if result is not None:
+                if _tracing():
+                    _trace_instant("tier_up", "runtime", func.__name__)
+                tier_cores.append(result[0])
+                wrapper._jit_instance = result[0]
+                compiled_ptr = result[1]
+                _register_code(wrapper, tier_cores, func.__name__)
+                publish_native()
+
+    def compile_specialized(spec_mode):
+        """Compile an int/float-mode version for profiled arguments; returns the callable or None."""
+        try:
+            core = JIT()
+            core.set_opt_level(opt_level)
+            core.set_pipeline_options(vectorize, inline, unroll)
+            core.set_fastmath_flags(fastmath_flags)
+            core.set_target(target_cpu or "", target_features or "")
+            core.set_multiversion(multiversion)
+            # Self-calls stay native; the guard still checks the global binding
+            core.set_native_callees(globals_dict, builtins_dict, _native_callees(func, wrapper, spec_mode))
+            compile_fn = getattr(core, "compile_" + spec_mode)
+            spec_instructions, spec_constants, spec_locals, offsets = _inline_reductions(func, instructions, constants, total_locals)
+            if spec_mode == "int":
+                core.set_bit_calls(_bits_calls(func, offsets))
+            core.set_raise_sites(_raise_sites(func, offsets))
+            if not compile_fn(spec_instructions, spec_constants, func.__name__, param_count, spec_locals):
+                return None
+            native = getattr(core, "get_" + spec_mode + "_callable")(func.__name__, param_count)
+            # Arguments the native types can't hold (e.g. ints beyond int64) take the generic code
+            native._set_fallback(call_generic)
+            native._count_into(wrapper)
+        except Exception as error:
+            _record_compile_error(func, spec_mode, error)
+            return None
+        tier_cores.append(core)
+        natives.append(native)
+        return native
+
+    def _profile_call(args, result):
+        """Record one call's types; specialize once profile_calls calls have been seen."""
+        if not compile_lock.acquire(blocking=False):
+            return  # Another thread is profiling or specializing
+        try:
+            _profile_call_locked(args, result)
+        finally:
+            compile_lock.release()
+
+    def _profile_call_locked(args, result):
+        nonlocal profile_remaining, specialized
+        if not profile_remaining:
+            return  # Another thread specialized first
+        profiled_arg_types.update(type(a) for a in args)
+        profiled_result_types.add(type(result))
+        profile_remaining -= 1
+        if profile_remaining:
+            return
+        spec_mode = _specialized_mode(func, profiled_arg_types, profiled_result_types)
+        if spec_mode is not None and param_count > 0:
+            native = compile_specialized(spec_mode)
+            if native is not None:
+                specialized = (int if spec_mode == "int" else float, native)
+                _register_code(wrapper, tier_cores, func.__name__)
+
+    def publish_native():
+        """Let calls jump straight to ``compiled_ptr`` once no per-call bookkeeping is left."""
+        if tier_up_pending or use_specialize or _code_limit:
+            return
+        if type(compiled_ptr) is type(wrapper):
+            wrapper._set_native(compiled_ptr)
+
+    def unload(wait=True):
+        """
+        Release the native code and the Python references it holds; the next
+        call recompiles. ``wait=False`` (code-limit eviction) returns False
+        instead of waiting while this function or a caller is being compiled.
+        Code a call may still be running is freed once it returns (see free_retired).
+        """
+        if not compile_lock.acquire(blocking=wait):
+            return False
+        try:
+            return unload_locked(wait)
+        finally:
+            compile_lock.release()
+
+    def unload_locked(wait):
+        nonlocal compiled_ptr, compile_future, compile_failed
+        nonlocal call_count, tier_up_future, tier_up_pending
+        nonlocal profile_remaining, specialized
+        # Callers holding direct calls into this code go first
+        for dependent in list(wrapper._jit_dependents):
+            if dependent.unload(wait) is False:
+                return False  # Still called directly: keep this code
+            wrapper._jit_dependents.discard(dependent)
+            retired_callers.append(dependent)
+        # New calls, and old references to the natives, run the interpreter from here on
+        wrapper._set_native(None)
+        for native in natives:
+            native._set_native(None)
+        del natives[:]
+        compiled_ptr = None
+        compile_future = None
+        compile_failed = False
+        retired_cores.extend((core, True) for core in tier_cores)
+        retired_cores.extend((core, True) for core in value_cores)
+        retired_cores.extend((core, False) for core in osr_cores)
+        del tier_cores[1:]
+        wrapper._jit_instance = jit_instance
+        tier_up_pending = baseline or (tiered and opt_level > 1)
+        call_count = 0
+        tier_up_future = None
+        profile_remaining = profile_calls
+        profiled_arg_types.clear()
+        profiled_result_types.clear()
+        specialized = None
+        del value_cores[:]
+        value_clones.clear()
+        shape_sightings.clear()
+        if value_slots:
+            wrapper._set_value_clones(value_slots, value_clones, True, value_shapes)
+        osr_counts.clear()
+        osr_entries.clear()
+        del osr_cores[:]
+        _code_lru.pop(id(wrapper), None)
+        if not free_retired():
+            _unloads_pending.add(wrapper)
+        return True
+
+    def running():
+        """Whether a call may still be running this function's unloaded code, or a caller's that calls it directly."""
+        return wrapper._active_calls() > 0 or any(caller._jit_running() for caller in retired_callers)
+
+    def free_retired():
+        """
+        Free the code unload() retired once no call runs it; False while one
+        still may. Until then this function's name stays defined on its core,
+        so compiles wait and calls run the interpreter.
+        """
+        if not retired_cores:
+            return True
+        if running():
+            return False
+        for core, owns_name in retired_cores:
+            if owns_name:
+                core.unload(func.__name__)
+        del retired_cores[:]
+        del retired_callers[:]
+        _unloads_pending.discard(wrapper)
+        return True
+
+    def free_retired_unlocked():
+        """free_retired() for _register_code's sweep; False while this function is busy or still running."""
+        if not compile_lock.acquire(blocking=False):
+            return False
+        try:
+            return free_retired()
+        finally:
+            compile_lock.release()
+
+    def native_address():
+        """Native entry point for direct calls from other @jit functions (0 if unavailable)."""
+        nonlocal compiled_ptr, tier_up_pending
+        if compiled_ptr is None:
+            if background_compile or compile_failed or id(wrapper) in _native_resolving:
+                return 0
+            # Waiting could deadlock with a thread compiling a callee of ours
+            if not compile_lock.acquire(blocking=False):
+                return 0
+            try:
+                if compiled_ptr is None:
+                    if not free_retired():
+                        return 0
+                    if baseline:
+                        tier_up_pending = False  # Direct calls need LLVM code: compile it at opt_level now
+                    native = compile_native(jit_instance)
+                    if native is None:
+                        return 0
+                    _register_code(wrapper, tier_cores, func.__name__)
+                    compiled_ptr = native
+                    publish_native()
+            finally:
+                compile_lock.release()
+        if frozen_values:
+            return 0  # A direct call would skip the entry's frozen-global guards
+        return wrapper._jit_instance.lookup(func.__name__)
+
+    def precompile_now(lazy=False):
+        """
+        precompile_all(): compile now, top tier included; True if native code is installed.
+        ``lazy`` (compile_many) leaves optimization and machine code to the first call.
+        """
+        with compile_lock:
+            jit_instance.set_lazy_materialize(lazy)
+            try:
+                installed = precompile_locked()
+            finally:
+                jit_instance.set_lazy_materialize(False)
+            if not installed:
+                return False
+        if tier_up_pending:
+            tier_up_future.result()
+            _tier_up_check()
+        return compiled_ptr is not None
+
+    def precompile_locked():
+        nonlocal compiled_ptr, compile_future, compile_failed, cold, tier_up_future
+        if compiled_ptr is None and not compile_failed:
+            if not free_retired():
+                return False
+            if compile_future is not None:
+                native = compile_future.result()
+            else:
+                on_hot()  # Nothing profiles it before fork: straight to the top tier
+                native = compile_native(jit_instance)
+            cold = False
+            if native is None:
+                compile_failed = True
+                return False
+            _register_code(wrapper, tier_cores, func.__name__)
+            compiled_ptr = native
+            publish_native()
+        if tier_up_pending and tier_up_future is None:
+            tier_up_future = _get_compile_executor().submit(compile_top_tier)
+        return compiled_ptr is not None
+
+    exported = None  # (target, object) for pickling once built, False if the code cannot be exported
+
+    def export_object():
+        """
+        ``(target, object)`` a pickled copy of this function links instead of
+        compiling (see _reduce_jit_function), or None. Only typed code free of
+        process-specific addresses is exported: no direct calls to other
+        functions, frozen globals, prange loops or branch profiles.
+        """
+        nonlocal exported
+        with compile_lock:
+            if exported is None:
+                exported = False
+                if wrapper._mode in aot.AOT_MODES and not multiversion and not prange_loops and not pgo:
+                    core = JIT()
+                    core.set_opt_level(opt_level)
+                    core.set_pipeline_options(vectorize, inline, unroll)
+                    core.set_fastmath_flags(fastmath_flags)
+                    core.set_target(target_cpu or "", target_features or "")
+                    try:
+                        exported = aot.export_function(wrapper, core)
+                    except (RuntimeError, ValueError):
+                        pass  # It needs something only this process has: pickled copies compile instead
+        return exported or None
 
+    def install_object(target, obj):
+        """Link object code from export_object() in place of a compile; True once native code is installed."""
+        nonlocal compiled_ptr, cold, tier_up_pending
+        if wrapper._mode not in aot.AOT_MODES or target != jit_instance.target_signature():
+            return False  # Built for another CPU: compile here as usual
+        with compile_lock:
             if compiled_ptr is None:
-                return func(*args, **kwargs)
+                if not free_retired() or not jit_instance.load_object(obj, [func.__name__]):
+                    return False
+                native = getattr(jit_instance, f"get_{wrapper._mode}_callable")(func.__name__, param_count)
+                adopt(native)
+                tier_up_pending = False  # Exported at opt_level: already the top tier
+                cold = False
+                _register_code(wrapper, tier_cores, func.__name__)
+                compiled_ptr = native
+                publish_native()
+        return True
+
+    fallbacks = collections.Counter()  # Reason -> calls run in the interpreter (see stats())
+
+    def fall_back(reason, args, kwargs):
+        """Run the call in the interpreter, counting ``reason`` while statistics are on."""
+        if _stats_enabled():
+            fallbacks[reason] += 1
+        if _tracing():
+            _trace_instant("fallback", "runtime", f"{func.__name__}: {reason}")
+        return interpret(*args, **kwargs)
 
+    def ensure_native():
+        """Compile, or collect the background compile; None once compiled_ptr is set, else the fallback reason."""
+        nonlocal compiled_ptr, compile_future, compile_failed, tier_up_pending
+        # One thread compiles; calls on other threads keep running the interpreter
+        if not compile_lock.acquire(blocking=False):
+            return "compiling"
         try:
-            return compiled_ptr(*args, **kwargs)
-        except Exception:
-            return func(*args, **kwargs)
+            if compiled_ptr is not None:
+                return None  # Published while this thread was checking
+            if compile_failed:
+                return "compile failed"
+            if not free_retired():
+                return "unloading"
+            if background_compile:
+                # Run the interpreter until the worker thread has native code ready
+                if compile_future is None:
+                    if baseline:
+                        tier_up_pending = False  # Calls already wait for this compile, at opt_level
+                    compile_future = _get_compile_executor().submit(compile_native_in_background)
+                if not compile_future.done():
+                    return "compiling"
+                native = compile_future.result()
+                if native is None:
+                    compile_failed = True
+                    return "compile failed"
+            else:
+                native = None
+                if baseline and tier_up_pending:
+                    native = compile_baseline(jit_instance)
+                    if native is None:
+                        tier_up_pending = False  # No stencils for it: straight to LLVM at opt_level
+                if native is None:
+                    native = compile_native(jit_instance)
+                if native is None:
+                    return "compile failed"
+            _register_code(wrapper, tier_cores, func.__name__)
+            # Set last: other threads call compiled_ptr without taking the lock
+            compiled_ptr = native
+            publish_native()
+            return None
+        finally:
+            compile_lock.release()
+
+    def dispatch(*args, **kwargs):
+        """Slow path of the published JITFunction: compiles, tiers up and falls back."""
+        native = compiled_ptr
+        if native is None:
+            if compile_failed:
+                return fall_back("compile failed", args, kwargs)
+            if cold:
+                return fall_back("cold", args, kwargs)
+            reason = ensure_native()
+            native = compiled_ptr
+            if native is None:  # Or unloaded by another thread since
+                return fall_back(reason or "compiling", args, kwargs)
+        elif _code_limit:
+            _code_lru.move_to_end(id(wrapper), last=True)
+
+        if tier_up_pending:
+            _tier_up_check()
+            native = compiled_ptr if compiled_ptr is not None else native  # Top tier, once swapped in
+
+        if type(native) is type(wrapper):
+            # Deoptimizes to `func` by itself; exceptions from the code propagate
+            return native(*args, **kwargs)
+        try:
+            return native(*args, **kwargs)
+        except TypeError:
+            # nanobind rejected the arguments before the (exception-free) kernel ran
+            return fall_back("TypeError", args, kwargs)
+
+    if use_specialize:
+        call_generic = dispatch
+
+        def dispatch(*args, **kwargs):
+            if specialized is not None:
+                # Entry guard: every argument has the profiled type
+                spec_type, native = specialized
+                if not kwargs and len(args) == param_count == positional_count and all(type(a) is spec_type for a in args):
+                    return native(*args)  # Deoptimizes to call_generic by itself
+                return call_generic(*args, **kwargs)
+            result = call_generic(*args, **kwargs)
+            if profile_remaining and not kwargs:
+                _profile_call(args, result)
+            return result
+
+    if value_slots:
+        import inspect
+
+        call_generic = dispatch
+        value_signature = inspect.signature(func)
+        value_names = [func.__code__.co_varnames[slot] for slot in value_slots]
+
+        def dispatch(*args, **kwargs):
+            # The native entry sends only calls with values not in the table here
+            if compiled_ptr is None:
+                return call_generic(*args, **kwargs)  # The generic code publishes that entry
+            try:
+                bound = value_signature.bind(*args, **kwargs)
+                bound.apply_defaults()
+                values = tuple(bound.arguments[name] for name in value_names)
+                types = tuple(map(type, values))
+                if value_shapes:
+                    values = tuple(map(_buffer_shape, values))
+                key = values[0] if len(values) == 1 else values
+                entry = value_clones.get(key) or add_value_clone(key, types)
+            except TypeError:  # A binding error, an unhashable value, or a non-contiguous array
+                entry = None
+            if entry is None or entry[0] is None or entry[1:] != types or kwargs or len(args) != param_count:
+                # Keyword calls reach the clone through the native entry from now on
+                return call_generic(*args, **kwargs)
+            return entry[0](*args)  # Deoptimizes to `func` by itself
 
+    # Native vectorcall entry; runs `dispatch` until publish_native() installs code
+    code = func.__code__
+    wrapper = create_jit_function(
+        func.__name__, dispatch, func, code.co_varnames[:param_count], func.__defaults__,
+        func.__kwdefaults__, positional_count, bool(code.co_flags & _CO_VARARGS),
+        bool(code.co_flags & _CO_VARKEYWORDS),
+    )
+    if use_int_mode:
+        wrapper._set_resume(_deopt_resumer(func, func))
+    if value_slots:
+        wrapper._set_value_clones(value_slots, value_clones, True, value_shapes)
     wrapper.__name__ = func.__name__
     wrapper.__doc__ = func.__doc__
     wrapper._jit_instance = jit_instance
     wrapper._original_func = func
     wrapper._instructions = instructions
-    wrapper._mode = "int" if use_int_mode else ("float" if use_float_mode else ("bool" if use_bool_mode else ("int32" if use_int32_mode else ("float32" if use_float32_mode else ("complex128" if use_complex128_mode else ("ptr" if use_ptr_mode else ("vec4f" if use_vec4f_mode else ("vec8i" if use_vec8i_mode else ("complex64" if use_complex64_mode else ("optional_f64" if use_optional_f64_mode else "object"))))))))))
+    wrapper.unload = unload
+    wrapper._native_address = native_address
+    wrapper._jit_precompile = precompile_now
+    wrapper._jit_export = export_object
+    wrapper._jit_install = install_object
+    wrapper._jit_options = jit_options
+    wrapper._jit_source = source_func
+    wrapper._native_signature = (native_param_types, native_return_type)
+    wrapper._native_records = native_records
+    wrapper._int_overflow = int_overflow
+    wrapper._jit_dependents = weakref.WeakSet()
+    wrapper._jit_running = running
+    wrapper._jit_free_retired = free_retired_unlocked
+    wrapper._jit_fallbacks = fallbacks
+    wrapper._jit_compile_stats = {}
+    _stats_functions.add(wrapper)
+    if use_complex128_mode or use_complex64_mode:
+
+        def buffer_sum(*buffers):
+            """Sum of the function over complex buffers, as one native loop with the GIL released."""
+            if not native_address():
+                return sum(map(func, *buffers), 0j)
+            return wrapper._jit_instance.get_complex_sum_callable(func.__name__, param_count, use_complex64_mode)(*buffers)
+
+        wrapper.sum = buffer_sum
+    if use_int_mode or use_float_mode or use_bool_mode or use_int32_mode or use_float32_mode or use_native_mode:
+        _add_c_callbacks(wrapper, func, param_count, native_address)
+    if osr_headers and not _osr_watch(func.__code__, osr_jump):
+        warnings.warn(
+            f"Function '{func.__name__}': sys.monitoring.OPTIMIZER_ID is in use by another tool; "
+            f"osr has no effect.",
+            RuntimeWarning,
+            stacklevel=3,
+        )
+    wrapper._mode = "int" if use_int_mode else ("float" if use_float_mode else ("bool" if use_bool_mode else ("int32" if use_int32_mode else ("float32" if use_float32_mode else ("complex128" if use_complex128_mode else ("ptr" if use_ptr_mode else ("vec4f" if use_vec4f_mode else ("vec8i" if use_vec8i_mode else ("complex64" if use_complex64_mode else ("optional_f64" if use_optional_f64_mode else ("native" if use_native_mode else (mode if use_wide_vector_mode else "object"))))))))))))
+    if not lazy:
+        precompile_now()  # lazy=False: native code before the first call
+    elif cold:
+        hotness.watch(func.__code__, hot_key, on_hot, on_hot_loop)
+    elif precompile:
+        jit_instance.set_hot_code(True)
+        compile_future = _get_compile_executor().submit(compile_native_in_background)
     return wrapper
 
 
-def dump_ir(func):
-    """
-    Dump the LLVM IR for a JIT-compiled function.
-    
-    Args:
-        func: A JIT-compiled function (decorated with @jit)
-        
-    Returns:
-        str: The LLVM IR as a string, or None if function wasn't JIT compiled
-        
-    Example:
-        @jit
-        def add(a, b):
-            return a + b
-        
-        add(1, 2)  # Trigger compilation
-        print(dump_ir(add))
-    """
-    if not hasattr(func, '_jit_instance'):
-        raise ValueError("Function is not a JIT-compiled function. Use @jit decorator first.")
-    
+def _recompile(func, ir_name):
+    """Compile ``func`` again under ``ir_name`` with its mode's settings, to capture IR or explain data."""
     jit_instance = func._jit_instance
     original_func = func._original_func
-    
-    # Enable IR dump and recompile
-    jit_instance.set_dump_ir(True)
-    
+
     # Get compilation parameters
     instructions = func._instructions
     constants = _extract_constants(original_func)
@@ -1078,18 +4494,25 @@ def dump_ir(func):
     exception_table = _parse_exception_table(original_func)
     
     code = original_func.__code__
-    param_count = code.co_argcount
+    param_count = _parameter_slots(code)
     nlocals = code.co_nlocals
     num_cellvars = len(code.co_cellvars)
     num_freevars = len(code.co_freevars)
     total_locals = nlocals + num_cellvars + num_freevars
     
-    # Compile with a unique name to capture IR
-    ir_name = f"{original_func.__name__}_ir_dump"
+    jit_instance.set_native_records(getattr(func, "_native_records", []))
     
+    offsets = None
+    if func._mode in ("int", "float"):
+        instructions, constants, total_locals, offsets = _inline_reductions(original_func, instructions, constants, total_locals)
+    if func._mode in ("int", "int32"):
+        jit_instance.set_bit_calls(_bits_calls(original_func, offsets))
+    if func._mode in ("int", "float"):
+        jit_instance.set_raise_sites(_raise_sites(original_func, offsets))
+
     if func._mode == "int":
         jit_instance.compile_int(
-            instructions, constants, ir_name, param_count, total_locals
+            instructions, constants, ir_name, param_count, total_locals, getattr(func, "_int_overflow", "deopt")
         )
     elif func._mode == "float":
         jit_instance.compile_float(
@@ -1116,13 +4539,20 @@ def dump_ir(func):
             instructions, constants, ir_name, param_count, total_locals
         )
     elif func._mode == "vec4f":
+        jit_instance.set_simd_calls(_simd_calls(original_func))
         jit_instance.compile_vec4f(
             instructions, constants, ir_name, param_count, total_locals
         )
     elif func._mode == "vec8i":
+        jit_instance.set_simd_calls(_simd_calls(original_func))
         jit_instance.compile_vec8i(
             instructions, constants, ir_name, param_count, total_locals
         )
+    elif func._mode in _WIDE_VECTOR_MODES or func._mode in _NARROW_VECTOR_MODES:
+        jit_instance.set_simd_calls(_simd_calls(original_func))
+        getattr(jit_instance, "compile_" + func._mode)(
+            instructions, constants, ir_name, param_count, total_locals
+        )
     elif func._mode == "complex64":
         jit_instance.compile_complex64(
             instructions, constants, ir_name, param_count, total_locals
@@ -1131,6 +4561,10 @@ def dump_ir(func):
         jit_instance.compile_optional_f64(
             instructions, constants, ir_name, param_count, total_locals
         )
+    elif func._mode == "native" and jit_instance.compile_native(
+        instructions, constants, names, ir_name, param_count, total_locals, *func._native_signature
+    ):
+        pass  # Untypable native-mode functions dump their object-mode IR below
     else:
         jit_instance.compile(
             instructions,
@@ -1145,6 +4579,34 @@ def dump_ir(func):
             total_locals,
             nlocals,
         )
+
+
+def dump_ir(func):
+    """
+    Dump the LLVM IR for a JIT-compiled function.
+    
+    Args:
+        func: A JIT-compiled function (decorated with @jit)
+        
+    Returns:
+        str: The LLVM IR as a string, or None if function wasn't JIT compiled
+        
+    Example:
+        @jit
+        def add(a, b):
+            return a + b
+        
+        add(1, 2)  # Trigger compilation
+        print(dump_ir(add))
+    """
+    if not hasattr(func, '_jit_instance'):
+        raise ValueError("Function is not a JIT-compiled function. Use @jit decorator first.")
+    
+    jit_instance = func._jit_instance
+    
+    # Enable IR dump and recompile
+    jit_instance.set_dump_ir(True)
+    _recompile(func, f"{func._original_func.__name__}_ir_dump")
     
     ir = jit_instance.get_last_ir()
     jit_instance.set_dump_ir(False)
@@ -1152,6 +4614,186 @@ def dump_ir(func):
     return ir
 
 
+# explain() compiles under a fresh name each call: a name compiled before would be skipped
+_explain_count = 0
+
+
+def explain(func, file=None):
+    """
+    How each bytecode instruction of an @jit function was lowered, for performance tuning.
+
+    Recompiles ``func`` in its mode with bytecode offsets carried through
+    the optimizer as debug locations, then prints one row per instruction
+    (to ``file``, default stdout):
+
+    - ``lowering``: ``native`` (machine operations only), ``cached`` (an
+      inline-cache site or inline fast path, with a generic fallback),
+      ``helper`` (JustJIT runtime helpers) or ``generic`` (C-API calls)
+    - ``capi``, ``refcount`` and ``helpers``: calls emitted for it before
+      optimization, refcount operations being Py_INCREF/Py_DECREF
+    - ``vectorizer``: what the loop and SLP vectorizers reported there
+
+    and one row per innermost loop of the generated machine code: its first
+    offset, its instruction count and, when ``llvm-mca`` is on PATH, the
+    estimated cycles per iteration on the compile's target CPU.
+
+    Lowering is recorded for object and native mode; the other typed modes
+    report only vectorizer remarks and loops. Returns ``{"mode",
+    "instructions", "loops", "remarks"}``: per instruction a dict of the
+    columns above, per loop ``{"offset", "instructions", "cycles"}``
+    (``cycles`` None without llvm-mca), and the raw ``(offset, pass, kind,
+    message)`` remarks.
+    """
+    global _explain_count
+    if not hasattr(func, "_jit_instance"):
+        raise ValueError("Function is not a JIT-compiled function. Use @jit decorator first.")
+    jit_instance = func._jit_instance
+    _explain_count += 1
+    ir_name = f"{func._original_func.__name__}_explain{_explain_count}"
+    jit_instance.set_explain_codegen(True)
+    try:
+        _recompile(func, ir_name)
+        captured = jit_instance.get_last_explain()
+    finally:
+        jit_instance.set_explain_codegen(False)
+    jit_instance.unload(ir_name)
+
+    remarks_at = collections.defaultdict(list)
+    for offset, _pass, kind, message in captured["remarks"]:
+        remarks_at[offset].append((kind, message))
+    instructions = []
+    for instr in dis.get_instructions(func._original_func):
+        site = captured["sites"].get(instr.offset)
+        notes = remarks_at.get(instr.offset, [])
+        passed = [message for kind, message in notes if kind == "passed"]
+        if site is None:
+            lowering = "-"  # Emitted nothing (RESUME, NOP, folded away)
+        elif site["cache_calls"]:
+            lowering = "cached"
+        elif site["capi_calls"]:
+            lowering = "generic"
+        elif site["helper_calls"]:
+            lowering = "helper"
+        else:
+            lowering = "native"
+        instructions.append({
+            "offset": instr.offset,
+            "opname": instr.opname,
+            "argrepr": instr.argrepr,
+            "lowering": lowering,
+            "capi": site["capi_calls"] if site else 0,
+            "refcount": site["refcount_ops"] if site else 0,
+            "helpers": (site["helper_calls"] + site["cache_calls"]) if site else 0,
+            "ir": site["instructions"] if site else 0,
+            "vectorizer": passed[0] if passed else notes[0][1] if notes else "",
+        })
+    loops = [
+        {"offset": offset, "instructions": len(body), "cycles": _mca_cycles(body, captured["cpu"])}
+        for offset, body in _assembly_loops(captured["assembly"])
+    ]
+
+    print("offset\topcode\tlowering\tcapi\trefcount\thelpers\tir\tvectorizer", file=file)
+    for row in instructions:
+        opcode = f"{row['opname']} {row['argrepr']}".strip()
+        print(f"{row['offset']}\t{opcode}\t{row['lowering']}\t{row['capi']}\t{row['refcount']}\t"
+              f"{row['helpers']}\t{row['ir']}\t{row['vectorizer']}", file=file)
+    for loop in loops:
+        cycles = f"{loop['cycles']:.2f} cycles/iteration" if loop["cycles"] is not None else "llvm-mca not available"
+        print(f"loop at offset {loop['offset']}: {loop['instructions']} instructions, {cycles}", file=file)
+    return {"mode": func._mode, "instructions": instructions, "loops": loops, "remarks": captured["remarks"]}
+
+
+def _assembly_loops(assembly):
+    """Innermost loops of LLVM's assembly output as ``(offset, instruction lines)``.
+
+    LLVM marks each innermost loop's header label with an "=>This Inner Loop
+    Header" comment; the loop runs to the branch back to that label. The
+    offset is the lowest bytecode offset among the loop's ``.loc`` lines
+    (line numbers are offset + 1), or None.
+    """
+    import re
+
+    loops, header, body, lines_seen = [], None, [], []
+    for line in assembly.splitlines():
+        text = re.split(r"\s(?:#|//)\s", line + " ")[0].strip()  # Not AArch64's "#1" immediates
+        if header is None:
+            if "=>This Inner Loop Header" in line and text.endswith(":"):
+                header, body, lines_seen = text[:-1], [], []
+            continue
+        if text.startswith(".loc"):
+            parts = text.split()
+            if len(parts) >= 3 and parts[2].isdigit() and int(parts[2]) > 0:
+                lines_seen.append(int(parts[2]) - 1)
+        elif text and not text.startswith(".") and not text.endswith(":"):
+            body.append(text)
+            if text.split()[-1] == header:  # The back edge
+                loops.append((min(lines_seen) if lines_seen else None, body))
+                header = None
+        elif text.startswith(".cfi_endproc"):
+            header = None
+    return loops
+
+
+def _mca_cycles(body, cpu):
+    """llvm-mca's Block RThroughput (cycles per iteration) for ``body``, or None without llvm-mca."""
+    import shutil
+    import subprocess
+
+    tool = shutil.which("llvm-mca")
+    if tool is None or not body:
+        return None
+    try:
+        result = subprocess.run([tool, f"-mcpu={cpu}"], input="\n".join(body) + "\n",
+                                capture_output=True, text=True, timeout=60)
+    except (OSError, subprocess.SubprocessError):
+        return None
+    for line in result.stdout.splitlines():
+        if line.strip().startswith("Block RThroughput:"):
+            return float(line.split(":")[1])
+    return None
+
+
+# ============================================================================
+# External Libraries
+# ============================================================================
+
+def load_library(name):
+    """
+    Make a shared library's exported functions callable from JIT and inline C code.
+
+    The library's symbols are resolved like the process's own, so C code only
+    needs a prototype (or the library's header) to call them directly:
+
+        justjit.load_library("openblas")
+        inline_c('''
+            void cblas_dscal(int n, double a, double* x, int incx);
+            void scale(double* x, long long n) { cblas_dscal(n, 2.0, x, 1); }
+        ''')
+
+    Args:
+        name: path of the library, or a name such as "openblas" or "sleef"
+            that ctypes.util.find_library() can locate
+
+    Returns:
+        The path that was loaded. Loading a library twice does nothing.
+
+    Raises:
+        RuntimeError: If the library cannot be found or loaded
+    """
+    try:
+        _load_library(name)
+        return name
+    except RuntimeError:
+        if os.sep in name or (os.altsep and os.altsep in name):
+            raise
+        import ctypes.util
+        found = ctypes.util.find_library(name)
+        if not found:
+            raise
+        _load_library(found)
+        return found
+
+
 # ============================================================================
 # Inline C Compiler - Compile C/C++ code at runtime
 # ============================================================================
@@ -1178,7 +4820,9 @@ def dump_c_ir():
     return None
 
 
-def inline_c(code, lang="c", captured_vars=None, include_paths=None, dump_ir=False):
+def inline_c(code, lang="c", captured_vars=None, include_paths=None, dump_ir=False,
+             opt_level=2, march="native", fast_math=False, extra_args=None, nogil=False,
+             openmp=False, libraries=None):
     """
     Compile C/C++ code at runtime and return callable functions.
     
@@ -1186,10 +4830,29 @@ def inline_c(code, lang="c", captured_vars=None, include_paths=None, dump_ir=Fal
     C/C++ toolchain (MSVC, MinGW, etc.) without hardcoded paths.
     
     Args:
-        code: C or C++ source code to compile
+        code: C or C++ source code to compile, or a list of sources compiled
+            as separate translation units in parallel and linked together
         lang: "c" or "c++" (default: "c")
-        captured_vars: dict of Python variables to inject into C code
+        captured_vars: dict of Python variables to inject into C code, as
+            globals bound on each call, so new values don't recompile
         include_paths: list of additional include directories
+        opt_level: optimization level 0-3; the module goes through the same
+            LLVM pipeline as @jit code (default: 2)
+        march: "native" targets the host CPU and its features (AVX2, FMA, ...),
+            a CPU name such as "x86-64-v3" targets that CPU, "" keeps clang's
+            baseline (default: "native")
+        fast_math: compile with -ffast-math (default: False)
+        extra_args: list of additional clang -cc1 arguments
+        nogil: release the GIL around each call of the returned functions.
+            True releases it for every function (code that uses Python or
+            jit_* helpers must take it back with jit_gil_acquire), "auto"
+            only for functions that never reference Python or jit_* helpers
+            (default: False)
+        openmp: compile with -fopenmp, so ``#pragma omp parallel for`` (with
+            reductions, critical sections and the omp_* API) runs on JustJIT's
+            thread pool; JUSTJIT_NUM_THREADS sets its size (default: False)
+        libraries: shared libraries the code calls (BLAS, LAPACK, SLEEF, ...),
+            loaded with load_library() before compiling
         
     Returns:
         dict containing:
@@ -1270,6 +4933,9 @@ def inline_c(code, lang="c", captured_vars=None, include_paths=None, dump_ir=Fal
         except Exception:
             pass  # Ignore errors in path detection
     
+    for library in libraries or ():
+        load_library(library)
+
     # Add user-provided include paths
     if include_paths:
         for path in include_paths:
@@ -1278,13 +4944,30 @@ def inline_c(code, lang="c", captured_vars=None, include_paths=None, dump_ir=Fal
     # Compile and execute
     if captured_vars is None:
         captured_vars = {}
+    if nogil is True:
+        nogil_mode = "on"
+    elif nogil is False or nogil is None:
+        nogil_mode = "off"
+    elif nogil == "auto":
+        nogil_mode = "auto"
+    else:
+        raise ValueError(f"nogil must be True, False or 'auto', got {nogil!r}")
     
     # Enable IR capture if requested
     global _last_c_ir
     if dump_ir and _global_jit_for_c:
         _global_jit_for_c.set_dump_ir(True)
     
-    result = _global_c_compiler.compile(code, lang, captured_vars)
+    clang_extra = list(extra_args or ())
+    if openmp:
+        clang_extra.append("-fopenmp")
+
+    if isinstance(code, (list, tuple)):
+        result = _global_c_compiler.compile_sources(list(code), lang, captured_vars, opt_level, march,
+                                                    fast_math, clang_extra, nogil_mode)
+    else:
+        result = _global_c_compiler.compile(code, lang, captured_vars, opt_level, march, fast_math,
+                                            clang_extra, nogil_mode)
     
     # Capture IR if requested
     if dump_ir and _global_jit_for_c:
@@ -0,0 +1,158 @@
+"""
+Ahead-of-time export of typed-mode JIT functions.
+
+``compile_module`` lowers a set of functions with the regular typed-mode
+compilers and writes one relocatable, position-independent object file plus a
+small JSON manifest next to it. ``load_module`` links that object straight
+into a JIT instance and builds callables from its symbols, so shipping the
+object with a wheel removes compile time from the first call.
+
+Example:
+    # build step
+    justjit.aot.compile_module([dot, axpy], "kernels.o")
+
+    # at runtime
+    kernels = justjit.aot.load_module("kernels.o")
+    kernels.dot(a, b)
+"""
+
+import json
+import os
+import types
+
+from ._core import JIT
+
+# Modes whose IR holds no process-specific pointers (same set the object cache accepts)
+AOT_MODES = (
+    "int",
+    "float",
+    "bool",
+    "int32",
+    "float32",
+    "complex128",
+    "ptr",
+    "vec4f",
+    "vec8i",
+    "vec8d",
+    "vec16f",
+    "vec16i",
+    "vec16u8",
+    "vec32u8",
+    "vec16i16",
+    "complex64",
+    "optional_f64",
+)
+
+MANIFEST_VERSION = 6  # 2: objects export <name>__entry trampolines, 3: vec4f/vec8i <name>__batch loops,
+# 4: complex128/complex64 <name>__batch and <name>__sum loops, 5: optional_f64 <name>__batch loops,
+# 6: bool <name>__mask_q/<name>__mask_d loops
+
+
+def _manifest_path(path):
+    return os.fspath(path) + ".json"
+
+
+def compile_module(funcs, path, *, mode=None, opt_level=3):
+    """
+    Compile functions ahead of time into a relocatable object file.
+
+    Args:
+        funcs: @jit-decorated functions (their mode is reused) or plain
+               functions (compiled with ``mode``)
+        path: Output object file; the manifest is written to ``path + ".json"``
+        mode: Mode for plain functions (default None, which requires @jit functions)
+        opt_level: LLVM optimization level (0-3, default 3)
+
+    Returns:
+        The list of exported function names.
+    """
+    core = JIT()
+    core.set_opt_level(opt_level)
+    core.set_aot_capture(True)
+
+    exported = [_compile_into(core, f, mode) for f in funcs]
+
+    with open(path, "wb") as f:
+        f.write(core.emit_aot_object())
+    with open(_manifest_path(path), "w") as f:
+        json.dump({"version": MANIFEST_VERSION, "functions": exported}, f, indent=2)
+
+    return [entry["name"] for entry in exported]
+
+
+def _compile_into(core, f, mode=None):
+    """Compile ``f`` (a @jit function, or a plain one in ``mode``) on ``core``; returns its manifest entry."""
+    from . import _extract_bytecode, _extract_constants, _inline_reductions
+
+    func = getattr(f, "_original_func", f)
+    func_mode = getattr(f, "_mode", None) or mode
+    if func_mode not in AOT_MODES:
+        raise ValueError(
+            f"Function '{func.__name__}' uses mode {func_mode!r}; "
+            f"AOT export supports {', '.join(AOT_MODES)}"
+        )
+
+    code = func.__code__
+    param_count = code.co_argcount
+    total_locals = code.co_nlocals + len(code.co_cellvars) + len(code.co_freevars)
+
+    instructions, constants = _extract_bytecode(func), _extract_constants(func)
+    if func_mode in ("int", "float"):
+        instructions, constants, total_locals, _ = _inline_reductions(func, instructions, constants, total_locals)
+
+    compile_fn = getattr(core, "compile_" + func_mode)
+    # Int mode bakes the wrapper's overflow policy into the code
+    extra = (getattr(f, "_int_overflow", "deopt"),) if func_mode == "int" else ()
+    if not compile_fn(
+        instructions,
+        constants,
+        func.__name__,
+        param_count,
+        total_locals,
+        *extra,
+    ):
+        raise RuntimeError(f"Failed to compile '{func.__name__}' in {func_mode} mode")
+
+    return {"name": func.__name__, "mode": func_mode, "param_count": param_count}
+
+
+def export_function(f, core):
+    """
+    Compile the @jit function ``f`` on ``core``, a fresh JIT set up with its
+    options, into a relocatable object. Returns ``(target, object)``, where
+    ``target`` is ``core.target_signature()``: the object only loads where
+    that matches. Pickled JIT functions carry this (see justjit.JITFunction).
+    """
+    core.set_aot_capture(True)
+    _compile_into(core, f)
+    return core.target_signature(), core.emit_aot_object()
+
+
+def load_module(path):
+    """
+    Load an object produced by ``compile_module``.
+
+    Returns:
+        A namespace with one native callable per exported function.
+    """
+    with open(_manifest_path(path)) as f:
+        manifest = json.load(f)
+    if manifest.get("version") != MANIFEST_VERSION:
+        raise ValueError(f"Unsupported AOT manifest version in {_manifest_path(path)}")
+
+    with open(path, "rb") as f:
+        obj = f.read()
+
+    functions = manifest["functions"]
+    core = JIT()
+    if not core.load_object(obj, [entry["name"] for entry in functions]):
+        raise RuntimeError(f"Failed to load AOT object {path}")
+
+    callables = {}
+    for entry in functions:
+        getter = getattr(core, "get_" + entry["mode"] + "_callable")
+        callables[entry["name"]] = getter(entry["name"], entry["param_count"])
+
+    module = types.SimpleNamespace(**callables)
+    module._jit_instance = core  # Owns the code memory the callables point into
+    return module
@@ -0,0 +1,555 @@
+"""
+Benchmark harness for every JIT mode.
+
+Each case is measured three ways, separately:
+
+- ``first_call``: decorating a fresh copy of the function and making its
+  first call, i.e. compile latency as a user sees it (the object cache is
+  turned off while benchmarking so every sample compiles);
+- ``call``: steady-state nanoseconds per call;
+- ``throughput``: items per second for cases whose call loops over ``items``
+  elements (loops, generators, buffer batches).
+
+Alongside them each case records ``fallback_rate``, the share of @jit calls
+that deoptimized or ran in the interpreter (from justjit.stats()), and
+``peak_rss_mb``, the resident-set high-water mark while it compiled and ran.
+
+Every metric is ``repeat`` samples taken after ``warmup`` discarded ones; a
+sample runs the call enough times to last ``min_time`` seconds. Results are
+plain JSON so two commits can be compared:
+
+    python -m justjit.bench -o base.json            # on the base commit
+    python -m justjit.bench -o head.json            # on the change
+    python -m justjit.bench compare base.json head.json
+
+``compare`` exits with status 1 when any metric got slower by more than the
+threshold and by more than the noise of the two runs, so it can gate CI.
+
+``--corpus workloads`` runs the realistic programs of justjit.workloads
+instead of the per-mode cases (``all`` runs both). ``--save-baseline DIR``
+files the results under a name keyed by JustJIT version, Python and machine,
+and ``compare DIR head.json`` compares against the newest matching baseline
+there, so releases can be checked against the previous one.
+
+``frames`` reports the bytes each of a million coroutines takes while all of
+them are suspended at an await, for JIT coroutines and CPython's own.
+"""
+
+import argparse
+import array
+import json
+import math
+import os
+import platform
+import statistics
+import sys
+import time
+import tracemalloc
+import types
+
+import justjit
+
+RESULTS_VERSION = 2
+
+
+class Case:
+    """
+    One benchmark: ``func`` compiled with ``mode`` and called with ``args``.
+
+    ``run(f, args)`` makes one call (default ``f(*args)``), ``items`` marks a
+    throughput case, ``build(func)`` replaces the @jit decoration (inline C
+    passes ``func=None`` and builds its own callable) and ``python=False``
+    skips the CPython baseline for code the interpreter cannot run as is.
+    """
+
+    def __init__(self, name, mode, func, args, *, items=None, run=None, build=None, python=True):
+        self.name = name
+        self.mode = mode
+        self.func = func
+        self.args = args
+        self.items = items
+        self.run = run or (lambda f, call_args: f(*call_args))
+        self.build = build or (lambda f: justjit.jit(f, mode=mode))
+        self.python = python
+
+
+def _fresh(func):
+    """A new function object over the same code, so each decoration compiles again."""
+    if func is None:
+        return None
+    copy = types.FunctionType(func.__code__, func.__globals__, func.__name__, func.__defaults__, func.__closure__)
+    copy.__kwdefaults__ = func.__kwdefaults__
+    copy.__qualname__ = func.__qualname__
+    return copy
+
+
+def _drive(coro):
+    """Run a coroutine that never suspends on an event loop."""
+    try:
+        while True:
+            coro.send(None)
+    except StopIteration as stop:
+        return stop.value
+
+
+# =============================================================================
+# Cases
+# =============================================================================
+
+
+def _add(a, b):
+    return a + b
+
+
+def _mul(a, b):
+    return a * b
+
+
+def _both(a, b):
+    return a and b
+
+
+def _fibonacci(n):
+    a = 0
+    b = 1
+    i = 0
+    while i < n:
+        a, b = b, a + b
+        i = i + 1
+    return a
+
+
+def _sum_while(n):
+    total = 0
+    i = 0
+    while i < n:
+        total = total + i
+        i = i + 1
+    return total
+
+
+def _harmonic(n):
+    total = 0.0
+    i = 1.0
+    while i <= n:
+        total = total + 1.0 / i
+        i = i + 1.0
+    return total
+
+
+def _element(buf, i):
+    return buf[i]
+
+
+def _countdown(n):
+    while n > 0:
+        yield n
+        n = n - 1
+
+
+async def _doubled(x):
+    return x * 2
+
+
+class _Pending:
+    """An awaitable that never completes, like a connection's pending read."""
+
+    def __await__(self):
+        return self
+
+    def __iter__(self):
+        return self
+
+    def __next__(self):
+        return None
+
+    def send(self, _value):
+        return None
+
+
+async def _connection(pending):
+    received = 0
+    while True:
+        await pending
+        received = received + 1
+
+
+def _inline_c_add(_func):
+    return justjit.inline_c("double bench_c_add(double a, double b) { return a + b; }")["bench_c_add"]
+
+
+LOOP = 10000
+BATCH = 4096
+
+
+def default_cases():
+    """The built-in cases, one or more per mode."""
+    ints = array.array("i", range(BATCH))
+    threes = array.array("i", [3] * BATCH)
+    doubles = array.array("d", [0.5] * BATCH)
+    return [
+        Case("object_add", "object", _add, (3, 4)),
+        Case("object_fibonacci", "object", _fibonacci, (90,), items=90),
+        Case("int_add", "int", _add, (3, 4)),
+        Case("int_sum_loop", "int", _sum_while, (LOOP,), items=LOOP),
+        Case("float_add", "float", _add, (3.0, 4.0)),
+        Case("float_harmonic", "float", _harmonic, (float(LOOP),), items=LOOP),
+        Case("bool_and", "bool", _both, (True, False)),
+        Case("int32_add", "int32", _add, (3, 4)),
+        Case("float32_mul", "float32", _mul, (1.5, 2.0)),
+        Case("complex128_mul", "complex128", _mul, (1 + 2j, 3 - 1j)),
+        Case("complex64_mul", "complex64", _mul, (1 + 2j, 3 - 1j)),
+        Case("ptr_element", "ptr", _element, (doubles, 7)),
+        Case("vec8i_batch", "vec8i", _mul, (ints, threes), items=BATCH, python=False),
+        Case("generator_drain", "auto", _countdown, (LOOP,), items=LOOP, run=lambda f, a: sum(f(*a))),
+        Case("coroutine_call", "auto", _doubled, (21,), run=lambda f, a: _drive(f(*a))),
+        Case("inline_c_add", "inline_c", None, (3.0, 4.0), build=_inline_c_add, python=False),
+    ]
+
+
+def corpus_cases(name):
+    """The cases of a corpus: ``"default"``, ``"workloads"`` (justjit.workloads) or ``"all"``."""
+    from justjit import workloads  # Imports this module for Case
+
+    if name == "default":
+        return default_cases()
+    if name == "workloads":
+        return workloads.workload_cases()
+    if name == "all":
+        return default_cases() + workloads.workload_cases()
+    raise ValueError(f"unknown corpus {name!r}")
+
+
+# =============================================================================
+# Measurement
+# =============================================================================
+
+
+def suspended_coroutine_bytes(count=1_000_000, *, jit=True):
+    """
+    Bytes per coroutine with ``count`` of them suspended at an await at once,
+    as traced by tracemalloc: what a server parking one coroutine per
+    connection pays for each. ``jit=False`` measures CPython's coroutines.
+    """
+    func = justjit.jit(_fresh(_connection)) if jit else _connection
+    pending = _Pending()
+    func(pending).send(None)  # Compiles outside the traced region
+    parked = [None] * count
+    tracemalloc.start()
+    try:
+        before = tracemalloc.get_traced_memory()[0]
+        for i in range(count):
+            coro = func(pending)
+            coro.send(None)
+            parked[i] = coro
+        used = tracemalloc.get_traced_memory()[0] - before
+    finally:
+        tracemalloc.stop()
+    return used / count
+
+
+def _summary(samples):
+    return {
+        "samples": samples,
+        "mean": statistics.fmean(samples),
+        "stdev": statistics.stdev(samples) if len(samples) > 1 else 0.0,
+        "median": statistics.median(samples),
+        "min": min(samples),
+    }
+
+
+def _calibrate(call, min_time):
+    """Loop count that makes one sample last at least min_time seconds."""
+    loops = 1
+    while True:
+        start = time.perf_counter()
+        for _ in range(loops):
+            call()
+        if time.perf_counter() - start >= min_time or loops >= 1 << 30:
+            return loops
+        loops *= 2
+
+
+def _time_calls(call, loops, warmup, repeat):
+    """Seconds per call for each of ``repeat`` samples."""
+    samples = []
+    for index in range(warmup + repeat):
+        start = time.perf_counter()
+        for _ in range(loops):
+            call()
+        elapsed = time.perf_counter() - start
+        if index >= warmup:
+            samples.append(elapsed / loops)
+    return samples
+
+
+def _measure(case, f, *, warmup, repeat, min_time):
+    call = lambda: case.run(f, case.args)  # noqa: E731
+    seconds = _time_calls(call, _calibrate(call, min_time), warmup, repeat)
+    result = {"call": _summary([s * 1e9 for s in seconds])}
+    if case.items:
+        result["throughput"] = _summary([case.items / s for s in seconds])
+    return result
+
+
+def _first_call(case, samples):
+    times = []
+    for _ in range(samples):
+        fresh = _fresh(case.func)
+        start = time.perf_counter()
+        f = case.build(fresh)
+        case.run(f, case.args)
+        times.append((time.perf_counter() - start) * 1e3)
+    return _summary(times)
+
+
+def _fallback_rate(call, calls):
+    """
+    Share of @jit calls among ``calls`` calls that deoptimized or ran in the
+    interpreter, from justjit.stats(); None when no @jit function ran.
+    """
+    was_enabled = justjit._stats_enabled()
+    justjit.reset_stats()
+    justjit.enable_stats()
+    try:
+        for _ in range(calls):
+            call()
+        functions = list(justjit.stats()["functions"].values())
+    finally:
+        justjit.enable_stats(was_enabled)
+    fallbacks = sum(sum(entry["fallbacks"].values()) for entry in functions)
+    total = sum(entry["calls"] for entry in functions) + fallbacks
+    if total == 0:
+        return None
+    return (sum(entry["deopts"] for entry in functions) + fallbacks) / total
+
+
+def _reset_peak_rss():
+    """Start a new peak-RSS window (Linux); elsewhere the peak stays the process's."""
+    try:
+        with open("/proc/self/clear_refs", "w") as refs:
+            refs.write("5")
+    except OSError:
+        pass
+
+
+def _peak_rss_mb():
+    """The resident-set high-water mark in MiB, or None where it can't be read."""
+    try:
+        with open("/proc/self/status") as status:
+            for line in status:
+                if line.startswith("VmHWM:"):
+                    return int(line.split()[1]) / 1024
+    except OSError:
+        pass
+    try:
+        import resource
+    except ImportError:  # Windows
+        return None
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    return peak / (1 << 20) if sys.platform == "darwin" else peak / 1024  # Bytes on macOS, KiB elsewhere
+
+
+def run(cases=None, *, select=None, warmup=2, repeat=10, min_time=0.02, first_call_samples=5, baseline=True, log=None):
+    """
+    Benchmark ``cases`` (default: default_cases()) and return the results dict.
+
+    ``select`` keeps only cases whose name contains one of its substrings.
+    Cases whose mode is unavailable here (no NumPy, no inline C, an ISA the
+    CPU lacks) are listed under ``"skipped"`` with the error instead of
+    failing the run. With ``baseline`` each case also times the plain
+    CPython function and reports ``speedup`` (CPython median / JIT median).
+    ``fallback_rate`` and ``peak_rss_mb`` are None when not measurable
+    (no @jit function in the case, no RSS counter on the platform).
+    """
+    if cases is None:
+        cases = default_cases()
+    if select:
+        cases = [case for case in cases if any(part in case.name for part in select)]
+    results = {
+        "version": RESULTS_VERSION,
+        "justjit": justjit.__version__,
+        "python": platform.python_version(),
+        "machine": platform.machine(),
+        "platform": platform.platform(),
+        "settings": {"warmup": warmup, "repeat": repeat, "min_time": min_time, "first_call_samples": first_call_samples},
+        "cases": {},
+        "skipped": {},
+    }
+    cache_dir = justjit.get_cache_dir()
+    justjit.set_cache_dir("")
+    try:
+        for case in cases:
+            try:
+                _reset_peak_rss()
+                first_call = _first_call(case, first_call_samples)
+                entry = {"mode": case.mode, "first_call_ms": first_call}
+                f = case.build(_fresh(case.func))
+                entry.update(_measure(case, f, warmup=warmup, repeat=repeat, min_time=min_time))
+                entry["peak_rss_mb"] = _peak_rss_mb()
+                entry["fallback_rate"] = _fallback_rate(lambda: case.run(f, case.args), repeat)
+            except Exception as exc:
+                results["skipped"][case.name] = f"{type(exc).__name__}: {exc}"
+                continue
+            if baseline and case.python:
+                python = _measure(case, case.func, warmup=warmup, repeat=repeat, min_time=min_time)
+                entry["python_call"] = python["call"]
+                entry["speedup"] = python["call"]["median"] / entry["call"]["median"]
+            results["cases"][case.name] = entry
+            if log is not None:
+                speedup = f"  {entry['speedup']:.2f}x" if "speedup" in entry else ""
+                fallbacks = f"  fallback {entry['fallback_rate']:.1%}" if entry["fallback_rate"] else ""
+                print(
+                    f"{case.name:<20} first call {first_call['median']:9.3f} ms"
+                    f"  call {entry['call']['median']:11.1f} ns{speedup}{fallbacks}",
+                    file=log,
+                )
+    finally:
+        justjit.set_cache_dir(cache_dir)
+    return results
+
+
+# =============================================================================
+# Comparison
+# =============================================================================
+
+# Metric -> (unit, True when larger is better). fallback_rate and peak_rss_mb
+# are single numbers rather than sample summaries.
+METRICS = {
+    "first_call_ms": ("ms", False),
+    "call": ("ns", False),
+    "throughput": ("items/s", True),
+    "fallback_rate": ("calls", False),
+    "peak_rss_mb": ("MiB", False),
+}
+
+
+def compare(base, head, *, threshold=0.05):
+    """
+    Compare two results dicts metric by metric, on medians.
+
+    A change counts only when it exceeds ``threshold`` (relative) and twice
+    the combined standard error of the two sample sets; single-number
+    metrics have no noise, and any fallback rate appearing from zero counts.
+    Returns a list of
+    ``(case, metric, base_median, head_median, verdict)`` with verdict
+    ``"slower"``, ``"faster"`` or ``"same"``.
+    """
+    rows = []
+    for name, head_case in sorted(head["cases"].items()):
+        base_case = base["cases"].get(name)
+        if base_case is None:
+            continue
+        for metric, (_unit, larger_is_better) in METRICS.items():
+            old, new = base_case.get(metric), head_case.get(metric)
+            if old is None or new is None:
+                continue
+            if isinstance(old, dict):
+                noise = 2 * math.sqrt(
+                    old["stdev"] ** 2 / len(old["samples"]) + new["stdev"] ** 2 / len(new["samples"])
+                )
+                old, new = old["median"], new["median"]
+            else:
+                noise = 0.0
+            change = (new - old) / old if old else (math.inf if new > old else 0.0)
+            verdict = "same"
+            if abs(change) > threshold and abs(new - old) > noise:
+                verdict = "faster" if (change > 0) == larger_is_better else "slower"
+            rows.append((name, metric, old, new, verdict))
+    return rows
+
+
+def _print_comparison(rows, file):
+    for name, metric, old, new, verdict in rows:
+        unit = METRICS[metric][0]
+        ratio = f"{new / old:6.3f}x" if old else "   new "
+        print(f"{name:<20} {metric:<14} {old:14.4g} -> {new:<14.4g} {unit:<8} {ratio}  {verdict}", file=file)
+
+
+def baseline_name(results):
+    """File name of ``results`` as a baseline: JustJIT version, Python minor version and machine."""
+    python = ".".join(results["python"].split(".")[:2])
+    return f"{results['justjit']}-py{python}-{results['machine']}.json"
+
+
+def _version_key(name):
+    return tuple(int(part) if part.isdigit() else 0 for part in name.split("-")[0].split("."))
+
+
+def latest_baseline(directory, head):
+    """Path of the newest baseline in ``directory`` for ``head``'s Python and machine, or None."""
+    suffix = baseline_name(head).split("-", 1)[1]
+    names = [name for name in os.listdir(directory) if name.endswith("-" + suffix)]
+    if not names:
+        return None
+    return os.path.join(directory, max(names, key=_version_key))
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(prog="python -m justjit.bench", description=__doc__.strip().splitlines()[0])
+    commands = parser.add_subparsers(dest="command")
+    run_parser = commands.add_parser("run", help="benchmark and write JSON results (default)")
+    compare_parser = commands.add_parser("compare", help="compare two JSON results")
+    frames_parser = commands.add_parser("frames", help="bytes per suspended coroutine, JIT and CPython")
+    frames_parser.add_argument("-n", "--count", type=int, default=1_000_000)
+    for command in (parser, run_parser):
+        command.add_argument("-o", "--output", help="write the JSON results here (default: stdout)")
+        command.add_argument("-k", "--select", action="append", help="only cases whose name contains this")
+        command.add_argument("--corpus", choices=("default", "workloads", "all"), default="default")
+        command.add_argument("--save-baseline", metavar="DIR", help="also write the results to DIR as a baseline")
+        command.add_argument("--warmup", type=int, default=2)
+        command.add_argument("--repeat", type=int, default=10)
+        command.add_argument("--min-time", type=float, default=0.02)
+        command.add_argument("--first-call-samples", type=int, default=5)
+        command.add_argument("--no-baseline", action="store_true", help="skip the CPython timings")
+    compare_parser.add_argument("base", help="base results, or a baseline directory")
+    compare_parser.add_argument("head")
+    compare_parser.add_argument("--threshold", type=float, default=0.05)
+    args = parser.parse_args(argv)
+
+    if args.command == "frames":
+        sizes = {"count": args.count, "justjit": suspended_coroutine_bytes(args.count),
+                 "python": suspended_coroutine_bytes(args.count, jit=False)}
+        print(json.dumps(sizes, indent=1))
+        return 0
+
+    if args.command == "compare":
+        with open(args.head) as head_file:
+            head = json.load(head_file)
+        base_path = args.base
+        if os.path.isdir(base_path):
+            base_path = latest_baseline(base_path, head)
+            if base_path is None:
+                print(f"no baseline in {args.base} for {baseline_name(head)}", file=sys.stderr)
+                return 2
+            print(f"comparing against {base_path}", file=sys.stderr)
+        with open(base_path) as base_file:
+            rows = compare(json.load(base_file), head, threshold=args.threshold)
+        _print_comparison(rows, sys.stdout)
+        return 1 if any(row[4] == "slower" for row in rows) else 0
+
+    results = run(
+        corpus_cases(args.corpus),
+        select=args.select,
+        warmup=args.warmup,
+        repeat=args.repeat,
+        min_time=args.min_time,
+        first_call_samples=args.first_call_samples,
+        baseline=not args.no_baseline,
+        log=sys.stderr,
+    )
+    text = json.dumps(results, indent=1)
+    if args.save_baseline:
+        os.makedirs(args.save_baseline, exist_ok=True)
+        with open(os.path.join(args.save_baseline, baseline_name(results)), "w") as out:
+            out.write(text + "\n")
+    if args.output:
+        with open(args.output, "w") as out:
+            out.write(text + "\n")
+    elif not args.save_baseline:
+        print(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
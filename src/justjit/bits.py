@@ -0,0 +1,82 @@
+"""
+Bit operations for int and int32 mode.
+
+An int-mode (or int32-mode) function may call these as ``bits.<name>(...)``
+or ``justjit.bits.<name>(...)``, or by a name imported from this module;
+the compiler lowers each call to one LLVM instruction or intrinsic
+(``llvm.ctpop``, ``llvm.ctlz``, ``llvm.cttz``, ``llvm.fshl`` / ``llvm.fshr``,
+``llvm.bswap``, ``udiv`` / ``urem`` / ``lshr`` / ``icmp ult``) instead of
+calling it. The ``int`` methods ``x.bit_count()`` and ``x.bit_length()``
+are lowered the same way.
+
+Operations see the two's complement bits of the value: 64 of them in int
+mode, 32 in int32 mode. The unsigned ones treat those bits as an unsigned
+number and give back the bits of the result, so ``bits.udiv(-1, 2)`` is
+``2**63 - 1``. The definitions below use 64 bits, and run when called
+outside compiled code.
+"""
+
+__all__ = [
+    "popcount", "clz", "ctz", "rotl", "rotr", "bswap",
+    "ushr", "udiv", "umod", "ult",
+]
+
+_MASK = (1 << 64) - 1
+
+
+def popcount(x):
+    """Number of set bits (llvm.ctpop)."""
+    return (x & _MASK).bit_count()
+
+
+def clz(x):
+    """Leading zero bits; 64 for 0 (llvm.ctlz)."""
+    return 64 - (x & _MASK).bit_length()
+
+
+def ctz(x):
+    """Trailing zero bits; 64 for 0 (llvm.cttz)."""
+    x &= _MASK
+    return (x & -x).bit_length() - 1 if x else 64
+
+
+def rotl(x, n):
+    """``x`` rotated left by ``n`` bits, ``n`` taken modulo 64 (llvm.fshl)."""
+    n %= 64
+    x &= _MASK
+    return _signed(x << n | x >> (64 - n))
+
+
+def rotr(x, n):
+    """``x`` rotated right by ``n`` bits, ``n`` taken modulo 64 (llvm.fshr)."""
+    return rotl(x, -n)
+
+
+def bswap(x):
+    """The bytes of ``x`` in reverse order (llvm.bswap)."""
+    return _signed(int.from_bytes((x & _MASK).to_bytes(8, "little"), "big"))
+
+
+def ushr(x, n):
+    """Logical shift right: zeros shift in; 0 once ``n`` reaches 64."""
+    return _signed((x & _MASK) >> n)
+
+
+def udiv(a, b):
+    """Unsigned quotient."""
+    return _signed((a & _MASK) // (b & _MASK))
+
+
+def umod(a, b):
+    """Unsigned remainder."""
+    return _signed((a & _MASK) % (b & _MASK))
+
+
+def ult(a, b):
+    """1 if ``a`` is below ``b`` as unsigned numbers, else 0."""
+    return int((a & _MASK) < (b & _MASK))
+
+
+def _signed(x):
+    x &= _MASK
+    return x - (1 << 64) if x >> 63 else x
@@ -0,0 +1,201 @@
+"""
+Sampling hotness profiler that decides what gets compiled.
+
+While sampling is on, @jit functions decorated afterwards start cold: their
+calls run in the interpreter, where a background thread samples every
+thread's stack each ``interval`` seconds. A function seen ``hot_samples``
+times is hot and compiles in the background at its full opt_level (tiered
+functions skip tier 1); one never seen is never compiled. A loop whose
+header collects ``hot_samples`` samples is reported too, so osr=True
+functions enter native code at that loop on its next iteration.
+
+Samples add up into a profile keyed by ``module.qualname`` that save()
+writes as JSON. After load(), the functions the profile marks hot are
+compiled in the background as soon as they are decorated, before their
+first call. With ``JUSTJIT_HOT_PROFILE=path`` the profile is loaded at
+import (if the file exists), sampling runs, and the profile is written back
+at exit.
+"""
+
+import atexit
+import collections
+import dis
+import json
+import os
+import sys
+import threading
+
+PROFILE_VERSION = 1
+
+_lock = threading.Lock()
+_watched = {}  # code object -> _Watch
+_profile = {}  # module.qualname -> {"samples": n, "loops": Counter(header offset -> n)}
+_preloaded = set()  # Hot in a loaded profile
+_hot_samples = 10
+_interval = 0.005
+_thread = None
+_stop = None
+
+
+class _Watch:
+    """A cold function: where its loops are and what to call once it gets hot."""
+
+    def __init__(self, code, key, on_hot, on_hot_loop):
+        self.key = key
+        self.on_hot = on_hot
+        self.on_hot_loop = on_hot_loop
+        self.samples = 0
+        self.loop_samples = collections.Counter()
+        # (header, last offset) of every loop, innermost (shortest) first
+        self.loops = sorted(
+            (
+                (instr.argval, instr.offset)
+                for instr in dis.get_instructions(code)
+                if instr.opname in ("JUMP_BACKWARD", "JUMP_BACKWARD_NO_INTERRUPT")
+            ),
+            key=lambda loop: loop[1] - loop[0],
+        )
+
+    def loop_at(self, offset):
+        for header, end in self.loops:
+            if header <= offset <= end:
+                return header
+        return None
+
+
+def _sample(watch, offset):
+    entry = _profile.setdefault(watch.key, {"samples": 0, "loops": collections.Counter()})
+    entry["samples"] += 1
+    watch.samples += 1
+    header = watch.loop_at(offset)
+    if header is not None:
+        entry["loops"][header] += 1
+        watch.loop_samples[header] += 1
+        if watch.loop_samples[header] == _hot_samples:
+            watch.on_hot_loop(header)
+    if watch.samples == _hot_samples:
+        watch.on_hot()
+
+
+def _run(interval, stop):
+    own = threading.get_ident()
+    while not stop.wait(interval):
+        with _lock:
+            for ident, frame in sys._current_frames().items():
+                if ident == own:
+                    continue
+                seen = set()
+                while frame is not None:
+                    watch = _watched.get(frame.f_code)
+                    # Recursive calls count once per sample
+                    if watch is not None and frame.f_code not in seen:
+                        seen.add(frame.f_code)
+                        _sample(watch, frame.f_lasti)
+                    frame = frame.f_back
+
+
+def start(interval=0.005, hot_samples=10):
+    """Start sampling; @jit functions decorated from now on stay interpreted until hot."""
+    global _thread, _stop, _hot_samples, _interval
+    if interval <= 0 or hot_samples < 1:
+        raise ValueError("interval must be positive and hot_samples at least 1")
+    _hot_samples = hot_samples
+    if _thread is not None:
+        return
+    _interval = interval
+    _stop = threading.Event()
+    _thread = threading.Thread(target=_run, args=(interval, _stop), name="justjit-sampler", daemon=True)
+    _thread.start()
+
+
+def stop():
+    """Stop sampling; functions that are still cold stay interpreted."""
+    global _thread
+    if _thread is None:
+        return
+    _stop.set()
+    _thread.join()
+    _thread = None
+
+
+def sampling():
+    return _thread is not None
+
+
+def watch(code, key, on_hot, on_hot_loop):
+    """Sample ``code``; ``on_hot()`` once it is hot, ``on_hot_loop(header)`` per hot loop (sampler thread)."""
+    with _lock:
+        _watched[code] = _Watch(code, key, on_hot, on_hot_loop)
+
+
+def is_hot(key):
+    """True if a loaded profile marks ``key`` (module.qualname) hot."""
+    return key in _preloaded
+
+
+def hot_functions():
+    """``{module.qualname: {"samples": n, "loops": {header offset: n}}}``, hottest first."""
+    with _lock:
+        rows = sorted(_profile.items(), key=lambda item: -item[1]["samples"])
+        return {key: {"samples": entry["samples"], "loops": dict(entry["loops"])} for key, entry in rows}
+
+
+def save(path):
+    """Write the accumulated profile (including a loaded one) as JSON."""
+    functions = {
+        key: {"samples": entry["samples"], "loops": {str(header): n for header, n in entry["loops"].items()}}
+        for key, entry in hot_functions().items()
+    }
+    with open(path, "w") as out:
+        json.dump({"version": PROFILE_VERSION, "hot_samples": _hot_samples, "functions": functions}, out, indent=1)
+
+
+def load(path, hot_samples=None):
+    """
+    Merge a saved profile; functions with at least ``hot_samples`` samples
+    (default: the threshold it was recorded with) are precompiled in the
+    background when decorated.
+    """
+    with open(path) as src:
+        data = json.load(src)
+    if data.get("version") != PROFILE_VERSION:
+        raise ValueError(f"Unsupported hotness profile version in {path}")
+    threshold = hot_samples if hot_samples is not None else data.get("hot_samples", _hot_samples)
+    with _lock:
+        for key, saved in data["functions"].items():
+            entry = _profile.setdefault(key, {"samples": 0, "loops": collections.Counter()})
+            entry["samples"] += saved["samples"]
+            entry["loops"].update({int(header): n for header, n in saved["loops"].items()})
+            if saved["samples"] >= threshold:
+                _preloaded.add(key)
+
+
+def _before_fork():
+    # The child must not inherit _lock held by the sampler thread
+    _lock.acquire()
+
+
+def _after_fork_in_child():
+    """The sampler thread stays in the parent: the child samples with its own."""
+    global _thread
+    _lock.release()
+    if _thread is not None:
+        _thread = None
+        start(_interval, _hot_samples)
+
+
+if hasattr(os, "register_at_fork"):
+    os.register_at_fork(before=_before_fork, after_in_parent=_lock.release, after_in_child=_after_fork_in_child)
+
+
+def _from_environment():
+    path = os.environ.get("JUSTJIT_HOT_PROFILE")
+    if not path:
+        return
+    if os.path.exists(path):
+        load(path)
+    start()
+    atexit.register(save, path)
+
+
+_from_environment()
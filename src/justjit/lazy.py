@@ -0,0 +1,217 @@
+"""
+Lazy element-wise array expressions, fused into one native loop.
+
+``lazy(a) * b + lazy(c) * d - e`` records the expression instead of
+computing it, so no temporary array is allocated per operator. ``evaluate()``
+lowers the recorded DAG to a scalar function of its distinct arrays and
+scalars (a shared subexpression is computed once) and compiles that with
+vectorize() into a single loop that LLVM vectorizes. Large arrays are split
+into L2-sized blocks across the ``prange()`` thread pool with the GIL
+released. Loops are cached by the expression's shape and mode, so
+evaluating the same expression over new arrays only runs it.
+
+``expr("a * b + c * d - e", a=..., b=...)`` is the same, numexpr style:
+names are bound from the keywords (then the caller's variables) and the
+functions float mode calls natively, such as ``sqrt`` or ``exp``, are in
+scope.
+
+Operands are 1-D buffers of one element type, or C-contiguous N-D arrays
+of one shape, plus scalars; length-1 arrays broadcast. The result is a
+NumPy array when any operand is one, otherwise an ``array.array``.
+"""
+
+import array
+import math
+import sys
+import threading
+
+# Element-wise operators and the Python source of each (operands as {0}, {1})
+_BINARY = {
+    "add": "{0} + {1}", "sub": "{0} - {1}", "mul": "{0} * {1}", "truediv": "{0} / {1}",
+    "floordiv": "{0} // {1}", "mod": "{0} % {1}", "pow": "{0} ** {1}",
+}
+_UNARY = {"neg": "-{0}", "pos": "+{0}", "abs": "abs({0})"}
+
+# (function body source, mode) -> vectorized loop
+_loops = {}
+_loops_lock = threading.Lock()
+
+
+class LazyExpr:
+    """A recorded element-wise expression; see the module docstring."""
+
+    __slots__ = ("op", "args")
+    __array_ufunc__ = None  # NumPy arrays on the left defer to the reflected operators
+
+    def __init__(self, op, args):
+        self.op = op
+        self.args = args
+
+    def _binary(op, reflected=False):
+        def method(self, other):
+            return LazyExpr(op, (other, self) if reflected else (self, other))
+        return method
+
+    __add__, __radd__ = _binary("add"), _binary("add", True)
+    __sub__, __rsub__ = _binary("sub"), _binary("sub", True)
+    __mul__, __rmul__ = _binary("mul"), _binary("mul", True)
+    __truediv__, __rtruediv__ = _binary("truediv"), _binary("truediv", True)
+    __floordiv__, __rfloordiv__ = _binary("floordiv"), _binary("floordiv", True)
+    __mod__, __rmod__ = _binary("mod"), _binary("mod", True)
+    __pow__, __rpow__ = _binary("pow"), _binary("pow", True)
+    del _binary
+
+    def __neg__(self):
+        return LazyExpr("neg", (self,))
+
+    def __pos__(self):
+        return LazyExpr("pos", (self,))
+
+    def __abs__(self):
+        return LazyExpr("abs", (self,))
+
+    def __repr__(self):
+        source, operands = _lower(self)
+        return f"<LazyExpr: {source.count(chr(10)) - 1} operations over {len(operands)} operands>"
+
+    def evaluate(self, out=None, mode=None):
+        """
+        Run the expression as one fused loop and return the result.
+
+        Args:
+            out: Writable buffer for the result (default: a new array)
+            mode: 'float', 'float32', 'int' or 'int32' (default: from the
+                  operands' element type; scalars alone mean 'float')
+        """
+        from . import _BUFFER_MODES, _UFUNC_KINDS
+
+        source, operands = _lower(self)
+        shape = None
+        numpy_like = None
+        args = []
+        for operand in operands:
+            if isinstance(operand, (int, float)):
+                args.append(operand)
+                continue
+            view = memoryview(operand)
+            if view.ndim > 1 or (view.ndim == 1 and len(view) > 1):
+                if shape is not None and view.shape != shape:
+                    raise ValueError(f"operands could not be broadcast together with shapes {shape} {view.shape}")
+                shape = view.shape
+            if mode is None:
+                key = (view.format.lstrip("@=<"), view.itemsize)
+                if key not in _BUFFER_MODES:
+                    raise TypeError(f"lazy expressions take float64, float32, int64 or int32 arrays, not format {view.format!r}")
+                mode = _BUFFER_MODES[key]
+            if numpy_like is None and type(operand).__module__ == "numpy":
+                numpy_like = operand
+            args.append(view.cast("B").cast(view.format) if view.ndim > 1 else view)
+        mode = mode or "float"
+        if mode not in _UFUNC_KINDS:
+            raise ValueError(f"mode must be one of {', '.join(_UFUNC_KINDS)}, not {mode!r}")
+        kind = _UFUNC_KINDS[mode]
+        shape = shape or (1,)
+        count = math.prod(shape)
+
+        result = out
+        if result is None:
+            if numpy_like is not None:
+                result = sys.modules["numpy"].empty(shape, dtype=kind)
+            else:
+                result = array.array(kind, bytes(count * array.array(kind).itemsize))
+        target = memoryview(result)
+        if target.ndim > 1:
+            target = target.cast("B").cast(target.format)
+        _loop_for(source, len(operands), mode)(*args, out=target)
+        return result
+
+
+def lazy(obj):
+    """Wrap an array (or scalar) so operators on it build a LazyExpr instead of computing."""
+    return obj if isinstance(obj, LazyExpr) else LazyExpr("leaf", (obj,))
+
+
+def _function(name):
+    def call(*args):
+        return LazyExpr(("math", name), args)
+    call.__name__ = name
+    return call
+
+
+def expr(source, **operands):
+    """
+    Evaluate ``source``, an element-wise expression over arrays, as one fused loop.
+
+    Names come from ``operands``, then the caller's locals and globals; math
+    functions float mode calls natively (``sqrt``, ``exp``, ``log``, ...)
+    are available by name.
+
+    Example:
+        result = justjit.expr("a * b + c * d - e", a=a, b=b, c=c, d=d, e=e)
+    """
+    from . import _MATH_NATIVE
+
+    caller = sys._getframe(1)
+    namespace = {name: _function(name) for name in _MATH_NATIVE}
+    namespace.update(caller.f_globals)
+    namespace.update(caller.f_locals)
+    namespace.update(operands)
+    code = compile(source, "<justjit.expr>", "eval")
+    for name in code.co_names:
+        value = namespace.get(name)
+        if value is not None and not isinstance(value, LazyExpr) and not callable(value):
+            namespace[name] = lazy(value)
+    result = eval(code, {"__builtins__": {"abs": abs}}, namespace)
+    if not isinstance(result, LazyExpr):
+        result = LazyExpr("pos", (lazy(result),))
+    return result.evaluate()
+
+
+def _lower(root):
+    """
+    Scalar function source for the DAG under ``root``, and its operands.
+
+    Each distinct leaf becomes a parameter ``a<i>`` and each operator node a
+    local ``t<i>``, assigned once however many nodes share it, so equal
+    expression shapes give equal source whatever the operands are.
+    """
+    operands, params, temps, lines = [], {}, {}, []
+
+    def name(node):
+        if not isinstance(node, LazyExpr):
+            node = LazyExpr("leaf", (node,))
+        if node.op == "leaf":
+            leaf = node.args[0]
+            if id(leaf) not in params:
+                params[id(leaf)] = f"a{len(operands)}"
+                operands.append(leaf)
+            return params[id(leaf)]
+        if id(node) in temps:
+            return temps[id(node)]
+        args = [name(arg) for arg in node.args]
+        if isinstance(node.op, tuple):
+            value = f"math.{node.op[1]}({', '.join(args)})"
+        else:
+            value = (_BINARY.get(node.op) or _UNARY[node.op]).format(*args)
+        temps[id(node)] = f"t{len(temps)}"
+        lines.append(f"    {temps[id(node)]} = {value}")
+        return temps[id(node)]
+
+    result = name(root)
+    header = f"def lazy_expr({', '.join(f'a{i}' for i in range(len(operands)))}):"
+    return "\n".join([header, *lines, f"    return {result}"]), operands
+
+
+def _loop_for(source, nin, mode):
+    from . import _create_vectorized
+
+    key = (source, mode)
+    with _loops_lock:
+        loop = _loops.get(key)
+    if loop is None:
+        namespace = {"math": math}
+        exec(source, namespace)
+        loop = _create_vectorized(namespace["lazy_expr"], mode, False, 3, False, None, None, "cpu", parallel=True)
+        with _loops_lock:
+            loop = _loops.setdefault(key, loop)
+    return loop
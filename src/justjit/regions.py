@@ -0,0 +1,416 @@
+"""
+Numeric loops of object-mode functions, compiled natively (jit(regions=True)).
+
+A function that native mode cannot type as a whole, because it builds
+dicts, formats strings or catches exceptions, often spends its time in one
+loop of plain arithmetic over ints, floats and arrays. ``outline_regions``
+moves each such loop into a function of its own, a region, and rewrites
+the original to call it:
+
+    def summarize(path, values):            def summarize(path, values):
+        try:                                    try:
+            scale = SCALES[path]                    scale = SCALES[path]
+        except KeyError:                        except KeyError:
+            scale = 1.0                             scale = 1.0
+        total = 0.0                             total = 0.0
+        for i in range(len(values)):            total = __justjit_region_0(values, scale, total)
+            total += values[i] * scale          return f"{path}: {total}"
+        return f"{path}: {total}"
+
+The region's parameters are the locals the loop reads (its live-ins),
+and it returns the one local the loop assigns that is read after it (its
+live-out). Each call compiles the region in native mode for the types of
+its arguments (int, float, bool, or the element type and rank of a
+buffer), so the loop runs with unboxed locals and direct element access;
+arguments of other types run the region interpreted.
+
+A loop qualifies when it is a ``for`` over ``range()`` or a ``while``
+without ``else``, and its body only assigns locals and array elements,
+branches, loops and breaks, using numbers, operators, comparisons,
+``math`` functions and abs/min/max/int/float/bool/round/len. Each local it
+uses must be assigned on every path before the loop, or be a temporary
+of the loop alone. Functions with closures, ``global`` or ``nonlocal``
+are left as they are.
+"""
+
+import ast
+import inspect
+import textwrap
+import threading
+import types
+import warnings
+
+# Builtins a region may call (native mode lowers each, or rejects the region)
+_BUILTINS = ("abs", "min", "max", "int", "float", "bool", "round", "len", "range")
+
+# Signature element type for each (buffer format, itemsize)
+_ELEMENTS = {
+    ("d", 8): "f64", ("f", 4): "f32", ("q", 8): "i64", ("l", 8): "i64",
+    ("i", 4): "i32", ("l", 4): "i32", ("B", 1): "u8",
+}
+
+# Typed compiles kept per region; later argument types run the region interpreted
+_KERNEL_LIMIT = 8
+
+_EXPRESSIONS = (
+    ast.Name, ast.Constant, ast.BinOp, ast.UnaryOp, ast.BoolOp, ast.Compare, ast.IfExp,
+    ast.Subscript, ast.Attribute, ast.Call, ast.Tuple,
+    ast.operator, ast.unaryop, ast.boolop, ast.cmpop, ast.expr_context,
+)
+
+
+class _Region:
+    """A region's plain function plus its native compile per argument types."""
+
+    def __init__(self, func):
+        self.func = func
+        self.kernels = {}
+        self.lock = threading.Lock()
+
+    def __call__(self, *args):
+        key = tuple(map(_arg_type, args))
+        kernel = self.kernels.get(key)
+        if kernel is None:
+            kernel = self._compile(key)
+        return kernel(*args)
+
+    def _compile(self, key):
+        from . import jit
+
+        with self.lock:
+            kernel = self.kernels.get(key)
+            if kernel is None:
+                if None in key or len(self.kernels) >= _KERNEL_LIMIT:
+                    kernel = self.func
+                else:
+                    with warnings.catch_warnings():
+                        # A region native mode cannot type runs in object mode
+                        warnings.simplefilter("ignore", RuntimeWarning)
+                        kernel = jit(self.func, signature="(" + ", ".join(key) + ")")
+                self.kernels[key] = kernel
+            return kernel
+
+
+def _arg_type(value):
+    """Native signature type for a region argument, or None if native mode takes no such type."""
+    kind = type(value)
+    if kind is bool:
+        return "b1"
+    if kind is int:
+        return "i64"
+    if kind is float:
+        return "f64"
+    try:
+        view = memoryview(value)
+    except TypeError:
+        return None
+    element = _ELEMENTS.get((view.format.lstrip("@=<"), view.itemsize))
+    if element is None or view.ndim == 0:
+        return None
+    return f"{element}[{', '.join(':' * view.ndim)}]"
+
+
+def outline_regions(func):
+    """``func`` with its qualifying loops moved into natively compiled regions, or None if it has none."""
+    code = func.__code__
+    if code.co_freevars or code.co_cellvars or code.co_flags & (inspect.CO_GENERATOR | inspect.CO_COROUTINE | inspect.CO_ASYNC_GENERATOR):
+        return None
+    try:
+        source = textwrap.dedent(inspect.getsource(func))
+    except (OSError, TypeError):
+        return None
+    tree = ast.parse(source)
+    func_def = tree.body[0] if tree.body else None
+    if not isinstance(func_def, ast.FunctionDef) or func_def.name != code.co_name:
+        return None
+    if any(isinstance(node, (ast.Global, ast.Nonlocal, ast.Lambda, ast.FunctionDef, ast.ClassDef)) for node in ast.walk(func_def) if node is not func_def):
+        return None
+    ast.increment_lineno(tree, code.co_firstlineno - 1)
+
+    local_names = set(code.co_varnames)
+    candidates = []
+    _find_loops(func_def.body, set(code.co_varnames[: _parameter_count(code)]), func, local_names, candidates)
+    references = _references(func_def)
+
+    regions, replacements = [], {}
+    for loop, assigned in candidates:
+        plan = _plan(loop, assigned, local_names, references)
+        if plan is None:
+            continue
+        params, live_out = plan
+        name = f"__justjit_region_{len(regions)}"
+        regions.append(_region_function(func, name, loop, params, live_out))
+        call = ast.Call(ast.Name(name, ast.Load()), [ast.Name(param, ast.Load()) for param in params], [])
+        if live_out is None:
+            statement = ast.Expr(call)
+        else:
+            statement = ast.Assign([ast.Name(live_out, ast.Store())], call)
+        replacements[id(loop)] = ast.copy_location(statement, loop)
+    if not regions:
+        return None
+
+    # The rewritten function is built inside a factory taking the regions, so they are its free variables
+    func_def = _Replace(replacements).visit(func_def)
+    names = [f"__justjit_region_{i}" for i in range(len(regions))]
+    return _closure_function(func, func_def, "__justjit_regions", names, list(map(_Region, regions)))
+
+
+def _closure_function(func, func_def, factory_name, names, values):
+    """
+    ``func_def``, a rewrite of ``func``, compiled inside a factory that takes
+    ``names`` and called with ``values``, so the rewrite reads them as free
+    variables. Defaults, annotations, names and ``__dict__`` come from ``func``,
+    since the factory does not evaluate them.
+    """
+    func_def.decorator_list = []
+    func_def.returns = None
+    arguments = func_def.args
+    arguments.defaults, arguments.kw_defaults = [], [None] * len(arguments.kwonlyargs)
+    for arg in arguments.posonlyargs + arguments.args + arguments.kwonlyargs + [arguments.vararg, arguments.kwarg]:
+        if arg is not None:
+            arg.annotation = None
+    factory = ast.FunctionDef(
+        factory_name,
+        ast.arguments([], [ast.arg(name) for name in names], None, [], [], None, []),
+        [func_def, ast.Return(ast.Name(func_def.name, ast.Load()))],
+        [],
+    )
+    factory_code = _function_code(factory, func_def, func.__code__.co_filename)
+    rewritten = types.FunctionType(factory_code, func.__globals__)(*values)
+    rewritten.__defaults__ = func.__defaults__
+    rewritten.__kwdefaults__ = func.__kwdefaults__
+    rewritten.__annotations__ = func.__annotations__
+    rewritten.__qualname__ = func.__qualname__
+    rewritten.__module__ = func.__module__
+    rewritten.__doc__ = func.__doc__
+    rewritten.__dict__.update(func.__dict__)
+    return rewritten
+
+
+def _parameter_count(code):
+    return code.co_argcount + code.co_kwonlyargcount + bool(code.co_flags & inspect.CO_VARARGS) + bool(code.co_flags & inspect.CO_VARKEYWORDS)
+
+
+def _find_loops(block, assigned, func, local_names, found):
+    """Collect the outermost qualifying loops of ``block`` with the locals assigned on every path to each."""
+    assigned = set(assigned)
+    for statement in block:
+        if isinstance(statement, (ast.For, ast.While)) and _qualifies(statement, func, local_names):
+            found.append((statement, frozenset(assigned)))
+        elif isinstance(statement, ast.For):
+            _find_loops(statement.body, assigned | _target_names(statement.target), func, local_names, found)
+            _find_loops(statement.orelse, assigned, func, local_names, found)
+        elif isinstance(statement, (ast.While, ast.If)):
+            _find_loops(statement.body, assigned, func, local_names, found)
+            _find_loops(statement.orelse, assigned, func, local_names, found)
+        elif isinstance(statement, ast.With):
+            bound = set().union(*(_target_names(item.optional_vars) for item in statement.items if item.optional_vars))
+            _find_loops(statement.body, assigned | bound, func, local_names, found)
+        elif isinstance(statement, ast.Try):
+            _find_loops(statement.body, assigned, func, local_names, found)
+            for handler in statement.handlers:
+                _find_loops(handler.body, assigned, func, local_names, found)
+            _find_loops(statement.orelse, assigned | _definite(statement.body), func, local_names, found)
+            _find_loops(statement.finalbody, assigned, func, local_names, found)
+        assigned |= _definite([statement])
+
+
+def _definite(block):
+    """Locals every path that runs ``block`` to its end has assigned."""
+    names = set()
+    for statement in block:
+        if isinstance(statement, ast.Assign):
+            for target in statement.targets:
+                names |= _target_names(target)
+        elif isinstance(statement, (ast.AugAssign, ast.AnnAssign)) and getattr(statement, "value", None) is not None:
+            names |= _target_names(statement.target)
+        elif isinstance(statement, ast.If):
+            names |= _definite(statement.body) & _definite(statement.orelse) if statement.orelse else set()
+        elif isinstance(statement, ast.With):
+            names |= _definite(statement.body)
+        elif isinstance(statement, ast.Try):
+            # Handlers that leave (raise or return) do not reach the code after the try
+            after = _definite(statement.body) | _definite(statement.orelse)
+            for handler in statement.handlers:
+                if not (handler.body and isinstance(handler.body[-1], (ast.Raise, ast.Return))):
+                    after &= _definite(handler.body)
+            names |= after | _definite(statement.finalbody)
+    return names
+
+
+def _target_names(target):
+    if isinstance(target, ast.Name):
+        return {target.id}
+    if isinstance(target, (ast.Tuple, ast.List)):
+        return set().union(*map(_target_names, target.elts))
+    return set()
+
+
+def _qualifies(loop, func, local_names):
+    """True if ``loop`` only does the arithmetic native mode compiles (see the module docstring)."""
+    if loop.orelse:
+        return False
+    if isinstance(loop, ast.For) and not (isinstance(loop.target, ast.Name) and _is_range(loop.iter, func, local_names)):
+        return False
+    if isinstance(loop, ast.While) and not _expression(loop.test, func, local_names):
+        return False
+    if isinstance(loop, ast.For) and not all(_expression(arg, func, local_names) for arg in loop.iter.args):
+        return False
+    return all(_statement(statement, func, local_names) for statement in loop.body)
+
+
+def _statement(statement, func, local_names):
+    if isinstance(statement, (ast.Break, ast.Continue, ast.Pass)):
+        return True
+    if isinstance(statement, (ast.For, ast.While)):
+        return _qualifies(statement, func, local_names)
+    if isinstance(statement, ast.If):
+        return _expression(statement.test, func, local_names) and all(
+            _statement(child, func, local_names) for child in statement.body + statement.orelse
+        )
+    if isinstance(statement, (ast.Assign, ast.AugAssign)):
+        targets = statement.targets if isinstance(statement, ast.Assign) else [statement.target]
+        return all(_store_target(target, func, local_names) for target in targets) and _expression(statement.value, func, local_names)
+    return False
+
+
+def _store_target(target, func, local_names):
+    if isinstance(target, ast.Name):
+        return target.id in local_names
+    if isinstance(target, ast.Tuple):
+        return all(isinstance(item, ast.Name) and item.id in local_names for item in target.elts)
+    return (
+        isinstance(target, ast.Subscript)
+        and isinstance(target.value, ast.Name)
+        and target.value.id in local_names
+        and _expression(target.slice, func, local_names)
+    )
+
+
+def _expression(node, func, local_names):
+    for child in ast.walk(node):
+        if not isinstance(child, _EXPRESSIONS):
+            return False
+        if isinstance(child, ast.Constant) and type(child.value) not in (int, float, bool):
+            return False
+        if isinstance(child, ast.Attribute) and not (
+            child.attr == "shape" and isinstance(child.value, ast.Name) and child.value.id in local_names
+            or _is_math(child.value, func, local_names)
+        ):
+            return False
+        if isinstance(child, ast.Call):
+            if child.keywords or not (_is_builtin(child.func, func, local_names) or (
+                isinstance(child.func, ast.Attribute) and _is_math(child.func.value, func, local_names)
+            )):
+                return False
+    return True
+
+
+def _is_range(node, func, local_names):
+    return (
+        isinstance(node, ast.Call) and not node.keywords and 1 <= len(node.args) <= 3
+        and isinstance(node.func, ast.Name) and node.func.id == "range"
+        and _is_builtin(node.func, func, local_names)
+    )
+
+
+def _is_builtin(node, func, local_names):
+    return isinstance(node, ast.Name) and node.id in _BUILTINS and node.id not in local_names and node.id not in func.__globals__
+
+
+def _is_math(node, func, local_names):
+    return (
+        isinstance(node, ast.Name) and node.id not in local_names
+        and getattr(func.__globals__.get(node.id), "__name__", None) == "math"
+    )
+
+
+def _references(func_def):
+    """``[(node, enclosing for loops)]`` for every Name in ``func_def``, counting a for only in its body."""
+    references = []
+
+    def visit(node, loops):
+        if isinstance(node, ast.Name):
+            references.append((node, loops))
+        if isinstance(node, ast.For):
+            # Reads in the body see this loop's target, not a value from before the loop
+            visit(node.iter, loops)
+            visit(node.target, loops)
+            for child in node.body:
+                visit(child, loops + (node,))
+            for child in node.orelse:
+                visit(child, loops)
+            return
+        for child in ast.iter_child_nodes(node):
+            visit(child, loops)
+
+    visit(func_def, ())
+    return references
+
+
+def _binds(loops, name, within):
+    """True if one of ``loops`` for which ``within(loop)`` holds has ``name`` as its target."""
+    return any(within(loop) and name in _target_names(loop.target) for loop in loops)
+
+
+def _plan(loop, assigned, local_names, references):
+    """``(parameters, live-out or None)`` for outlining ``loop``, or None if it cannot be."""
+    inside = {id(node) for node in ast.walk(loop)}
+    # A for around the loop does not rebind its target between the loop and a later read
+    around = {id(outer) for node, loops in references if id(node) in inside for outer in loops if id(outer) not in inside}
+    loaded, stored, outside_loads, outside_stores = [], set(), set(), set()
+    for node, loops in references:
+        name = node.id
+        if name not in local_names:
+            continue
+        if id(node) in inside:
+            if isinstance(node.ctx, ast.Store):
+                stored.add(name)
+            elif name not in loaded and not _binds(loops, name, lambda outer: id(outer) in inside):
+                loaded.append(name)
+        elif isinstance(node.ctx, ast.Store):
+            outside_stores.add(name)
+        elif not _binds(loops, name, lambda outer: id(outer) not in around):
+            outside_loads.add(name)
+
+    params, live_outs = [], []
+    for name in loaded + sorted(stored - set(loaded)):
+        if name in assigned:
+            if name in stored and name in outside_loads:
+                live_outs.append(name)
+            if name in loaded or name in live_outs:
+                params.append(name)
+        elif name in outside_loads or (name in loaded and name in outside_stores):
+            # Possibly bound before the loop, or read after it without a value the region can return
+            return None
+    if len(live_outs) > 1:
+        return None
+    return params, live_outs[0] if live_outs else None
+
+
+def _region_function(func, name, loop, params, live_out):
+    body = [loop]
+    if live_out is not None:
+        body.append(ast.copy_location(ast.Return(ast.Name(live_out, ast.Load())), loop))
+    region_def = ast.FunctionDef(name, ast.arguments([], [ast.arg(param) for param in params], None, [], [], None, []), body, [])
+    region = types.FunctionType(_function_code(region_def, loop, func.__code__.co_filename), func.__globals__, name)
+    region.__qualname__ = f"{func.__qualname__}.<region {name[len('__justjit_region_'):]}>"
+    region.__module__ = func.__module__
+    region._justjit_region = True
+    return region
+
+
+def _function_code(function_def, location, filename):
+    """Code object of ``function_def``, compiled with the line numbers of ``location``."""
+    module = ast.fix_missing_locations(ast.Module([ast.copy_location(function_def, location)], []))
+    return next(const for const in compile(module, filename, "exec").co_consts if isinstance(const, types.CodeType))
+
+
+class _Replace(ast.NodeTransformer):
+    """Replace each outlined loop with its region call."""
+
+    def __init__(self, replacements):
+        self.replacements = replacements
+
+    def generic_visit(self, node):
+        return self.replacements.get(id(node)) or super().generic_visit(node)
@@ -0,0 +1,92 @@
+"""
+Lane operations for the vector modes (vec4f, vec8i, vec8d, vec16f, vec16i,
+vec16u8, vec32u8, vec16i16).
+
+A vector-mode function may call these as ``simd.<name>(...)`` or
+``justjit.simd.<name>(...)``, or by a name imported from this module; the
+compiler lowers each call to LLVM vector instructions instead of calling
+it. Comparisons between vectors give lane masks, scalars (constants or lane
+reductions) are broadcast where a vector is needed, and a function that
+returns a reduction returns a number instead of a list of lanes.
+
+The definitions below give the meaning of each operation on sequences of
+lanes, and run when called outside compiled code.
+"""
+
+import builtins
+
+__all__ = [
+    "hsum", "hmin", "hmax", "any", "all", "select", "minimum", "maximum",
+    "broadcast", "shuffle", "permute", "gather",
+]
+
+
+def hsum(v):
+    """Sum of the lanes (llvm.vector.reduce.add / fadd, reassociated into a tree)."""
+    return builtins.sum(v)
+
+
+def hmin(v):
+    """Smallest lane."""
+    return builtins.min(v)
+
+
+def hmax(v):
+    """Largest lane."""
+    return builtins.max(v)
+
+
+def any(mask):
+    """1 if any lane of ``mask`` is set, else 0."""
+    return int(builtins.any(mask))
+
+
+def all(mask):
+    """1 if every lane of ``mask`` is set, else 0."""
+    return int(builtins.all(mask))
+
+
+def select(mask, a, b):
+    """Blend: ``a[i]`` where ``mask[i]`` is set, else ``b[i]``."""
+    return [x if m else y for m, x, y in zip(mask, _lanes(a, len(mask)), _lanes(b, len(mask)))]
+
+
+def minimum(a, b):
+    """Lane-wise minimum."""
+    return [builtins.min(x, y) for x, y in zip(a, b)]
+
+
+def maximum(a, b):
+    """Lane-wise maximum."""
+    return [builtins.max(x, y) for x, y in zip(a, b)]
+
+
+def broadcast(x, lanes=None):
+    """``x`` in every lane (in compiled code the lane count comes from the mode)."""
+    return [x] * (lanes or 1)
+
+
+def shuffle(a, b, indices=None):
+    """
+    Lanes picked by constant indices: ``shuffle(a, (3, 2, 1, 0))`` reverses
+    ``a``; ``shuffle(a, b, indices)`` indexes ``a`` followed by ``b``.
+    """
+    if indices is None:
+        a, indices = list(a), b
+    else:
+        a = list(a) + list(b)
+    return [a[i] for i in indices]
+
+
+def permute(a, indices):
+    """Lanes picked by run-time indices (taken modulo the lane count)."""
+    return [a[int(i) % len(a)] for i in indices]
+
+
+def gather(table, indices):
+    """Lookup of each lane's index in a constant tuple (clamped to its last entry)."""
+    return [table[builtins.min(int(i), len(table) - 1)] for i in indices]
+
+
+def _lanes(x, count):
+    return x if hasattr(x, "__len__") else [x] * count
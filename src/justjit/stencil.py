@@ -0,0 +1,347 @@
+"""
+Neighborhood computations over 1-D and 2-D float64 arrays.
+
+A stencil kernel reads its array parameters with relative indices, where
+``a[0]`` (or ``a[0, 0]``) is the element being computed:
+
+    @justjit.stencil
+    def smooth(a):
+        return a[-1] + 2 * a[0] + a[1]
+
+    @justjit.stencil(border="reflect")
+    def laplacian(u):
+        return u[-1, 0] + u[1, 0] + u[0, -1] + u[0, 1] - 4 * u[0, 0]
+
+Calling it runs the kernel at every element and returns a new array of the
+same shape, or fills ``out=``. The kernel is lowered to a native-mode
+function with two parts. The interior loop nest indexes the arrays with the
+loop counters plus constant offsets, so native mode checks its bounds once
+per row rather than per element, and the innermost loop vectorizes. The
+border loops map each out-of-range neighbor first, by ``border``:
+'constant' (``cval``), 'reflect' (d c b a | a b c d | d c b a), 'wrap' or
+'nearest'.
+
+With ``parallel=True`` and C-contiguous arrays, the interior instead runs as
+one vectorize() loop over shifted flat views of the arrays, in blocks across
+the ``prange()`` pool with the GIL released. The border pass then rewrites
+the cells at the edges.
+
+Parameters that are never subscripted are float scalars, passed through.
+Every array argument must have the kernel's shape.
+"""
+
+import array
+import ast
+import inspect
+import sys
+import textwrap
+import threading
+
+_BORDERS = ("constant", "reflect", "wrap", "nearest")
+
+
+class Stencil:
+    """A compiled stencil kernel; see the module docstring."""
+
+    def __init__(self, kernel, border="constant", cval=0.0, parallel=False):
+        if border not in _BORDERS:
+            raise ValueError(f"border must be one of {', '.join(_BORDERS)}, not {border!r}")
+        self.kernel = kernel
+        self.border = border
+        self.cval = float(cval)
+        self.parallel = parallel
+        self.__name__ = kernel.__name__
+        self.__doc__ = kernel.__doc__
+        self._analysis = _analyze(kernel)
+        self._native = None
+        self._point = None
+        self._lock = threading.Lock()
+
+    def __repr__(self):
+        return f"<justjit.stencil {self.__name__} border={self.border!r}>"
+
+    def __call__(self, *args, out=None):
+        analysis = self._analysis
+        if len(args) != len(analysis.params):
+            raise TypeError(f"{self.__name__}() takes {len(analysis.params)} arguments ({len(args)} given)")
+        shape = None
+        numpy_like = None
+        views = []
+        for name, arg in zip(analysis.params, args):
+            if name not in analysis.arrays:
+                continue
+            view = memoryview(arg)
+            if view.format.lstrip("@=<") != "d" or view.ndim != analysis.ndim:
+                raise TypeError(f"{name} must be a {analysis.ndim}-D float64 array")
+            if shape is not None and view.shape != shape:
+                raise ValueError(f"arrays of different shapes: {shape} and {view.shape}")
+            shape = view.shape
+            views.append(view)
+            if numpy_like is None and type(arg).__module__ == "numpy":
+                numpy_like = arg
+        if shape is None:
+            raise TypeError(f"{self.__name__}() needs an array argument")
+
+        result = out
+        if result is None:
+            count = 1
+            for size in shape:
+                count *= size
+            if numpy_like is not None:
+                result = sys.modules["numpy"].empty(shape, dtype="d")
+            elif analysis.ndim == 1:
+                result = array.array("d", bytes(8 * count))
+            else:
+                result = memoryview(bytearray(8 * count)).cast("d", shape)
+        target = memoryview(result)
+        if target.readonly or target.format.lstrip("@=<") != "d" or target.shape != shape:
+            raise ValueError(f"out must be a writable float64 array of shape {shape}")
+
+        native = self._compile()
+        interior = 1
+        if self.parallel and all(view.c_contiguous for view in views + [target]) and self._run_flat(args, views, target):
+            interior = 0
+        native(target, *args, self.cval, interior)
+        return result
+
+    def _compile(self):
+        with self._lock:
+            if self._native is None:
+                from . import jit
+
+                analysis = self._analysis
+                namespace = {}
+                exec(_native_source(analysis, self.border), namespace)
+                array_type = "f64[" + ", ".join(":" * analysis.ndim) + "]"
+                params = [array_type] + [array_type if name in analysis.arrays else "f64" for name in analysis.params]
+                self._native = jit(f"void({', '.join(params + ['f64', 'i64'])})")(namespace["stencil_" + self.__name__])
+            return self._native
+
+    def _run_flat(self, args, views, target):
+        """Interior as one parallel vectorize() loop over shifted flat views; False if it is empty."""
+        from . import _create_vectorized
+
+        analysis = self._analysis
+        shape = target.shape
+        row = shape[1] if analysis.ndim == 2 else 1
+        lows, highs = analysis.lows, analysis.highs
+        # Flat positions of the first and one past the last interior cell; the
+        # edge columns between them are computed too, and rewritten by the border pass
+        first = lows[0] * row + (lows[1] if analysis.ndim == 2 else 0)
+        past = (shape[0] - highs[0] - 1) * row + (shape[1] - highs[1] if analysis.ndim == 2 else 1)
+        if any(size <= low + high for size, low, high in zip(shape, lows, highs)) or past <= first:
+            return False
+        with self._lock:
+            if self._point is None:
+                namespace = {}
+                exec(_point_source(analysis), namespace)
+                self._point = _create_vectorized(
+                    namespace["stencil_point"], "float", False, 3, False, None, None, "cpu", parallel=True
+                )
+        flat = {name: view.cast("B").cast("d") for name, view in zip(analysis.arrays_in_order, views)}
+        operands = []
+        for name, offsets in analysis.accesses:
+            shift = offsets[0] * row + (offsets[1] if analysis.ndim == 2 else 0)
+            operands.append(flat[name][first + shift:past + shift])
+        scalars = [arg for name, arg in zip(analysis.params, args) if name not in analysis.arrays]
+        self._point(*operands, *scalars, out=target.cast("B").cast("d")[first:past])
+        return True
+
+
+def stencil(kernel=None, *, border="constant", cval=0.0, parallel=False):
+    """
+    Compile a relative-index kernel into a neighborhood loop over whole arrays.
+
+    Args:
+        kernel: Function reading its array parameters as ``a[di]`` or ``a[di, dj]``
+        border: 'constant', 'reflect', 'wrap' or 'nearest' handling of
+                neighbors outside the array
+        cval: Value of outside neighbors with border='constant'
+        parallel: Run the interior across the prange() pool (C-contiguous arrays)
+
+    Example:
+        @justjit.stencil(border="wrap")
+        def smooth(a):
+            return 0.25 * a[-1] + 0.5 * a[0] + 0.25 * a[1]
+
+        smoothed = smooth(signal)
+    """
+    if kernel is None:
+        return lambda kernel: Stencil(kernel, border, cval, parallel)
+    return Stencil(kernel, border, cval, parallel)
+
+
+class _Analysis:
+    """The kernel's parameters, relative accesses and neighborhood."""
+
+    def __init__(self, func_def, params, arrays, ndim, accesses):
+        self.func_def = func_def
+        self.params = params
+        self.arrays = arrays
+        self.arrays_in_order = [name for name in params if name in arrays]
+        self.ndim = ndim
+        self.accesses = accesses  # Distinct (array, offsets), in order of first use
+        self.lows = [max([0] + [-offsets[d] for _, offsets in accesses]) for d in range(ndim)]
+        self.highs = [max([0] + [offsets[d] for _, offsets in accesses]) for d in range(ndim)]
+
+
+def _offset(node):
+    if isinstance(node, ast.Constant) and type(node.value) is int:
+        return node.value
+    if isinstance(node, ast.UnaryOp) and isinstance(node.op, (ast.USub, ast.UAdd)):
+        value = _offset(node.operand)
+        return None if value is None else (-value if isinstance(node.op, ast.USub) else value)
+    return None
+
+
+def _analyze(kernel):
+    source = textwrap.dedent(inspect.getsource(kernel))
+    func_def = next(node for node in ast.parse(source).body if isinstance(node, (ast.FunctionDef, ast.AsyncFunctionDef)))
+    func_def.decorator_list = []
+    params = [arg.arg for arg in func_def.args.args]
+    body = func_def.body
+    if body and isinstance(body[0], ast.Expr) and isinstance(body[0].value, ast.Constant) and isinstance(body[0].value.value, str):
+        body = body[1:]  # Docstring
+    if not body or not isinstance(body[-1], ast.Return) or body[-1].value is None or any(
+        isinstance(node, ast.Return) for statement in body[:-1] for node in ast.walk(statement)
+    ):
+        raise TypeError(f"stencil kernel {kernel.__name__} must end in its only return of a value")
+    func_def.body = body
+
+    arrays, accesses, ndim = set(), [], None
+    for node in ast.walk(func_def):
+        if isinstance(node, ast.Subscript) and isinstance(node.value, ast.Name) and node.value.id in params:
+            index = node.slice.elts if isinstance(node.slice, ast.Tuple) else [node.slice]
+            offsets = tuple(_offset(item) for item in index)
+            if None in offsets or len(offsets) > 2 or (ndim is not None and len(offsets) != ndim):
+                raise TypeError(f"stencil kernel {kernel.__name__}: indices must be constant offsets of one rank, 1 or 2")
+            ndim = len(offsets)
+            arrays.add(node.value.id)
+            if (node.value.id, offsets) not in accesses:
+                accesses.append((node.value.id, offsets))
+    if ndim is None:
+        raise TypeError(f"stencil kernel {kernel.__name__} reads no array")
+    subscripted = {id(node.value) for node in ast.walk(func_def) if isinstance(node, ast.Subscript)}
+    for node in ast.walk(func_def):
+        if isinstance(node, ast.Name) and node.id in arrays and id(node) not in subscripted:
+            raise TypeError(f"stencil kernel {kernel.__name__} uses array {node.id} without an index")
+    return _Analysis(func_def, params, arrays, ndim, accesses)
+
+
+class _Rewrite(ast.NodeTransformer):
+    """Replaces each relative access by ``replace(array, offsets)``."""
+
+    def __init__(self, analysis, replace):
+        self.analysis = analysis
+        self.replace = replace
+
+    def visit_Subscript(self, node):
+        if isinstance(node.value, ast.Name) and node.value.id in self.analysis.arrays:
+            index = node.slice.elts if isinstance(node.slice, ast.Tuple) else [node.slice]
+            return self.replace(node.value.id, tuple(_offset(item) for item in index))
+        return self.generic_visit(node)
+
+
+def _kernel_lines(analysis, replace, target, indent):
+    """The kernel body with accesses replaced, its result stored to ``target``."""
+    rewrite = _Rewrite(analysis, replace)
+    lines = []
+    for statement in analysis.func_def.body:
+        statement = rewrite.visit(ast.parse(ast.unparse(statement)).body[0])
+        if isinstance(statement, ast.Return):
+            statement = ast.parse(f"{target} = {ast.unparse(statement.value)}").body[0]
+        lines.extend(indent + line for line in ast.unparse(statement).splitlines())
+    return lines
+
+
+def _shifted(counter, offset):
+    return counter if offset == 0 else f"{counter} {'+' if offset > 0 else '-'} {abs(offset)}"
+
+
+def _native_source(analysis, border):
+    """A native-mode function: the interior loop nest (when ``_interior``), then the border cells."""
+    ndim = analysis.ndim
+    sizes = [f"_n{d}" for d in range(ndim)]
+    header = f"def stencil_{analysis.func_def.name}(_out, {', '.join(analysis.params)}, _cval, _interior):"
+    lines = [header, "    _n0 = len(_out)" if ndim == 1 else f"    {', '.join(sizes)} = _out.shape"]
+
+    # Interior: counters plus constant offsets, bounds-checked once per loop
+    lines.append("    if _interior != 0:")
+    indent = "        "
+    for d in range(ndim):
+        lines.append(f"{indent}for _i{d} in range({analysis.lows[d]}, _n{d} - {analysis.highs[d]}):")
+        indent += "    "
+
+    def interior_access(name, offsets):
+        index = ", ".join(_shifted(f"_i{d}", offsets[d]) for d in range(ndim))
+        return ast.parse(f"{name}[{index}]", mode="eval").body
+
+    target = "_out[" + ", ".join(f"_i{d}" for d in range(ndim)) + "]"
+    lines.extend(_kernel_lines(analysis, interior_access, target, indent))
+
+    # Border cells: each neighbor's index mapped by the border mode first
+    def border_body(indent):
+        body = []
+        for k, (name, offsets) in enumerate(analysis.accesses):
+            inside = []
+            for d in range(ndim):
+                j, n = f"_j{d}", f"_n{d}"
+                body.append(f"{indent}{j} = {_shifted(f'_b{d}', offsets[d])}")
+                if border == "constant":
+                    inside.append(f"{j} >= 0 and {j} < {n}")
+                elif border == "wrap":
+                    body.append(f"{indent}{j} = {j} % {n}")
+                elif border == "reflect":
+                    body.append(f"{indent}{j} = {j} % (2 * {n})")
+                    body.append(f"{indent}if {j} >= {n}:")
+                    body.append(f"{indent}    {j} = 2 * {n} - {j} - 1")
+                else:
+                    body.append(f"{indent}if {j} < 0:")
+                    body.append(f"{indent}    {j} = 0")
+                    body.append(f"{indent}if {j} >= {n}:")
+                    body.append(f"{indent}    {j} = {n} - 1")
+            load = f"{name}[{', '.join(f'_j{d}' for d in range(ndim))}]"
+            if inside:
+                body.append(f"{indent}if {' and '.join(inside)}:")
+                body.append(f"{indent}    _v{k} = {load}")
+                body.append(f"{indent}else:")
+                body.append(f"{indent}    _v{k} = _cval")
+            else:
+                body.append(f"{indent}_v{k} = {load}")
+        target = "_out[" + ", ".join(f"_b{d}" for d in range(ndim)) + "]"
+        body.extend(_kernel_lines(analysis, lambda name, offsets: ast.Name(f"_v{analysis.accesses.index((name, offsets))}"), target, indent))
+        return body
+
+    def edges(d, indent):
+        # The cells of the last axis d outside the interior, without overlap when it is empty
+        low, high, n = analysis.lows[d], analysis.highs[d], f"_n{d}"
+        return [
+            f"{indent}for _b{d} in range(0, {low} if {low} < {n} else {n}):",
+            *border_body(indent + "    "),
+            f"{indent}for _b{d} in range({n} - {high} if {n} - {high} > {low} else {low}, {n}):",
+            *border_body(indent + "    "),
+        ]
+
+    if ndim == 1:
+        lines.extend(edges(0, "    "))
+    else:
+        low, high = analysis.lows[0], analysis.highs[0]
+        lines.append("    for _b0 in range(_n0):")
+        lines.append(f"        if _b0 >= {low} and _b0 < _n0 - {high}:")
+        lines.extend(edges(1, "            "))
+        lines.append("        else:")
+        lines.append("            for _b1 in range(_n1):")
+        lines.extend(border_body("                "))
+    return "\n".join(lines) + "\n"
+
+
+def _point_source(analysis):
+    """The kernel as a scalar function of its distinct accesses, then its scalars, for vectorize()."""
+    values = [f"_v{k}" for k in range(len(analysis.accesses))]
+    scalars = [name for name in analysis.params if name not in analysis.arrays]
+    lines = [f"def stencil_point({', '.join(values + scalars)}):"]
+    lines.extend(
+        _kernel_lines(analysis, lambda name, offsets: ast.Name(f"_v{analysis.accesses.index((name, offsets))}"), "_result", "    ")
+    )
+    lines.append("    return _result")
+    return "\n".join(lines) + "\n"
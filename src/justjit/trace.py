@@ -0,0 +1,213 @@
+"""
+Low-overhead tracing of JIT events as Chrome trace JSON or Perfetto protobuf.
+
+While tracing is on, the runtime records events into a ring per thread
+(``capacity`` events each, oldest overwritten first):
+
+- ``compile``: a ``compile`` span per compiled function, spans for its
+  decode, build_cfg, stack_depths, verify, optimize and add_module phases,
+  and a ``materialize`` span when its first lookup generates machine code;
+- ``runtime``: ``deopt`` (a native call rerun in the interpreter),
+  ``fallback`` (a call run interpreted, with the reason) and ``tier_up``
+  (a tiered function switching to its top-tier code);
+- ``generator``: a live-object counter per JITGenerator / JITCoroutine type,
+  sampled at every creation, so creation bursts show as ramps;
+- ``inline_c``: an ``inline_c`` span per inline C compile.
+
+Open Chrome JSON in chrome://tracing or ui.perfetto.dev, and the protobuf
+(``.pftrace``) in ui.perfetto.dev or trace_processor. Timestamps are
+CLOCK_MONOTONIC, the clock of ``time.monotonic_ns()``, so application
+events recorded with it line up. With ``JUSTJIT_TRACE=path`` tracing starts
+at import and the trace is written to path at exit; a forked child writes
+its own events to path with its pid inserted before the extension.
+"""
+
+import atexit
+import itertools
+import json
+import os
+
+from ._core import trace_start as _trace_start, trace_stop as stop, tracing
+from ._core import trace_instant as _trace_instant, trace_events as _trace_events
+
+DEFAULT_CAPACITY = 1 << 16
+PERFETTO_SUFFIXES = (".pftrace", ".perfetto-trace", ".pb")
+
+
+def start(capacity=DEFAULT_CAPACITY):
+    """Start recording, keeping the last ``capacity`` events per thread; earlier events are dropped."""
+    if capacity < 1:
+        raise ValueError("capacity must be at least 1")
+    _trace_start(capacity)
+
+
+def instant(name, detail="", category="python"):
+    """Record an instant event of your own (no-op while not tracing)."""
+    _trace_instant(name, category, detail)
+
+
+def events(clear=True):
+    """
+    Recorded events, oldest first, as dicts with name, cat, ph ('X' span,
+    'i' instant, 'C' counter), ts and dur (nanoseconds), value, tid and
+    detail. ``clear`` drops them from the rings.
+    """
+    keys = ("name", "cat", "ph", "ts", "dur", "value", "tid", "detail")
+    return sorted((dict(zip(keys, event)) for event in _trace_events(clear)), key=lambda event: event["ts"])
+
+
+# =============================================================================
+# Chrome trace JSON
+# =============================================================================
+
+
+def chrome_trace(recorded):
+    """The Chrome trace event format (a dict ready for json.dump) of ``events()``."""
+    pid = os.getpid()
+    trace_events = []
+    for event in recorded:
+        entry = {"name": event["name"], "cat": event["cat"], "ph": event["ph"], "ts": event["ts"] / 1000, "pid": pid, "tid": event["tid"]}
+        if event["ph"] == "X":
+            entry["dur"] = event["dur"] / 1000
+        elif event["ph"] == "i":
+            entry["s"] = "t"
+        if event["ph"] == "C":
+            entry["args"] = {"live": event["value"]}
+        elif event["detail"]:
+            entry["args"] = {"detail": event["detail"]}
+        trace_events.append(entry)
+    return {"traceEvents": trace_events, "displayTimeUnit": "ns"}
+
+
+# =============================================================================
+# Perfetto protobuf
+# =============================================================================
+# Hand-encoded perfetto.protos.Trace: one TrackDescriptor packet per thread
+# and counter track, then TrackEvent packets. Field numbers are from
+# protos/perfetto/trace/{trace_packet,track_event/track_event,
+# track_event/track_descriptor,track_event/debug_annotation}.proto.
+
+_SEQUENCE_ID = 1
+_CLOCK_MONOTONIC = 3
+_SLICE_BEGIN, _SLICE_END, _INSTANT, _COUNTER = 1, 2, 3, 4
+
+
+def _varint(value):
+    value &= 0xFFFFFFFFFFFFFFFF  # Negative int64s as two's complement
+    out = bytearray()
+    while value > 0x7F:
+        out.append(value & 0x7F | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+def _field(number, value):
+    """One field: ints as varints, str/bytes length-delimited."""
+    if isinstance(value, int):
+        return _varint(number << 3) + _varint(value)
+    if isinstance(value, str):
+        value = value.encode()
+    return _varint(number << 3 | 2) + _varint(len(value)) + value
+
+
+def _packet(*fields):
+    """A Trace.packet field holding a TracePacket on our sequence."""
+    return _field(1, b"".join(fields) + _field(10, _SEQUENCE_ID))
+
+
+def _track_event(ts, kind, track, name=None, category=None, detail=None, value=None):
+    fields = [_field(9, kind), _field(11, track)]
+    if name is not None:
+        fields.append(_field(23, name))
+    if category is not None:
+        fields.append(_field(22, category))
+    if detail:
+        fields.append(_field(4, _field(10, "detail") + _field(6, detail)))
+    if value is not None:
+        fields.append(_field(30, value))
+    return ts, _packet(_field(8, ts), _field(58, _CLOCK_MONOTONIC), _field(11, b"".join(fields)))
+
+
+def perfetto_trace(recorded):
+    """A serialized perfetto.protos.Trace of ``events()``."""
+    pid = os.getpid()
+    uuids = itertools.count(1)
+    process = next(uuids)
+    # Incremental state cleared: trace_processor accepts the sequence from its first packet
+    descriptors = [_field(1, _field(60, _field(1, process) + _field(3, _field(1, pid))) + _field(13, 1) + _field(10, _SEQUENCE_ID))]
+    threads, counters = {}, {}
+    timeline = []  # (sort key, packet)
+    for event in recorded:
+        if event["ph"] == "C":
+            track = counters.get(event["name"])
+            if track is None:
+                track = counters[event["name"]] = next(uuids)
+                descriptors.append(_packet(_field(60, _field(1, track) + _field(5, process) + _field(2, event["name"]) + _field(8, b""))))
+            ts, packet = _track_event(event["ts"], _COUNTER, track, value=event["value"])
+            timeline.append(((ts, 2, 0), packet))
+            continue
+        track = threads.get(event["tid"])
+        if track is None:
+            track = threads[event["tid"]] = next(uuids)
+            thread = _field(1, pid) + _field(2, event["tid"])
+            descriptors.append(_packet(_field(60, _field(1, track) + _field(5, process) + _field(4, thread))))
+        if event["ph"] == "X":
+            # Spans on a track must nest: at equal times ends go first (inner first), then outer begins
+            begin, end = event["ts"], event["ts"] + event["dur"]
+            timeline.append(((begin, 1, -event["dur"]), _track_event(begin, _SLICE_BEGIN, track, event["name"], event["cat"], event["detail"])[1]))
+            timeline.append(((end, 0, -begin), _track_event(end, _SLICE_END, track)[1]))
+        else:
+            ts, packet = _track_event(event["ts"], _INSTANT, track, event["name"], event["cat"], event["detail"])
+            timeline.append(((ts, 2, 0), packet))
+    timeline.sort(key=lambda item: item[0])
+    return b"".join(descriptors) + b"".join(packet for _key, packet in timeline)
+
+
+def dump(path, format=None, clear=True):
+    """
+    Write the recorded events to ``path`` as ``format`` "chrome" (JSON) or
+    "perfetto" (protobuf); by default Perfetto for .pftrace / .perfetto-trace
+    / .pb paths and Chrome JSON otherwise. Returns the number of events.
+    """
+    if format is None:
+        format = "perfetto" if path.endswith(PERFETTO_SUFFIXES) else "chrome"
+    if format not in ("chrome", "perfetto"):
+        raise ValueError(f"format must be 'chrome' or 'perfetto', not {format!r}")
+    recorded = events(clear)
+    if format == "perfetto":
+        with open(path, "wb") as out:
+            out.write(perfetto_trace(recorded))
+    else:
+        with open(path, "w") as out:
+            json.dump(chrome_trace(recorded), out)
+    return len(recorded)
+
+
+_exit_path = None  # Where JUSTJIT_TRACE writes this process's trace
+
+
+def _dump_at_exit():
+    dump(_exit_path)
+
+
+def _after_fork_in_child():
+    # The child's rings start empty; keep its trace from overwriting the parent's
+    global _exit_path
+    root, ext = os.path.splitext(os.environ["JUSTJIT_TRACE"])
+    _exit_path = f"{root}.{os.getpid()}{ext}"
+
+
+def _from_environment():
+    global _exit_path
+    path = os.environ.get("JUSTJIT_TRACE")
+    if not path:
+        return
+    start()
+    _exit_path = path
+    atexit.register(_dump_at_exit)
+    if hasattr(os, "register_at_fork"):
+        os.register_at_fork(after_in_child=_after_fork_in_child)
+
+
+_from_environment()
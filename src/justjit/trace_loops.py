@@ -0,0 +1,579 @@
+"""
+A trace-recording tier for hot loops that work through calls (jit(trace_loops=True)).
+
+Compiling one function at a time stops at every call. A loop that advances
+a list of objects through small methods compiles to a loop of calls, each
+building a frame and looking the method up on the receiver again. The
+tracing tier runs the function in the interpreter first and watches it
+through ``sys.monitoring``. Once a loop header has taken ``trace_threshold``
+backward jumps, the loop's next iterations are recorded: each call it makes,
+the function called, the receiver's type, and the calls those functions
+make in turn, three levels deep. The function is then rewritten along the
+recorded path and compiled as one function:
+
+    for p in particles:                   for p in particles:
+        total += p.step(dt)                   __justjit_trace0_self = p
+                                              __justjit_trace0_arg0 = dt
+                                              if type(...) is Particle and Particle.step is <step>:
+                                                  <step's body, its locals renamed>
+                                              else:
+                                                  __justjit_trace0_result = __justjit_trace0_self.step(...)
+                                              total += __justjit_trace0_result
+
+Each inlined call is guarded on what the recording saw. A method call
+checks the receiver's type and the class attribute, and a plain call checks
+the function object. A polymorphic site, one that saw several receiver
+types, gets one guarded copy per type, most frequent first, up to four. A
+failed guard is a side exit for that call only. The else branch makes the
+original call, which runs the callee's own @jit code or the interpreter,
+and the loop goes on in the trace. The rewrite is compiled by jit() with
+the same options. Object mode lowers the guards and inlined bodies like any
+other code, and with regions=True the numeric loops the inlining exposes
+become native regions.
+
+A call is inlined when it is a statement of its own, or the whole value of
+an assignment, an augmented assignment to a local, or a return. The callee
+must be a plain Python function or @jit function of the same module without
+closures, ``*args``, ``**kwargs``, keyword-only parameters, ``yield``, nested
+functions, imports, ``global`` or a ``return`` inside a loop. An instance
+attribute that shadows the method of its class is not checked by the guard.
+"""
+
+import ast
+import collections
+import copy
+import dis
+import functools
+import inspect
+import sys
+import textwrap
+import threading
+import types
+import warnings
+
+from .regions import _closure_function
+
+# Iterations of the hot loop recorded once it is hot
+_RECORD_ITERATIONS = 64
+# Calls run interpreted while waiting for a hot loop, before tracing gives up
+_RECORD_CALLS = 20
+# Levels of calls recorded and inlined below the traced function
+_MAX_DEPTH = 3
+# Guarded targets inlined at one call site
+_MAX_TARGETS = 4
+# Builtins that see the caller's frame, so an inlined body may not use them
+_FRAME_NAMES = frozenset(("locals", "vars", "dir", "eval", "exec", "super"))
+# Nodes an inlined body may not contain
+_UNINLINABLE = (
+    ast.Global, ast.Nonlocal, ast.Lambda, ast.FunctionDef, ast.AsyncFunctionDef, ast.ClassDef,
+    ast.Yield, ast.YieldFrom, ast.Await, ast.Import, ast.ImportFrom, ast.Match,
+)
+
+_PREFIX = "__justjit_trace"
+
+_tool = None
+_tool_lock = threading.Lock()
+_recorders = {}  # code object -> the _Recorder recording its calls
+
+
+def _claim_tool():
+    """The sys.monitoring tool id of the tracing tier, or None if ids 3 and 4 are both taken."""
+    global _tool
+    with _tool_lock:
+        if _tool is None:
+            monitoring = sys.monitoring
+            for tool in (4, 3):
+                if monitoring.get_tool(tool) is None:
+                    monitoring.use_tool_id(tool, "justjit-trace")
+                    monitoring.register_callback(tool, monitoring.events.JUMP, _on_jump)
+                    monitoring.register_callback(tool, monitoring.events.CALL, _on_call)
+                    _tool = tool
+                    break
+        return _tool
+
+
+def _on_jump(code, instruction_offset, destination_offset):
+    recorder = _recorders.get(code)
+    if recorder is not None and code is recorder.code and destination_offset < instruction_offset:
+        recorder.jump(destination_offset)
+
+
+def _on_call(code, instruction_offset, callee, arg0):
+    recorder = _recorders.get(code)
+    if recorder is not None and recorder.recording:
+        recorder.call(code, instruction_offset, callee, arg0)
+
+
+def _python_function(callee):
+    """The plain function ``callee`` runs: itself, or the source function of a @jit wrapper; else None."""
+    if not isinstance(callee, types.FunctionType):
+        callee = getattr(callee, "_jit_source", None)
+    return callee if isinstance(callee, types.FunctionType) else None
+
+
+class _Recorder:
+    """Counts a function's backward jumps, then records the calls of its first hot loop."""
+
+    def __init__(self, code, threshold):
+        self.code = code
+        self.threshold = threshold
+        # (header, last offset) of every loop; a continue adds a second jump to the same header
+        self.loops = [
+            (instr.argval, instr.offset)
+            for instr in dis.get_instructions(code)
+            if instr.opname in ("JUMP_BACKWARD", "JUMP_BACKWARD_NO_INTERRUPT")
+        ]
+        self.jumps = collections.Counter()
+        self.header = None
+        self.end = None
+        self.recording = False
+        self.done = False
+        self.iterations = 0
+        self.sites = collections.defaultdict(collections.Counter)  # (code, offset) -> Counter of targets
+        self.depths = {code: 0}
+
+    def start(self):
+        if self.code in _recorders:
+            return False  # Already recorded as another trace's callee
+        _recorders[self.code] = self
+        sys.monitoring.set_local_events(_tool, self.code, sys.monitoring.events.JUMP)
+        return True
+
+    def jump(self, header):
+        if self.header is None:
+            self.jumps[header] += 1
+            if self.jumps[header] >= self.threshold:
+                self.header = header
+                self.end = max(end for start, end in self.loops if start == header)
+                self.recording = True
+                events = sys.monitoring.events
+                sys.monitoring.set_local_events(_tool, self.code, events.JUMP | events.CALL)
+        elif header == self.header:
+            self.iterations += 1
+            if self.iterations >= _RECORD_ITERATIONS:
+                self.stop()
+
+    def call(self, code, offset, callee, arg0):
+        if code is self.code and not self.header <= offset <= self.end:
+            return
+        # A bound method names its function and receiver; a method-form call passes self as arg0
+        if isinstance(callee, types.MethodType):
+            key = ("method", callee.__func__, type(callee.__self__))
+        else:
+            key = ("call", callee, type(arg0))
+        try:
+            self.sites[code, offset][key] += 1
+        except TypeError:
+            return  # An unhashable callable is never inlined
+        target = _python_function(key[1])
+        depth = self.depths[code] + 1
+        if target is not None and depth < _MAX_DEPTH and target.__code__ not in _recorders:
+            _recorders[target.__code__] = self
+            self.depths[target.__code__] = depth
+            sys.monitoring.set_local_events(_tool, target.__code__, sys.monitoring.events.CALL)
+
+    def stop(self):
+        """Stop recording and remove every event this recorder set."""
+        if self.done:
+            return
+        self.done = True
+        self.recording = False
+        for code, recorder in list(_recorders.items()):
+            if recorder is self:
+                del _recorders[code]
+                sys.monitoring.set_local_events(_tool, code, 0)
+
+
+class TracingFunction:
+    """
+    A jit(trace_loops=True) function. Calls run interpreted while the
+    recorder waits for a hot loop, then go to the compiled trace, or to the
+    method-at-a-time compile when there was nothing to trace.
+    """
+
+    _active = None  # The compiled callable once decided
+    _method = None
+
+    @classmethod
+    def create(cls, func, options, threshold):
+        """A tracing wrapper for ``func``, or None when it has no loop the tier can trace."""
+        code = func.__code__
+        if not hasattr(sys, "monitoring") or code.co_freevars or code.co_cellvars or _parse(func) is None:
+            return None
+        if not any(instr.opname.startswith("JUMP_BACKWARD") for instr in dis.get_instructions(code)):
+            return None
+        if _claim_tool() is None:
+            warnings.warn(
+                f"Function '{func.__name__}': sys.monitoring tool ids 3 and 4 are in use; trace_loops has no effect.",
+                RuntimeWarning,
+                stacklevel=4,
+            )
+            return None
+        tracer = cls(func, options, threshold)
+        return tracer if tracer._recorder.start() else None
+
+    def __init__(self, func, options, threshold):
+        self._func = func
+        self._options = options
+        self._recorder = _Recorder(func.__code__, threshold)
+        self._calls = 0
+        self._lock = threading.RLock()
+        self._original_func = func
+        self._jit_source = func
+        self.trace_sites = []  # (line, (qualname of each inlined target, ...)) per inlined call site
+        functools.update_wrapper(self, func)
+
+    def __call__(self, *args, **kwargs):
+        active = self._active
+        if active is None:
+            active = self._tier_up()
+            if active is None:
+                return self._func(*args, **kwargs)
+        return active(*args, **kwargs)
+
+    def __get__(self, obj, objtype=None):
+        return self if obj is None else types.MethodType(self, obj)
+
+    def __getattr__(self, name):
+        # JIT attributes (_jit_instance, _mode, ...) come from the code calls run now
+        if name.startswith("__"):
+            raise AttributeError(name)
+        active = self._active
+        return getattr(active if active is not None else self._method_jit(), name)
+
+    def __repr__(self):
+        return f"<justjit.TracingFunction {self.__qualname__}>"
+
+    def _method_jit(self):
+        from . import jit
+
+        with self._lock:
+            if self._method is None:
+                self._method = jit(self._func, **self._options)
+            return self._method
+
+    def _tier_up(self):
+        """The compiled callable once recording is over, else None (run this call interpreted)."""
+        recorder = self._recorder
+        if not recorder.done:
+            self._calls += 1
+            if self._calls <= _RECORD_CALLS:
+                return None
+            recorder.stop()
+        from . import jit, _record_rejection
+
+        with self._lock:
+            if self._active is None:
+                traced = None
+                if recorder.header is None:
+                    _record_rejection(self._func, "trace", "no loop got hot while recording")
+                else:
+                    traced, self.trace_sites = build_trace(self._func, recorder.sites)
+                    if traced is None:
+                        _record_rejection(self._func, "trace", "no call in the hot loop could be inlined")
+                recorder.sites.clear()
+                self._active = self._method_jit() if traced is None else jit(traced, **self._options)
+            return self._active
+
+
+# =============================================================================
+# Building the trace
+# =============================================================================
+
+
+def _parse(func):
+    """``(FunctionDef, column shift)`` of ``func``'s source, or None without usable source."""
+    try:
+        lines, _ = inspect.getsourcelines(func)
+        source = textwrap.dedent("".join(lines))
+        tree = ast.parse(source)
+    except (OSError, TypeError, SyntaxError):
+        return None
+    func_def = tree.body[0] if tree.body else None
+    if not isinstance(func_def, ast.FunctionDef) or func_def.name != func.__code__.co_name:
+        return None
+    ast.increment_lineno(tree, func.__code__.co_firstlineno - 1)
+    return func_def, len(lines[0]) - len(source.splitlines(True)[0])
+
+
+def build_trace(func, sites):
+    """
+    ``func`` rewritten with the calls recorded in ``sites`` inlined behind
+    guards, and the inlined sites as ``[(line, (target qualname, ...))]``.
+    The function is None when no recorded call could be inlined.
+    """
+    parsed = _parse(func)
+    if parsed is None:
+        return None, []
+    func_def, shift = parsed
+    inliner = _Inliner(func, sites)
+    func_def.body = inliner.rewrite(func, func_def.body, shift, 0, frozenset((func,)), frozenset(func.__code__.co_varnames))
+    if not inliner.inlined:
+        return None, []
+    names = [name for name, _obj in inliner.refs.values()]
+    values = [obj for _name, obj in inliner.refs.values()]
+    return _closure_function(func, func_def, "__justjit_trace", names, values), inliner.inlined
+
+
+class _Inliner:
+    """Inlines the recorded call sites of a function and of the functions inlined into it."""
+
+    def __init__(self, func, sites):
+        self.globals = func.__globals__
+        self.sites = sites
+        self.refs = {}  # id(object) -> (free variable name, object)
+        self.count = 0
+        self.trees = {}
+        self.inlined = []
+
+    def ref(self, obj):
+        """A load of ``obj``, passed to the rewrite as a free variable."""
+        entry = self.refs.get(id(obj))
+        if entry is None:
+            entry = self.refs[id(obj)] = (f"{_PREFIX}_ref{len(self.refs)}", obj)
+        return ast.Name(entry[0], ast.Load())
+
+    def fresh(self):
+        self.count += 1
+        return f"{_PREFIX}{self.count - 1}_"
+
+    def rewrite(self, func, body, shift, depth, chain, scope):
+        """``body``, statements of ``func``, with its recorded call sites inlined."""
+        by_end = {}
+        positions = list(func.__code__.co_positions())
+        for (code, offset), targets in self.sites.items():
+            if code is func.__code__ and offset // 2 < len(positions):
+                _line, end_line, _col, end_col = positions[offset // 2]
+                # The end of a call is its closing parenthesis, wherever a method chain starts it
+                by_end.setdefault((end_line, end_col), collections.Counter()).update(targets)
+        calls = {}
+        for node in (node for statement in body for node in ast.walk(statement)):
+            if isinstance(node, ast.Call):
+                targets = by_end.get((node.end_lineno, node.end_col_offset + shift))
+                if targets:
+                    calls[id(node)] = targets
+        if not calls:
+            return body
+        rewriter = _SiteRewriter(self, calls, depth, chain, scope)
+        return [result for statement in body for result in _as_list(rewriter.visit(statement))]
+
+    def site(self, call, targets, depth, chain, scope):
+        """``(statements computing the call into a local, that local)``, or None to keep the call."""
+        if any(isinstance(arg, ast.Starred) for arg in call.args) or any(keyword.arg is None for keyword in call.keywords):
+            return None
+        method = isinstance(call.func, ast.Attribute)
+        prefix = self.fresh()
+        receiver = prefix + "self"
+        callee_name = prefix + "callee"
+        args = [prefix + f"arg{i}" for i in range(len(call.args))]
+        keywords = [(keyword.arg, prefix + "kw_" + keyword.arg) for keyword in call.keywords]
+        result = prefix + "result"
+
+        branches, names = [], []
+        for (kind, callee, arg_type), _count in targets.most_common():
+            if len(branches) == _MAX_TARGETS:
+                break
+            if method:
+                # obj.m(...): the recorded function must be the class attribute found on obj's type
+                if _class_attribute(arg_type, call.func.attr) is not callee:
+                    continue
+                guard = ast.BoolOp(ast.And(), [
+                    ast.Compare(ast.Call(self.ref(type), [ast.Name(receiver, ast.Load())], []), [ast.Is()], [self.ref(arg_type)]),
+                    ast.Compare(ast.Attribute(self.ref(arg_type), call.func.attr, ast.Load()), [ast.Is()], [self.ref(callee)]),
+                ])
+                positional = [receiver] + args
+            elif kind == "call":
+                guard = ast.Compare(ast.Name(callee_name, ast.Load()), [ast.Is()], [self.ref(callee)])
+                positional = args
+            else:
+                continue
+            target = _python_function(callee)
+            if target is None or target in chain:
+                continue
+            body = self.inline(target, positional, keywords, result, depth, chain, scope)
+            if body is None:
+                continue
+            branches.append((guard, body))
+            names.append(target.__qualname__)
+        if not branches:
+            return None
+
+        statements = []
+        if method:
+            statements.append(_assign(receiver, call.func.value))
+        else:
+            statements.append(_assign(callee_name, call.func))
+        statements += [_assign(name, arg) for name, arg in zip(args, call.args)]
+        statements += [_assign(name, keyword.value) for (_key, name), keyword in zip(keywords, call.keywords)]
+        exit_callee = ast.Attribute(ast.Name(receiver, ast.Load()), call.func.attr, ast.Load()) if method else ast.Name(callee_name, ast.Load())
+        exit_call = ast.Call(
+            exit_callee,
+            [ast.Name(name, ast.Load()) for name in args],
+            [ast.keyword(key, ast.Name(name, ast.Load())) for key, name in keywords],
+        )
+        chain_if = [_assign(result, exit_call)]  # The side exit: the call as written
+        for guard, body in reversed(branches):
+            chain_if = [ast.If(guard, body, chain_if)]
+        statements += chain_if
+        if depth == 0:
+            self.inlined.append((call.lineno, tuple(names)))
+        return statements, result
+
+    def inline(self, target, positional, keywords, result, depth, chain, scope):
+        """``target``'s body with its parameters bound to the given locals, storing its result, or None."""
+        code = target.__code__
+        if (
+            target.__globals__ is not self.globals
+            or code.co_freevars or code.co_cellvars or code.co_kwonlyargcount
+            or code.co_flags & (inspect.CO_VARARGS | inspect.CO_VARKEYWORDS | inspect.CO_GENERATOR
+                                | inspect.CO_COROUTINE | inspect.CO_ASYNC_GENERATOR)
+        ):
+            return None
+        if target not in self.trees:
+            self.trees[target] = _parse(target)
+        parsed = self.trees[target]
+        if parsed is None:
+            return None
+        func_def, shift = parsed
+        params = code.co_varnames[: code.co_argcount]
+        if len(positional) > len(params):
+            return None
+        bound = dict(zip(params, positional))
+        for key, name in keywords:
+            if key not in params or key in bound:
+                return None
+            bound[key] = name
+        defaults = target.__defaults__ or ()
+        first_default = len(params) - len(defaults)
+        values = []
+        for index, param in enumerate(params):
+            if param in bound:
+                values.append(ast.Name(bound[param], ast.Load()))
+            elif index >= first_default:
+                values.append(self.ref(defaults[index - first_default]))
+            else:
+                return None
+
+        body = copy.deepcopy(func_def.body)
+        if body and isinstance(body[0], ast.Expr) and isinstance(body[0].value, ast.Constant) and isinstance(body[0].value.value, str):
+            body = body[1:]  # Docstring
+        local_names = set(code.co_varnames)
+        nodes = [node for statement in body for node in ast.walk(statement)]
+        free = {node.id for node in nodes if isinstance(node, ast.Name) and node.id not in local_names}
+        if any(isinstance(node, _UNINLINABLE) for node in nodes) or free & (scope | _FRAME_NAMES):
+            return None  # A global the caller's locals would hide, or code that needs a frame of its own
+        if any(_returns_in_loops(statement) for statement in body):
+            return None
+        returns = [node for node in nodes if isinstance(node, ast.Return)]
+
+        body = self.rewrite(target, body, shift, depth + 1, chain | {target}, scope | local_names)
+        prefix = self.fresh()
+        renamer = _Rename(local_names, prefix)
+        body = [renamer.visit(statement) for statement in body]
+        params_bound = [_assign(prefix + param, value) for param, value in zip(params, values)]
+
+        none = ast.Constant(None)
+        if not returns:
+            body.append(_assign(result, none))
+        elif len(returns) == 1 and isinstance(body[-1], ast.Return):
+            body[-1] = ast.copy_location(_assign(result, body[-1].value or none), body[-1])
+        else:
+            # An early return leaves a loop that runs once
+            falls_through = not isinstance(body[-1], ast.Return)
+            breaker = _ReturnToBreak(result)
+            body = [node for statement in body for node in _as_list(breaker.visit(statement))]
+            if falls_through:
+                body += [_assign(result, none), ast.Break()]
+            body = [ast.While(ast.Constant(True), body, [])]
+        return params_bound + body
+
+
+def _class_attribute(owner, name):
+    """``name`` as found on ``owner``'s MRO, without binding it; None when absent."""
+    if not isinstance(owner, type):
+        return None
+    for klass in owner.__mro__:
+        if name in vars(klass):
+            return vars(klass)[name]
+    return None
+
+
+def _returns_in_loops(node, in_loop=False):
+    if isinstance(node, ast.Return):
+        return in_loop
+    in_loop = in_loop or isinstance(node, (ast.For, ast.While, ast.AsyncFor))
+    return any(_returns_in_loops(child, in_loop) for child in ast.iter_child_nodes(node))
+
+
+def _assign(name, value):
+    return ast.Assign([ast.Name(name, ast.Store())], value)
+
+
+def _as_list(result):
+    return result if isinstance(result, list) else [result]
+
+
+class _SiteRewriter(ast.NodeTransformer):
+    """Replace each statement whose value is a recorded call with that call inlined."""
+
+    def __init__(self, inliner, calls, depth, chain, scope):
+        self.inliner = inliner
+        self.calls = calls
+        self.depth = depth
+        self.chain = chain
+        self.scope = scope
+
+    def inline(self, statement, call, rebuild):
+        if not isinstance(call, ast.Call) or id(call) not in self.calls:
+            return self.generic_visit(statement)
+        inlined = self.inliner.site(call, self.calls[id(call)], self.depth, self.chain, self.scope)
+        if inlined is None:
+            return self.generic_visit(statement)
+        statements, result = inlined
+        value = ast.Name(result, ast.Load())
+        tail = rebuild(value)
+        return [ast.copy_location(node, statement) for node in statements] + ([ast.copy_location(tail, statement)] if tail else [])
+
+    def visit_Expr(self, node):
+        return self.inline(node, node.value, lambda value: None)
+
+    def visit_Assign(self, node):
+        return self.inline(node, node.value, lambda value: ast.Assign(node.targets, value))
+
+    def visit_AugAssign(self, node):
+        # The target is read before the call, so only a local (which the callee cannot change) qualifies
+        if not isinstance(node.target, ast.Name):
+            return self.generic_visit(node)
+        return self.inline(node, node.value, lambda value: ast.AugAssign(node.target, node.op, value))
+
+    def visit_Return(self, node):
+        return self.inline(node, node.value, lambda value: ast.Return(value))
+
+
+class _Rename(ast.NodeTransformer):
+    """Prefix the locals of an inlined body."""
+
+    def __init__(self, names, prefix):
+        self.names = names
+        self.prefix = prefix
+
+    def visit_Name(self, node):
+        if node.id in self.names:
+            node.id = self.prefix + node.id
+        return node
+
+    def visit_ExceptHandler(self, node):
+        if node.name in self.names:
+            node.name = self.prefix + node.name
+        return self.generic_visit(node)
+
+
+class _ReturnToBreak(ast.NodeTransformer):
+    """``return value`` as ``result = value; break`` inside the loop wrapping an inlined body."""
+
+    def __init__(self, result):
+        self.result = result
+
+    def visit_Return(self, node):
+        store = _assign(self.result, node.value or ast.Constant(None))
+        return [ast.copy_location(store, node), ast.copy_location(ast.Break(), node)]
@@ -0,0 +1,992 @@
+"""
+Realistic workloads for justjit.bench.
+
+The toy cases in justjit.bench time one construct per mode. The workloads
+here are whole programs the way users write them: a pyperformance subset
+(nbody, spectral_norm, richards, chaos, go and raytrace, each condensed but
+keeping its data structures and call graph), NumPy-style array kernels in
+native mode, a generator pipeline, an async fan-out and inline C numeric
+code. Every function and class of a workload is compiled, so a regression
+in any part of the JIT (object mode, methods, generators, coroutines,
+native arrays, inline C) shows up in one of them:
+
+    python -m justjit.bench --corpus workloads
+
+Each workload returns a checksum, so the JIT and CPython runs can be
+compared for correctness as well as speed.
+"""
+
+import array
+import asyncio
+import math
+import types
+
+import justjit
+from justjit.bench import Case
+
+
+def _rebind(func, namespace):
+    """A copy of ``func`` whose globals are ``namespace``."""
+    copy = types.FunctionType(func.__code__, namespace, func.__name__, func.__defaults__, func.__closure__)
+    copy.__kwdefaults__ = func.__kwdefaults__
+    copy.__qualname__ = func.__qualname__
+    return copy
+
+
+def _jit_build(*members, **options):
+    """
+    build() for a workload spread over several functions and classes. Each
+    call copies the members into a private copy of this module's globals
+    with @jit applied to every function and method, so the members call each
+    other's compiled versions while the CPython baseline keeps the plain
+    ones. The last member is the entry point.
+    """
+
+    def build(_func):
+        namespace = dict(globals())
+        for member in members:
+            if isinstance(member, type):
+                body = {}
+                for name, value in vars(member).items():
+                    if name in ("__dict__", "__weakref__"):
+                        continue
+                    if isinstance(value, types.FunctionType):
+                        value = justjit.jit(_rebind(value, namespace), **options)
+                    body[name] = value
+                bases = tuple(namespace[base.__name__] if base in members else base for base in member.__bases__)
+                namespace[member.__name__] = type(member.__name__, bases, body)
+            else:
+                namespace[member.__name__] = justjit.jit(_rebind(member, namespace), **options)
+        return namespace[members[-1].__name__]
+
+    return build
+
+
+class Lcg:
+    """Deterministic pseudo-random ints, so every run plays the same game."""
+
+    def __init__(self, seed):
+        self.state = seed
+
+    def below(self, n):
+        self.state = (self.state * 1103515245 + 12345) & 0x7FFFFFFF
+        return self.state % n
+
+
+# =============================================================================
+# nbody: planets under gravity (floats in lists, nested loops)
+# =============================================================================
+
+SOLAR_MASS = 4 * math.pi * math.pi
+DAYS_PER_YEAR = 365.24
+
+
+def nbody_system():
+    """Sun, Jupiter, Saturn, Uranus and Neptune as ([x, y, z], [vx, vy, vz], mass)."""
+    planets = [
+        ((4.84143144246472090e00, -1.16032004402742839e00, -1.03622044471123109e-01),
+         (1.66007664274403694e-03, 7.69901118419740425e-03, -6.90460016972063023e-05), 9.54791938424326609e-04),
+        ((8.34336671824457987e00, 4.12479856412430479e00, -4.03523417114321381e-01),
+         (-2.76742510726862411e-03, 4.99852801234917238e-03, 2.30417297573763929e-05), 2.85885980666130812e-04),
+        ((1.28943695621391310e01, -1.51111514016986312e01, -2.23307578892655734e-01),
+         (2.96460137564761618e-03, 2.37847173959480950e-03, -2.96589568540237556e-05), 4.36624404335156298e-05),
+        ((1.53796971148509165e01, -2.59193146099879641e01, 1.79258772950371181e-01),
+         (2.68067772490389322e-03, 1.62824170038242295e-03, -9.51592254519715870e-05), 5.15138902046611451e-05),
+    ]
+    bodies = [([0.0, 0.0, 0.0], [0.0, 0.0, 0.0], SOLAR_MASS)]
+    for position, velocity, mass in planets:
+        bodies.append((list(position), [v * DAYS_PER_YEAR for v in velocity], mass * SOLAR_MASS))
+    return bodies
+
+
+def nbody_pairs(bodies):
+    pairs = []
+    for i in range(len(bodies) - 1):
+        for j in range(i + 1, len(bodies)):
+            pairs.append((bodies[i], bodies[j]))
+    return pairs
+
+
+def nbody_offset_momentum(bodies):
+    px = py = pz = 0.0
+    for _position, (vx, vy, vz), mass in bodies:
+        px -= vx * mass
+        py -= vy * mass
+        pz -= vz * mass
+    _position, velocity, mass = bodies[0]
+    velocity[0] = px / mass
+    velocity[1] = py / mass
+    velocity[2] = pz / mass
+
+
+def nbody_advance(dt, steps, bodies, pairs):
+    for _ in range(steps):
+        for ([x1, y1, z1], v1, m1), ([x2, y2, z2], v2, m2) in pairs:
+            dx = x1 - x2
+            dy = y1 - y2
+            dz = z1 - z2
+            mag = dt * ((dx * dx + dy * dy + dz * dz) ** -1.5)
+            b1 = m1 * mag
+            b2 = m2 * mag
+            v1[0] -= dx * b2
+            v1[1] -= dy * b2
+            v1[2] -= dz * b2
+            v2[0] += dx * b1
+            v2[1] += dy * b1
+            v2[2] += dz * b1
+        for position, (vx, vy, vz), _mass in bodies:
+            position[0] += dt * vx
+            position[1] += dt * vy
+            position[2] += dt * vz
+
+
+def nbody_energy(bodies, pairs):
+    e = 0.0
+    for ((x1, y1, z1), _v1, m1), ((x2, y2, z2), _v2, m2) in pairs:
+        dx = x1 - x2
+        dy = y1 - y2
+        dz = z1 - z2
+        e -= (m1 * m2) / ((dx * dx + dy * dy + dz * dz) ** 0.5)
+    for _position, (vx, vy, vz), mass in bodies:
+        e += mass * (vx * vx + vy * vy + vz * vz) / 2.0
+    return e
+
+
+def nbody(steps):
+    bodies = nbody_system()
+    pairs = nbody_pairs(bodies)
+    nbody_offset_momentum(bodies)
+    nbody_advance(0.01, steps, bodies, pairs)
+    return nbody_energy(bodies, pairs)
+
+
+# =============================================================================
+# spectral_norm: power iteration on an implicit matrix (int and float calls)
+# =============================================================================
+
+
+def spectral_eval_a(i, j):
+    return 1.0 / ((i + j) * (i + j + 1) // 2 + i + 1)
+
+
+def spectral_times_u(u):
+    n = len(u)
+    result = []
+    for i in range(n):
+        total = 0.0
+        for j in range(n):
+            total += spectral_eval_a(i, j) * u[j]
+        result.append(total)
+    return result
+
+
+def spectral_times_transposed_u(u):
+    n = len(u)
+    result = []
+    for i in range(n):
+        total = 0.0
+        for j in range(n):
+            total += spectral_eval_a(j, i) * u[j]
+        result.append(total)
+    return result
+
+
+def spectral_norm(n):
+    u = [1.0] * n
+    v = u
+    for _ in range(10):
+        v = spectral_times_transposed_u(spectral_times_u(u))
+        u = spectral_times_transposed_u(spectral_times_u(v))
+    vbv = vv = 0.0
+    for ue, ve in zip(u, v):
+        vbv += ue * ve
+        vv += ve * ve
+    return math.sqrt(vbv / vv)
+
+
+# =============================================================================
+# richards: the Richards OS task scheduler (classes, attributes, dispatch)
+# =============================================================================
+
+I_IDLE = 1
+I_WORK = 2
+I_HANDLERA = 3
+I_HANDLERB = 4
+I_DEVA = 5
+I_DEVB = 6
+
+K_DEV = 1000
+K_WORK = 1001
+
+BUFSIZE = 4
+
+
+class Packet:
+    def __init__(self, link, ident, kind):
+        self.link = link
+        self.ident = ident
+        self.kind = kind
+        self.datum = 0
+        self.data = [0] * BUFSIZE
+
+    def append_to(self, queue):
+        self.link = None
+        if queue is None:
+            return self
+        p = queue
+        while p.link is not None:
+            p = p.link
+        p.link = self
+        return queue
+
+
+class DeviceTaskRec:
+    def __init__(self):
+        self.pending = None
+
+
+class IdleTaskRec:
+    def __init__(self):
+        self.control = 1
+        self.count = 10000
+
+
+class HandlerTaskRec:
+    def __init__(self):
+        self.work_in = None
+        self.device_in = None
+
+
+class WorkerTaskRec:
+    def __init__(self):
+        self.destination = I_HANDLERA
+        self.count = 0
+
+
+class TaskWorkArea:
+    def __init__(self):
+        self.task_tab = [None] * 10
+        self.task_list = None
+        self.hold_count = 0
+        self.qpkt_count = 0
+
+
+class Task:
+    def __init__(self, area, ident, priority, queue, waiting, record):
+        self.area = area
+        self.link = area.task_list
+        self.ident = ident
+        self.priority = priority
+        self.input = queue
+        self.packet_pending = queue is not None
+        self.task_waiting = waiting
+        self.task_holding = False
+        self.record = record
+        area.task_list = self
+        area.task_tab[ident] = self
+
+    def holding_or_waiting(self):
+        return self.task_holding or (not self.packet_pending and self.task_waiting)
+
+    def add_packet(self, packet, old):
+        if self.input is None:
+            self.input = packet
+            self.packet_pending = True
+            if self.priority > old.priority:
+                return self
+        else:
+            packet.append_to(self.input)
+        return old
+
+    def run_task(self):
+        if self.packet_pending and self.task_waiting and not self.task_holding:
+            message = self.input
+            self.input = message.link
+            self.task_waiting = False
+            self.packet_pending = self.input is not None
+        else:
+            message = None
+        return self.fn(message, self.record)
+
+    def wait_task(self):
+        self.task_waiting = True
+        return self
+
+    def hold(self):
+        self.area.hold_count += 1
+        self.task_holding = True
+        return self.link
+
+    def release(self, ident):
+        task = self.area.task_tab[ident]
+        task.task_holding = False
+        if task.priority > self.priority:
+            return task
+        return self
+
+    def qpkt(self, packet):
+        task = self.area.task_tab[packet.ident]
+        self.area.qpkt_count += 1
+        packet.link = None
+        packet.ident = self.ident
+        return task.add_packet(packet, self)
+
+
+class DeviceTask(Task):
+    def fn(self, packet, record):
+        if packet is None:
+            packet = record.pending
+            if packet is None:
+                return self.wait_task()
+            record.pending = None
+            return self.qpkt(packet)
+        record.pending = packet
+        return self.hold()
+
+
+class HandlerTask(Task):
+    def fn(self, packet, record):
+        if packet is not None:
+            if packet.kind == K_WORK:
+                record.work_in = packet.append_to(record.work_in)
+            else:
+                record.device_in = packet.append_to(record.device_in)
+        work = record.work_in
+        if work is None:
+            return self.wait_task()
+        count = work.datum
+        if count >= BUFSIZE:
+            record.work_in = work.link
+            return self.qpkt(work)
+        device = record.device_in
+        if device is None:
+            return self.wait_task()
+        record.device_in = device.link
+        device.datum = work.data[count]
+        work.datum = count + 1
+        return self.qpkt(device)
+
+
+class IdleTask(Task):
+    def fn(self, packet, record):
+        record.count -= 1
+        if record.count == 0:
+            return self.hold()
+        if record.control & 1 == 0:
+            record.control //= 2
+            return self.release(I_DEVA)
+        record.control = record.control // 2 ^ 0xD008
+        return self.release(I_DEVB)
+
+
+class WorkTask(Task):
+    def fn(self, packet, record):
+        if packet is None:
+            return self.wait_task()
+        destination = I_HANDLERB if record.destination == I_HANDLERA else I_HANDLERA
+        record.destination = destination
+        packet.ident = destination
+        packet.datum = 0
+        for i in range(BUFSIZE):
+            record.count += 1
+            if record.count > 26:
+                record.count = 1
+            packet.data[i] = 64 + record.count
+        return self.qpkt(packet)
+
+
+def richards_schedule(area):
+    task = area.task_list
+    while task is not None:
+        if task.holding_or_waiting():
+            task = task.link
+        else:
+            task = task.run_task()
+
+
+def richards(iterations):
+    """(hold count, packets queued) of the last run: (9297, 23246) when correct."""
+    area = None
+    for _ in range(iterations):
+        area = TaskWorkArea()
+        IdleTask(area, I_IDLE, 1, None, False, IdleTaskRec())
+        queue = Packet(Packet(None, 0, K_WORK), 0, K_WORK)
+        WorkTask(area, I_WORK, 1000, queue, True, WorkerTaskRec())
+        queue = Packet(Packet(Packet(None, I_DEVA, K_DEV), I_DEVA, K_DEV), I_DEVA, K_DEV)
+        HandlerTask(area, I_HANDLERA, 2000, queue, True, HandlerTaskRec())
+        queue = Packet(Packet(Packet(None, I_DEVB, K_DEV), I_DEVB, K_DEV), I_DEVB, K_DEV)
+        HandlerTask(area, I_HANDLERB, 3000, queue, True, HandlerTaskRec())
+        DeviceTask(area, I_DEVA, 4000, None, True, DeviceTaskRec())
+        DeviceTask(area, I_DEVB, 5000, None, True, DeviceTaskRec())
+        richards_schedule(area)
+    return area.hold_count, area.qpkt_count
+
+
+# =============================================================================
+# chaos: the chaos game over B-spline transformations (small objects, floats)
+# =============================================================================
+
+
+class GVector:
+    def __init__(self, x=0.0, y=0.0, z=0.0):
+        self.x = x
+        self.y = y
+        self.z = z
+
+    def mag(self):
+        return math.sqrt(self.x * self.x + self.y * self.y + self.z * self.z)
+
+    def dist(self, other):
+        return math.sqrt((self.x - other.x) ** 2 + (self.y - other.y) ** 2 + (self.z - other.z) ** 2)
+
+    def __sub__(self, other):
+        return GVector(self.x - other.x, self.y - other.y, self.z - other.z)
+
+    def linear_combination(self, other, l1, l2):
+        return GVector(self.x * l1 + other.x * l2, self.y * l1 + other.y * l2, self.z * l1 + other.z * l2)
+
+
+class Spline:
+    def __init__(self, points, degree, knots):
+        self.points = points
+        self.degree = degree
+        self.knots = knots
+
+    def domain(self):
+        return self.knots[self.degree - 1], self.knots[len(self.knots) - self.degree]
+
+    def index(self, u):
+        for ii in range(self.degree - 1, len(self.knots) - self.degree):
+            if self.knots[ii] <= u < self.knots[ii + 1]:
+                return ii
+        return self.domain()[1] - 1
+
+    def __call__(self, u):
+        """A point of the B-spline, by de Boor's algorithm."""
+        start, end = self.domain()
+        if u == start:
+            return self.points[0]
+        if u == end:
+            return self.points[-1]
+        i = self.index(u)
+        d = [self.points[i - self.degree + 1 + ii] for ii in range(self.degree + 1)]
+        knots = self.knots
+        for ik in range(1, self.degree + 1):
+            for ii in range(i - self.degree + ik + 1, i + 2):
+                ua = knots[ii + self.degree - ik]
+                ub = knots[ii - 1]
+                co1 = (ua - u) / (ua - ub)
+                co2 = (u - ub) / (ua - ub)
+                at = ii - i + self.degree - ik - 1
+                d[at] = d[at].linear_combination(d[at + 1], co1, co2)
+        return d[0]
+
+
+class Chaosgame:
+    def __init__(self, splines, thickness, rng):
+        self.splines = splines
+        self.thickness = thickness
+        self.rng = rng
+        self.minx = min(p.x for spline in splines for p in spline.points)
+        self.miny = min(p.y for spline in splines for p in spline.points)
+        self.maxx = max(p.x for spline in splines for p in spline.points)
+        self.maxy = max(p.y for spline in splines for p in spline.points)
+        self.height = self.maxy - self.miny
+        self.width = self.maxx - self.minx
+        self.num_trafos = []
+        max_length = thickness * self.width / self.height
+        for spline in splines:
+            length = 0.0
+            current = spline(0)
+            for i in range(1, 1000):
+                last = current
+                current = spline(i / 999)
+                length += current.dist(last)
+            self.num_trafos.append(max(1, int(length / max_length * 1.5)))
+        self.num_total = sum(self.num_trafos)
+
+    def random_trafo(self):
+        r = self.rng.below(self.num_total + 1)
+        low = 0
+        for i in range(len(self.num_trafos)):
+            if low <= r < low + self.num_trafos[i]:
+                return i, self.rng.below(self.num_trafos[i])
+            low += self.num_trafos[i]
+        return len(self.num_trafos) - 1, self.rng.below(self.num_trafos[-1])
+
+    def transform_point(self, point):
+        x = (point.x - self.minx) / self.width
+        y = (point.y - self.miny) / self.height
+        spline_index, segment = self.random_trafo()
+        spline = self.splines[spline_index]
+        start, end = spline.domain()
+        seg_length = (end - start) / self.num_trafos[spline_index]
+        t = start + seg_length * segment + seg_length * x
+        base = spline(t)
+        if t + 1 / 50000 > end:
+            derivative = spline(t - 1 / 50000) - base
+        else:
+            derivative = base - spline(t + 1 / 50000)
+        base = GVector(base.x, base.y, base.z)
+        mag = derivative.mag()
+        if mag != 0:
+            base.x += derivative.y / mag * (y - 0.5) * self.thickness
+            base.y += -derivative.x / mag * (y - 0.5) * self.thickness
+        base.x = min(max(base.x, self.minx), self.maxx)
+        base.y = min(max(base.y, self.miny), self.maxy)
+        return base
+
+
+def chaos(iterations):
+    """Pixels set on a 64x64 image after ``iterations`` rounds of the game."""
+    splines = [
+        Spline([GVector(1.597350, 3.304460), GVector(1.575810, 4.123260), GVector(1.313210, 5.288350),
+                GVector(1.618900, 5.329910), GVector(2.889940, 5.502700), GVector(2.373060, 4.381830),
+                GVector(1.662000, 4.360280)], 3, [0, 0, 0, 1, 1, 1, 2, 2, 2]),
+        Spline([GVector(2.804500, 4.017350), GVector(2.550500, 3.525230), GVector(1.979010, 2.620360),
+                GVector(1.979010, 2.620360)], 3, [0, 0, 0, 1, 1, 1]),
+        Spline([GVector(2.001670, 4.011320), GVector(2.335040, 3.312830), GVector(2.366800, 3.233460),
+                GVector(2.366800, 3.233460)], 3, [0, 0, 0, 1, 1, 1]),
+    ]
+    game = Chaosgame(splines, 0.25, Lcg(1234))
+    size = 64
+    image = [[0] * size for _ in range(size)]
+    point = GVector((game.maxx + game.minx) / 2, (game.maxy + game.miny) / 2)
+    for _ in range(iterations):
+        point = game.transform_point(point)
+        x = min(int((point.x - game.minx) / game.width * size), size - 1)
+        y = min(int((point.y - game.miny) / game.height * size), size - 1)
+        image[x][size - y - 1] = 1
+    return sum(sum(row) for row in image)
+
+
+# =============================================================================
+# go: random playouts on a 9x9 board (lists, flood fill, branching)
+# =============================================================================
+
+GO_SIZE = 9
+EMPTY = 0
+BLACK = 1
+WHITE = 2
+
+
+def go_neighbours():
+    """For each point of the board, the points next to it."""
+    result = []
+    for pos in range(GO_SIZE * GO_SIZE):
+        row, col = divmod(pos, GO_SIZE)
+        around = []
+        if row > 0:
+            around.append(pos - GO_SIZE)
+        if row < GO_SIZE - 1:
+            around.append(pos + GO_SIZE)
+        if col > 0:
+            around.append(pos - 1)
+        if col < GO_SIZE - 1:
+            around.append(pos + 1)
+        result.append(around)
+    return result
+
+
+class GoBoard:
+    def __init__(self):
+        self.stones = [EMPTY] * (GO_SIZE * GO_SIZE)
+        self.neighbours = go_neighbours()
+        self.ko = -1
+
+    def group(self, pos):
+        """The stones connected to ``pos`` and their number of liberties."""
+        color = self.stones[pos]
+        members = [pos]
+        seen = {pos}
+        liberties = set()
+        stack = [pos]
+        while stack:
+            p = stack.pop()
+            for q in self.neighbours[p]:
+                stone = self.stones[q]
+                if stone == EMPTY:
+                    liberties.add(q)
+                elif stone == color and q not in seen:
+                    seen.add(q)
+                    members.append(q)
+                    stack.append(q)
+        return members, len(liberties)
+
+    def is_eye(self, pos, color):
+        for q in self.neighbours[pos]:
+            if self.stones[q] != color:
+                return False
+        return True
+
+    def legal(self, pos, color):
+        if self.stones[pos] != EMPTY or pos == self.ko:
+            return False
+        for q in self.neighbours[pos]:
+            if self.stones[q] == EMPTY:
+                return True
+        self.stones[pos] = color
+        ok = self.group(pos)[1] > 0
+        for q in self.neighbours[pos]:
+            if not ok and self.stones[q] == 3 - color and self.group(q)[1] == 0:
+                ok = True
+        self.stones[pos] = EMPTY
+        return ok
+
+    def play(self, pos, color):
+        self.stones[pos] = color
+        captured = []
+        for q in self.neighbours[pos]:
+            if self.stones[q] == 3 - color:
+                members, liberties = self.group(q)
+                if liberties == 0:
+                    for stone in members:
+                        self.stones[stone] = EMPTY
+                        captured.append(stone)
+        self.ko = captured[0] if len(captured) == 1 else -1
+
+    def score(self, color):
+        total = 0
+        for pos in range(GO_SIZE * GO_SIZE):
+            if self.stones[pos] == color or (self.stones[pos] == EMPTY and self.is_eye(pos, color)):
+                total += 1
+        return total
+
+
+def go_playout(board, rng, max_moves):
+    color = BLACK
+    passes = 0
+    for _ in range(max_moves):
+        candidates = []
+        for pos in range(GO_SIZE * GO_SIZE):
+            if not board.is_eye(pos, color) and board.legal(pos, color):
+                candidates.append(pos)
+        if candidates:
+            board.play(candidates[rng.below(len(candidates))], color)
+            passes = 0
+        else:
+            passes += 1
+            if passes == 2:
+                break
+        color = WHITE if color == BLACK else BLACK
+    return board.score(BLACK) - board.score(WHITE)
+
+
+def go(games):
+    """Sum over ``games`` seeded random games of black's score minus white's."""
+    total = 0
+    for seed in range(games):
+        total += go_playout(GoBoard(), Lcg(seed + 1), GO_SIZE * GO_SIZE * 3)
+    return total
+
+
+# =============================================================================
+# raytrace: a reflective scene (vector objects, recursion, method calls)
+# =============================================================================
+
+EPSILON = 0.00001
+
+
+class Vector:
+    def __init__(self, x, y, z):
+        self.x = x
+        self.y = y
+        self.z = z
+
+    def dot(self, other):
+        return self.x * other.x + self.y * other.y + self.z * other.z
+
+    def magnitude(self):
+        return math.sqrt(self.dot(self))
+
+    def add(self, other):
+        return Vector(self.x + other.x, self.y + other.y, self.z + other.z)
+
+    def sub(self, other):
+        return Vector(self.x - other.x, self.y - other.y, self.z - other.z)
+
+    def scale(self, factor):
+        return Vector(self.x * factor, self.y * factor, self.z * factor)
+
+    def normalized(self):
+        return self.scale(1.0 / self.magnitude())
+
+    def reflect_through(self, normal):
+        return self.sub(normal.scale(2 * self.dot(normal)))
+
+
+class Ray:
+    def __init__(self, point, vector):
+        self.point = point
+        self.vector = vector.normalized()
+
+    def point_at_time(self, t):
+        return self.point.add(self.vector.scale(t))
+
+
+class Sphere:
+    def __init__(self, centre, radius, colour, reflectivity):
+        self.centre = centre
+        self.radius = radius
+        self.colour = colour
+        self.reflectivity = reflectivity
+
+    def intersection_time(self, ray):
+        cp = self.centre.sub(ray.point)
+        v = cp.dot(ray.vector)
+        discriminant = self.radius * self.radius - (cp.dot(cp) - v * v)
+        if discriminant < 0:
+            return None
+        return v - math.sqrt(discriminant)
+
+    def normal_at(self, point):
+        return point.sub(self.centre).normalized()
+
+
+class Halfspace:
+    def __init__(self, point, normal, colour, reflectivity):
+        self.point = point
+        self.normal = normal.normalized()
+        self.colour = colour
+        self.reflectivity = reflectivity
+
+    def intersection_time(self, ray):
+        v = ray.vector.dot(self.normal)
+        if v == 0:
+            return None
+        return self.point.sub(ray.point).dot(self.normal) / v
+
+    def normal_at(self, point):
+        return self.normal
+
+
+class Scene:
+    def __init__(self, objects, lights, eye, depth):
+        self.objects = objects
+        self.lights = lights
+        self.eye = eye
+        self.depth = depth
+
+    def first_hit(self, ray):
+        best = None
+        best_time = math.inf
+        for obj in self.objects:
+            t = obj.intersection_time(ray)
+            if t is not None and EPSILON < t < best_time:
+                best = obj
+                best_time = t
+        return best, best_time
+
+    def lambert(self, point, normal):
+        total = 0.1
+        for light in self.lights:
+            to_light = light.sub(point)
+            shadow = Ray(point, to_light)
+            blocker, t = self.first_hit(shadow)
+            if blocker is None or t > to_light.magnitude():
+                total += max(0.0, normal.dot(shadow.vector))
+        return min(total, 1.0)
+
+    def trace(self, ray, depth):
+        obj, t = self.first_hit(ray)
+        if obj is None:
+            return Vector(0.0, 0.0, 0.0)
+        point = ray.point_at_time(t)
+        normal = obj.normal_at(point)
+        colour = obj.colour.scale(self.lambert(point, normal))
+        if depth < self.depth and obj.reflectivity > 0:
+            reflected = self.trace(Ray(point, ray.vector.reflect_through(normal)), depth + 1)
+            colour = colour.scale(1 - obj.reflectivity).add(reflected.scale(obj.reflectivity))
+        return colour
+
+    def render(self, width, height):
+        checksum = 0.0
+        for y in range(height):
+            for x in range(width):
+                direction = Vector((x - width / 2) / width, (height / 2 - y) / height - 0.2, -1.0)
+                colour = self.trace(Ray(self.eye, direction), 0)
+                checksum += colour.x + colour.y + colour.z
+        return checksum
+
+
+def raytrace(size):
+    """Sum of the colour channels of a ``size`` x ``size`` render."""
+    objects = [
+        Sphere(Vector(1.0, 3.0, -10.0), 2.0, Vector(1.0, 1.0, 0.0), 0.5),
+        Halfspace(Vector(0.0, 0.0, 0.0), Vector(0.0, 1.0, 0.0), Vector(0.5, 0.5, 0.5), 0.2),
+    ]
+    for i in range(6):
+        objects.append(Sphere(Vector(i - 3.0, (i % 3) * 0.5 + 0.3, -6.0 - i), 0.3, Vector(0.0, 0.2, 1.0), 0.3))
+    scene = Scene(objects, [Vector(30.0, 30.0, 10.0), Vector(-10.0, 100.0, 30.0)], Vector(0.0, 1.8, 10.0), 2)
+    return scene.render(size, size)
+
+
+# =============================================================================
+# NumPy-style array kernels (native mode over buffers)
+# =============================================================================
+
+
+def axpy(a, x, y):
+    for i in range(len(x)):
+        y[i] += a * x[i]
+
+
+def matmul(a, b, out):
+    n, m = a.shape
+    p = b.shape[1]
+    for i in range(n):
+        for j in range(p):
+            total = 0.0
+            for k in range(m):
+                total += a[i, k] * b[k, j]
+            out[i, j] = total
+
+
+def _matrix(n, values):
+    """An n x n float64 matrix as a 2-D memoryview over an array.array."""
+    return memoryview(array.array("d", values)).cast("B").cast("d", [n, n])
+
+
+# =============================================================================
+# Generator pipeline and async fan-out
+# =============================================================================
+
+
+def pipeline_source(n):
+    i = 0
+    while i < n:
+        yield i
+        i += 1
+
+
+def pipeline_scale(items, factor):
+    for x in items:
+        yield x * factor
+
+
+def pipeline_keep_even(items):
+    for x in items:
+        if x % 2 == 0:
+            yield x
+
+
+def pipeline_running_max(items):
+    best = 0
+    for x in items:
+        if x > best:
+            best = x
+        yield best
+
+
+def generator_pipeline(n):
+    return sum(pipeline_running_max(pipeline_keep_even(pipeline_scale(pipeline_source(n), 3))))
+
+
+async def fan_out_fetch(i):
+    await asyncio.sleep(0)
+    return i * i
+
+
+async def fan_out(n):
+    results = await asyncio.gather(*[fan_out_fetch(i) for i in range(n)])
+    return sum(results)
+
+
+_loop = None
+
+
+def _run_async(f, args):
+    global _loop
+    if _loop is None:
+        _loop = asyncio.new_event_loop()
+    return _loop.run_until_complete(f(*args))
+
+
+# =============================================================================
+# Inline C numeric code
+# =============================================================================
+
+
+def mandelbrot(width, height, max_iter):
+    total = 0
+    for y in range(height):
+        for x in range(width):
+            cr = -2.0 + 2.5 * x / width
+            ci = -1.25 + 2.5 * y / height
+            zr = zi = 0.0
+            i = 0
+            while i < max_iter and zr * zr + zi * zi <= 4.0:
+                zr, zi = zr * zr - zi * zi + cr, 2.0 * zr * zi + ci
+                i += 1
+            total += i
+    return total
+
+
+MANDELBROT_C = """
+long long workload_mandelbrot(long long width, long long height, long long max_iter) {
+    long long total = 0;
+    for (long long y = 0; y < height; y++) {
+        for (long long x = 0; x < width; x++) {
+            double cr = -2.0 + 2.5 * x / width, ci = -1.25 + 2.5 * y / height;
+            double zr = 0.0, zi = 0.0;
+            long long i = 0;
+            while (i < max_iter && zr * zr + zi * zi <= 4.0) {
+                double t = zr * zr - zi * zi + cr;
+                zi = 2.0 * zr * zi + ci;
+                zr = t;
+                i++;
+            }
+            total += i;
+        }
+    }
+    return total;
+}
+"""
+
+
+def _inline_c_mandelbrot(_func):
+    return justjit.inline_c(MANDELBROT_C)["workload_mandelbrot"]
+
+
+# =============================================================================
+# Cases
+# =============================================================================
+
+NBODY_STEPS = 1000
+ARRAY_LENGTH = 1 << 16
+MATRIX_SIZE = 48
+
+
+def workload_cases():
+    """The workload corpus as justjit.bench cases."""
+    xs = array.array("d", [i * 0.5 for i in range(ARRAY_LENGTH)])
+    ys = array.array("d", [1.0] * ARRAY_LENGTH)
+    n = MATRIX_SIZE
+    a = _matrix(n, [(i % 7) * 0.25 for i in range(n * n)])
+    b = _matrix(n, [(i % 5) * 0.5 for i in range(n * n)])
+    out = _matrix(n, [0.0] * (n * n))
+    return [
+        Case("nbody", "auto", nbody, (NBODY_STEPS,), items=NBODY_STEPS,
+             build=_jit_build(nbody_system, nbody_pairs, nbody_offset_momentum, nbody_advance, nbody_energy, nbody)),
+        Case("spectral_norm", "auto", spectral_norm, (32,),
+             build=_jit_build(spectral_eval_a, spectral_times_u, spectral_times_transposed_u, spectral_norm)),
+        Case("richards", "auto", richards, (1,),
+             build=_jit_build(Packet, DeviceTaskRec, IdleTaskRec, HandlerTaskRec, WorkerTaskRec, TaskWorkArea, Task,
+                              DeviceTask, HandlerTask, IdleTask, WorkTask, richards_schedule, richards)),
+        Case("chaos", "auto", chaos, (2000,), items=2000,
+             build=_jit_build(Lcg, GVector, Spline, Chaosgame, chaos)),
+        Case("go", "auto", go, (1,), build=_jit_build(Lcg, go_neighbours, GoBoard, go_playout, go)),
+        Case("raytrace", "auto", raytrace, (24,), items=24 * 24,
+             build=_jit_build(Vector, Ray, Sphere, Halfspace, Scene, raytrace)),
+        Case("array_axpy", "native", axpy, (2.0, xs, ys), items=ARRAY_LENGTH,
+             build=lambda f: justjit.jit("void(f64, f64[:], f64[:])")(f)),
+        Case("array_matmul", "native", matmul, (a, b, out), items=n * n * n,
+             build=lambda f: justjit.jit("void(f64[:, :], f64[:, :], f64[:, :])")(f)),
+        Case("generator_pipeline", "auto", generator_pipeline, (10000,), items=10000,
+             build=_jit_build(pipeline_source, pipeline_scale, pipeline_keep_even, pipeline_running_max,
+                              generator_pipeline)),
+        Case("async_fan_out", "auto", fan_out, (200,), items=200, run=_run_async,
+             build=_jit_build(fan_out_fetch, fan_out)),
+        Case("inline_c_mandelbrot", "inline_c", mandelbrot, (64, 48, 50), items=64 * 48,
+             build=_inline_c_mandelbrot),
+    ]
@@ -7,9 +7,420 @@
 
 #include "raii_wrapper.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 // Use the justjit namespace for C++ classes
 using namespace justjit;
 
+namespace {
+
+// Method names arrive as C strings on every call; keep one interned str per
+// name so PyObject_VectorcallMethod doesn't allocate a new one each time.
+// Callers hold the GIL, which also guards the map. Returns a borrowed reference.
+PyObject* method_name(const char* method) {
+    static std::unordered_map<std::string, PyObject*> names;
+    auto it = names.find(method);
+    if (it != names.end()) {
+        return it->second;
+    }
+    PyObject* name = PyUnicode_InternFromString(method);
+    if (!name) return nullptr;
+    names.emplace(method, name);  // Kept for the life of the process
+    return name;
+}
+
+// Call obj.method(*args) through the vectorcall protocol; stack[0] is reserved
+// for obj and the arguments follow it
+PyObject* call_method(PyObject* obj, const char* method, PyObject** stack, size_t nargs) {
+    PyObject* name = method_name(method);
+    if (!name) return nullptr;
+    stack[0] = obj;
+    return PyObject_VectorcallMethod(name, stack, (nargs + 1) | PY_VECTORCALL_ARGUMENTS_OFFSET, nullptr);
+}
+
+// Vectorcall func on args[1..nargs]; args[0] is scratch space the callee may use
+PyObject* call_function(PyObject* func, PyObject** args, size_t nargs) {
+    if (!PyCallable_Check(func)) {
+        PyErr_SetString(PyExc_TypeError, "Object is not callable");
+        return nullptr;
+    }
+    return PyObject_Vectorcall(func, args + 1, nargs | PY_VECTORCALL_ARGUMENTS_OFFSET, nullptr);
+}
+
+// Struct layouts are "<kind><offset>,..." with struct-module kinds ('d', 'f',
+// 'q', 'i', 'h', 'b', '?', ... and 'p' for pointers), as written by the
+// shim generator; each call walks the few fields in place
+template <typename Visit>
+bool for_each_field(const char* layout, Visit visit) {
+    while (*layout) {
+        char kind = *layout++;
+        char* end = nullptr;
+        long offset = std::strtol(layout, &end, 10);
+        if (!visit(kind, static_cast<size_t>(offset))) return false;
+        layout = *end == ',' ? end + 1 : end;
+    }
+    return true;
+}
+
+Py_ssize_t layout_fields(const char* layout) {
+    Py_ssize_t count = 0;
+    for_each_field(layout, [&](char, size_t) { ++count; return true; });
+    return count;
+}
+
+// Free NumpyBuffer handles for jit_buffer_new
+constexpr size_t BUFFER_POOL_LIMIT = 64;
+
+std::vector<NumpyBuffer*>& buffer_pool() {
+    static std::vector<NumpyBuffer*> pool;
+    return pool;
+}
+
+// DLPack (v0) structures, as dlpack.h lays them out
+struct DLDevice {
+    int32_t device_type;  // 1 = kDLCPU
+    int32_t device_id;
+};
+struct DLDataType {
+    uint8_t code;  // 0 int, 1 uint, 2 float, 5 complex, 6 bool
+    uint8_t bits;
+    uint16_t lanes;
+};
+struct DLTensor {
+    void* data;
+    DLDevice device;
+    int32_t ndim;
+    DLDataType dtype;
+    int64_t* shape;
+    int64_t* strides;  // In elements; NULL for C-contiguous
+    uint64_t byte_offset;
+};
+struct DLManagedTensor {
+    DLTensor dl_tensor;
+    void* manager_ctx;
+    void (*deleter)(DLManagedTensor* self);
+};
+
+// What a view built from an array interface points into: the shape, strides
+// and format storage, and a reference to whatever keeps the data alive (the
+// array itself, or the unconsumed DLPack capsule, whose destructor calls
+// the producer's deleter). Lives in a capsule that becomes the view's `obj`.
+struct InterfaceView {
+    PyObject* owner;
+    char format[4];
+    Py_ssize_t dims[1];  // shape[ndim] then strides[ndim]
+};
+
+constexpr const char* INTERFACE_VIEW_NAME = "justjit.interface_view";
+
+void interface_view_free(PyObject* capsule) {
+    auto* holder = static_cast<InterfaceView*>(PyCapsule_GetPointer(capsule, INTERFACE_VIEW_NAME));
+    Py_XDECREF(holder->owner);
+    PyMem_Free(holder);
+}
+
+// Struct-module format of `kind` ('i', 'u', 'f', 'c' or 'b') elements of `bytes` bytes, or nullptr
+const char* interface_format(char kind, Py_ssize_t bytes) {
+    switch (kind) {
+    case 'i': return bytes == 1 ? "b" : bytes == 2 ? "h" : bytes == 4 ? "i" : bytes == 8 ? "q" : nullptr;
+    case 'u': return bytes == 1 ? "B" : bytes == 2 ? "H" : bytes == 4 ? "I" : bytes == 8 ? "Q" : nullptr;
+    case 'f': return bytes == 2 ? "e" : bytes == 4 ? "f" : bytes == 8 ? "d" : nullptr;
+    case 'c': return bytes == 8 ? "Zf" : bytes == 16 ? "Zd" : nullptr;
+    case 'b': return bytes == 1 ? "?" : nullptr;
+    default: return nullptr;
+    }
+}
+
+// Fill `view` over `data` with `shape` and byte `strides` (nullptr: C order).
+// Steals `owner`; returns -1 with an exception set.
+int fill_interface_view(Py_buffer* view, PyObject* owner, void* data, bool readonly, const char* format,
+                        Py_ssize_t itemsize, int ndim, const Py_ssize_t* shape, const Py_ssize_t* strides, int flags) {
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE && readonly) {
+        Py_DECREF(owner);
+        PyErr_SetString(PyExc_BufferError, "array interface describes read-only memory");
+        return -1;
+    }
+    auto* holder = static_cast<InterfaceView*>(
+        PyMem_Malloc(sizeof(InterfaceView) + sizeof(Py_ssize_t) * std::max(2 * ndim - 1, 0)));
+    if (holder == nullptr) {
+        Py_DECREF(owner);
+        PyErr_NoMemory();
+        return -1;
+    }
+    holder->owner = owner;
+    std::strncpy(holder->format, format, sizeof(holder->format) - 1);
+    holder->format[sizeof(holder->format) - 1] = '\0';
+    Py_ssize_t* view_shape = holder->dims;
+    Py_ssize_t* view_strides = holder->dims + ndim;
+    Py_ssize_t len = itemsize;
+    for (int d = ndim - 1; d >= 0; --d) {
+        view_shape[d] = shape[d];
+        view_strides[d] = strides != nullptr ? strides[d] : (d == ndim - 1 ? itemsize : view_strides[d + 1] * shape[d + 1]);
+        len *= shape[d];
+    }
+    PyObject* capsule = PyCapsule_New(holder, INTERFACE_VIEW_NAME, interface_view_free);
+    if (capsule == nullptr) {
+        Py_DECREF(owner);
+        PyMem_Free(holder);
+        return -1;
+    }
+    view->obj = capsule;
+    view->buf = data;
+    view->len = len;
+    view->itemsize = itemsize;
+    view->readonly = readonly;
+    view->ndim = ndim;
+    view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? holder->format : nullptr;
+    view->shape = view_shape;
+    view->strides = view_strides;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    if ((flags & PyBUF_C_CONTIGUOUS) == PyBUF_C_CONTIGUOUS && !PyBuffer_IsContiguous(view, 'C')) {
+        PyBuffer_Release(view);
+        PyErr_SetString(PyExc_BufferError, "array interface describes a non-contiguous array");
+        return -1;
+    }
+    return 0;
+}
+
+// __array_interface__ with `data` as an (address, read-only) pair: 1 on
+// success, 0 when `obj` has none, -1 on error
+int array_interface_buffer(PyObject* obj, Py_buffer* view, int flags) {
+    PyObject* interface = PyObject_GetAttrString(obj, "__array_interface__");
+    if (interface == nullptr) {
+        if (!PyErr_ExceptionMatches(PyExc_AttributeError)) return -1;
+        PyErr_Clear();
+        return 0;
+    }
+    auto release_interface = make_guard([&] { Py_DECREF(interface); });
+    PyObject* typestr = PyDict_Check(interface) ? PyDict_GetItemString(interface, "typestr") : nullptr;
+    PyObject* shape = PyDict_Check(interface) ? PyDict_GetItemString(interface, "shape") : nullptr;
+    PyObject* data = PyDict_Check(interface) ? PyDict_GetItemString(interface, "data") : nullptr;
+    PyObject* strides = PyDict_Check(interface) ? PyDict_GetItemString(interface, "strides") : nullptr;
+    PyObject* mask = PyDict_Check(interface) ? PyDict_GetItemString(interface, "mask") : nullptr;
+    const char* type = typestr != nullptr && PyUnicode_Check(typestr) ? PyUnicode_AsUTF8(typestr) : nullptr;
+    if (type == nullptr || shape == nullptr || !PyTuple_Check(shape) || data == nullptr || !PyTuple_Check(data) ||
+        PyTuple_GET_SIZE(data) != 2 || (strides != nullptr && strides != Py_None && !PyTuple_Check(strides)) ||
+        (mask != nullptr && mask != Py_None) || std::strlen(type) < 3) {
+        PyErr_Clear();
+        PyErr_SetString(PyExc_BufferError, "unsupported __array_interface__ (needs typestr, shape and an address)");
+        return -1;
+    }
+    // Native byte order only ('|' for single bytes, '=' or this host's order)
+    const char native_order = PY_LITTLE_ENDIAN ? '<' : '>';
+    const char* format = type[0] == '|' || type[0] == '=' || type[0] == native_order
+                             ? interface_format(type[1], std::atol(type + 2))
+                             : nullptr;
+    const int ndim = static_cast<int>(PyTuple_GET_SIZE(shape));
+    const bool strided = strides != nullptr && strides != Py_None;
+    if (format == nullptr || ndim > 64 || (strided && PyTuple_GET_SIZE(strides) != ndim)) {
+        PyErr_Format(PyExc_BufferError, "unsupported __array_interface__ typestr '%s' or layout", type);
+        return -1;
+    }
+    Py_ssize_t dims[128];
+    for (int d = 0; d < ndim; ++d) {
+        dims[d] = PyLong_AsSsize_t(PyTuple_GET_ITEM(shape, d));
+        dims[ndim + d] = strided ? PyLong_AsSsize_t(PyTuple_GET_ITEM(strides, d)) : 0;
+    }
+    void* address = PyLong_AsVoidPtr(PyTuple_GET_ITEM(data, 0));
+    const int readonly = PyObject_IsTrue(PyTuple_GET_ITEM(data, 1));
+    if (PyErr_Occurred()) return -1;
+    Py_INCREF(obj);
+    return fill_interface_view(view, obj, address, readonly != 0, format, std::atol(type + 2), ndim, dims,
+                               strided ? dims + ndim : nullptr, flags) < 0 ? -1 : 1;
+}
+
+// __dlpack__ of a CPU tensor: 1 on success, 0 when `obj` has none, -1 on error
+int dlpack_buffer(PyObject* obj, Py_buffer* view, int flags) {
+    PyObject* method = PyObject_GetAttrString(obj, "__dlpack__");
+    if (method == nullptr) {
+        if (!PyErr_ExceptionMatches(PyExc_AttributeError)) return -1;
+        PyErr_Clear();
+        return 0;
+    }
+    PyObject* capsule = PyObject_CallNoArgs(method);
+    Py_DECREF(method);
+    if (capsule == nullptr) return -1;
+    // Left unconsumed (still named "dltensor"): releasing the capsule calls the deleter
+    auto* managed = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(capsule, "dltensor"));
+    if (managed == nullptr) {
+        Py_DECREF(capsule);
+        return -1;
+    }
+    const DLTensor& tensor = managed->dl_tensor;
+    static const char dl_kinds[] = {'i', 'u', 'f', 0, 0, 'c', 'b'};
+    const char* format = tensor.dtype.lanes == 1 && tensor.dtype.code < sizeof(dl_kinds) && tensor.dtype.bits % 8 == 0
+                             ? interface_format(dl_kinds[tensor.dtype.code], tensor.dtype.bits / 8)
+                             : nullptr;
+    if (tensor.device.device_type != 1 || format == nullptr || tensor.ndim < 0 || tensor.ndim > 64) {
+        Py_DECREF(capsule);
+        PyErr_SetString(PyExc_BufferError, "__dlpack__ needs a CPU tensor of int, uint, float, complex or bool elements");
+        return -1;
+    }
+    const Py_ssize_t itemsize = tensor.dtype.bits / 8;
+    Py_ssize_t dims[128];
+    for (int d = 0; d < tensor.ndim; ++d) {
+        dims[d] = static_cast<Py_ssize_t>(tensor.shape[d]);
+        dims[tensor.ndim + d] = tensor.strides != nullptr ? static_cast<Py_ssize_t>(tensor.strides[d]) * itemsize : 0;
+    }
+    void* data = static_cast<char*>(tensor.data) + tensor.byte_offset;
+    return fill_interface_view(view, capsule, data, false, format, itemsize, tensor.ndim, dims,
+                               tensor.strides != nullptr ? dims + tensor.ndim : nullptr, flags) < 0 ? -1 : 1;
+}
+
+// Arrow C data interface structures, as the specification lays them out
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    ArrowSchema** children;
+    ArrowSchema* dictionary;
+    void (*release)(ArrowSchema*);
+    void* private_data;
+};
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;  // [validity bitmap, values] for primitive types
+    ArrowArray** children;
+    ArrowArray* dictionary;
+    void (*release)(ArrowArray*);
+    void* private_data;
+};
+
+// Struct-module format of a primitive Arrow format string, or nullptr
+// (booleans are bit-packed, so they have no element view)
+const char* arrow_format(const char* format, Py_ssize_t& itemsize) {
+    if (format == nullptr || format[0] == '\0' || format[1] != '\0') return nullptr;
+    switch (format[0]) {
+    case 'c': itemsize = 1; return "b";
+    case 'C': itemsize = 1; return "B";
+    case 's': itemsize = 2; return "h";
+    case 'S': itemsize = 2; return "H";
+    case 'i': itemsize = 4; return "i";
+    case 'I': itemsize = 4; return "I";
+    case 'l': itemsize = 8; return "q";
+    case 'L': itemsize = 8; return "Q";
+    case 'e': itemsize = 2; return "e";
+    case 'f': itemsize = 4; return "f";
+    case 'g': itemsize = 8; return "d";
+    default: return nullptr;
+    }
+}
+
+// __arrow_c_array__: 1 on success, 0 when `obj` has none, -1 on error.
+// `validity` may be nullptr, in which case arrays with nulls are refused.
+int arrow_buffers(PyObject* obj, Py_buffer* values, Py_buffer* validity) {
+    PyObject* method = PyObject_GetAttrString(obj, "__arrow_c_array__");
+    if (method == nullptr) {
+        if (!PyErr_ExceptionMatches(PyExc_AttributeError)) return -1;
+        PyErr_Clear();
+        return 0;
+    }
+    PyObject* pair = PyObject_CallNoArgs(method);
+    Py_DECREF(method);
+    if (pair == nullptr) return -1;
+    auto release_pair = make_guard([&] { Py_DECREF(pair); });
+    if (!PyTuple_Check(pair) || PyTuple_GET_SIZE(pair) != 2) {
+        PyErr_SetString(PyExc_TypeError, "__arrow_c_array__ must return a (schema, array) pair of capsules");
+        return -1;
+    }
+    // Left unconsumed: the array capsule releases the array when the views let it go
+    PyObject* array_capsule = PyTuple_GET_ITEM(pair, 1);
+    auto* schema = static_cast<ArrowSchema*>(PyCapsule_GetPointer(PyTuple_GET_ITEM(pair, 0), "arrow_schema"));
+    auto* array = schema != nullptr ? static_cast<ArrowArray*>(PyCapsule_GetPointer(array_capsule, "arrow_array")) : nullptr;
+    if (array == nullptr) return -1;
+    Py_ssize_t itemsize = 0;
+    const char* format = arrow_format(schema->format, itemsize);
+    if (format == nullptr || array->n_buffers != 2 || array->buffers[1] == nullptr) {
+        PyErr_Format(PyExc_BufferError, "Arrow arrays of format '%s' have no primitive values buffer",
+                     schema->format != nullptr ? schema->format : "");
+        return -1;
+    }
+    const bool nulls = array->null_count != 0 && array->buffers[0] != nullptr;
+    if (nulls && (validity == nullptr || array->offset % 8 != 0)) {
+        PyErr_SetString(PyExc_BufferError, validity == nullptr
+                                               ? "Arrow array has nulls; pass it to an optional_f64 kernel"
+                                               : "Arrow array slices with nulls must start at a multiple of 8 rows");
+        return -1;
+    }
+    const Py_ssize_t length = static_cast<Py_ssize_t>(array->length);
+    void* data = const_cast<char*>(static_cast<const char*>(array->buffers[1])) + array->offset * itemsize;
+    // Arrow buffers are immutable once exported
+    if (fill_interface_view(values, Py_NewRef(array_capsule), data, true, format, itemsize, 1, &length, nullptr,
+                            PyBUF_STRIDES | PyBUF_FORMAT) < 0) {
+        return -1;
+    }
+    if (validity != nullptr) {
+        validity->obj = nullptr;
+        const Py_ssize_t bytes = (length + 7) / 8;
+        void* bitmap = const_cast<char*>(static_cast<const char*>(array->buffers[0])) + array->offset / 8;
+        if (nulls && fill_interface_view(validity, Py_NewRef(array_capsule), bitmap, true, "B", 1, 1, &bytes, nullptr,
+                                         PyBUF_STRIDES | PyBUF_FORMAT) < 0) {
+            PyBuffer_Release(values);
+            return -1;
+        }
+    }
+    return 1;
+}
+
+}  // namespace
+
+namespace justjit {
+
+int get_array_buffer(PyObject* obj, Py_buffer* view, int flags) {
+    if (PyObject_CheckBuffer(obj) || (flags & PyBUF_STRIDES) != PyBUF_STRIDES) {
+        return PyObject_GetBuffer(obj, view, flags);
+    }
+    int found = array_interface_buffer(obj, view, flags);
+    // Arrow before DLPack: pyarrow arrays export both, and only Arrow describes nulls
+    if (found == 0) {
+        found = arrow_buffers(obj, view, nullptr);
+        if (found > 0 && (flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+            PyBuffer_Release(view);
+            PyErr_SetString(PyExc_BufferError, "Arrow arrays are read-only");
+            return -1;
+        }
+    }
+    if (found == 0) {
+        found = dlpack_buffer(obj, view, flags);
+    }
+    if (found == 0) {
+        PyErr_Format(PyExc_TypeError, "a bytes-like object or array is required, not '%.100s'", Py_TYPE(obj)->tp_name);
+    }
+    return found > 0 ? 0 : -1;
+}
+
+bool is_array_like(PyObject* obj) {
+    if (PyObject_CheckBuffer(obj)) return true;
+    if (PyObject_HasAttrStringWithError(obj, "__array_interface__") > 0) return true;
+    const bool exported = PyObject_HasAttrStringWithError(obj, "__dlpack__") > 0 ||
+                          PyObject_HasAttrStringWithError(obj, "__arrow_c_array__") > 0;
+    PyErr_Clear();
+    return exported;
+}
+
+int get_arrow_column(PyObject* obj, Py_buffer* values, Py_buffer* validity) {
+    const int found = arrow_buffers(obj, values, validity);
+    if (found == 0) {
+        PyErr_Format(PyExc_TypeError, "'%.100s' does not export an Arrow array", Py_TYPE(obj)->tp_name);
+    }
+    return found > 0 ? 0 : -1;
+}
+
+}  // namespace justjit
+
 // ============================================================================
 // C API Exports - Must have C linkage for JIT symbol resolution
 // ============================================================================
@@ -48,17 +459,35 @@ PyObject* jit_pyobj_get(void* ptr) {
 }
 
 // Buffer Access - C API for NumPy arrays
+// Handles are recycled through a small free list (guarded by the GIL, which
+// PyObject_GetBuffer needs anyway) instead of a new/delete per buffer
 void* jit_buffer_new(PyObject* arr) {
-    auto* buf = new NumpyBuffer(arr);
+    auto& pool = buffer_pool();
+    NumpyBuffer* buf;
+    if (pool.empty()) {
+        buf = new NumpyBuffer();
+    } else {
+        buf = pool.back();
+        pool.pop_back();
+    }
+    *buf = NumpyBuffer(arr);
     if (!buf->valid()) {
-        delete buf;
+        pool.push_back(buf);
         return nullptr;
     }
     return buf;
 }
 
 void jit_buffer_free(void* buf) {
-    delete static_cast<NumpyBuffer*>(buf);
+    if (!buf) return;
+    auto* handle = static_cast<NumpyBuffer*>(buf);
+    *handle = NumpyBuffer();  // Releases the view
+    auto& pool = buffer_pool();
+    if (pool.size() < BUFFER_POOL_LIMIT) {
+        pool.push_back(handle);
+    } else {
+        delete handle;
+    }
 }
 
 void* jit_buffer_data(void* buf) {
@@ -211,22 +640,30 @@ int jit_hasattr(PyObject* obj, const char* name) {
 }
 
 PyObject* jit_call_method(PyObject* obj, const char* method, PyObject* args) {
-    PyObject* meth = PyObject_GetAttrString(obj, method);
-    if (!meth) return nullptr;
-    PyObject* result = PyObject_Call(meth, args ? args : PyTuple_New(0), nullptr);
-    Py_DECREF(meth);
+    // args is a tuple (e.g. from jit_build_args*) or NULL for no arguments
+    if (!args) {
+        return jit_call_method0(obj, method);
+    }
+    if (!PyTuple_Check(args)) {
+        PyErr_SetString(PyExc_TypeError, "jit_call_method expects a tuple of arguments");
+        return nullptr;
+    }
+    Py_ssize_t nargs = PyTuple_GET_SIZE(args);
+    PyObject* small[8];
+    PyObject** stack = nargs < 8 ? small : static_cast<PyObject**>(PyMem_Malloc((nargs + 1) * sizeof(PyObject*)));
+    if (!stack) return PyErr_NoMemory();
+    for (Py_ssize_t i = 0; i < nargs; i++) {
+        stack[i + 1] = PyTuple_GET_ITEM(args, i);
+    }
+    PyObject* result = call_method(obj, method, stack, nargs);
+    if (stack != small) PyMem_Free(stack);
     return result;
 }
 
 PyObject* jit_call_method0(PyObject* obj, const char* method) {
     // Call method with no arguments
-    PyObject* meth = PyObject_GetAttrString(obj, method);
-    if (!meth) return nullptr;
-    PyObject* empty_args = PyTuple_New(0);
-    PyObject* result = PyObject_Call(meth, empty_args, nullptr);
-    Py_DECREF(empty_args);
-    Py_DECREF(meth);
-    return result;
+    PyObject* stack[1];
+    return call_method(obj, method, stack, 0);
 }
 
 // ============================================================================
@@ -300,67 +737,51 @@ void jit_error_print() { PyErr_Print(); }
 // Enhanced Callback Functions for Bidirectional Interop
 // ============================================================================
 
+// The callbacks below pass their arguments on the stack through vectorcall,
+// so a call allocates no argument tuple
+
 // Call Python function with 1 argument
 PyObject* jit_call1(PyObject* func, PyObject* arg) {
-    if (!PyCallable_Check(func)) {
-        PyErr_SetString(PyExc_TypeError, "Object is not callable");
-        return nullptr;
-    }
-    PyObject* args = PyTuple_Pack(1, arg);
-    if (!args) return nullptr;
-    PyObject* result = PyObject_Call(func, args, nullptr);
-    Py_DECREF(args);
-    return result;
+    PyObject* args[2] = {nullptr, arg};
+    return call_function(func, args, 1);
 }
 
 // Call Python function with 2 arguments
 PyObject* jit_call2(PyObject* func, PyObject* arg1, PyObject* arg2) {
-    if (!PyCallable_Check(func)) {
-        PyErr_SetString(PyExc_TypeError, "Object is not callable");
-        return nullptr;
-    }
-    PyObject* args = PyTuple_Pack(2, arg1, arg2);
-    if (!args) return nullptr;
-    PyObject* result = PyObject_Call(func, args, nullptr);
-    Py_DECREF(args);
-    return result;
+    PyObject* args[3] = {nullptr, arg1, arg2};
+    return call_function(func, args, 2);
 }
 
 // Call Python function with 3 arguments
 PyObject* jit_call3(PyObject* func, PyObject* arg1, PyObject* arg2, PyObject* arg3) {
+    PyObject* args[4] = {nullptr, arg1, arg2, arg3};
+    return call_function(func, args, 3);
+}
+
+// Call Python function with n arguments from a C array
+PyObject* jit_call_vec(PyObject* func, PyObject* const* args, Py_ssize_t n) {
     if (!PyCallable_Check(func)) {
         PyErr_SetString(PyExc_TypeError, "Object is not callable");
         return nullptr;
     }
-    PyObject* args = PyTuple_Pack(3, arg1, arg2, arg3);
-    if (!args) return nullptr;
-    PyObject* result = PyObject_Call(func, args, nullptr);
-    Py_DECREF(args);
-    return result;
+    if (n < 0) {
+        PyErr_SetString(PyExc_ValueError, "jit_call_vec: negative argument count");
+        return nullptr;
+    }
+    // args belongs to the caller, so the callee may not borrow args[-1]
+    return PyObject_Vectorcall(func, args, static_cast<size_t>(n), nullptr);
 }
 
 // Call method with 1 argument
 PyObject* jit_call_method1(PyObject* obj, const char* method, PyObject* arg) {
-    PyObject* meth = PyObject_GetAttrString(obj, method);
-    if (!meth) return nullptr;
-    PyObject* args = PyTuple_Pack(1, arg);
-    if (!args) { Py_DECREF(meth); return nullptr; }
-    PyObject* result = PyObject_Call(meth, args, nullptr);
-    Py_DECREF(args);
-    Py_DECREF(meth);
-    return result;
+    PyObject* stack[2] = {nullptr, arg};
+    return call_method(obj, method, stack, 1);
 }
 
 // Call method with 2 arguments
 PyObject* jit_call_method2(PyObject* obj, const char* method, PyObject* arg1, PyObject* arg2) {
-    PyObject* meth = PyObject_GetAttrString(obj, method);
-    if (!meth) return nullptr;
-    PyObject* args = PyTuple_Pack(2, arg1, arg2);
-    if (!args) { Py_DECREF(meth); return nullptr; }
-    PyObject* result = PyObject_Call(meth, args, nullptr);
-    Py_DECREF(args);
-    Py_DECREF(meth);
-    return result;
+    PyObject* stack[3] = {nullptr, arg1, arg2};
+    return call_method(obj, method, stack, 2);
 }
 
 // Build tuple from arguments
@@ -477,5 +898,283 @@ PyObject* jit_py_exec(const char* code, PyObject* locals) {
     return nullptr;
 }
 
+// ============================================================================
+// JITCallable Argument Conversion
+// ============================================================================
+
+// int/bool, None (0) or a capsule's pointer, for integer parameters
+int jit_callable_arg_i64(PyObject* arg, Py_ssize_t index, long long* out) {
+    if (PyLong_Check(arg)) {
+        long long value = PyLong_AsLongLong(arg);
+        if (value == -1 && PyErr_Occurred()) return -1;
+        *out = value;
+        return 0;
+    }
+    if (arg == Py_None) {
+        *out = 0;
+        return 0;
+    }
+    if (PyCapsule_CheckExact(arg)) {
+        void* ptr = PyCapsule_GetPointer(arg, PyCapsule_GetName(arg));
+        if (!ptr) return -1;
+        *out = reinterpret_cast<long long>(ptr);
+        return 0;
+    }
+    PyErr_Format(PyExc_TypeError, "argument %zd must be int or None, not %.100s",
+                 index, Py_TYPE(arg)->tp_name);
+    return -1;
+}
+
+// float, int or None (0.0), for double and float parameters
+int jit_callable_arg_f64(PyObject* arg, Py_ssize_t index, double* out) {
+    if (PyFloat_CheckExact(arg)) {
+        *out = PyFloat_AS_DOUBLE(arg);
+        return 0;
+    }
+    if (PyFloat_Check(arg) || PyLong_Check(arg)) {
+        double value = PyFloat_AsDouble(arg);
+        if (value == -1.0 && PyErr_Occurred()) return -1;
+        *out = value;
+        return 0;
+    }
+    if (arg == Py_None) {
+        *out = 0.0;
+        return 0;
+    }
+    PyErr_Format(PyExc_TypeError, "argument %zd must be float, int or None, not %.100s",
+                 index, Py_TYPE(arg)->tp_name);
+    return -1;
+}
+
+// Whether a buffer's struct-module format holds the pointee's element type:
+// same item size, and float vs integer vs bool kind (signedness is not checked)
+static bool buffer_format_matches(const Py_buffer* view, char expected) {
+    if (expected == 'v' || expected == 'x') {
+        return true;  // void* and struct/pointer pointees take any buffer
+    }
+    const char* fmt = view->format ? view->format : "B";
+    if (*fmt == '@' || *fmt == '=' || *fmt == '<' || ((*fmt == '>' || *fmt == '!') && view->itemsize == 1)) {
+        fmt++;
+    }
+    if (fmt[0] == '\0' || fmt[1] != '\0') {
+        return false;
+    }
+
+    auto kind_of = [](char code) {
+        switch (code) {
+            case 'e': case 'f': case 'd': return 'f';
+            case '?': return '?';
+            case 'c': case 'b': case 'B': case 'h': case 'H': case 'i': case 'I':
+            case 'l': case 'L': case 'q': case 'Q': case 'n': case 'N': return 'i';
+            default: return '\0';
+        }
+    };
+    char expected_kind = kind_of(expected);
+    char actual_kind = kind_of(fmt[0]);
+    if (expected_kind == '?' && actual_kind == 'i') {
+        actual_kind = '?';  // uint8 masks for _Bool*
+    }
+
+    Py_ssize_t expected_size = 0;
+    switch (expected) {
+        case 'b': case 'B': case '?': expected_size = 1; break;
+        case 'h': case 'H': expected_size = 2; break;
+        case 'i': case 'I': case 'f': expected_size = 4; break;
+        case 'q': case 'Q': case 'd': expected_size = 8; break;
+    }
+    return actual_kind != '\0' && actual_kind == expected_kind && view->itemsize == expected_size;
+}
+
+// A buffer, an int address, a capsule or None (NULL), for pointer parameters
+int jit_callable_arg_ptr(PyObject* arg, Py_ssize_t index, const char* spec, Py_buffer* view, void** out) {
+    if (arg == Py_None) {
+        *out = nullptr;
+        return 0;
+    }
+    if (PyLong_Check(arg)) {
+        void* ptr = PyLong_AsVoidPtr(arg);
+        if (!ptr && PyErr_Occurred()) return -1;
+        *out = ptr;
+        return 0;
+    }
+    if (PyCapsule_CheckExact(arg)) {
+        void* ptr = PyCapsule_GetPointer(arg, PyCapsule_GetName(arg));
+        if (!ptr) return -1;
+        *out = ptr;
+        return 0;
+    }
+    if (PyObject_CheckBuffer(arg)) {
+        // Zero-copy: C code reads and writes the object's memory for the duration of the call
+        int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (spec[1] == 'w' ? PyBUF_WRITABLE : 0);
+        if (PyObject_GetBuffer(arg, view, flags) < 0) return -1;
+        if (!buffer_format_matches(view, spec[0])) {
+            PyErr_Format(PyExc_TypeError, "argument %zd: buffer of format '%s' does not match the C pointer's "
+                         "element type '%c'", index, view->format ? view->format : "B", spec[0]);
+            PyBuffer_Release(view);
+            return -1;
+        }
+        *out = view->buf;
+        return 0;
+    }
+    PyErr_Format(PyExc_TypeError, "argument %zd must be a buffer, an int address, capsule or None, not %.100s",
+                 index, Py_TYPE(arg)->tp_name);
+    return -1;
+}
+
+void jit_callable_release_buffer(Py_buffer* view) {
+    if (view->obj) {
+        PyBuffer_Release(view);
+    }
+}
+
+int jit_callable_arg_struct(PyObject* arg, Py_ssize_t index, const char* layout, void* out) {
+    Py_ssize_t expected = layout_fields(layout);
+    if (!PyTuple_Check(arg) && !PyList_Check(arg)) {
+        PyErr_Format(PyExc_TypeError, "argument %zd must be a tuple of %zd fields, not %.100s",
+                     index, expected, Py_TYPE(arg)->tp_name);
+        return -1;
+    }
+    if (PySequence_Fast_GET_SIZE(arg) != expected) {
+        PyErr_Format(PyExc_TypeError, "argument %zd must have %zd fields, not %zd",
+                     index, expected, PySequence_Fast_GET_SIZE(arg));
+        return -1;
+    }
+    PyObject** items = PySequence_Fast_ITEMS(arg);
+    Py_ssize_t field = 0;
+    char* base = static_cast<char*>(out);
+    bool ok = for_each_field(layout, [&](char kind, size_t offset) {
+        PyObject* item = items[field++];
+        char* slot = base + offset;
+        if (kind == 'd' || kind == 'f') {
+            double value;
+            if (jit_callable_arg_f64(item, index, &value) < 0) return false;
+            if (kind == 'f') {
+                float narrow = static_cast<float>(value);
+                std::memcpy(slot, &narrow, sizeof(narrow));
+            } else {
+                std::memcpy(slot, &value, sizeof(value));
+            }
+            return true;
+        }
+        if (kind == 'p') {
+            void* ptr = item == Py_None ? nullptr : PyLong_AsVoidPtr(item);
+            if (!ptr && PyErr_Occurred()) return false;
+            std::memcpy(slot, &ptr, sizeof(ptr));
+            return true;
+        }
+        if (kind == '?') {
+            int truth = PyObject_IsTrue(item);
+            if (truth < 0) return false;
+            *slot = static_cast<char>(truth);
+            return true;
+        }
+        long long value;
+        if (jit_callable_arg_i64(item, index, &value) < 0) return false;
+        switch (kind) {
+            case 'b': case 'B': { int8_t v = static_cast<int8_t>(value); std::memcpy(slot, &v, 1); break; }
+            case 'h': case 'H': { int16_t v = static_cast<int16_t>(value); std::memcpy(slot, &v, 2); break; }
+            case 'i': case 'I': { int32_t v = static_cast<int32_t>(value); std::memcpy(slot, &v, 4); break; }
+            default: std::memcpy(slot, &value, 8); break;
+        }
+        return true;
+    });
+    return ok ? 0 : -1;
+}
+
+PyObject* jit_callable_box_struct(const void* data, const char* layout, PyObject* type) {
+    PyObject* fields = PyTuple_New(layout_fields(layout));
+    if (!fields) return nullptr;
+    Py_ssize_t field = 0;
+    bool ok = for_each_field(layout, [&](char kind, size_t offset) {
+        PyObject* item = jit_callable_box_scalar(static_cast<const char*>(data) + offset, kind);
+        if (!item) return false;
+        PyTuple_SET_ITEM(fields, field++, item);
+        return true;
+    });
+    if (!ok) {
+        Py_DECREF(fields);
+        return nullptr;
+    }
+    if (!type) {
+        return fields;
+    }
+    PyObject* result = PyObject_Call(type, fields, nullptr);
+    Py_DECREF(fields);
+    return result;
+}
+
+PyObject* jit_callable_box_scalar(const void* data, char kind) {
+    const char* slot = static_cast<const char*>(data);
+    switch (kind) {
+        case 'v': return Py_NewRef(Py_None);
+        case 'd': { double v; std::memcpy(&v, slot, 8); return PyFloat_FromDouble(v); }
+        case 'f': { float v; std::memcpy(&v, slot, 4); return PyFloat_FromDouble(v); }
+        case '?': return PyBool_FromLong(*slot != 0);
+        case 'b': { int8_t v; std::memcpy(&v, slot, 1); return PyLong_FromLong(v); }
+        case 'B': { uint8_t v; std::memcpy(&v, slot, 1); return PyLong_FromLong(v); }
+        case 'h': { int16_t v; std::memcpy(&v, slot, 2); return PyLong_FromLong(v); }
+        case 'H': { uint16_t v; std::memcpy(&v, slot, 2); return PyLong_FromLong(v); }
+        case 'i': { int32_t v; std::memcpy(&v, slot, 4); return PyLong_FromLong(v); }
+        case 'I': { uint32_t v; std::memcpy(&v, slot, 4); return PyLong_FromUnsignedLong(v); }
+        case 'Q': case 'p': { uint64_t v; std::memcpy(&v, slot, 8); return PyLong_FromUnsignedLongLong(v); }
+        default: { int64_t v; std::memcpy(&v, slot, 8); return PyLong_FromLongLong(v); }
+    }
+}
+
+void* jit_callable_save_thread() {
+    return PyEval_SaveThread();
+}
+
+void jit_callable_restore_thread(void* state) {
+    PyEval_RestoreThread(static_cast<PyThreadState*>(state));
+}
+
+// ============================================================================
+// Caller-allocated Buffer Views
+// ============================================================================
+int jit_view_open(PyObject* obj, JitView* view, char kind, int writable) {
+    view->data = nullptr;
+    view->len = 0;
+    view->itemsize = 0;
+    view->view.obj = nullptr;
+    int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+    if (get_array_buffer(obj, &view->view, flags) < 0) {
+        view->view.obj = nullptr;
+        return -1;
+    }
+    if (!buffer_format_matches(&view->view, kind)) {
+        PyErr_Format(PyExc_TypeError, "buffer of format '%s' does not match the element type '%c'",
+                     view->view.format ? view->view.format : "B", kind);
+        PyBuffer_Release(&view->view);
+        view->view.obj = nullptr;
+        return -1;
+    }
+    view->data = view->view.buf;
+    view->itemsize = view->view.itemsize;
+    view->len = view->view.itemsize ? view->view.len / view->view.itemsize : 0;
+    return 0;
+}
+
+int jit_view_open_n(PyObject* const* objs, JitView* views, const char* kinds, Py_ssize_t n, int writable) {
+    for (Py_ssize_t i = 0; i < n; i++) {
+        if (jit_view_open(objs[i], &views[i], kinds ? kinds[i] : 'v', writable) < 0) {
+            while (i-- > 0) {
+                jit_view_close(&views[i]);
+            }
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void jit_view_close(JitView* view) {
+    if (view->view.obj) {
+        PyBuffer_Release(&view->view);
+        view->view.obj = nullptr;
+    }
+    view->data = nullptr;
+    view->len = 0;
+}
+
 } // extern "C"
 
@@ -5,7 +5,7 @@
  * - ScopeGuard: Generic cleanup on scope exit
  * - GILGuard/GILRelease: Python GIL management
  * - PyObjectPtr: Python object lifetime management
- * - NumpyBuffer: Zero-copy NumPy array access
+ * - NumpyBuffer: Zero-copy array access (buffer protocol, __array_interface__, DLPack)
  * - Type converters: Python <-> C type conversion
  */
 
@@ -154,6 +154,29 @@ private:
     PyObject* ptr_;
 };
 
+// ============================================================================
+// Array interfaces beyond the buffer protocol
+// ============================================================================
+// PyObject_GetBuffer that also accepts objects without the buffer protocol
+// that describe CPU memory through __array_interface__ (version 3, data
+// given as an address) or __dlpack__ (PyTorch CPU tensors, JAX arrays). The
+// view is filled in place without copying; its `obj` owns the producer's
+// memory (and the shape/strides/format storage) until PyBuffer_Release.
+// Returns -1 with an exception set, like PyObject_GetBuffer.
+int get_array_buffer(PyObject* obj, Py_buffer* view, int flags);
+
+// Whether get_array_buffer can try `obj`: it has the buffer protocol,
+// __array_interface__, __dlpack__ or __arrow_c_array__
+bool is_array_like(PyObject* obj);
+
+// A primitive Arrow array exported through __arrow_c_array__: `values` views
+// its data buffer (offset applied) and `validity` its null bitmap, whose
+// bit 0 is the first row. `validity->obj` is left NULL when the array has
+// no nulls. Both views keep the exported array alive. Returns -1 with an
+// exception set (non-primitive types, or nulls at a bit offset not a
+// multiple of 8).
+int get_arrow_column(PyObject* obj, Py_buffer* values, Py_buffer* validity);
+
 // ============================================================================
 // NumpyBuffer - Zero-copy access to NumPy array data via buffer protocol
 // ============================================================================
@@ -165,7 +188,7 @@ public:
     
     explicit NumpyBuffer(PyObject* arr) noexcept : valid_(false) {
         view_.obj = nullptr;
-        if (PyObject_GetBuffer(arr, &view_, PyBUF_STRIDES | PyBUF_FORMAT) == 0) {
+        if (get_array_buffer(arr, &view_, PyBUF_STRIDES | PyBUF_FORMAT) == 0) {
             valid_ = true;
         }
     }
@@ -176,6 +199,14 @@ public:
         }
     }
     
+    // Take over a view already filled by get_array_buffer or get_arrow_column
+    static NumpyBuffer adopt(const Py_buffer& view) noexcept {
+        NumpyBuffer buffer;
+        buffer.view_ = view;
+        buffer.valid_ = view.obj != nullptr;
+        return buffer;
+    }
+    
     // Move semantics
     NumpyBuffer(NumpyBuffer&& other) noexcept 
         : view_(other.view_), valid_(other.valid_) {
@@ -208,6 +239,7 @@ public:
     Py_ssize_t* strides() const noexcept { return view_.strides; }
     const char* format() const noexcept { return view_.format; }
     bool readonly() const noexcept { return view_.readonly != 0; }
+    bool c_contiguous() const noexcept { return valid_ && PyBuffer_IsContiguous(&view_, 'C'); }
     
     // Typed access
     template<typename T>
@@ -271,6 +303,21 @@ inline PyObject* bool_to_py(bool val) {
   #define JIT_EXPORT __attribute__((visibility("default")))
 #endif
 
+// Caller-allocated buffer view, JitView in the inline C prelude: the
+// Py_buffer is filled in place in the caller's storage (usually the stack),
+// so opening one allocates nothing. data/len/itemsize are set by
+// jit_view_open; storage mirrors the prelude's opaque void* view[12].
+struct JitView {
+    void* data;          // Element pointer, NULL when closed or the open failed
+    long long len;       // Element count
+    long long itemsize;
+    union {
+        Py_buffer view;
+        void* storage[12];
+    };
+};
+static_assert(sizeof(Py_buffer) <= sizeof(void*[12]), "JitView storage too small for Py_buffer");
+
 extern "C" {
     // GIL management
     JIT_EXPORT void* jit_gil_acquire();
@@ -375,6 +422,9 @@ JIT_EXPORT PyObject* jit_call2(PyObject* func, PyObject* arg1, PyObject* arg2);
 // Call Python function with 3 arguments
 JIT_EXPORT PyObject* jit_call3(PyObject* func, PyObject* arg1, PyObject* arg2, PyObject* arg3);
 
+// Call Python function with n arguments from a C array (vectorcall, no tuple)
+JIT_EXPORT PyObject* jit_call_vec(PyObject* func, PyObject* const* args, Py_ssize_t n);
+
 // Call method with 1 argument
 JIT_EXPORT PyObject* jit_call_method1(PyObject* obj, const char* method, PyObject* arg);
 
@@ -407,6 +457,47 @@ JIT_EXPORT Py_ssize_t jit_bytes_len(PyObject* bytes);
 JIT_EXPORT PyObject* jit_py_eval(const char* expr, PyObject* locals);
 JIT_EXPORT PyObject* jit_py_exec(const char* code, PyObject* locals);
 
+// JITCallable argument conversion, called from the vectorcall trampolines
+// inline C functions get. Store the C value of args[index] in *out and
+// return 0, or set TypeError/OverflowError and return -1.
+JIT_EXPORT int jit_callable_arg_i64(PyObject* arg, Py_ssize_t index, long long* out);
+JIT_EXPORT int jit_callable_arg_f64(PyObject* arg, Py_ssize_t index, double* out);
+
+// Pointer parameters also take buffer-protocol objects: the C-contiguous view
+// is acquired into *view (writable unless the pointee is const) and checked
+// against spec, "<format><r|w>" for the pointee (see param_buffer_spec).
+// The trampoline zeroes every view up front and releases them all after the
+// call or on a failed conversion.
+JIT_EXPORT int jit_callable_arg_ptr(PyObject* arg, Py_ssize_t index, const char* spec,
+                                    Py_buffer* view, void** out);
+JIT_EXPORT void jit_callable_release_buffer(Py_buffer* view);
+
+// Struct parameters and results of the clang-generated __jit_vcall_<name>
+// shims. layout is "<kind><offset>,..." for a struct of scalar fields.
+// arg_struct fills *out from a tuple (or list) with one item per field;
+// box_struct returns the fields as a tuple, or type(*fields) when type is
+// non-NULL (the namedtuple made for the C struct). box_scalar boxes one
+// value of that kind ('v' for None).
+JIT_EXPORT int jit_callable_arg_struct(PyObject* arg, Py_ssize_t index, const char* layout, void* out);
+JIT_EXPORT PyObject* jit_callable_box_struct(const void* data, const char* layout, PyObject* type);
+JIT_EXPORT PyObject* jit_callable_box_scalar(const void* data, char kind);
+// PyEval_SaveThread/RestoreThread for shims, which can't declare Python's own
+// prototypes without clashing with a user #include <Python.h>
+JIT_EXPORT void* jit_callable_save_thread();
+JIT_EXPORT void jit_callable_restore_thread(void* state);
+
+// Open a C-contiguous view of obj into caller storage, checking its format
+// against kind ('d', 'f', 'q', 'i', 'B', ... as in jit_callable_arg_ptr,
+// 'v' for any) once, here, rather than on each access. Writable unless
+// writable is 0. Returns 0, or -1 with a Python exception set and
+// view->data NULL; jit_view_close is safe either way.
+JIT_EXPORT int jit_view_open(PyObject* obj, JitView* view, char kind, int writable);
+// Open n views at once (kinds may be NULL for 'v'); on failure the views
+// opened so far are closed again
+JIT_EXPORT int jit_view_open_n(PyObject* const* objs, JitView* views, const char* kinds, Py_ssize_t n,
+                               int writable);
+JIT_EXPORT void jit_view_close(JitView* view);
+
 } // extern "C"
 
 } // namespace justjit
@@ -0,0 +1,253 @@
+"""
+Build the copy-and-patch stencils of the baseline tier (tiered='baseline').
+
+Compiles tier0_stencils.c with clang into one relocatable object, one
+section per stencil (-ffunction-sections), and writes a C++ header holding
+each stencil's machine code and its holes: the offsets of the 64-bit
+absolute relocations the runtime fills in when it copies the stencil
+(jit_core.cpp, compile_baseline). Relocations against the _JIT_* symbols
+take the instruction's values; any other symbol is written as the address
+of that C-API function or object; read-only data a stencil refers to is
+appended to its code.
+
+Stencils are built for x86-64 ELF only (-mcmodel=large makes every
+reference a 64-bit absolute address). Anything else - no clang, another
+target, an unexpected relocation - writes a header without stencils, and
+the baseline tier is reported unavailable.
+
+    build_stencils.py --clang CLANG --output HEADER [-I DIR ...]
+"""
+
+import argparse
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+SOURCE = os.path.join(HERE, "tier0_stencils.c")
+
+CFLAGS = [
+    "-c", "-O3", "-std=c11", "-DNDEBUG", "--target=x86_64-unknown-linux-gnu",
+    "-fno-pic", "-mcmodel=large", "-ffunction-sections", "-fno-asynchronous-unwind-tables",
+    "-fno-unwind-tables", "-fno-stack-protector", "-fno-jump-tables", "-fcf-protection=none",
+    "-fomit-frame-pointer", "-fno-plt",
+]
+
+PREFIX = ".text.tier0_"
+HOLES = {
+    "_JIT_OPARG": "HOLE_OPARG",
+    "_JIT_OPERAND": "HOLE_OPERAND",
+    "_JIT_CONTINUE": "HOLE_CONTINUE",
+    "_JIT_JUMP_TARGET": "HOLE_JUMP_TARGET",
+}
+
+EM_X86_64 = 62
+SHT_RELA = 4
+SHT_NOBITS = 8
+SHT_SYMTAB = 2
+STT_SECTION = 3
+SHN_UNDEF = 0
+R_X86_64_64 = 1
+
+
+class StencilError(Exception):
+    pass
+
+
+def _sections(data):
+    if data[:4] != b"\x7fELF" or data[4] != 2 or data[5] != 1:
+        raise StencilError("not a 64-bit little-endian ELF object")
+    machine = struct.unpack_from("<H", data, 18)[0]
+    if machine != EM_X86_64:
+        raise StencilError(f"ELF machine {machine} is not x86-64")
+    shoff = struct.unpack_from("<Q", data, 40)[0]
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 58)
+    sections = []
+    for i in range(shnum):
+        name, kind, flags, _, offset, size, link, info, align, entsize = struct.unpack_from(
+            "<IIQQQQIIQQ", data, shoff + i * shentsize)
+        body = b"" if kind == SHT_NOBITS else data[offset:offset + size]
+        sections.append({"name": name, "type": kind, "flags": flags, "data": body, "link": link,
+                         "info": info, "align": max(align, 1), "entsize": entsize})
+    names = sections[shstrndx]["data"]
+    for section in sections:
+        section["name"] = _cstring(names, section["name"])
+    return sections
+
+
+def _cstring(table, offset):
+    return table[offset:table.index(b"\0", offset)].decode()
+
+
+def _symbols(sections):
+    symtab = next(s for s in sections if s["type"] == SHT_SYMTAB)
+    strings = sections[symtab["link"]]["data"]
+    symbols = []
+    for pos in range(0, len(symtab["data"]), 24):
+        name, info, _, shndx, value, _ = struct.unpack_from("<IBBHQQ", symtab["data"], pos)
+        symbols.append({"name": _cstring(strings, name), "type": info & 0xF, "shndx": shndx, "value": value})
+    return symbols
+
+
+def _align(size, alignment):
+    return (size + alignment - 1) // alignment * alignment
+
+
+def extract(data):
+    """{stencil name: (code bytes, alignment, [(offset, kind, addend, symbol)])} of an object file."""
+    sections = _sections(data)
+    symbols = _symbols(sections)
+    relocations = {s["info"]: s for s in sections if s["type"] == SHT_RELA}
+    stencils = {}
+    for index, section in enumerate(sections):
+        if not section["name"].startswith(PREFIX):
+            continue
+        name = section["name"][len(PREFIX):]
+        code = bytearray(section["data"])
+        alignment = 1
+        appended = {}  # Data section index -> its offset in the stencil
+        holes = []
+        rela = relocations.get(index)
+        entries = rela["data"] if rela else b""
+        for pos in range(0, len(entries), 24):
+            offset, info, addend = struct.unpack_from("<QQq", entries, pos)
+            kind = info & 0xFFFFFFFF
+            symbol = symbols[info >> 32]
+            if kind != R_X86_64_64:
+                raise StencilError(f"{name}: relocation type {kind} at {offset:#x}")
+            if symbol["shndx"] == SHN_UNDEF:
+                if symbol["name"] in HOLES:
+                    holes.append((offset, HOLES[symbol["name"]], addend, None))
+                elif symbol["name"].startswith("_JIT_"):
+                    raise StencilError(f"{name}: unknown hole {symbol['name']}")
+                else:
+                    holes.append((offset, "HOLE_SYMBOL", addend, symbol["name"]))
+                continue
+            target = sections[symbol["shndx"]]
+            if not target["name"].startswith(".rodata") or symbol["shndx"] in relocations:
+                raise StencilError(f"{name}: reference to {target['name']}")
+            if symbol["shndx"] not in appended:
+                start = _align(len(code), target["align"])
+                code.extend(b"\xcc" * (start - len(code)))
+                appended[symbol["shndx"]] = start
+                code.extend(target["data"])
+                alignment = max(alignment, target["align"])
+            value = symbol["value"] if symbol["type"] != STT_SECTION else 0
+            holes.append((offset, "HOLE_CODE", appended[symbol["shndx"]] + value + addend, None))
+        stencils[name] = (bytes(code), alignment, sorted(holes))
+    if "ENTRY" not in stencils:
+        raise StencilError("no ENTRY stencil")
+    return stencils
+
+
+def render(stencils):
+    lines = [
+        "// Generated by src/stencils/build_stencils.py from tier0_stencils.c. Do not edit.",
+        "#pragma once",
+        "",
+        "#include <cstddef>",
+        "#include <cstdint>",
+        "",
+        "#define JUSTJIT_HAS_STENCILS 1",
+        "",
+        "namespace justjit::stencils",
+        "{",
+        "    enum HoleKind",
+        "    {",
+        "        HOLE_OPARG,",
+        "        HOLE_OPERAND,",
+        "        HOLE_CONTINUE,",
+        "        HOLE_JUMP_TARGET,",
+        "        HOLE_CODE,   // The stencil's own copy, plus the addend",
+        "        HOLE_SYMBOL, // `symbol`, plus the addend",
+        "    };",
+        "",
+        "    struct Hole",
+        "    {",
+        "        uint32_t offset; // Of a 64-bit little-endian address in the code",
+        "        HoleKind kind;",
+        "        int64_t addend;",
+        "        const void *symbol;",
+        "    };",
+        "",
+        "    struct Stencil",
+        "    {",
+        "        const unsigned char *code;",
+        "        size_t size;",
+        "        size_t alignment;",
+        "        const Hole *holes;",
+        "        size_t hole_count;",
+        "    };",
+    ]
+    for name, (code, alignment, holes) in sorted(stencils.items()):
+        lines.append("")
+        lines.append(f"    static const unsigned char {name}_code[] = {{")
+        for start in range(0, len(code), 16):
+            lines.append("        " + " ".join(f"0x{byte:02x}," for byte in code[start:start + 16]))
+        lines.append("    };")
+        if holes:
+            lines.append(f"    static const Hole {name}_holes[] = {{")
+            for offset, kind, addend, symbol in holes:
+                target = f"reinterpret_cast<const void *>(&{symbol})" if symbol else "nullptr"
+                lines.append(f"        {{{offset:#x}, {kind}, {addend}, {target}}},")
+            lines.append("    };")
+            lines.append(f"    static const Stencil {name} = {{{name}_code, sizeof({name}_code), {alignment}, "
+                         f"{name}_holes, {len(holes)}}};")
+        else:
+            lines.append(f"    static const Stencil {name} = {{{name}_code, sizeof({name}_code), {alignment}, nullptr, 0}};")
+    lines.append("} // namespace justjit::stencils")
+    return "\n".join(lines) + "\n"
+
+
+def render_unavailable(reason):
+    return (
+        "// Generated by src/stencils/build_stencils.py: no stencils in this build\n"
+        f"// ({reason})\n"
+        "#pragma once\n"
+        "\n"
+        "#define JUSTJIT_HAS_STENCILS 0\n"
+    )
+
+
+def build(clang, includes):
+    with tempfile.TemporaryDirectory() as tmp:
+        obj = os.path.join(tmp, "tier0_stencils.o")
+        command = [clang, *CFLAGS, *(f"-I{path}" for path in includes), f"-I{os.path.dirname(HERE)}",
+                   SOURCE, "-o", obj]
+        result = subprocess.run(command, capture_output=True, text=True)
+        if result.returncode != 0:
+            raise StencilError("clang failed:\n" + result.stderr)
+        with open(obj, "rb") as f:
+            return extract(f.read())
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument("--clang", default="", help="clang executable (empty: no stencils)")
+    parser.add_argument("--machine", default="", help="Target processor, e.g. CMAKE_SYSTEM_PROCESSOR")
+    parser.add_argument("--output", required=True)
+    parser.add_argument("-I", dest="includes", action="append", default=[])
+    args = parser.parse_args(argv)
+
+    if not args.clang or args.clang.endswith("NOTFOUND"):
+        header = render_unavailable("clang not found")
+    elif args.machine and args.machine.lower() not in ("x86_64", "amd64"):
+        header = render_unavailable(f"stencils are x86-64 only, not {args.machine}")
+    elif not sys.platform.startswith("linux"):
+        header = render_unavailable(f"stencils are ELF only, not {sys.platform}")
+    else:
+        try:
+            header = render(build(args.clang, args.includes))
+        except (OSError, StencilError) as exc:
+            print(f"build_stencils.py: baseline tier disabled: {exc}", file=sys.stderr)
+            header = render_unavailable(str(exc).splitlines()[0])
+
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, "w") as f:
+        f.write(header)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,626 @@
+// Stencils of the baseline tier: one machine-code template per supported
+// object-mode opcode, compiled by build_stencils.py with clang into
+// justjit_stencils.h. The runtime (compile_baseline in jit_core.cpp) copies
+// one stencil per instruction and patches its holes, the _JIT_* symbols:
+//
+//   _JIT_OPARG        the instruction's argument, as a number
+//   _JIT_OPERAND      a pointer: a constant, a name, a LOAD_GLOBAL cache, ...
+//   _JIT_CONTINUE     the next instruction's stencil
+//   _JIT_JUMP_TARGET  the jump target's stencil
+//
+// Every stencil takes the frame and the stack pointer and ends by
+// tail-calling the next one (musttail, so a loop does not grow the C
+// stack), by returning the function's result, or by tail-calling
+// jit_tier0_unwind with the error set. The stack pointer passed on is always
+// one past the top of the live stack, so the unwind releases exactly those
+// values.
+//
+// The value holes are declared weak: the compiler would otherwise take the
+// address of an external symbol to be non-NULL and drop the checks an
+// argument of 0 needs (BUILD_TUPLE 0, CALL 0).
+
+#include "tier0.h"
+
+#include <stdint.h>
+
+extern char _JIT_OPARG[] __attribute__((weak));
+extern char _JIT_OPERAND[] __attribute__((weak));
+extern PyObject *_JIT_CONTINUE(Tier0Frame *frame, PyObject **sp);
+extern PyObject *_JIT_JUMP_TARGET(Tier0Frame *frame, PyObject **sp);
+
+#define OPARG ((Py_ssize_t)(uintptr_t)_JIT_OPARG)
+#define OPERAND ((PyObject *)_JIT_OPERAND)
+
+#define STENCIL(NAME) PyObject *tier0_##NAME(Tier0Frame *frame, PyObject **sp)
+#define CONTINUE() __attribute__((musttail)) return _JIT_CONTINUE(frame, sp)
+#define JUMP() __attribute__((musttail)) return _JIT_JUMP_TARGET(frame, sp)
+#define ERROR() __attribute__((musttail)) return jit_tier0_unwind(frame, sp)
+
+// The function's entry point (a JITEntryFunc); _JIT_CONTINUE is its first instruction
+PyObject *tier0_ENTRY(PyObject *const *args, Py_ssize_t nargs)
+{
+    return jit_tier0_run(args, nargs, (const Tier0Code *)_JIT_OPERAND, _JIT_CONTINUE);
+}
+
+// ----- Locals and constants -----
+
+STENCIL(LOAD_FAST)
+{
+    *sp++ = Py_NewRef(frame->locals[OPARG]);
+    CONTINUE();
+}
+
+STENCIL(LOAD_FAST_CHECK)
+{
+    PyObject *value = frame->locals[OPARG];
+    if (value == NULL)
+    {
+        jit_tier0_unbound_local(OPERAND);
+        ERROR();
+    }
+    *sp++ = Py_NewRef(value);
+    CONTINUE();
+}
+
+STENCIL(LOAD_FAST_AND_CLEAR)
+{
+    *sp++ = frame->locals[OPARG];
+    frame->locals[OPARG] = NULL;
+    CONTINUE();
+}
+
+STENCIL(LOAD_FAST_LOAD_FAST)
+{
+    *sp++ = Py_NewRef(frame->locals[OPARG >> 4]);
+    *sp++ = Py_NewRef(frame->locals[OPARG & 15]);
+    CONTINUE();
+}
+
+STENCIL(STORE_FAST)
+{
+    PyObject *old = frame->locals[OPARG];
+    frame->locals[OPARG] = *--sp;
+    Py_XDECREF(old);
+    CONTINUE();
+}
+
+STENCIL(STORE_FAST_LOAD_FAST)
+{
+    PyObject *old = frame->locals[OPARG >> 4];
+    frame->locals[OPARG >> 4] = sp[-1];
+    Py_XDECREF(old);
+    sp[-1] = Py_NewRef(frame->locals[OPARG & 15]);
+    CONTINUE();
+}
+
+STENCIL(STORE_FAST_STORE_FAST)
+{
+    PyObject *old = frame->locals[OPARG >> 4];
+    frame->locals[OPARG >> 4] = *--sp;
+    Py_XDECREF(old);
+    old = frame->locals[OPARG & 15];
+    frame->locals[OPARG & 15] = *--sp;
+    Py_XDECREF(old);
+    CONTINUE();
+}
+
+STENCIL(LOAD_CONST)
+{
+    *sp++ = Py_NewRef(OPERAND);
+    CONTINUE();
+}
+
+STENCIL(LOAD_GLOBAL)
+{
+    PyObject *value = *(PyObject **)_JIT_OPERAND;
+    if (value == NULL)
+    {
+        value = jit_tier0_load_global(_JIT_OPERAND);
+        if (value == NULL)
+        {
+            ERROR();
+        }
+    }
+    *sp++ = Py_NewRef(value);
+    if (OPARG & 1)
+    {
+        *sp++ = NULL;
+    }
+    CONTINUE();
+}
+
+// ----- Stack -----
+
+STENCIL(POP_TOP)
+{
+    Py_DECREF(*--sp);
+    CONTINUE();
+}
+
+STENCIL(PUSH_NULL)
+{
+    *sp++ = NULL;
+    CONTINUE();
+}
+
+STENCIL(COPY)
+{
+    PyObject *value = sp[-OPARG];
+    *sp++ = Py_NewRef(value);
+    CONTINUE();
+}
+
+STENCIL(SWAP)
+{
+    PyObject *top = sp[-1];
+    sp[-1] = sp[-OPARG];
+    sp[-OPARG] = top;
+    CONTINUE();
+}
+
+// ----- Operators -----
+
+STENCIL(BINARY_OP)
+{
+    PyObject *lhs = sp[-2];
+    PyObject *rhs = sp[-1];
+    PyObject *result = ((binaryfunc)_JIT_OPERAND)(lhs, rhs);
+    Py_DECREF(lhs);
+    Py_DECREF(rhs);
+    sp -= 2;
+    if (result == NULL)
+    {
+        ERROR();
+    }
+    *sp++ = result;
+    CONTINUE();
+}
+
+STENCIL(BINARY_SUBSCR)
+{
+    PyObject *container = sp[-2];
+    PyObject *sub = sp[-1];
+    PyObject *result = PyObject_GetItem(container, sub);
+    Py_DECREF(container);
+    Py_DECREF(sub);
+    sp -= 2;
+    if (result == NULL)
+    {
+        ERROR();
+    }
+    *sp++ = result;
+    CONTINUE();
+}
+
+STENCIL(STORE_SUBSCR)
+{
+    PyObject *value = sp[-3];
+    PyObject *container = sp[-2];
+    PyObject *sub = sp[-1];
+    int err = PyObject_SetItem(container, sub, value);
+    Py_DECREF(value);
+    Py_DECREF(container);
+    Py_DECREF(sub);
+    sp -= 3;
+    if (err < 0)
+    {
+        ERROR();
+    }
+    CONTINUE();
+}
+
+// Argument: the rich comparison in the bits above 5; bit 4 asks for a bool
+STENCIL(COMPARE_OP)
+{
+    PyObject *lhs = sp[-2];
+    PyObject *rhs = sp[-1];
+    PyObject *result = PyObject_RichCompare(lhs, rhs, (int)(OPARG >> 5));
+    Py_DECREF(lhs);
+    Py_DECREF(rhs);
+    sp -= 2;
+    if (result == NULL)
+    {
+        ERROR();
+    }
+    if (OPARG & 16)
+    {
+        int truth = PyObject_IsTrue(result);
+        Py_DECREF(result);
+        if (truth < 0)
+        {
+            ERROR();
+        }
+        result = truth ? Py_True : Py_False;
+    }
+    *sp++ = result;
+    CONTINUE();
+}
+
+STENCIL(CONTAINS_OP)
+{
+    PyObject *item = sp[-2];
+    PyObject *container = sp[-1];
+    int found = PySequence_Contains(container, item);
+    Py_DECREF(item);
+    Py_DECREF(container);
+    sp -= 2;
+    if (found < 0)
+    {
+        ERROR();
+    }
+    *sp++ = (found ^ (int)(OPARG & 1)) ? Py_True : Py_False;
+    CONTINUE();
+}
+
+STENCIL(IS_OP)
+{
+    PyObject *lhs = sp[-2];
+    PyObject *rhs = sp[-1];
+    int same = lhs == rhs;
+    Py_DECREF(lhs);
+    Py_DECREF(rhs);
+    sp -= 2;
+    *sp++ = (same ^ (int)(OPARG & 1)) ? Py_True : Py_False;
+    CONTINUE();
+}
+
+STENCIL(UNARY_NEGATIVE)
+{
+    PyObject *value = sp[-1];
+    PyObject *result = PyNumber_Negative(value);
+    Py_DECREF(value);
+    if (result == NULL)
+    {
+        --sp;
+        ERROR();
+    }
+    sp[-1] = result;
+    CONTINUE();
+}
+
+STENCIL(UNARY_INVERT)
+{
+    PyObject *value = sp[-1];
+    PyObject *result = PyNumber_Invert(value);
+    Py_DECREF(value);
+    if (result == NULL)
+    {
+        --sp;
+        ERROR();
+    }
+    sp[-1] = result;
+    CONTINUE();
+}
+
+// The operand is always a bool (TO_BOOL comes first)
+STENCIL(UNARY_NOT)
+{
+    sp[-1] = sp[-1] == Py_True ? Py_False : Py_True;
+    CONTINUE();
+}
+
+STENCIL(TO_BOOL)
+{
+    PyObject *value = sp[-1];
+    int truth = PyObject_IsTrue(value);
+    Py_DECREF(value);
+    if (truth < 0)
+    {
+        --sp;
+        ERROR();
+    }
+    sp[-1] = truth ? Py_True : Py_False;
+    CONTINUE();
+}
+
+// ----- Control flow -----
+
+// Also JUMP_BACKWARD and JUMP_BACKWARD_NO_INTERRUPT
+STENCIL(JUMP_FORWARD)
+{
+    JUMP();
+}
+
+STENCIL(POP_JUMP_IF_TRUE)
+{
+    PyObject *cond = *--sp;
+    int truth = cond == Py_True ? 1 : cond == Py_False ? 0 : PyObject_IsTrue(cond);
+    Py_DECREF(cond);
+    if (truth < 0)
+    {
+        ERROR();
+    }
+    if (truth)
+    {
+        JUMP();
+    }
+    CONTINUE();
+}
+
+STENCIL(POP_JUMP_IF_FALSE)
+{
+    PyObject *cond = *--sp;
+    int truth = cond == Py_True ? 1 : cond == Py_False ? 0 : PyObject_IsTrue(cond);
+    Py_DECREF(cond);
+    if (truth < 0)
+    {
+        ERROR();
+    }
+    if (!truth)
+    {
+        JUMP();
+    }
+    CONTINUE();
+}
+
+STENCIL(POP_JUMP_IF_NONE)
+{
+    PyObject *value = *--sp;
+    Py_DECREF(value);
+    if (value == Py_None)
+    {
+        JUMP();
+    }
+    CONTINUE();
+}
+
+STENCIL(POP_JUMP_IF_NOT_NONE)
+{
+    PyObject *value = *--sp;
+    Py_DECREF(value);
+    if (value != Py_None)
+    {
+        JUMP();
+    }
+    CONTINUE();
+}
+
+STENCIL(GET_ITER)
+{
+    PyObject *iterable = sp[-1];
+    PyObject *iter = PyObject_GetIter(iterable);
+    Py_DECREF(iterable);
+    if (iter == NULL)
+    {
+        --sp;
+        ERROR();
+    }
+    sp[-1] = iter;
+    CONTINUE();
+}
+
+// Exhausted: pops the iterator and jumps past the loop's END_FOR and POP_TOP
+STENCIL(FOR_ITER)
+{
+    PyObject *iter = sp[-1];
+    PyObject *next = Py_TYPE(iter)->tp_iternext(iter);
+    if (next != NULL)
+    {
+        *sp++ = next;
+        CONTINUE();
+    }
+    if (jit_tier0_iter_error() < 0)
+    {
+        ERROR();
+    }
+    Py_DECREF(iter);
+    --sp;
+    JUMP();
+}
+
+STENCIL(RETURN_VALUE)
+{
+    (void)frame;
+    return *--sp;
+}
+
+STENCIL(RETURN_CONST)
+{
+    (void)frame;
+    (void)sp;
+    return Py_NewRef(OPERAND);
+}
+
+STENCIL(RAISE_VARARGS)
+{
+    PyObject *exc = *--sp;
+    jit_tier0_raise(exc, NULL);
+    Py_DECREF(exc);
+    ERROR();
+}
+
+STENCIL(RAISE_VARARGS_CAUSE)
+{
+    PyObject *cause = *--sp;
+    PyObject *exc = *--sp;
+    jit_tier0_raise(exc, cause);
+    Py_DECREF(exc);
+    Py_DECREF(cause);
+    ERROR();
+}
+
+// ----- Attributes and calls -----
+
+// The method form (bit 0) pushes the bound attribute and NULL for CALL
+STENCIL(LOAD_ATTR)
+{
+    PyObject *owner = sp[-1];
+    PyObject *attr = PyObject_GetAttr(owner, OPERAND);
+    Py_DECREF(owner);
+    if (attr == NULL)
+    {
+        --sp;
+        ERROR();
+    }
+    sp[-1] = attr;
+    if (OPARG & 1)
+    {
+        *sp++ = NULL;
+    }
+    CONTINUE();
+}
+
+STENCIL(STORE_ATTR)
+{
+    PyObject *value = sp[-2];
+    PyObject *owner = sp[-1];
+    int err = PyObject_SetAttr(owner, OPERAND, value);
+    Py_DECREF(value);
+    Py_DECREF(owner);
+    sp -= 2;
+    if (err < 0)
+    {
+        ERROR();
+    }
+    CONTINUE();
+}
+
+// Stack: callable, self or NULL, then OPARG arguments
+STENCIL(CALL)
+{
+    PyObject **args = sp - OPARG;
+    PyObject *callable = args[-2];
+    PyObject *self = args[-1];
+    Py_ssize_t total = OPARG;
+    if (self != NULL)
+    {
+        --args;
+        ++total;
+    }
+    PyObject *result = PyObject_Vectorcall(callable, args, (size_t)total | PY_VECTORCALL_ARGUMENTS_OFFSET, NULL);
+    for (Py_ssize_t i = 0; i < total; ++i)
+    {
+        Py_DECREF(args[i]);
+    }
+    Py_DECREF(callable);
+    sp -= OPARG + 2;
+    if (result == NULL)
+    {
+        ERROR();
+    }
+    *sp++ = result;
+    CONTINUE();
+}
+
+// ----- Containers and strings -----
+
+STENCIL(BUILD_TUPLE)
+{
+    PyObject *tuple = PyTuple_New(OPARG);
+    if (tuple == NULL)
+    {
+        ERROR();
+    }
+    sp -= OPARG;
+    for (Py_ssize_t i = 0; i < OPARG; ++i)
+    {
+        PyTuple_SET_ITEM(tuple, i, sp[i]);
+    }
+    *sp++ = tuple;
+    CONTINUE();
+}
+
+STENCIL(BUILD_LIST)
+{
+    PyObject *list = PyList_New(OPARG);
+    if (list == NULL)
+    {
+        ERROR();
+    }
+    sp -= OPARG;
+    for (Py_ssize_t i = 0; i < OPARG; ++i)
+    {
+        PyList_SET_ITEM(list, i, sp[i]);
+    }
+    *sp++ = list;
+    CONTINUE();
+}
+
+STENCIL(LIST_APPEND)
+{
+    PyObject *value = *--sp;
+    int err = PyList_Append(sp[-OPARG], value);
+    Py_DECREF(value);
+    if (err < 0)
+    {
+        ERROR();
+    }
+    CONTINUE();
+}
+
+STENCIL(UNPACK_SEQUENCE)
+{
+    PyObject *seq = *--sp;
+    int err = jit_tier0_unpack(seq, OPARG, sp);
+    Py_DECREF(seq);
+    if (err < 0)
+    {
+        ERROR();
+    }
+    sp += OPARG;
+    CONTINUE();
+}
+
+STENCIL(FORMAT_SIMPLE)
+{
+    PyObject *value = sp[-1];
+    if (!PyUnicode_CheckExact(value))
+    {
+        PyObject *text = PyObject_Format(value, NULL);
+        Py_DECREF(value);
+        if (text == NULL)
+        {
+            --sp;
+            ERROR();
+        }
+        sp[-1] = text;
+    }
+    CONTINUE();
+}
+
+// Argument: 1 str(), 2 repr(), 3 ascii()
+STENCIL(CONVERT_VALUE)
+{
+    PyObject *value = sp[-1];
+    PyObject *result = OPARG == 1 ? PyObject_Str(value) : OPARG == 2 ? PyObject_Repr(value) : PyObject_ASCII(value);
+    Py_DECREF(value);
+    if (result == NULL)
+    {
+        --sp;
+        ERROR();
+    }
+    sp[-1] = result;
+    CONTINUE();
+}
+
+STENCIL(FORMAT_WITH_SPEC)
+{
+    PyObject *value = sp[-2];
+    PyObject *spec = sp[-1];
+    PyObject *text = PyObject_Format(value, spec);
+    Py_DECREF(value);
+    Py_DECREF(spec);
+    sp -= 2;
+    if (text == NULL)
+    {
+        ERROR();
+    }
+    *sp++ = text;
+    CONTINUE();
+}
+
+STENCIL(BUILD_STRING)
+{
+    PyObject *text = jit_tier0_build_string(sp - OPARG, OPARG);
+    for (Py_ssize_t i = 1; i <= OPARG; ++i)
+    {
+        Py_DECREF(sp[-i]);
+    }
+    sp -= OPARG;
+    if (text == NULL)
+    {
+        ERROR();
+    }
+    *sp++ = text;
+    CONTINUE();
+}
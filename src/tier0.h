@@ -0,0 +1,58 @@
+#pragma once
+
+// Baseline tier (copy-and-patch): the frame layout and runtime helpers shared
+// by the stencils (src/stencils/tier0_stencils.c, compiled by clang at build
+// time) and the runtime that copies and patches them (jit_core.cpp). Plain C,
+// so both sides see one definition.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // What a function's entry stencil hands jit_tier0_run
+    typedef struct Tier0Code
+    {
+        Py_ssize_t nlocals;
+        Py_ssize_t stack_size; // co_stacksize
+    } Tier0Code;
+
+    // One call's locals and value stack. Stencils take the frame and the stack
+    // pointer (one past the top) and tail-call the next instruction's stencil.
+    typedef struct Tier0Frame
+    {
+        const Tier0Code *code;
+        PyObject **locals;
+        PyObject **stack; // Bottom of the value stack
+    } Tier0Frame;
+
+    typedef PyObject *(*Tier0Op)(Tier0Frame *frame, PyObject **sp);
+
+    // Sets up the frame, runs `body` (the first instruction's stencil), then
+    // releases the locals
+    PyObject *jit_tier0_run(PyObject *const *args, Py_ssize_t nargs, const Tier0Code *code, Tier0Op body);
+
+    // Error exit of every stencil: releases the value stack and returns NULL
+    PyObject *jit_tier0_unwind(Tier0Frame *frame, PyObject **sp);
+
+    // Miss of a LOAD_GLOBAL cache (a justjit::GlobalCacheEntry, whose borrowed
+    // value is its first member): globals, then builtins, else NameError.
+    // Returns a borrowed reference.
+    PyObject *jit_tier0_load_global(void *entry);
+    void jit_tier0_unbound_local(PyObject *name);
+    // After tp_iternext returned NULL: 0 when the iterator is exhausted
+    // (a StopIteration is cleared), -1 when it raised something else
+    int jit_tier0_iter_error(void);
+    PyObject *jit_tier0_power(PyObject *base, PyObject *exponent);
+    PyObject *jit_tier0_inplace_power(PyObject *base, PyObject *exponent);
+    // Stores the n items of `seq` to out[n - 1] .. out[0] (first item on top)
+    int jit_tier0_unpack(PyObject *seq, Py_ssize_t n, PyObject **out);
+    PyObject *jit_tier0_build_string(PyObject *const *items, Py_ssize_t n);
+    void jit_tier0_raise(PyObject *exc, PyObject *cause);
+
+#ifdef __cplusplus
+}
+#endif
@@ -26,6 +26,10 @@ enum class JITType : uint8_t
     VEC8I = 10,   // <8 x i32> (AVX SIMD)
     COMPLEX64 = 11, // {float, float} (single-precision complex)
     OPTIONAL_F64 = 12, // {i1, f64} (nullable float64)
+    VEC8D = 13,   // <8 x double> (AVX-512; split on narrower targets)
+    VEC16F = 14,  // <16 x float> (AVX-512; split on narrower targets)
+    VEC16I = 15,  // <16 x i32> (AVX-512; split on narrower targets)
+    FIXED64 = 16, // int64_t count of 10**-k units (native mode's fixed(k); k is per function)
 };
 
 // Convert JITType to LLVM Type
@@ -35,6 +39,7 @@ inline llvm::Type* jit_type_to_llvm(JITType type, llvm::LLVMContext& ctx)
     {
     case JITType::INT64:
     case JITType::UINT64:
+    case JITType::FIXED64:
         return llvm::Type::getInt64Ty(ctx);
     case JITType::FLOAT64:
         return llvm::Type::getDoubleTy(ctx);
@@ -52,6 +57,26 @@ inline bool is_native_type(JITType type)
     return type != JITType::OBJECT;
 }
 
+// Join of two slot types in native-mode type inference: equal types stay,
+// int64 and float64 unify to float64, int64 and fixed to fixed, and anything
+// else is polymorphic (returns OBJECT, which native mode rejects)
+inline JITType unify_native_types(JITType a, JITType b)
+{
+    if (a == b)
+    {
+        return a;
+    }
+    if ((a == JITType::INT64 && b == JITType::FLOAT64) || (a == JITType::FLOAT64 && b == JITType::INT64))
+    {
+        return JITType::FLOAT64;
+    }
+    if ((a == JITType::INT64 && b == JITType::FIXED64) || (a == JITType::FIXED64 && b == JITType::INT64))
+    {
+        return JITType::FIXED64;
+    }
+    return JITType::OBJECT;
+}
+
 // Structure to hold a typed value during compilation
 struct TypedValue
 {
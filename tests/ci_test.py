@@ -10,7 +10,15 @@ Run: python tests/ci_test.py
 Exit code 0 = success, non-zero = failure
 """
 
+import array
+import collections
+import io
+import json
+import math
+import os
 import sys
+import threading
+import types
 
 def main():
     passed = 0
@@ -73,6 +81,107 @@ def main():
     check("int add", int_add(3, 5), 8)
     check("int double", int_double(7), 14)
 
+    # Unloading frees the native code; the next call recompiles
+    int_double.unload()
+    check("int double after unload", int_double(8), 16)
+
+    # Hot cores link into their own code slabs, and unloading frees code there too
+    @jit(mode='int')
+    def hot_triple(x):
+        return x * 3
+
+    hot_triple._jit_instance.set_hot_code(True)
+    check("hot code slab", hot_triple(5), 15)
+    hot_triple.unload()
+    check("hot code slab after unload", hot_triple(6), 18)
+
+    # Code unloaded while a call still runs it stays mapped until that call returns
+    @jit
+    def runs_while_unloaded(n, evict):
+        total = 0
+        for i in range(n):
+            total += i
+        evict()
+        for i in range(n):
+            total += i * 2
+        return total
+
+    check("unload while on the stack", runs_while_unloaded(10, runs_while_unloaded.unload), 135)
+    check("unload while on the stack is deferred", runs_while_unloaded in justjit._unloads_pending, True)
+    check("call after deferred unload", runs_while_unloaded(10, lambda: None), 135)
+    check("deferred unload freed", runs_while_unloaded in justjit._unloads_pending, False)
+
+    @jit
+    def evicting_callee(x):
+        return x + 1
+
+    def compile_evicting_callee():
+        justjit.set_code_limit(1)  # Compiling the callee evicts its running caller
+        try:
+            evicting_callee(1)
+        finally:
+            justjit.set_code_limit(0)
+
+    check("code limit evicts a running caller", runs_while_unloaded(10, compile_evicting_callee), 135)
+    check("evicted caller recompiles", runs_while_unloaded(4, lambda: None), 18)
+
+    # Memory accounting: linked bytes per function and for the whole process
+    usage = {name: entry for name, entry in justjit.memory_usage()["functions"].items() if name.endswith("int_double")}
+    check("memory usage per function", [entry["code_bytes"] > 0 for entry in usage.values()], [True])
+    check("memory usage totals", justjit.runtime_memory_usage()["code_bytes"] >= list(usage.values())[0]["code_bytes"], True)
+
+    # int64 overflow reruns the call in the interpreter, or raises by policy
+    check("int overflow deopts", int_add(2**62, 2**62), 2**63)
+
+    @jit(mode='int', int_overflow='raise')
+    def int_square_raising(x):
+        return x * x
+
+    try:
+        int_square_raising(2**40)
+        raised = False
+    except OverflowError:
+        raised = True
+    check("int overflow raises", raised, True)
+
+    # An overflow inside nested range() loops resumes in the interpreter at that
+    # operation, with the loop iterators and operand stack rebuilt
+    @jit(mode='int')
+    def int_grow(n, k):
+        total = 1
+        for i in range(n):
+            for j in range(3):
+                total = total * k + i * j
+        return total - n
+
+    check("int overflow resumes mid-loop", int_grow(30, 3), int_grow._original_func(30, 3))
+    check("int overflow resume without overflow", int_grow(5, 3), int_grow._original_func(5, 3))
+
+    # Reductions over generator expressions compile as loops of the function
+    @jit(mode='int')
+    def int_reductions(n, k):
+        total = sum(i * k for i in range(n) if i % 3)
+        return total + 1000 * max(i % 4 for i in range(n)) + 10000 * any(i > 5 for i in range(n))
+
+    @jit(mode='int')
+    def int_smallest(n):
+        return min((i - 3) * (i - 3) for i in range(n))
+
+    @jit(mode='float')
+    def float_sum_halves(n):
+        return sum(i * 0.5 for i in range(n))
+
+    check("genexpr reductions compile", [int_reductions._native_address() != 0, float_sum_halves._native_address() != 0], [True, True])
+    check("int genexpr reductions", [int_reductions(10, 2), int_reductions(3, 5)], [13054, 2015])
+    check("int genexpr min", int_smallest(6), 0)
+    try:
+        int_smallest(0)
+        raised = False
+    except ValueError:
+        raised = True
+    check("empty min deopts", raised, True)
+    check("float genexpr sum", float_sum_halves(5.0), 5.0)
+
     # float mode (f64)
     @jit(mode='float')
     def float_mul(a, b):
@@ -85,6 +194,98 @@ def main():
     check("float mul", float_mul(2.5, 4.0), 10.0)
     check("float square", float_square(3.0), 9.0)
 
+    # float mode with per-ISA clones and runtime CPU dispatch
+    @jit(mode='float', multiversion=True)
+    def float_fma(a, b, c):
+        return a * b + c
+
+    check("float multiversion", float_fma(2.0, 3.0, 1.0), 7.0)
+
+    # Profile-guided tiering: tier 1 counts branches, tier 2 uses them as weights
+    @jit(mode='int', tiered=True, tier_threshold=20, pgo=True)
+    def pgo_sum_odd(n):
+        total = 0
+        i = 0
+        while i < n:
+            if i % 2 == 1:
+                total = total + i
+            i = i + 1
+        return total
+
+    check("pgo tier 1", pgo_sum_odd(10), 25)
+    check("pgo branch counts", sum(pgo_sum_odd._jit_instance.get_branch_profile("pgo_sum_odd")) > 0, True)
+    check("pgo tier 2", [pgo_sum_odd(100) for _ in range(100)][-1], 2500)
+
+    # Baseline tier: copied stencils first, LLVM once hot
+    @jit(tiered='baseline', tier_threshold=20)
+    def baseline_words(words, sep):
+        out = []
+        for i, word in enumerate(words):
+            if word is not None and len(word) > 1:
+                out.append(f"{i}:{word!r}")
+        return sep.join(out)
+
+    check("baseline tier 1", baseline_words(["a", "bc", None, "def"], ","), "1:'bc',3:'def'")
+    check("baseline tier 2", [baseline_words(["xy"], "") for _ in range(50)][-1], "0:'xy'")
+    try:
+        baseline_words([1], ",")
+        raised = False
+    except TypeError:
+        raised = True
+    check("baseline error", raised, True)
+
+    # Tier-up: O1 code first; after tier_threshold calls the opt_level compile
+    # runs in the background and a later call swaps its core and code in
+    import time
+
+    @jit(mode='int', tiered=True, tier_threshold=5)
+    def tiered_cube(x):
+        return x * x * x
+
+    tier1_result, tier1_core = tiered_cube(3), tiered_cube._jit_instance
+    check("tier 1 at O1", (tier1_result, tier1_core.get_opt_level()), (27, 1))
+    deadline = time.monotonic() + 30
+    while tiered_cube._jit_instance is tier1_core and time.monotonic() < deadline:
+        tiered_cube(2)
+        time.sleep(0.001)
+    tier2_core = tiered_cube._jit_instance
+    check("tier up swapped", (tier2_core is not tier1_core, tier2_core.get_opt_level(), tiered_cube(4)), (True, 3, 64))
+
+    # A tier-up compile that raises keeps the tier-1 code and is listed by report()
+    @jit(mode='int', tiered=True, tier_threshold=3)
+    def tier_up_raises(x):
+        return x + 7
+
+    def broken_core():
+        raise MemoryError("no core")
+
+    real_core = justjit.JIT
+    justjit.JIT = broken_core
+    try:
+        tier_up_results = [tier_up_raises(1) for _ in range(4)]
+        justjit._get_compile_executor().submit(lambda: None).result()
+        tier_up_results.append(tier_up_raises(2))
+    finally:
+        justjit.JIT = real_core
+    check("tier up error recorded",
+          (tier_up_results, [r["reason"] for r in justjit.report(io.StringIO())["rejections"]
+                             if r["function"].endswith(".tier_up_raises")]),
+          ([8, 8, 8, 8, 9], ["compile raised MemoryError: no core"]))
+
+    @jit(mode='float')
+    def map_poly(x):
+        return x * x + 1.0
+
+    @jit(mode='int')
+    def map_add(a, b):
+        return a + b
+
+    check("map list", map_poly.map([1.0, 2.0, 3.0]), [2.0, 5.0, 10.0])
+    check("map buffer out", list(map_poly.map(array.array('d', [0.5, 2.0]), out=array.array('d', [0.0, 0.0]))), [1.25, 5.0])
+    check("starmap", map_add.starmap([(1, 2), (3, 4)]), [3, 7])
+    check("c signature", map_add.c_signature(), "long long (long long, long long)")
+    check("ctypes pointer", map_poly.ctypes()(3.0), 10.0)
+
     # int32 mode (i32)
     @jit(mode='int32')
     def int32_sub(a, b):
@@ -143,12 +344,827 @@ def main():
     check("bool or FT", bool_or(False, True), True)
     check("bool or FF", bool_or(False, False), False)
 
+    # Bool-mode predicates over columns: int64 and float64 mixed, packed into a bitmap
+    import array
+
+    @jit(mode='bool')
+    def in_band(a, b):
+        return a > 2 and b < 5.5
+
+    band = in_band(array.array('q', range(10)), array.array('d', [0.0, 9.0] * 5), packed=True)
+    check("bool column bitmap", list(band), [0b01010000, 0b1])
+
+    # native mode: int, float and bool locals in one function
+    @jit(mode='native')
+    def native_mean_above(n, limit: float):
+        total = 0
+        count = 0
+        for i in range(n):
+            x = i * 0.5
+            if x > limit:
+                total += x
+                count += 1
+        return total / count if count else 0.0
+
+    @jit(mode='native')
+    def native_has_factor(n, k):
+        return n % k == 0 and n > k
+
+    @jit(mode='native')
+    def native_square(x):
+        return x * x
+
+    @jit(mode='native')
+    def native_mulmod(a, b, m):
+        return (a * b + 1) % m
+
+    check("native mixed locals", native_mean_above(10, 2.0), 3.5)
+    check("native bool result", native_has_factor(12, 4), True)
+    check("native overflow bails out", native_square(2**40), 2**80)
+    check("native 128-bit intermediate", native_mulmod(2**62, 2**62 + 1, -(10**9 + 7)), (2**62 * (2**62 + 1) + 1) % -(10**9 + 7))
+
+    # native mode from annotations or a signature string
+    @jit
+    def native_annotated(x: float, n: int) -> float:
+        return x * n + 1
+
+    @jit("f64(f64, i64)")
+    def native_signed(x, n):
+        return x - n
+
+    check("native from annotations", (native_annotated(1.5, 4), native_annotated._mode), (7.0, "native"))
+    check("native from signature", native_signed(2.5, 1), 1.5)
+
+    # fixed-point decimals: fixed * fixed rounds half-even to the type's places
+    from decimal import Decimal
+
+    @jit("fixed2(fixed2, i64, fixed2)")
+    def native_invoice(price, qty, rate):
+        net = price * qty
+        return net + net * rate
+
+    check("native fixed-point", (native_invoice(Decimal("19.99"), 3, Decimal("0.07")), native_invoice._mode), (Decimal("64.17"), "native"))
+
+    # native mode with buffer-protocol array parameters
+    import array
+
+    @jit("void(f64[:], f64[:])")
+    def native_prefix_sum(a, out):
+        total = 0.0
+        for i in range(len(a)):
+            total += a[i]
+            out[i] = total
+
+    @jit("void(i64[:], i64[:])")
+    def native_histogram(data, counts):
+        for i in range(len(data)):
+            counts[data[i]] += 1
+
+    prefix = array.array('d', [0.0] * 3)
+    native_prefix_sum(array.array('d', [1.0, 2.0, 3.0]), prefix)
+    check("native array prefix sum", list(prefix), [1.0, 3.0, 6.0])
+    counts = array.array('q', [0] * 3)
+    native_histogram(array.array('q', [0, 2, 2, 1, 2]), counts)
+    check("native array histogram", list(counts), [1, 1, 3])
+
+    # Arrays without the buffer protocol: __array_interface__ is read in place
+    class InterfaceArray:
+        def __init__(self, data):
+            self.data = data
+            address, length = data.buffer_info()
+            self.__array_interface__ = {"version": 3, "typestr": "<f8", "shape": (length,),
+                                        "data": (address, False), "strides": None}
+
+    interface_out = InterfaceArray(array.array('d', [0.0] * 3))
+    native_prefix_sum(InterfaceArray(array.array('d', [1.0, 2.0, 3.0])), interface_out)
+    check("native __array_interface__", list(interface_out.data), [1.0, 3.0, 6.0])
+
+    # Bounds checks hoisted out of range loops: an overrun still raises at its element
+    @jit("void(f64[:], f64[:], i64)")
+    def native_axpy(x, y, n):
+        for i in range(n):
+            y[i] += 2.0 * x[i]
+
+    ys = array.array('d', [1.0, 1.0, 1.0])
+    native_axpy(array.array('d', [1.0, 2.0, 3.0]), ys, 3)
+    check("native hoisted bounds", list(ys), [3.0, 5.0, 7.0])
+    try:
+        native_axpy(array.array('d', [1.0, 2.0, 3.0, 4.0]), ys, 4)
+        check("native hoisted overrun", "no error", "IndexError")
+    except IndexError:
+        check("native hoisted overrun", list(ys), [5.0, 9.0, 13.0])
+
+    @jit("f64(f64[:, :, :])")
+    def native_sum3(a):
+        total = 0.0
+        n, m, k = a.shape
+        for i in range(n):
+            for j in range(m):
+                for l in range(k):
+                    total += a[i, j, l]
+        return total - a[1, 2, 3]
+
+    cube = memoryview(array.array('d', range(24))).cast('B').cast('d', (2, 3, 4))
+    check("native 3-D array", native_sum3(cube), 253.0)
+
+    # native mode byte strings: bytes/bytearray/ASCII str as u8[:]
+    @jit("i64(bytes)")
+    def native_sum_fields(line):
+        total = 0
+        start = 0
+        n = len(line)
+        while start < n:
+            end = line.find(b",", start)
+            if end < 0:
+                end = n
+            value = 0
+            for i in range(start, end):
+                value = value * 10 + line[i] - 48
+            total += value
+            start = end + 1
+        return total
+
+    @jit("b1(str)")
+    def native_is_get(request):
+        return request.startswith("GET ")
+
+    @jit("void(u8[:])")
+    def native_upper(buf):
+        for i in range(len(buf)):
+            if buf[i] >= 97 and buf[i] <= 122:
+                buf[i] -= 32
+
+    check("native bytes find", native_sum_fields(b"12,30,7"), 49)
+    check("native bytearray", native_sum_fields(bytearray(b"5,5")), 10)
+    check("native str startswith", (native_is_get("GET /"), native_is_get("POST /")), (True, False))
+    upper = bytearray(b"abc!")
+    native_upper(upper)
+    check("native u8 store", bytes(upper), b"ABC!")
+
+    # native mode record parameters: fields unpacked once at entry
+    import typing
+
+    @justjit.record
+    class Order(typing.NamedTuple):
+        price: float
+        qty: int
+
+    @jit
+    def native_notional(o: Order, fee: float) -> float:
+        return o.price * o.qty - fee
+
+    check("native record fields", native_notional(Order(2.5, 4), 1.0), 9.0)
+
+    # Arrays of records: fields read in place from a structured buffer, or
+    # copied out when stored narrower (side is a uint8 here)
+    import ctypes
+
+    global Fill
+
+    @justjit.record
+    class Fill(typing.NamedTuple):
+        px: float
+        side: int
+
+    class FillStruct(ctypes.Structure):
+        _fields_ = [("px", ctypes.c_double), ("side", ctypes.c_uint8)]
+
+    @jit("f64(Fill[:])")
+    def native_fills(a):
+        total = 0.0
+        for i in range(len(a)):
+            total += a[i].px if a[i].side else -a["px"][i]
+        return total
+
+    fills = (FillStruct * 3)((2.0, 1), (0.5, 0), (1.5, 1))
+    check("native record array", native_fills(fills), 3.0)
+
+    # native mode lists and int-keyed dicts built inside the function
+    @jit
+    def native_sieve(n: int) -> int:
+        flags = [True] * (n + 1)
+        last_digits = {}
+        count = 0
+        for i in range(2, n + 1):
+            if flags[i]:
+                count += 1
+                last_digits[i % 10] = last_digits.get(i % 10, 0) + 1
+                for j in range(i * i, n + 1, i):
+                    flags[j] = False
+        return count * 100 + len(last_digits)
+
+    check("native lists and dicts", (native_sieve(30), native_sieve._mode), (1006, "native"))
+
+    # native mode sort(), argsort() and partition(), specialized per element type
+    @jit("f64(f64[:])")
+    def native_median(a):
+        n = len(a)
+        a.partition(n // 2)
+        return a[n // 2]
+
+    @jit("(i64[:])")
+    def native_order(keys):
+        order = keys.argsort()
+        keys.sort()
+        return order
+
+    @jit
+    def native_list_sort(n: int) -> int:
+        values = []
+        for i in range(n):
+            values.append((i * 7919) % n)
+        values.sort()
+        ordered = 1
+        for i in range(1, n):
+            if values[i - 1] > values[i]:
+                ordered = 0
+        return ordered
+
+    samples = array.array('d', [5.0, float("nan"), 1.0, 4.0, 2.0])
+    keys = array.array('q', [(i * 40503) % 10007 - 5000 for i in range(10007)])
+    expected = sorted(range(len(keys)), key=keys.__getitem__)
+    check("native partition", (native_median(samples), math.isnan(samples[3]) or math.isnan(samples[4])), (4.0, True))
+    check("native argsort radix sort", (native_order(keys) == expected, list(keys) == sorted(keys)), (True, True))
+    check("native list sort", (native_list_sort(1000), native_list_sort._mode), (1, "native"))
+
     # object mode
     @jit()
     def object_concat(a, b):
         return a + b
 
     check("object concat", object_concat("Hello", " World"), "Hello World")
+    check("object int add", object_concat(2, 3), 5)
+    check("object float add", object_concat(1.5, 2.25), 3.75)
+    check("object bigint add", object_concat(2**62, 2**62), 2**63)
+    check("object mixed add", object_concat(1, 0.5), 1.5)
+
+    @jit()
+    def object_range_sum(n):
+        total = 0
+        for i in range(n, 0, -2):
+            total = total + i
+        return total
+
+    check("object range loop", object_range_sum(10), 30)
+
+    # Object-mode code loads constants, names and dicts from a per-function table
+    @jit()
+    def object_greeting(name):
+        return "-".join(["hi", name]) + str(len(name))
+
+    check("object constant table", object_greeting("ann"), "hi-ann3")
+    slots = [entry.get("constant_slots", 0) for key, entry in justjit.memory_usage()["functions"].items()
+             if key.endswith("object_greeting")]
+    check("object constant table slots", [n > 0 for n in slots], [True])
+
+    @jit()
+    def object_iter_sum(seq):
+        total = 0
+        for x in seq:
+            total = total + x
+        return total
+
+    @jit()
+    def object_items_sum(d):
+        total = 0
+        for k, v in d.items():
+            total = total + k * v
+        return total
+
+    check("object list loop", object_iter_sum([1, 2, 3, 4]), 10)
+    check("object tuple loop", object_iter_sum((5, 6)), 11)
+    check("object dict keys loop", object_iter_sum({1: 0, 2: 0}), 3)
+    check("object dict items loop", object_items_sum({2: 3, 4: 5}), 26)
+
+    # Per-site LOAD_GLOBAL caches: after the sites are filled, a rebound global
+    # and a new global shadowing a builtin are seen on the next call
+    cached_globals = types.ModuleType("justjit_global_cache_test")
+    exec("SCALE = 2\n\ndef scaled_len(items):\n    return len(items) * SCALE\n", cached_globals.__dict__)
+    scaled_len = jit(cached_globals.scaled_len, mode='object')
+    check("global cache filled", [scaled_len([1, 2, 3]), scaled_len([1, 2, 3])], [6, 6])
+    cached_globals.SCALE = 5
+    check("global cache rebound", scaled_len([1, 2, 3]), 15)
+    cached_globals.len = lambda items: 10
+    check("global cache shadowed builtin", scaled_len([1, 2, 3]), 50)
+    del cached_globals.len
+    check("global cache shadow removed", scaled_len([1, 2, 3]), 15)
+
+    # Refcount elision: the reference counts of arguments are unchanged after
+    # many calls through loops, early returns, rebinding and exception unwinds
+    @jit(mode='object')
+    def refs_loop(items, n):
+        total = 0
+        for i in range(n):
+            total = total + len(items) + items[i % 2]
+        return total
+
+    @jit(mode='object')
+    def refs_early(items, flag):
+        if flag:
+            return len(items)
+        head = items[0]
+        return head + len(items)
+
+    @jit(mode='object')
+    def refs_rebind(a, b):
+        x = a
+        y = x
+        x = b
+        return len(y) + len(x)
+
+    @jit(mode='object')
+    def refs_unwind(items, bad):
+        try:
+            return len(items) + bad
+        except TypeError:
+            return -len(items)
+
+    @jit(mode='object')
+    def refs_raise(items, bad):
+        return len(items) + bad
+
+    def refcount_after(call, obj, times=200):
+        before = sys.getrefcount(obj)
+        for _ in range(times):
+            try:
+                call()
+            except TypeError:
+                pass
+        return sys.getrefcount(obj) - before
+
+    held, other = [1, 2], [3]
+    check("refcount elision results",
+          (refs_loop(held, 5), refs_early(held, True), refs_early(held, False), refs_rebind(held, other),
+           refs_unwind(held, 1), refs_unwind(held, "x")),
+          (17, 2, 3, 3, 3, -2))
+    check("refcount elision balance",
+          [refcount_after(lambda: refs_loop(held, 7), held), refcount_after(lambda: refs_early(held, True), held),
+           refcount_after(lambda: refs_early(held, False), held), refcount_after(lambda: refs_rebind(held, other), held),
+           refcount_after(lambda: refs_rebind(held, other), other), refcount_after(lambda: refs_unwind(held, "x"), held),
+           refcount_after(lambda: refs_raise(held, "x"), held)],
+          [0, 0, 0, 0, 0, 0, 0])
+
+    # JITFunction binds keywords and defaults and binds as a method
+    @jit(mode="int")
+    def int_axpy(a, x, y=1):
+        return a * x + y
+
+    check("jit function keywords", int_axpy(2, y=5, x=3), 11)
+    check("jit function defaults", int_axpy(2, 3), 7)
+    check("jit function keywords native", int_axpy(a=1, x=1), 2)
+    check("jit function type", type(int_axpy).__name__, "JITFunction")
+
+    check("jit function deopt beyond int64", int_axpy(2**70, 1, 0), 2**70)
+
+    # Keyword-only parameters, *args and **kwargs are bound into the entry's slots
+    @jit(mode="int")
+    def int_clamp(x, *, lo=0, hi):
+        if x < lo:
+            return lo
+        if x > hi:
+            return hi
+        return x
+
+    check("jit function keyword-only", int_clamp(12, hi=10), 10)
+    check("jit function keyword-only default", int_clamp(-3, lo=-1, hi=5), -1)
+    check("jit function keyword-only native", int_clamp._native_address() != 0, True)
+    try:
+        int_clamp(1, 2, 3)
+        raised = False
+    except TypeError:
+        raised = True
+    check("jit function keyword-only positional", raised, True)
+
+    @jit()
+    def object_gather(first, *rest, scale=2, **named):
+        return (first + sum(rest)) * scale + len(named)
+
+    check("jit function star args", object_gather(1, 2, 3), 12)
+    check("jit function star kwargs", object_gather(1, scale=3, a=0, b=0), 5)
+    check("jit function star args empty", object_gather(first=4), 8)
+
+    # CALL_KW from compiled code: keyword names reach the callee through
+    # vectorcall, including keyword-only parameters and **-collected names
+    def kw_target(a, b=10, *, scale, **extra):
+        return (a + b) * scale, sorted(extra.items())
+
+    @jit(mode='object')
+    def object_call_kw(x):
+        return [kw_target(x, scale=2), kw_target(x, 1, scale=3, tag=x, mode="m"),
+                kw_target(a=x, b=x, scale=1), sorted([3, x, 1], key=abs, reverse=True)]
+
+    check("CALL_KW vectorcall", object_call_kw(-5),
+          [(10, []), (-12, [("mode", "m"), ("tag", -5)]), (-10, []), [-5, 3, 1]])
+    try:
+        object_call_kw_missing = jit(lambda x: kw_target(x, b=1), mode='object')
+        object_call_kw_missing(1)
+        raised = False
+    except TypeError:
+        raised = True
+    check("CALL_KW missing keyword-only", raised, True)
+
+    # Exceptions from native code propagate without rerunning the function
+    @jit()
+    def object_log_then_divide(log, n):
+        log.append(n)
+        return 1 // n
+
+    calls = []
+    try:
+        object_log_then_divide(calls, 0)
+        raised = False
+    except ZeroDivisionError:
+        raised = True
+    check("native exception propagates", raised, True)
+    check("native exception runs once", len(calls), 1)
+
+    # Error sites share one unwind ladder per handler: raises inside a nested try,
+    # and failures with call arguments still on the stack, match the interpreter
+    def object_nested_unwind_py(items, divisor, log):
+        total = 0
+        for x in items:
+            try:
+                try:
+                    if x < 0:
+                        raise ValueError(x)
+                    if x == 99:
+                        raise KeyError(x)
+                    total = total + max(x, len(log), x // divisor)
+                except ZeroDivisionError:
+                    log.append("zero")
+                    total = total - 1
+                finally:
+                    log.append(x)
+            except ValueError as e:
+                log.append(("neg", e.args[0]))
+                total = total + 100
+        return total
+
+    object_nested_unwind = jit(mode='object')(object_nested_unwind_py)
+
+    def unwind_outcome(func, items, divisor):
+        log = []
+        try:
+            return func(items, divisor, log), log
+        except KeyError as e:
+            return ("KeyError", e.args), log
+
+    unwind_inputs = [([1, -2, 3], 1), ([1, -2, 3], 0), ([4, 99, 5], 2), ([], 0)]
+    check("nested try unwind", [unwind_outcome(object_nested_unwind, *case) for case in unwind_inputs],
+          [unwind_outcome(object_nested_unwind_py, *case) for case in unwind_inputs])
+
+    @jit(mode="float")
+    def float_kinetic(m, vx, vy, vz, scale):
+        return 0.5 * m * (vx * vx + vy * vy + vz * vz) * scale
+
+    check("float mode five parameters", float_kinetic(2.0, 1.0, 2.0, 2.0, 1.0), 9.0)
+    check("float mode five parameters again", float_kinetic(2.0, 1.0, 2.0, 2.0, scale=2.0), 18.0)
+
+    class Scaler:
+        @jit()
+        def scale(self, v):
+            return v * 2
+
+    check("jit function as method", Scaler().scale(4), 8)
+
+    # len / isinstance / abs / min / max lowered inline
+    @jit()
+    def object_builtin_mix(seq, lo, hi):
+        total = len(seq)
+        for x in seq:
+            if isinstance(x, int):
+                total = total + max(lo, min(abs(x), hi))
+        return total
+
+    check("object builtins inline", object_builtin_mix([-5, 1.5, 2, "s", 30], 1, 10), 5 + 5 + 2 + 10)
+    check("object builtins inline tuple", object_builtin_mix((0, -1), 1, 10), 2 + 1 + 1)
+
+    # Method calls pass self without a bound method; instance attributes still win
+    class Counter:
+        def bump(self, n):
+            return n + 1
+
+    @jit()
+    def object_method_calls(items, counter):
+        out = []
+        for x in items:
+            out.append(counter.bump(x))
+        return out
+
+    shadowed = Counter()
+    shadowed.bump = lambda n: n * 10
+    check("object method call", object_method_calls([1, 2], Counter()), [2, 3])
+    check("object method shadowed", object_method_calls([1, 2], shadowed), [10, 20])
+
+    # Presized comprehensions, dict literals and single-pass f-strings
+    @jit()
+    def object_squares(n):
+        return [x * x for x in range(n)]
+
+    @jit()
+    def object_evens(seq):
+        return [x for x in seq if x % 2 == 0]
+
+    @jit()
+    def object_describe(name, n):
+        return {"label": f"{name}={n}!", "n": n, "twice": n * 2}
+
+    check("presized comprehension", object_squares(5), [0, 1, 4, 9, 16])
+    check("filtered comprehension", object_evens([1, 2, 3, 4, 6]), [2, 4, 6])
+    check("f-string and dict literal", object_describe("k", 3), {"label": "k=3!", "n": 3, "twice": 6})
+
+    # list / tuple / dict subscripts
+    @jit()
+    def object_subscripts(values, pair, table):
+        values[-1] = values[0] + pair[1]
+        table["sum"] = values[-1] + table["base"]
+        return values[1] + pair[-2] + table["sum"]
+
+    @jit()
+    def object_index_error(values, i):
+        try:
+            return values[i]
+        except IndexError:
+            return -1
+
+    check("object subscripts", object_subscripts([1, 2, 3], (4, 5), {"base": 10}), 2 + 4 + 16)
+    check("object subscript out of range", object_index_error([1, 2], 5), -1)
+    check("object subscript negative", object_index_error([1, 2], -2), 1)
+
+    # A dict miss under `except KeyError:` reaches the handler without raising
+    @jit()
+    def object_count_known(table, keys):
+        found = 0
+        i = 0
+        while i < len(keys):
+            try:
+                found = found + table[keys[i]]
+            except KeyError:
+                found = found - 1
+            i = i + 1
+        return found
+
+    check("keyed dict miss", object_count_known({"a": 5, (1, 2): 7}, ["a", "b", (1, 2), 3]), 10)
+    check("keyed dict subclass", object_count_known(collections.defaultdict(int, a=5), ["a", "b"]), 5)
+
+    # A module rebinding KeyError gets the real exception, matched against its binding
+    keyed = types.ModuleType("justjit_keyed_test")
+    exec("KeyError = IndexError\n\ndef lookup(table, key):\n    try:\n        return table[key]\n"
+         "    except KeyError:\n        return -1\n", keyed.__dict__)
+    keyed_lookup = jit(keyed.lookup)
+    try:
+        keyed_lookup({}, (1, 2))
+        raised = None
+    except LookupError as e:
+        raised = (type(e).__name__, e.args)
+    check("keyed dict miss shadowed KeyError", raised, ("KeyError", ((1, 2),)))
+
+    # A bare `raise` under `except KeyError:` re-raises the real KeyError(key)
+    @jit()
+    def object_logged_lookup(table, key, log):
+        try:
+            return table[key]
+        except KeyError:
+            log.append(key)
+            raise
+
+    missed = []
+    try:
+        object_logged_lookup({"a": 1}, "b", missed)
+        raised = None
+    except KeyError as e:
+        raised = (type(e).__name__, e.args)
+    check("keyed dict miss re-raised", (object_logged_lookup({"a": 1}, "a", missed), raised, missed),
+          (1, ("KeyError", ("b",)), ["b"]))
+
+    # match/case: literal chains switch on the subject; class, mapping and sequence patterns
+    @jit()
+    def object_route(code, urgent):
+        match code:
+            case 1 if urgent:
+                return "page"
+            case 1:
+                return "ticket"
+            case 2:
+                return "email"
+            case 3:
+                return "log"
+        return "drop"
+
+    class Point:
+        __match_args__ = ("x", "y")
+
+        def __init__(self, x, y):
+            self.x = x
+            self.y = y
+
+    shapes = types.SimpleNamespace(Point=Point)
+
+    @jit()
+    def object_shape(ns, subject):
+        match subject:
+            case ns.Point(0, y):
+                return y
+            case ns.Point(x=x, y=y):
+                return x + y
+            case int(n):
+                return -n
+            case {"w": w, "h": h}:
+                return w * h
+            case [first, *rest]:
+                return first + len(rest)
+        return None
+
+    check("match literal guard", object_route(1, True), "page")
+    check("match literal fallthrough", [object_route(c, False) for c in (1, 2, 3, 4)], ["ticket", "email", "log", "drop"])
+    check("match literal non-int subject", [object_route(v, False) for v in (True, 2.0, 2**70, "1")], ["ticket", "email", "drop", "drop"])
+    check("match class positional", object_shape(shapes, Point(0, 7)), 7)
+    check("match class keywords", object_shape(shapes, Point(2, 3)), 5)
+    check("match self-matching builtin", object_shape(shapes, 4), -4)
+    check("match mapping", object_shape(shapes, collections.defaultdict(int, w=2, h=5)), 10)
+    check("match mapping missing key", object_shape(shapes, collections.defaultdict(int, w=2)), None)
+    check("match sequence", object_shape(shapes, [1, 2, 3]), 3)
+    check("match str is not a sequence", object_shape(shapes, "abc"), None)
+
+    # On-stack replacement: a call started in the interpreter (async_compile still
+    # compiling) continues natively at its hot while loop
+    @jit(async_compile=True, osr=True, osr_threshold=100)
+    def osr_countdown(n):
+        total = 0
+        while n > 0:
+            total += n % 7
+            n -= 1
+        return total
+
+    check("osr while loop", osr_countdown(200000), sum(k % 7 for k in range(1, 200001)))
+    check("osr while loop again", osr_countdown(50), sum(k % 7 for k in range(1, 51)))
+
+    # async_compile: while the compile waits behind the busy worker thread,
+    # calls run the interpreter with the same results; the next call after it
+    # finishes installs the native code
+    release_worker = threading.Event()
+    compile_worker = justjit._get_compile_executor()
+    compile_worker.submit(release_worker.wait, 30)
+    try:
+        @jit(mode='int', async_compile=True)
+        def async_poly(x):
+            return x * x - 3 * x + 2
+
+        pending = [async_poly(x) for x in range(-3, 4)]
+        check("async_compile pending", (pending, async_poly._native_address()),
+              ([x * x - 3 * x + 2 for x in range(-3, 4)], 0))
+    finally:
+        release_worker.set()
+    compile_worker.submit(lambda: None).result()
+    check("async_compile installed", (async_poly(10), async_poly._native_address() != 0), (72, True))
+
+    # compare/contains/is feeding a branch
+    @jit()
+    def object_filter_count(seq, banned):
+        count = 0
+        for x in seq:
+            if x is None:
+                continue
+            if x in banned:
+                continue
+            if x > 2.5:
+                count = count + 1
+        return count
+
+    check("object compare branch", object_filter_count([1, 3, None, 4.0, 5, float("nan")], {5}), 2)
+    check("object compare branch big ints", object_filter_count([2**70, -(2**70)], ()), 1)
+
+    # type-feedback specialization: profiled int calls switch to int mode
+    @jit(specialize=True, profile_calls=3)
+    def spec_poly(x, y):
+        return x * y + 1
+
+    for i in range(5):
+        spec_poly(i, 2)
+    check("specialized int", spec_poly(4, 5), 21)
+    check("specialized guard miss", spec_poly(1.5, 2.0), 4.0)
+
+    # object mode attribute caches (slots, instance dict, class attr, type change)
+    class SlotPoint:
+        __slots__ = ("x", "y")
+
+        def __init__(self, x, y):
+            self.x = x
+            self.y = y
+
+    class DictPoint:
+        scale = 10
+
+        def __init__(self, x, y):
+            self.x = x
+            self.y = y
+
+    @jit()
+    def attr_sum(p):
+        return p.x + p.y
+
+    @jit()
+    def attr_set_x(p, v):
+        p.x = v
+        return p.x
+
+    check("attr slots", attr_sum(SlotPoint(1, 2)), 3)
+    check("attr dict", attr_sum(DictPoint(3, 4)), 7)
+    check("attr slots again", attr_sum(SlotPoint(5, 6)), 11)
+    check("attr store slots", attr_set_x(SlotPoint(1, 2), 9), 9)
+    check("attr store dict", attr_set_x(DictPoint(1, 2), 8), 8)
+
+    @jit()
+    def attr_scale(p):
+        return p.scale
+
+    check("attr class", attr_scale(DictPoint(0, 0)), 10)
+    DictPoint.scale = 20
+    check("attr class after change", attr_scale(DictPoint(0, 0)), 20)
+
+    # A site seeing many receiver types turns megamorphic and keeps answering
+    many_types = [type(f"Point{k}", (), {"scale": k}) for k in range(80)]
+
+    @jit()
+    def attr_scale_sum(points):
+        total = 0
+        for p in points:
+            total += p.scale
+        return total
+
+    points = [cls() for cls in many_types] * 2
+    check("attr megamorphic site", attr_scale_sum(points), 2 * sum(range(80)))
+    check("attr megamorphic then slots", attr_sum(SlotPoint(7, 8)) + attr_scale_sum(points[:3]), 15 + 3)
+
+    # CALL sites with builtin feedback: METH_O / METH_NOARGS / METH_FASTCALL
+    # functions and method descriptors are called directly once seen
+    @jit()
+    def builtin_calls(words, n):
+        out = []
+        for i in range(n):
+            out.append(i)
+        out.reverse()
+        return ",".join(words) + str(len(out)) + str(out.pop()) + str(max(out))
+
+    check("call site builtins", builtin_calls(["a", "b"], 4), "a,b403")
+    check("call site builtins again", builtin_calls(["c"], 3), "c302")
+
+    @jit()
+    def call_each(fns, x):
+        return [f(x) for f in fns]
+
+    check("call site reseeded", call_each([str, len, repr] * 30, [1, 2])[-3:], ["[1, 2]", 2, "[1, 2]"])
+
+    # Classes with a Python __init__ are allocated and initialized at the call site
+    class Vec:
+        def __init__(self, x, y):
+            self.x = x
+            self.y = y
+
+    class SlotVec:
+        __slots__ = ("x", "y")
+
+        def __init__(self, x, y=0):
+            self.x = x
+            self.y = y
+
+    @jit()
+    def build_vecs(cls, n):
+        total = 0
+        for i in range(n):
+            v = cls(i, 2 * i)
+            total += v.x + v.y
+        return total
+
+    check("construct at call site", build_vecs(Vec, 100), 3 * sum(range(100)))
+    check("construct slots", build_vecs(SlotVec, 10), 3 * sum(range(10)))
+    Vec.__init__ = lambda self, x, y: setattr(self, "x", x) or setattr(self, "y", -y)
+    check("construct after __init__ changes", build_vecs(Vec, 10), -sum(range(10)))
+
+    class BadInit:
+        def __init__(self):
+            return 1
+
+    @jit()
+    def make(cls):
+        return cls()
+
+    try:
+        make(BadInit)
+        check("construct __init__ returning a value", "no error", "TypeError")
+    except TypeError:
+        check("construct __init__ returning a value", "TypeError", "TypeError")
+
+    @jit()
+    def append_to(target, x):
+        return list.append(target, x)
+
+    check("call site descriptor", append_to([1], 2), None)
+    try:
+        append_to((1,), 2)
+        check("call site descriptor wrong receiver", "no error", "TypeError")
+    except TypeError:
+        check("call site descriptor wrong receiver", "TypeError", "TypeError")
 
     # =========================================================================
     # Test 3: Factorial (multi-step)
@@ -170,6 +1186,136 @@ def main():
     check("factorial(5)", factorial(5), 120)
     check("factorial(10)", factorial(10), 3628800)
 
+    # Direct native calls between @jit functions (recursion and helpers);
+    # module globals so the calls compile to LOAD_GLOBAL
+    global fib, float_sq
+
+    @jit(mode='int')
+    def fib(n):
+        if n < 2:
+            return n
+        return fib(n - 1) + fib(n - 2)
+
+    @jit(mode='float')
+    def float_sq(x):
+        return x * x
+
+    @jit(mode='float')
+    def float_hypot2(a, b):
+        return float_sq(a) + float_sq(b)
+
+    check("recursive fib(20)", fib(20), 6765)
+    check("float helper call", float_hypot2(3.0, 4.0), 25.0)
+
+    global native_fib, native_scale
+
+    @jit
+    def native_fib(n: int) -> int:
+        if n < 2:
+            return n
+        return native_fib(n - 1) + native_fib(n - 2)
+
+    @jit
+    def native_scale(x: float, k: int) -> float:
+        return x * k
+
+    @jit
+    def native_scaled_fib(n: int, x: float) -> float:
+        return native_scale(x, native_fib(n))
+
+    check("native recursion and helper calls", (native_scaled_fib(10, 0.5), native_scaled_fib._mode), (27.5, "native"))
+
+    # Tuple returns: a struct for JIT callers, one boxed tuple for Python
+    global int_divmod
+
+    @jit(mode='int')
+    def int_divmod(a, b):
+        if b == 0:
+            return 0, 0
+        return a // b, a % b
+
+    @jit(mode='int')
+    def int_divmod_sum(a, b):
+        q, r = int_divmod(a, b)
+        lo, hi = 1, 2
+        return q + r + lo + hi
+
+    @jit(mode='float')
+    def float_bounds(a, b):
+        if a < b:
+            return a, b
+        return b, a
+
+    check("tuple return boxed", (int_divmod(17, 5), int_divmod(1, 0), float_bounds(2.0, -1.0)), ((3, 2), (0, 0), (-1.0, 2.0)))
+    check("tuple return unpacked by a jit caller", (int_divmod_sum(17, 5), int_divmod_sum._mode), (8, "int"))
+
+    # raise / assert of builtin exceptions stay in int and float mode
+    global int_checked_div
+
+    @jit(mode='int', int_overflow='wrap')
+    def int_checked_div(a, b):
+        if a < 0:
+            raise ValueError("a must not be negative")
+        assert b != 1, "b is one"
+        return a // b
+
+    @jit(mode='int', int_overflow='wrap')
+    def int_checked_div_total(n):
+        total = 0
+        for i in range(n):
+            total += int_checked_div(10, 4 - i)
+        return total
+
+    @jit(mode='float')
+    def float_checked_sqrt(x):
+        if x < 0.0:
+            raise ValueError
+        return x ** 0.5
+
+    def raised(fn, *args):
+        try:
+            fn(*args)
+        except Exception as exc:
+            return type(exc).__name__, str(exc)
+        return None
+
+    check("native raise", (int_checked_div(9, 2), raised(int_checked_div, -1, 2), raised(int_checked_div, 3, 1),
+                           raised(int_checked_div, 3, 0), raised(float_checked_sqrt, -1.0), float_checked_sqrt._mode),
+          (4, ("ValueError", "a must not be negative"), ("AssertionError", "b is one"),
+           ("ZeroDivisionError", "integer division or modulo by zero"), ("ValueError", ""), "float"))
+    check("native raise from a jit callee", (int_checked_div_total(3), raised(int_checked_div_total, 6)),
+          (10, ("AssertionError", "b is one")))
+
+    # transitive=True compiles undecorated helpers the function calls
+    global plain_cube, plain_cube_sum, plain_label
+
+    def plain_cube(n):
+        return n * n * n
+
+    def plain_cube_sum(n):
+        total = 0
+        for i in range(n):
+            total += plain_cube(i)
+        return total
+
+    def plain_label(x):
+        return "v" + str(x)
+
+    @jit(mode='int', transitive=True)
+    def transitive_int(n):
+        return plain_cube_sum(n) + 1
+
+    @jit(transitive=True)
+    def transitive_object(items):
+        return [plain_label(x) for x in items]
+
+    check("transitive int helpers", transitive_int(10), 2026)
+    check("transitive object helper", transitive_object([1, 2]), ["v1", "v2"])
+    saved_label = plain_label
+    plain_label = lambda x: "w" + str(x)
+    check("transitive guard on rebinding", transitive_object([3]), ["w3"])
+    plain_label = saved_label
+
     # =========================================================================
     # Test 4: Mode Chains (interop)
     # =========================================================================
@@ -210,6 +1356,842 @@ def main():
         print("  [FAIL] float mode IR not generated")
         failed += 1
 
+    # Value names are dropped from compiles unless the IR is dumped
+    check("dump_ir keeps value names", "entry:" in (ir or ""), True)
+
+    # explain(): per-offset lowering from debug locations
+    @jit("i64(i64, i64)")
+    def explained_axpy(a, b):
+        return a * b + 1
+
+    explained = justjit.explain(explained_axpy, io.StringIO())
+    check("explain native lowering", {row["lowering"] for row in explained["instructions"] if row["opname"] == "BINARY_OP"}, {"native"})
+
+    @jit(mode="int")
+    def int_two_ranges(n):
+        total = 0
+        for i in range(n):
+            total = total + i
+        for j in range(n):
+            total = total + 2 * j
+        return total
+
+    check("int mode sequential range loops", int_two_ranges(10), 135)
+
+    # Ahead-of-time export round trip
+    import tempfile
+    with tempfile.TemporaryDirectory() as tmp:
+        obj_path = os.path.join(tmp, "kernels.o")
+        names = justjit.aot.compile_module([int_add, float_mul], obj_path)
+        kernels = justjit.aot.load_module(obj_path)
+        check("aot exported names", names, ["int_add", "float_mul"])
+        check("aot int add", kernels.int_add(3, 5), 8)
+        check("aot float mul", kernels.float_mul(2.5, 4.0), 10.0)
+
+    # vectorize without NumPy: 1-D buffers and broadcast scalars
+    import array
+
+    @justjit.vectorize(mode='float', ufunc=False)
+    def scaled_sum(x, y, factor):
+        return (x + y) * factor
+
+    check("vectorize buffers", list(scaled_sum(array.array('d', [1.0, 2.0]), array.array('d', [3.0, 4.0]), 0.5)), [2.0, 3.0])
+    check("vectorize scalars", scaled_sum(1.0, 2.0, 2.0), 6.0)
+
+    # Lazy expressions: one fused loop, shared subexpressions computed once
+    la, lb = array.array('d', [1.0, 2.0, 3.0]), array.array('d', [4.0, 5.0, 6.0])
+    shared = justjit.lazy(la) * lb
+    check("lazy fused", list((shared + shared - 1.0).evaluate()), [7.0, 19.0, 35.0])
+    check("lazy expr", list(justjit.expr("sqrt(a * a + b * b) - c", a=la, b=lb, c=0.5)),
+          [math.sqrt(x * x + y * y) - 0.5 for x, y in zip(la, lb)])
+    lazy_big = array.array('d', range(100000))
+    check("lazy parallel blocks", justjit.expr("a * 2.0 + 1.0", a=lazy_big)[-1], 199999.0)
+
+    # Stencils: check-free interior loops, then border cells mapped by the border mode
+    @justjit.stencil(border="reflect")
+    def smooth3(a):
+        return a[-1] + 2.0 * a[0] + a[1]
+
+    check("stencil reflect", list(smooth3(array.array('d', [1.0, 2.0, 4.0]))), [5.0, 9.0, 14.0])
+
+    @justjit.stencil(border="wrap", parallel=True)
+    def laplace(u, h):
+        return (u[-1, 0] + u[1, 0] + u[0, -1] + u[0, 1] - 4.0 * u[0, 0]) * h
+
+    grid = memoryview(array.array('d', [float(i * i) for i in range(64 * 40)])).cast('B').cast('d', (64, 40))
+    lap = laplace(grid, 0.5)
+    def at(i, j):
+        return grid[i % 64, j % 40]
+    check("stencil wrap parallel", all(
+        lap[i, j] == (at(i - 1, j) + at(i + 1, j) + at(i, j - 1) + at(i, j + 1) - 4.0 * at(i, j)) * 0.5
+        for i in range(64) for j in range(40)), True)
+
+    # reduce/scan: small buffers run serially, large ones on the thread pool
+    def add_pair(a, b):
+        return a + b
+
+    def max_pair(a, b):
+        return a if a > b else b
+
+    big = array.array('q', range(100000))
+    check("reduce int parallel", justjit.reduce(add_pair, big, 7), sum(range(100000)) + 7)
+    check("reduce float max", justjit.reduce(max_pair, array.array('d', [3.0, 9.5, -1.0]), -1e300), 9.5)
+    check("scan small", list(justjit.scan(add_pair, array.array('d', [1.0, 2.0, 3.0, 4.0]))), [1.0, 3.0, 6.0, 10.0])
+    prefix = justjit.scan(add_pair, big)
+    check("scan parallel", (prefix[0], prefix[50000], prefix[-1]), (0, 50000 * 50001 // 2, sum(range(100000))))
+
+    # stream: a memory-mapped file folded chunk by chunk, past an 8-byte header
+    with tempfile.TemporaryDirectory() as tmp:
+        dump = os.path.join(tmp, "dump.bin")
+        with open(dump, "wb") as f:
+            f.write(b"HEADER01")
+            big.tofile(f)
+        check("stream chunks", justjit.stream(add_pair, dump, 7, dtype="q", chunk=40000, offset=8), sum(range(100000)) + 7)
+        check("stream max", justjit.stream(max_pair, dump, -1, dtype="q", offset=8), 99999)
+
+    # groupby: native hash aggregation, split across threads for large inputs
+    group_keys = array.array('q', [i % 7 - 3 for i in range(200000)])
+    group_values = array.array('d', [float(i % 5) for i in range(200000)])
+    expected_sums = {}
+    for key, value in zip(group_keys, group_values):
+        expected_sums[key] = expected_sums.get(key, 0.0) + value
+    check("groupby sum", justjit.groupby(group_keys, group_values, "sum"), expected_sums)
+    check("groupby count", justjit.groupby(array.array('i', [5, 1, 5, 5]), op="count"), {1: 1, 5: 3})
+    small_keys, small_max = justjit.groupby(array.array('i', [2, 1, 2]), array.array('q', [4, 9, 6]), "max", output="arrays")
+    check("groupby arrays", (list(small_keys), list(small_max)), ([1, 2], [9, 6]))
+
+    # target='cuda' needs the NVPTX backend and a GPU
+    if justjit.cuda_available():
+        @justjit.vectorize(mode='float', target='cuda')
+        def cuda_scaled_sum(x, y, factor):
+            return (x + y) * factor
+
+        check("vectorize cuda", list(cuda_scaled_sum(array.array('d', [1.0, 2.0]), array.array('d', [3.0, 4.0]), 0.5)), [2.0, 3.0])
+
+    # fastmath with individual flags
+    @justjit.jit(mode='float', fastmath={'reassoc', 'contract'})
+    def sum_squares(n):
+        total = 0.0
+        for i in range(n):
+            total += i * i
+        return total
+
+    check("fastmath flags", sum_squares(10.0), 285.0)
+
+    # vectorized exp/log/sin/cos/tanh: libmvec or the bundled SIMD library, fast under afn
+    def activation(x):
+        return math.tanh(x) + 1.0 / (1.0 + math.exp(-x)) + math.sin(x) * math.cos(x) + math.log(1.0 + x * x)
+
+    inputs = array.array('d', [i * 0.01 - 5.0 for i in range(1000)])
+    expected = [activation(x) for x in inputs]
+    precise = justjit.vectorize(activation, mode='float')(inputs)
+    fast = justjit.vectorize(activation, mode='float', fastmath={'afn'})(inputs)
+    check("vector math", max(abs(a - b) for a, b in zip(precise, expected)) < 1e-14, True)
+    check("vector math afn", max(abs(a - b) for a, b in zip(fast, expected)) < 1e-6, True)
+
+    # math.<name> calls lower to intrinsics / libm in float mode
+    @justjit.jit(mode='float')
+    def polar(x, y):
+        return math.sqrt(x * x + y * y) + math.atan2(y, x)
+
+    check("math calls", polar(3.0, 0.0), 3.0)
+
+    # parallel=True: prange reductions match the serial result
+    @justjit.jit(mode='int', parallel=True)
+    def prange_count(n, k):
+        total = 0
+        largest = 0
+        for i in justjit.prange(n):
+            if i % k == 0:
+                total += i
+            if i > largest:
+                largest = i
+        return total + largest
+
+    check("prange int reduction", prange_count(100000, 7), sum(range(0, 100000, 7)) + 99999)
+    check("prange short loop", prange_count(3, 1), 5)
+
+    # Resizing the pool keeps results; every slot's counters cover the region
+    threads = justjit.get_num_threads()
+    justjit.set_num_threads(3)
+    justjit.parallel_stats(reset=True)
+    resized = prange_count(100000, 7)
+    slots = justjit.parallel_stats()
+    justjit.set_num_threads(threads)
+    check("prange resized pool", (resized, justjit.get_num_threads() == threads), (sum(range(0, 100000, 7)) + 99999, True))
+    check("parallel stats", ([slot["regions"] for slot in slots], sum(slot["chunks"] for slot in slots) > 0), ([1, 1, 1], True))
+
+    # justjit.randint / random draw natively from the same seeded per-thread streams
+    @justjit.jit(mode='int')
+    def roll_dice(n):
+        total = 0
+        for i in range(n):
+            total += justjit.randint(1, 6)
+        return total
+
+    @justjit.jit(mode='float', parallel=True)
+    def estimate_pi(n):
+        hits = 0.0
+        for i in justjit.prange(n):
+            x = justjit.random()
+            y = justjit.random()
+            if x * x + y * y < 1.0:
+                hits += 1.0
+        return 4.0 * hits / n
+
+    justjit.seed(7)
+    native_rolls = roll_dice(1000)
+    justjit.seed(7)
+    check("seeded randint", native_rolls, sum(justjit.randint(1, 6) for _ in range(1000)))
+    check("prange random", abs(estimate_pi(200000) - math.pi) < 0.05, True)
+
+    # justjit.bits and the int bit methods compile to single instructions, with the Python meaning
+    @justjit.jit(mode='int', int_overflow='wrap')
+    def bit_mix(h, k):
+        h = justjit.bits.rotl(h ^ (k * 0x5BD1E995), 13)
+        return justjit.bits.bswap(h ^ justjit.bits.ushr(h, 29)) + justjit.bits.ctz(k) + justjit.bits.clz(h)
+
+    @justjit.jit(mode='int')
+    def bit_counts(a, b):
+        return (a ^ b).bit_count() * 1000 + a.bit_length() + justjit.bits.udiv(a, b) + justjit.bits.ult(a, b)
+
+    @justjit.jit(mode='int32')
+    def bit_popcount32(a, b):
+        return justjit.bits.popcount(a) + justjit.bits.clz(b)
+
+    check("bits rotate swap", [bit_mix(h, k) for h, k in ((1, 8), (-5, 3), (2**62, -1))],
+          [bit_mix._original_func(h, k) for h, k in ((1, 8), (-5, 3), (2**62, -1))])
+    check("bits methods unsigned", (bit_counts(-(2**63), 3), bit_counts(-1, 2), bit_counts(12, 5)),
+          (bit_counts._original_func(-(2**63), 3), bit_counts._original_func(-1, 2), bit_counts._original_func(12, 5)))
+    try:
+        bit_counts(5, 0)
+        raised = False
+    except ZeroDivisionError:
+        raised = True
+    check("bits udiv by zero", raised, True)
+    check("bits int32", bit_popcount32(-1, 1), 32 + 31)
+
+    # vec modes loop the vector body over whole buffers, including a partial tail
+    @justjit.jit(mode='vec8i')
+    def vec_mul(a, b):
+        return a * b
+
+    check("vec8i batch", list(vec_mul(array.array('i', range(10)), array.array('i', [3] * 10))), [3 * i for i in range(10)])
+
+    @justjit.jit(mode='vec8d')
+    def vec_axpy(a, b):
+        return a * b + b
+
+    check("vec8d batch", list(vec_axpy(array.array('d', [1.0] * 11), array.array('d', range(11)))), [2.0 * i for i in range(11)])
+
+    # justjit.simd calls lower to masks, blends, shuffles and lane reductions
+    @justjit.jit(mode='vec4f')
+    def vec_max_total(a, b):
+        return justjit.simd.hsum(justjit.simd.select(a > b, a, b))
+
+    @justjit.jit(mode='vec8i')
+    def vec_reverse_clamp(a, b):
+        return justjit.simd.minimum(justjit.simd.shuffle(a, (7, 6, 5, 4, 3, 2, 1, 0)), b)
+
+    check("simd select hsum", vec_max_total(array.array('f', [1, 5, 2, 8]), array.array('f', [4, 3, 6, 1])), 23.0)
+    check("simd shuffle minimum", vec_reverse_clamp(array.array('i', range(8)), array.array('i', [4] * 8)), [4, 4, 4, 4, 3, 2, 1, 0])
+
+    # u8 / i16 modes saturate min/max clamps of a sum and unpack averages
+    @justjit.jit(mode='vec32u8')
+    def vec_brighten(a, b):
+        return min(a + b, 255)
+
+    @justjit.jit(mode='vec16u8')
+    def vec_average(a, b):
+        return (a + b) // 2
+
+    @justjit.jit(mode='vec16i16')
+    def vec_mix(a, b):
+        return min(max(a + b, -32768), 32767)
+
+    pixels = array.array('B', [i * 7 % 256 for i in range(40)])
+    check("vec32u8 saturating add", list(vec_brighten(pixels, array.array('B', [200] * 40))), [min(p + 200, 255) for p in pixels])
+    check("vec16u8 average", list(vec_average(pixels, array.array('B', [255] * 40))), [(p + 255) // 2 for p in pixels])
+    samples = array.array('h', [30000, -30000, 5, -5] * 5)
+    check("vec16i16 saturating mix", list(vec_mix(samples, samples)), [max(min(2 * s, 32767), -32768) for s in samples])
+
+    # optional_f64 columns: a validity bitmap on one side, NaN sentinels on the other
+    @jit(mode='optional_f64')
+    def optional_add(a, b):
+        return a + b
+
+    col_values, col_valid = optional_add(
+        (array.array('d', [1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0]), bytes([0b11111011, 0b1])),
+        array.array('d', [10.0, float('nan')] + [10.0] * 7),
+    )
+    check("optional_f64 column bitmap", list(col_valid), [0b11111001, 0b1])
+    check("optional_f64 column values", [v for v in col_values if v == v], [11.0, 14.0, 15.0, 16.0, 17.0, 18.0, 19.0])
+
+    # Arrow arrays through __arrow_c_array__: values and the null bitmap are read in place
+    try:
+        import pyarrow as pa
+
+        arrow_values, arrow_valid = optional_add(pa.array([1.0, None, 3.0]), pa.array([10.0, 20.0, 30.0]))
+        check("optional_f64 arrow nulls", (list(arrow_valid), arrow_values[0], arrow_values[2]), ([0b101], 11.0, 33.0))
+        check("vec8d arrow input", list(vec_axpy(pa.array([1.0] * 3), pa.array([0.0, 1.0, 2.0]))), [0.0, 2.0, 4.0])
+    except ImportError:
+        print("  [SKIP] pyarrow not available")
+
+    # Runtime statistics: native calls, deopts by exception type, compile time by mode
+    @jit(mode='int')
+    def counted_inc(x):
+        return x + 1
+
+    justjit.enable_stats()
+    counted_inc(1)
+    counted_inc(2)
+    counted_inc(2 ** 70)  # Beyond int64: deoptimizes to the interpreter
+    justjit.enable_stats(False)
+    counted = next(f for name, f in justjit.stats()["functions"].items() if name.endswith(".counted_inc"))
+    check("stats calls and deopts", (counted["calls"], counted["deopts"]), (3, 1))
+    check("stats compile by mode", justjit.stats()["compile"]["int"]["count"] >= 1, True)
+    check("stats prometheus", "justjit_calls_total{" in justjit.stats(prometheus=True), True)
+
+    # Compile phase timers: every phase is recorded and the optimizer's IR sizes are kept
+    phases = counted_inc._jit_compile_stats
+    check("compile stats phases", all(phases[p] >= 0.0 for p in ("decode", "codegen", "optimize", "materialize")), True)
+    check("compile stats sizes", phases["ir_instructions_after"] > 0 and phases["code_bytes"] > 0, True)
+
+    # Object-mode error checks after the first reuse its return block
+    @jit
+    def shared_errors(a, b):
+        return a * b + a - b
+
+    check("shared slow paths", (shared_errors(3, 4), shared_errors._jit_compile_stats["shared_slow_paths"] >= 2), (11, True))
+    check("compile report", any(name.endswith(".counted_inc") for name, _ in justjit.compile_report(io.StringIO())), True)
+
+    # Rejection report: int mode gives up on BUILD_LIST and says where
+    @jit(mode='int')
+    def int_builds_list(a, b):
+        pair = [a, b]
+        return a
+
+    int_builds_list(1, 2)
+    build_list = justjit.report(io.StringIO())["opcodes"].get("BUILD_LIST", {})
+    check("report opcode", (build_list.get("modes", {}).get("int", 0) >= 1, any(f.endswith(".int_builds_list") for f in build_list.get("functions", []))), (True, True))
+
+    # Hotness sampling: a cold function runs interpreted until sampled hot, then compiles
+    justjit.start_sampling(interval=0.001, hot_samples=2)
+    try:
+        @jit(mode='int')
+        def sampled_sum(n):
+            total = 0
+            i = 0
+            while i < n:
+                total = total + i
+                i = i + 1
+            return total
+
+        sampled = [sampled_sum(300000) for _ in range(3)]
+    finally:
+        justjit.stop_sampling()
+    hot = {name: entry for name, entry in justjit.hot_functions().items() if name.endswith(".sampled_sum")}
+    check("sampling finds hot function", (sampled[-1], sum(e["samples"] for e in hot.values()) >= 2), (sum(range(300000)), True))
+    import tempfile
+    with tempfile.TemporaryDirectory() as profile_dir:
+        profile_path = os.path.join(profile_dir, "hot.json")
+        justjit.save_profile(profile_path)
+        justjit.load_profile(profile_path)
+    check("loaded profile marks hot", all(justjit.hotness.is_hot(name) for name in hot), True)
+
+    # Benchmark harness: one case, and a run compared with itself changes nothing
+    from justjit import bench
+    bench_results = bench.run(select=["int_add"], warmup=0, repeat=3, min_time=0.001, first_call_samples=1)
+    check("bench case", sorted(bench_results["cases"]["int_add"]),
+          ["call", "fallback_rate", "first_call_ms", "mode", "peak_rss_mb", "python_call", "speedup"])
+    check("bench fallback rate", bench_results["cases"]["int_add"]["fallback_rate"], 0.0)
+    check("bench compare", {row[4] for row in bench.compare(bench_results, bench_results)}, {"same"})
+    # Workload corpus: whole programs compiled together give the CPython answers
+    workload_cases = {case.name: case for case in bench.corpus_cases("workloads")}
+    richards_case, go_case = workload_cases["richards"], workload_cases["go"]
+    check("bench workloads", (richards_case.build(None)(1), go_case.build(None)(1)), ((9297, 23246), go_case.func(1)))
+
+    # Event tracing: a compile span per function, as Chrome JSON and Perfetto protobuf
+    justjit.start_tracing()
+
+    @jit(mode='int')
+    def traced_square(x):
+        return x * x
+
+    traced_square(7)
+    justjit.stop_tracing()
+    with tempfile.TemporaryDirectory() as trace_dir:
+        justjit.dump_trace(os.path.join(trace_dir, "trace.json"), clear=False)
+        with open(os.path.join(trace_dir, "trace.json")) as trace_file:
+            chrome = json.load(trace_file)["traceEvents"]
+        perfetto_events = justjit.dump_trace(os.path.join(trace_dir, "trace.pftrace"))
+    check("trace compile span", any(e["name"] == "compile" and e.get("args") == {"detail": "traced_square"} for e in chrome), True)
+    check("trace perfetto", perfetto_events, len(chrome))
+
+    # Threads calling a function that is not compiled yet: one compiles, the rest keep running
+    @jit(mode='int')
+    def threaded_square(x):
+        return x * x
+
+    thread_results = [None] * 8
+
+    def call_square(index):
+        thread_results[index] = sum(threaded_square(i) for i in range(200))
+
+    square_threads = [threading.Thread(target=call_square, args=(i,)) for i in range(8)]
+    for thread in square_threads:
+        thread.start()
+    for thread in square_threads:
+        thread.join()
+    check("concurrent first calls", thread_results, [sum(i * i for i in range(200))] * 8)
+
+    # precompile_all before fork: the child calls native code compiled in the parent
+    @jit(mode='int', lazy=True)
+    def forked_cube(x):
+        return x * x * x
+
+    check("precompile_all", justjit.precompile_all() >= 1 and forked_cube._jit_instance.lookup("forked_cube") != 0, True)
+    if hasattr(os, "fork"):
+        child = os.fork()
+        if child == 0:
+            os._exit(0 if forked_cube(3) == 27 else 1)
+        check("forked child runs precompiled code", os.waitstatus_to_exitcode(os.waitpid(child, 0)[1]), 0)
+
+    # jit_module: a module's functions compile together, callees first (square inlines into sum_squares)
+    batch = types.ModuleType("justjit_batch_test")
+    exec(
+        "def square(x):\n    return x * x\n\n"
+        "def sum_squares(n):\n    total = 0\n    i = 0\n    while i < n:\n"
+        "        total = total + square(i)\n        i = i + 1\n    return total\n",
+        batch.__dict__,
+    )
+    check("jit_module wrappers", sorted(justjit.jit_module(batch, mode='int')), ["square", "sum_squares"])
+    check("jit_module direct call", batch.sum_squares(4), 14)
+    check("compile_many", justjit.compile_many([batch.square, batch.sum_squares, len]), 2)
+    batch.square.unload()
+    check("inlined callee unloaded with its caller", batch.sum_squares(5), 30)
+
+    # jit_module only lowers: each function is optimized and compiled on its first call
+    lazy_batch = types.ModuleType("justjit_lazy_batch_test")
+    exec("def used(x):\n    return x + 1\n\ndef unused(x):\n    return x - 1\n", lazy_batch.__dict__)
+    justjit.jit_module(lazy_batch, mode='int')
+
+    def pending_ir(wrapper):
+        return wrapper._jit_instance.get_memory_usage()["functions"][wrapper.__name__]["pending_ir_instructions"]
+
+    check("jit_module defers materialization", pending_ir(lazy_batch.used) > 0 and pending_ir(lazy_batch.unused) > 0, True)
+    check("lazy function runs through its stub", lazy_batch.used(41), 42)
+    check("only the called function materialized", (pending_ir(lazy_batch.used), pending_ir(lazy_batch.unused) > 0), (0, True))
+
+    # A deferred compile that fails runs the call in the interpreter instead of aborting
+    failing_batch = types.ModuleType("justjit_failing_batch_test")
+    exec("def callee(x):\n    return x * 3\n\ndef caller(x):\n    return callee(x) + 1\n"
+         "\ndef alone(x):\n    return x - 2\n", failing_batch.__dict__)
+    justjit.jit_module(failing_batch, mode='int')
+    check("deferred caller before failures", failing_batch.caller(2), 7)
+    from justjit import _core
+    _core._fail_deferred_compiles(True)
+    try:
+        failed_calls = (failing_batch.alone(10), failing_batch.alone(11), failing_batch.caller(5))
+    finally:
+        _core._fail_deferred_compiles(False)
+    check("failed deferred compile falls back", failed_calls, (8, 9, 16))
+
+    # lazy=False compiles at decoration; warmup() compiles the rest, callees first
+    @jit(mode='int', lazy=False)
+    def eager_twice(x):
+        return x * 2
+
+    check("lazy=False compiles at decoration", eager_twice._jit_instance.lookup("eager_twice") != 0, True)
+    warm = types.ModuleType("justjit_warmup_test")
+    exec("def inc(x):\n    return x + 1\n\ndef inc_twice(x):\n    return inc(inc(x))\n", warm.__dict__)
+    warm.inc, warm.inc_twice = jit(warm.inc, mode='int'), jit(warm.inc_twice, mode='int')
+    check("warmup", justjit.warmup([warm.inc_twice, warm.inc, eager_twice]), 3)
+    check("warmup compiled before the first call", (warm.inc_twice._jit_instance.lookup("inc_twice") != 0, warm.inc_twice(5)), (True, 7))
+
+    # Pickled @jit functions carry their object code; the receiving wrapper links it instead of compiling
+    import pickle
+
+    shipped = types.ModuleType("justjit_pickle_test")
+    sys.modules[shipped.__name__] = shipped
+    exec("def poly(x):\n    return 3 * x * x + 2 * x + 1\n", shipped.__dict__)
+    plain_poly = shipped.poly
+    shipped.poly = jit(plain_poly, mode='int')
+    payload = pickle.dumps(shipped.poly)
+    shipped.poly = jit(plain_poly, mode='int')  # What a worker process would have after importing the module
+    received = pickle.loads(payload)
+    check("pickled function links its object code",
+          (received is shipped.poly, received._jit_instance.lookup("poly") != 0, received(4)), (True, True, 57))
+
+    # A remote cache backend receives new objects and serves them to a fresh compile
+    class DictBackend:
+        def __init__(self):
+            self.entries, self.hits = {}, 0
+
+        def get(self, key):
+            data = self.entries.get(key)
+            self.hits += data is not None
+            return data
+
+        def put(self, key, data):
+            self.entries[key] = data
+
+    def backend_poly(x):
+        return 3 * x * x + 7 * x + 1
+
+    backend = DictBackend()
+    justjit.set_cache_backend(backend)
+    try:
+        first = jit(mode='int')(backend_poly)(5)
+        uploaded = len(backend.entries)
+        second = jit(mode='int')(backend_poly)(5)
+        for key in backend.entries:
+            backend.entries[key] = b"\0" * 32 + backend.entries[key][32:]
+        hits = backend.hits
+        third = jit(mode='int')(backend_poly)(5)
+    finally:
+        justjit.set_cache_backend(None)
+    check("cache backend shares objects",
+          (first, second, third, uploaded > 0, hits > 0, backend.hits > hits),
+          (111, 111, 111, True, True, True))
+
+    # @jit on a class compiles its methods
+    @jit(mode='int')
+    class JitArith:
+        @staticmethod
+        def twice(x):
+            return x + x
+
+    check("jit class static method", JitArith.twice(21), 42)
+
+    # Tuple temporaries: a 4-way rotation never builds its tuple; lists, tuples and iterators unpack
+    @jit
+    def rotate4(n):
+        a, b, c, d = 1, 2, 3, 4
+        i = 0
+        while i < n:
+            a, b, c, d = b, c, d, a
+            i = i + 1
+        return a * 1000 + b * 100 + c * 10 + d
+
+    @jit
+    def unpack3(seq):
+        x, y, z = seq
+        return x + y + z
+
+    check("rotated tuple unpack", rotate4(5), 2341)
+    check("unpack list/tuple/iterator", [unpack3([1, 2, 3]), unpack3((4, 5, 6)), unpack3(iter("abc"))], [6, 15, "abc"])
+    try:
+        unpack3([1, 2])
+    except ValueError as e:
+        check("unpack too few", str(e), "not enough values to unpack (expected 3, got 2)")
+    else:
+        check("unpack too few", None, "ValueError")
+
+    # Closures from one factory share a single compile; each call sees its own cells
+    def make_kernel(scale, offset):
+        def kernel(x):
+            return x * scale + offset
+        return jit(kernel)
+
+    shared_before = len(justjit._shared_closure_cores)
+    kernels = [make_kernel(k, 1) for k in range(3)]
+    check("shared closure results", [kern(10) for kern in kernels], [1, 11, 21])
+    check("closures compile once", len(justjit._shared_closure_cores) - shared_before, 1)
+
+    # s += x in a loop grows the string in place, but never one that is shared
+    @jit
+    def join_digits(n):
+        s = ""
+        for i in range(n):
+            s += str(i)
+        return s
+
+    @jit
+    def append_shared(s):
+        t = ""
+        t += s
+        kept = t
+        t += "!"
+        return kept, t
+
+    check("str += loop", join_digits(12), "01234567891011")
+    check("str += keeps aliases", append_shared("ab"), ("ab", "ab!"))
+
+    # Float and int results reuse operands only the stack holds, never a shared one
+    @jit
+    def float_dot(xs, ys):
+        acc = 0.0
+        for i in range(len(xs)):
+            acc = acc + xs[i] * ys[i]
+        return acc
+
+    @jit
+    def add_keeps_operands(a, b):
+        acc = 0.0
+        acc = acc + a
+        kept = acc
+        acc = acc + b
+        return a, kept, acc, (a * 1000) + (b * 1000)
+
+    check("float acc reuse", float_dot([1.5, 2.0, 3.0], [2.0, 0.5, 1.0]), 7.0)
+    check("result reuse keeps aliases", add_keeps_operands(1.5, 2.5), (1.5, 1.5, 4.0, 4000.0))
+    check("int result reuse", add_keeps_operands(3, 4)[3], 7000)
+
+    # module.attr in an object-mode loop reads a watched cache; rebinding the attribute is seen
+    attr_mod = types.ModuleType("justjit_module_attr_test")
+    exec("import math\n\ndef norms(n):\n    total = 0.0\n    for i in range(n):\n"
+         "        total += math.sqrt(i) + math.pi\n    return total\n", attr_mod.__dict__)
+    norms = jit(attr_mod.norms)
+    check("module attribute loop", round(norms(4), 6), round(sum(math.sqrt(i) + math.pi for i in range(4)), 6))
+    fake_math = types.ModuleType("math")
+    fake_math.sqrt, fake_math.pi = (lambda v: v), 0.0
+    attr_mod.math = fake_math
+    check("module attribute rebound", norms(4), 6.0)
+    fake_math.pi = 1.0
+    check("module attribute mutated", norms(4), 10.0)
+
+    # Function-level imports are cached per site; replacing the sys.modules entry is seen
+    @jit
+    def imported_names():
+        import colorsys
+        from os import path
+        return colorsys.__name__, path is os.path
+
+    check("cached import", [imported_names(), imported_names()], [("colorsys", True)] * 2)
+    real_colorsys = sys.modules["colorsys"]
+    sys.modules["colorsys"] = types.ModuleType("swapped")
+    try:
+        check("cached import rebound", imported_names(), ("swapped", True))
+    finally:
+        sys.modules["colorsys"] = real_colorsys
+
+    # freeze_globals: an int-mode function reads module constants, and rebinding one recompiles it
+    frozen = types.ModuleType("justjit_freeze_test")
+    exec("N = 10\nSTEP = 3\n\ndef scaled(x):\n    return x * N + STEP\n", frozen.__dict__)
+    scaled = jit(frozen.scaled, mode='int')
+    check("frozen globals", scaled(2), 23)
+    frozen.N = 100
+    check("frozen global rebound", [scaled(2), scaled(2)], [203, 203])
+    check("frozen globals not a direct-call target", scaled._native_address(), 0)
+
+    # Frozen-global guards embed this process's objects, so such code never goes to the object cache
+    import tempfile
+    previous_cache_dir = justjit.get_cache_dir()
+    with tempfile.TemporaryDirectory() as cache_dir:
+        justjit.set_cache_dir(cache_dir)
+        try:
+            frozen.N = 10
+            scaled_first = jit(frozen.scaled, mode='int')
+            scaled_second = jit(frozen.scaled, mode='int')
+            check("frozen globals bypass the object cache", (scaled_first(2), os.listdir(cache_dir)), (23, []))
+            frozen.N = 7
+            check("frozen globals cache round trip", (scaled_second(2), scaled_first(2)), (17, 17))
+        finally:
+            justjit.set_cache_dir(previous_cache_dir)
+
+    # Object cache: keyed by code, constants and options, shared across cores,
+    # skipped for code that embeds another function's address or a record layout
+    def cached_poly(k, opt_level=3):
+        namespace = {}
+        exec(f"def cached_poly(x):\n    return x * x + {k} * x + 1\n", namespace)
+        return jit(namespace["cached_poly"], mode='int', opt_level=opt_level)
+
+    with tempfile.TemporaryDirectory() as cache_dir:
+        def cached_objects():
+            return {name: os.stat(os.path.join(cache_dir, name)).st_ino
+                    for name in os.listdir(cache_dir) if name.endswith(".o")}
+
+        justjit.set_cache_dir(cache_dir)
+        try:
+            check("object cache store", (cached_poly(3)(2), len(cached_objects())), (11, 1))
+            stored = cached_objects()
+            check("object cache hit across cores", (cached_poly(3)(5), cached_objects()), (41, stored))
+            check("object cache miss on constants", (cached_poly(4)(2), len(cached_objects())), (13, 2))
+            check("object cache miss on opt_level", (cached_poly(3, opt_level=1)(2), len(cached_objects())), (11, 3))
+
+            cache_ns = {"jit": jit}
+            exec("@jit(mode='int')\ndef cached_leaf(x):\n    return x + 1\n\n"
+                 "@jit(mode='int')\ndef cached_caller(x):\n    return cached_leaf(x) * 2\n", cache_ns)
+            cache_ns["cached_leaf"](1)
+            stored = cached_objects()
+            check("object cache bypass for direct calls", (cache_ns["cached_caller"](3), cached_objects()), (8, stored))
+
+            @jit
+            def cached_notional(o: Order, fee: float) -> float:
+                return o.price * o.qty + fee
+
+            check("object cache bypass for records", (cached_notional(Order(2.5, 4), 1.0), cached_objects()), (11.0, stored))
+        finally:
+            justjit.set_cache_dir(previous_cache_dir)
+
+        # A fresh process picks the directory up from the environment and hits the entries above
+        import subprocess
+        env = dict(os.environ, JUSTJIT_CACHE_DIR=cache_dir, PYTHONPATH=os.pathsep.join(sys.path))
+        probe = subprocess.run(
+            [sys.executable, "-c",
+             "import justjit\n"
+             "def cached_poly(x):\n    return x * x + 3 * x + 1\n"
+             "print(justjit.get_cache_dir(), justjit.jit(cached_poly, mode='int')(2))\n"],
+            env=env, capture_output=True, text=True)
+        stored = cached_objects()
+        check("JUSTJIT_CACHE_DIR", (probe.stdout.split(), len(stored)), ([cache_dir, "11"], 4))
+
+    # specialize=('name',): a clone per distinct value, picked at entry
+    @jit(mode='int', specialize=('window',))
+    def window_sum(n, window):
+        total = 0
+        for i in range(n - window):
+            for k in range(window):
+                total += i + k
+        return total
+
+    def window_sum_py(n, window):
+        return sum(i + k for i in range(n - window) for k in range(window))
+
+    window_calls = [(20, 3), (20, 5), (20, 3), (30, 5)] + [(12, w) for w in range(1, 12)]
+    check("value specialization", [window_sum(n, w) for n, w in window_calls],
+          [window_sum_py(n, w) for n, w in window_calls])
+    check("value specialization keywords", window_sum(n=20, window=3), window_sum_py(20, 3))
+
+    @jit(specialize='scale')
+    def scaled_label(x, scale):
+        return x * scale
+
+    check("value specialization types", [scaled_label(2, 3), scaled_label(2, 3.0), scaled_label("a", 3)], [6, 6.0, "aaa"])
+    try:
+        jit(specialize=('n',))(lambda n: [n := n + 1])
+        check("value specialization assigned parameter", "accepted", "ValueError")
+    except ValueError:
+        check("value specialization assigned parameter", "ValueError", "ValueError")
+
+    # specialize=True in native mode: a clone per small, stable array shape, extents compiled in
+    @jit(signature='f64(f64[:], f64[:])', specialize=True)
+    def shaped_dot(a, b):
+        total = 0.0
+        for i in range(len(a)):
+            total += a[i] * b[i]
+        return total
+
+    @jit(signature='f64(f64[:, :])', specialize=True)
+    def shaped_trace(m):
+        n, _ = m.shape
+        total = 0.0
+        for i in range(n):
+            total += m[i, i]
+        return total
+
+    vec3, vec4 = array.array('d', [1.0, 2.0, 3.0]), array.array('d', [1.0, 2.0, 3.0, 4.0])
+    check("shape clones", {(shaped_dot(vec3, vec3), shaped_dot(vec4, vec4)) for _ in range(40)}, {(14.0, 30.0)})
+    strided = memoryview(array.array('d', [1.0, 0.0, 2.0, 0.0, 3.0, 0.0]))[::2]
+    check("shape clone skips strided views", shaped_dot(strided, vec3), 14.0)
+    mat3 = memoryview(array.array('d', [1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0])).cast('B').cast('d', (3, 3))
+    check("shape clone of a matrix", {shaped_trace(mat3) for _ in range(40)}, {15.0})
+
+    # Consecutive range() loops over the same bounds fuse into one native loop
+    def passes_py(a, tmp, out):
+        for i in range(len(a)):
+            tmp[i] = a[i] * 2.0
+        for j in range(len(a)):
+            tmp[j] = tmp[j] - 1.0
+        for i in range(len(a)):
+            out[i] = tmp[i] if tmp[i] < 5.0 else 5.0
+
+    passes = jit(signature='void(f64[:], f64[:], f64[:])')(passes_py)
+    src = array.array('d', [0.5, 1.0, 2.0, 3.0, 4.0])
+    fused_out, plain_out = array.array('d', bytes(40)), array.array('d', bytes(40))
+    passes(src, array.array('d', bytes(40)), fused_out)
+    passes_py(src, array.array('d', bytes(40)), plain_out)
+    check("fused range loops", fused_out.tolist(), plain_out.tolist())
+    shared = array.array('d', [1.0, 2.0, 3.0, 4.0, 5.0, 6.0])
+    view, expected = memoryview(shared), array.array('d', shared)
+    passes(view[:5], view[1:], view[:5])
+    passes_py(memoryview(expected)[:5], memoryview(expected)[1:], memoryview(expected)[:5])
+    check("fused range loops with overlapping arrays", shared.tolist(), expected.tolist())
+
+    # regions=True: the numeric loops of an object-mode function run as native regions
+    def weighted_py(scales, name, values, out):
+        try:
+            scale = scales[name]
+        except KeyError:
+            scale = 1.0
+        total = 0.0
+        for i in range(len(values)):
+            out[i] = values[i] * scale
+            total += math.sqrt(out[i])
+        a, b = 0, 1
+        for _ in range(40):
+            a, b = b, a + b
+        return f"{name}: {total:.6f} {a}"
+
+    weighted = jit(regions=True)(weighted_py)
+    weights = array.array('d', [1.0, 4.0, 9.0, 16.0])
+    region_out, plain_out = array.array('d', bytes(32)), array.array('d', bytes(32))
+    check("native regions", [weighted({"x": 4.0}, key, weights, region_out) for key in "xy"],
+          [weighted_py({"x": 4.0}, key, weights, plain_out) for key in "xy"])
+    check("native regions store arrays", region_out.tolist(), plain_out.tolist())
+    check("native regions of a list", weighted({}, "z", [1.0, 4.0], [0.0, 0.0]), weighted_py({}, "z", [1.0, 4.0], [0.0, 0.0]))
+
+    # trace_loops=True: the methods a hot loop calls are inlined behind class guards
+    class TraceParticle:
+        def __init__(self, x):
+            self.x = x
+
+        def step(self, dt):
+            self.x += dt
+            return self.x
+
+    class TraceHeavy(TraceParticle):
+        def step(self, dt):
+            if self.x > 100.0:
+                return 0.0
+            self.x += dt / 2.0
+            return self.x
+
+    class TraceLight(TraceParticle):
+        def step(self, dt):
+            return -dt
+
+    def trace_simulate_py(particles, steps):
+        total = 0.0
+        for _ in range(steps):
+            for p in particles:
+                total += p.step(0.5)
+        return total
+
+    trace_simulate = jit(trace_loops=True, trace_threshold=50)(trace_simulate_py)
+    trace_results = [trace_simulate([TraceParticle(1.0), TraceHeavy(2.0)], 30) for _ in range(25)]
+    check("loop traces", trace_results, [trace_simulate_py([TraceParticle(1.0), TraceHeavy(2.0)], 30)] * 25)
+    if hasattr(sys, "monitoring"):
+        check("loop trace sites", {name.split(".")[-2] for _, names in trace_simulate.trace_sites for name in names},
+              {"TraceParticle", "TraceHeavy"})
+    check("loop trace side exit", trace_simulate([TraceLight(0.0), TraceHeavy(200.0)], 4),
+          trace_simulate_py([TraceLight(0.0), TraceHeavy(200.0)], 4))
+
+    # A subinterpreter gets an ImportError instead of the main interpreter's module
+    try:
+        import _testcapi
+    except ImportError:
+        _testcapi = None
+    if sys.version_info >= (3, 12) and hasattr(_testcapi, "run_in_subinterp"):
+        subinterp_source = (
+            f"import sys\nsys.path[:0] = {sys.path!r}\n"
+            "try:\n    import justjit\nexcept ImportError as e:\n    assert 'main interpreter' in str(e)\n"
+            "else:\n    raise AssertionError('imported')\n"
+        )
+        check("subinterpreter import refused", _testcapi.run_in_subinterp(subinterp_source), 0)
+
+    # enable_profiling: functions compiled afterwards get perf map entries
+    if sys.platform.startswith("linux"):
+        justjit.enable_profiling()
+
+        @jit(mode='int')
+        def profiled_add(a, b):
+            return a + b
+
+        perf_map = f"/tmp/perf-{os.getpid()}.map"
+        check("perf map entries", (profiled_add(2, 3), os.path.getsize(perf_map) > 0), (5, True))
+
     # =========================================================================
     # Test 6: inline_c
     # =========================================================================
@@ -248,6 +2230,133 @@ def main():
         step3 = float32_half(step2)  # 108
         check("JIT->C->JIT chain", step3, 108.0)
 
+        # Same source again: served from the compile cache, no second clang run
+        again = inline_c('''
+            double c_square(double x) { return x * x; }
+            double c_cube(double x) { return x * x * x; }
+            double c_add(double a, double b) { return a + b; }
+            int c_gcd(int a, int b) {
+                while (b != 0) { int t = b; b = a % b; a = t; }
+                return a;
+            }
+        ''')
+        mixed = inline_c('''
+            double c_mixed6(int a, double b, long long c, float d, int e, double f) {
+                return a * b + c * d + e * f;
+            }
+        ''')
+        check("C mixed 6 params", mixed['c_mixed6'](2, 1.5, 3, 0.5, 4, 0.25), 5.5)
+        # Pointer parameters take buffers zero-copy; the element type is checked
+        buffers = inline_c('''
+            void c_scale(double* a, long long n, double k) {
+                for (long long i = 0; i < n; i++) a[i] *= k;
+            }
+        ''')
+        scaled = array.array('d', [1.0, 2.0, 3.0])
+        buffers['c_scale'](scaled, len(scaled), 2.0)
+        try:
+            buffers['c_scale'](array.array('i', [1]), 1, 2.0)
+            wrong_type = "accepted"
+        except TypeError:
+            wrong_type = "TypeError"
+        check("C buffer params", (list(scaled), wrong_type), ([2.0, 4.0, 6.0], "TypeError"))
+        # Structs by value: tuples in, namedtuples out, through clang-built shims
+        structs = inline_c('''
+            typedef struct { double mean; double var; } Stats;
+            typedef struct { int lo; int hi; } Range;
+            Stats c_stats(const double* x, long long n) {
+                Stats s = {0, 0};
+                for (long long i = 0; i < n; i++) s.mean += x[i];
+                s.mean /= n;
+                for (long long i = 0; i < n; i++) s.var += (x[i] - s.mean) * (x[i] - s.mean);
+                s.var /= n;
+                return s;
+            }
+            int c_span(Range r) { return r.hi - r.lo; }
+            Range c_widen(Range r, int by) { Range o = {r.lo - by, r.hi + by}; return o; }
+        ''')
+        stats = structs['c_stats'](array.array('d', [1.0, 2.0, 3.0, 4.0]), 4)
+        check("C struct by value", (stats.mean, stats.var, structs['c_span']((3, 10)),
+                                    tuple(structs['c_widen']((3, 10), 2))), (2.5, 1.25, 7, (1, 12)))
+        check("C compile cache", (again['c_gcd'] is c_funcs['c_gcd'], again['c_gcd'](48, 18)), (True, 6))
+        # Captured values are bound after linking: new values reuse the compile
+        scaled_by = [inline_c('''
+            double c_scaled(double x) { return x * scale + xs[1] + offs_len; }
+        ''', captured_vars={"scale": k, "xs": (0.0, k), "offs": [1, 2, 3]}) for k in (2.0, 3.0)]
+        check("C captured rebind", (scaled_by[1]['c_scaled'] is scaled_by[0]['c_scaled'],
+                                    scaled_by[1]['c_scaled'](10.0)), (True, 36.0))
+        # A list of sources: separate translation units compiled in parallel and linked
+        units = inline_c([
+            "double c_poly(double x) { return (x + offset) * x; }",
+            "double c_poly(double x);\n"
+            "double c_poly_sum(long long n) { double s = 0; for (long long i = 0; i < n; i++) s += c_poly(i) + offset; return s; }",
+        ], captured_vars={"offset": 1.0})
+        check("C multiple units", units['c_poly_sum'](4), 24.0)
+        # IR is kept as bitcode and only printed here
+        check("C IR on demand", "define double @c_poly_sum" in dump_c_ir(), True)
+        # nogil="auto" drops the GIL around pure functions while another thread runs
+        pure = inline_c('''
+            long long c_spin_sum(long long n) {
+                volatile long long s = 0;
+                for (long long i = 0; i < n; i++) s += i;
+                return s;
+            }
+        ''', nogil="auto")
+        ticks = []
+        ticker = threading.Thread(target=lambda: [ticks.append(1) for _ in range(1000)])
+        ticker.start()
+        total = pure['c_spin_sum'](1000000)
+        ticker.join()
+        check("C nogil auto", (total, len(ticks)), (499999500000, 1000))
+        # Typed @jit code calls (and may inline) scalar C functions directly
+        global c_tri
+        c_tri = inline_c('''
+            long long c_tri(long long n) { return n * (n + 1) / 2; }
+        ''')['c_tri']
+
+        @jit
+        def sum_tri(n: int) -> int:
+            total = 0
+            for i in range(n):
+                total += c_tri(i)
+            return total
+
+        check("C call from native mode", (sum_tri(10), sum_tri._mode), (165, "native"))
+        # OpenMP loops run on the prange() pool
+        omp = inline_c('''
+            long long c_omp_sum(long long n) {
+                long long total = 0;
+                #pragma omp parallel for reduction(+:total) schedule(dynamic, 64)
+                for (long long i = 0; i < n; i++) total += i;
+                return total;
+            }
+        ''', openmp=True)
+        check("C OpenMP reduction", omp['c_omp_sum'](100000), 4999950000)
+
+        # A region capturing more variables than the runtime forwards fails to compile, not at run time
+        def omp_wide(n):
+            names = [f"v{i}" for i in range(n)]
+            return (f"long long c_omp_wide{n}(void) {{\n"
+                    f"    long long total = 0, {', '.join(f'{v} = 1' for v in names)};\n"
+                    f"    #pragma omp parallel for reduction(+:total)\n"
+                    f"    for (int i = 0; i < 4; i++) total += {' + '.join(names)};\n"
+                    f"    return total;\n}}\n")
+        check("C OpenMP region captures", inline_c(omp_wide(12), openmp=True)['c_omp_wide12'](), 48)
+        try:
+            inline_c(omp_wide(20), openmp=True)
+            wide_error = None
+        except RuntimeError as e:
+            wide_error = str(e)
+        check("C OpenMP too many captures", wide_error is not None and "at most 16" in wide_error, True)
+        # Symbols of a loaded shared library resolve from inline C
+        if sys.platform.startswith("linux"):
+            libm = justjit.load_library("m")
+            cbrt = inline_c('''
+                double cbrt(double x);
+                double c_cbrt(double x) { return cbrt(x); }
+            ''', libraries=[libm])['c_cbrt']
+            check("C load_library", (cbrt(27.0), libm in justjit.loaded_libraries()), (3.0, True))
+
     except RuntimeError as e:
         print(f"  [SKIP] inline_c not available: {e}")
     except Exception as e:
@@ -270,11 +2379,66 @@ def main():
         check("ptr get [2]", ptr_get(test_arr.ctypes.data, 2), 30.0)
         check("ptr get [4]", ptr_get(test_arr.ctypes.data, 4), 50.0)
 
+        # Buffers are passed without going through .ctypes
+        import array
+        check("ptr numpy buffer", ptr_get(test_arr, 3), 40.0)
+        check("ptr array('d')", ptr_get(array.array('d', [1.5, 2.5]), 1), 2.5)
+
+        # Objects that only export DLPack (CPU tensors) are viewed in place
+        class DLPackOnly:
+            def __init__(self, arr):
+                self.arr = arr
+
+            def __dlpack__(self, **kwargs):
+                return self.arr.__dlpack__(**kwargs)
+
+        check("ptr __dlpack__", ptr_get(DLPackOnly(test_arr[1:]), 1), 30.0)
+
+        # vectorize registers a NumPy ufunc
+        @justjit.vectorize(mode='float')
+        def distance(x1, y1, x2, y2):
+            dx = x2 - x1
+            dy = y2 - y1
+            return (dx * dx + dy * dy) ** 0.5
+
+        check("vectorize ufunc", distance(np.zeros(3), np.zeros(3), np.array([3.0, 6.0, 0.0]), 4.0).tolist(), [5.0, 7.211102550927978, 4.0])
+
+        # complex buffers run one interleaved loop; .sum reduces without a temporary
+        za = np.array([1+1j, 2-1j, 0.5j])
+        zb = np.array([2+2j, 1j, 3+0j])
+        check("complex128 buffers", complex_mul(za, zb).tolist(), (za * zb).tolist())
+        check("complex128 buffer sum", complex_mul.sum(za, za.conj()), 7.25+0j)
+
+        # a @ b on float64 matrices takes the built-in tiled GEMM (edge tiles included)
+        @jit
+        def matmul(a, b):
+            return a @ b
+
+        ma = np.arange(35.0).reshape(5, 7)
+        mb = np.arange(63.0).reshape(7, 9)[:, ::1]
+        check("matmul tiled", (matmul(ma, mb) == ma @ mb).all() and matmul(ma, mb).shape == (5, 9), True)
+        check("matmul int fallback", matmul(np.eye(2, dtype=np.int64), np.ones((2, 2), dtype=np.int64)).tolist(), [[1, 1], [1, 1]])
+
         # ptr -> JIT chain
         arr_val = ptr_get(test_arr.ctypes.data, 1)  # 20.0
         jit_val = float_square(arr_val)  # 400.0
         check("ptr->JIT chain", jit_val, 400.0)
 
+        # NumPy scalars and 0-d arrays unbox in place; float32/int32 keep their width
+        @jit(mode='float32')
+        def half32(x):
+            return x * 0.5
+
+        @jit(mode='int32')
+        def inc32(x):
+            return x + 1
+
+        check("numpy float64 scalar arg", float_square(test_arr[2]), 900.0)
+        check("numpy float32 scalar arg", half32(np.float32(3.0)), 1.5)
+        check("numpy int32 scalar arg", inc32(np.int32(41)), 42)
+        check("numpy int64 scalar arg", inc32(np.arange(5)[4]), 5)
+        check("numpy 0-d array arg", float_square(np.array(3.0)), 9.0)
+
         # ptr -> C -> JIT (if inline_c available)
         if HAS_INLINE_C:
             arr_val = ptr_get(test_arr.ctypes.data, 2)  # 30.0
@@ -346,6 +2510,49 @@ def main():
             check_close("type conversion", raii_funcs['test_type_conversion'](3.14159), 3.14159)
             check("refcount", raii_funcs['test_refcount'](), 1)
 
+            # Callbacks go through vectorcall: a C array of arguments, cached method names
+            callbacks = inline_c('''
+                long long test_callbacks(long long x) {
+                    void* a = jit_long_to_py(x);
+                    void* args[2] = {a, a};
+                    void* total = jit_call_vec(add_fn, args, 2);
+                    void* count = jit_call_method1(items, "count", a);
+                    long long out = jit_py_to_long(total) * 10 + jit_py_to_long(count);
+                    jit_decref(total);
+                    jit_decref(count);
+                    jit_decref(a);
+                    return out;
+                }
+            ''', captured_vars={"add_fn": lambda a, b: a + b, "items": [3, 3, 1]})
+            check("vectorcall callbacks", [callbacks['test_callbacks'](x) for x in (3, 3, 1)], [62, 62, 21])
+
+            # Stack-allocated views: opened in place, format checked once, batch open
+            view_arrays = [array.array('d', [1.0, 2.0, 3.0]), array.array('d', [10.0, 20.0, 30.0])]
+            views = inline_c('''
+                double test_views(void) {
+                    void* objs[2] = {jit_list_get(arrays, 0), jit_list_get(arrays, 1)};
+                    JitView v[2];
+                    double dot = -1.0;
+                    if (jit_view_open_n(objs, v, "dd", 2, 1) == 0) {
+                        double* a = (double*)v[0].data;
+                        double* b = (double*)v[1].data;
+                        dot = 0.0;
+                        for (long long i = 0; i < v[0].len; i++) dot += a[i] * b[i];
+                        a[0] = dot;
+                        jit_view_close(&v[1]);
+                        jit_view_close(&v[0]);
+                    }
+                    JitView wrong;
+                    if (jit_view_int32(objs[0], &wrong)) dot = -2.0;
+                    jit_error_clear();
+                    jit_view_close(&wrong);
+                    jit_decref(objs[1]);
+                    jit_decref(objs[0]);
+                    return dot;
+                }
+            ''', captured_vars={"arrays": view_arrays})
+            check("C buffer views", (views['test_views'](), view_arrays[0][0]), (140.0, 140.0))
+
         except Exception as e:
             print(f"  [FAIL] GIL/RAII test error: {e}")
             failed += 1
@@ -369,6 +2576,151 @@ def main():
         total = sum(countdown(5))
         check("generator sum", total, 15)
 
+        @jit
+        def count_up(start, stop=3):
+            while start < stop:
+                yield start
+                start = start + 1
+
+        check("generator keyword and default", list(count_up(start=1)), [1, 2])
+
+        # Short-lived generators reuse freed objects; each must start with clean locals
+        check("generator recycled", [sum(countdown(k)) for k in range(1, 200)][-3:], [19503, 19701, 19900])
+
+        @jit(mode='int')
+        def squares(n):
+            i = 0
+            while i < n:
+                yield i * i
+                i = i + 1
+
+        # Typed generator: a native batch first, then the rest through iteration
+        g = squares(300)
+        check("typed generator take", (g.take(4).tolist(), sum(g), len(g.take(5))), ([0, 1, 4, 9], 8955036, 0))
+
+        @jit
+        def drain(items):
+            total = 0
+            for item in items:
+                total = total + item
+            return total
+
+        # FOR_ITER in JIT code steps a JIT generator directly
+        check("jit loop over jit generator", (drain(countdown(100)), drain(squares(10))), (5050, 285))
+
+        @jit
+        def delegate(sub):
+            result = yield from sub
+            yield result
+
+        @jit
+        def two_then_return():
+            yield 1
+            yield 2
+            return 10
+
+        # yield from a JIT generator resumes it through am_send; the return value needs no StopIteration
+        check("yield from jit generator", list(delegate(two_then_return())), [1, 2, 10])
+
+        # Exhaustion through __next__ raises nothing extra; send() still reports the return value
+        finished = two_then_return()
+        next(finished), next(finished)
+        try:
+            finished.send(None)
+            stop_value = None
+        except StopIteration as stop:
+            stop_value = stop.value
+        check("generator stop value", (stop_value, next(finished, "done")), (10, "done"))
+
+        import asyncio
+
+        @jit
+        async def ticks(n, pause):
+            i = 0
+            while i < n:
+                await pause(0)
+                yield i
+                i = i + 1
+
+        async def collect_ticks():
+            return [tick async for tick in ticks(3, asyncio.sleep)]
+
+        # Native async generator: awaited sleeps go to the event loop, yields complete __anext__
+        check("native async generator", (type(ticks(1, asyncio.sleep)).__name__, asyncio.run(collect_ticks())),
+              ("JITAsyncGenerator", [0, 1, 2]))
+
+        @jit
+        async def doubled(x):
+            return x * 2
+
+        @jit
+        async def add_doubled(a, b, helper):
+            left = await helper(a)
+            right = await helper(b)
+            return left + right
+
+        @jit
+        async def await_futures(ready, pending, custom):
+            return (await ready) + (await pending) + (await custom)
+
+        class Awaitable:
+            def __await__(self):
+                yield from ()
+                return 100
+
+        async def drive_futures():
+            loop = asyncio.get_running_loop()
+            ready, pending = loop.create_future(), loop.create_future()
+            ready.set_result(1)
+            loop.call_soon(pending.set_result, 10)
+            return await await_futures(ready, pending, Awaitable())
+
+        # Futures are awaited through their am_await slot: done ones return in place, pending ones go to the loop
+        check("await asyncio futures", asyncio.run(drive_futures()), 111)
+
+        # Native run queue; the plain asyncio coroutine is handed to the event loop
+        check("run_all", justjit.run_all([add_doubled(i, 1, doubled) for i in range(3)] + [asyncio.sleep(0, result=7)]),
+              [2, 4, 6, 7])
+
+        # Suspended coroutines share their step function and names through the factory
+        from justjit import bench
+        parked = [add_doubled(i, 1, doubled) for i in range(2)]
+        check("coroutine names from factory", ["add_doubled" in repr(c) for c in parked], [True, True])
+        for coro in parked:
+            coro.close()
+        check("suspended coroutine bytes", bench.suspended_coroutine_bytes(1000) < bench.suspended_coroutine_bytes(1000, jit=False), True)
+
+        events = []
+
+        class Recorder:
+            def __enter__(self):
+                events.append("enter")
+                return self
+
+            def __exit__(self, *exc):
+                events.append("exit")
+                return False
+
+        @jit
+        def guarded(items, scale):
+            def scaled(v):
+                return v * scale
+            try:
+                with Recorder():
+                    for item in items:
+                        try:
+                            yield f"{item}:{scaled(int(item))}"
+                        except ValueError as e:
+                            yield f"bad {e}"
+            finally:
+                events.append("finally")
+
+        # Exception handlers, with blocks, f-strings and closures run inside the JIT generator
+        bad_input = guarded(["1", "2", "3"], 10)
+        got = [next(bad_input), bad_input.throw(ValueError("x"))]
+        bad_input.close()
+        check("generator handlers", (got, events), (["1:10", "bad x"], ["enter", "exit", "finally"]))
+
     except Exception as e:
         print(f"  [FAIL] Generator error: {e}")
         failed += 1